@@ -85,6 +85,14 @@ extern "C" {
 #define	LED_INT_HANDLE_EN				1		//LED
 #define	TKEY_INT_HANDLE_EN				1		//TOUCH
 
+//latency harness(latency_demo.c) owns BT1 interrupt, bt_irqhandler(BT1) is not called
+#define	LAT_BENCH_EN					0
+
+//startup.S paints the stack(__heap_end ~ __kernel_stack) for the high-water mark of csi_mem_report()
+#define	MEM_STACK_PAINT_EN				1
+//coret handler calls csi_mem_watch_tick(), margins/alarm set by csi_mem_watch_init()
+#define	MEM_WATCH_EN					0
+
 #ifdef __cplusplus
 }
 #endif
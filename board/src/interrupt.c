@@ -24,9 +24,22 @@
 #include "ifc.h"
 #include "iic.h"
 #include "tkey.h"
+#include <drv/prof.h>
+#include <drv/mem_report.h>
+
+/* Private macro-----------------------------------------------------------*/
+//ISR duration probes, opt-in: CONFIG_PROF and PROF_ISR_EN(soc.h)
+#if	PROF_ISR_EN
+	#define ISR_PROF_BEGIN(id)		PROF_BEGIN(id)
+	#define ISR_PROF_END(id)		PROF_END(id)
+#else
+	#define ISR_PROF_BEGIN(id)
+	#define ISR_PROF_END(id)
+#endif
 
 /* externs function--------------------------------------------------------*/
 extern void bt_irqhandler(csp_bt_t *ptBtBase);
+extern void lat_bench_bt_irqhandler(csp_bt_t *ptBtBase);
 extern void tick_irqhandler(void);					
 extern void dma_irqhandler(csp_dma_t *ptDmaBase);
 extern void uart_irqhandler(csp_uart_t *ptUartBase,uint8_t byIdx);
@@ -64,19 +77,25 @@ extern void rtc_irqhandler(csp_rtc_t *ptRtcBase);
 
 void coret_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_CORET);
 #if	CORET_INT_HANDLE_EN
     // ISR content ...
-	tick_irqhandler();		//system coret 
+	tick_irqhandler();		//system coret, first: csi_tick_get_cycles64 needs the wrap published before any nesting
+	#if	MEM_WATCH_EN
+		csi_mem_watch_tick();	//stack/heap headroom alarm
+	#endif
 	#if	TKEY_INT_HANDLE_EN
 		#if	defined(IS_CHIP_1103)
 			csi_tkey_basecnt_process();
 		#endif
 	#endif
 #endif
+	ISR_PROF_END(PROF_ID_ISR_CORET);
 }
 
 void syscon_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_SYSCON);
     // ISR content ...
 
 	if(csp_syscon_get_isr(SYSCON) & LVD_INT)
@@ -92,6 +111,7 @@ void syscon_int_handler(void)
 		//csi_pin_toggle(PA05);
 		csp_syscon_clr_clr(SYSCON, IWDT_INT);
 	}
+	ISR_PROF_END(PROF_ID_ISR_SYSCON);
 }
 
 /** \brief only used when DFLASH parallel mode PGM is enabled
@@ -101,255 +121,317 @@ void syscon_int_handler(void)
 
 void ifc_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_IFC);
 #if	IFC_INT_HANDLE_EN	
 	// ISR content ...
 	ifc_irqhandler();
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_IFC);
 }
 
 void adc_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_ADC);
 #if	ADC_INT_HANDLE_EN
 	// ISR content ...
 	adc_irqhandler(ADC0);//this is a weak function defined in adc_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_ADC);
 }
 
 void ept0_int_handler(void) 
 {	
+	ISR_PROF_BEGIN(PROF_ID_ISR_EPT0);
 #if	EPT_INT_HANDLE_EN	
 	// ISR content ...
 	ept_irqhandler(EPT0);//this is a weak function defined in ept_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_EPT0);
 }
 void dma_int_handler(void)
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_DMA);
 #if DMA_INT_HANDLE_EN
 	// ISR content ...	 
 	dma_irqhandler(DMA);
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_DMA);
 }
 
 void wwdt_int_handler(void)
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_WWDT);
 #if WWDT_INT_HANDLE_EN
 	 // ISR content ...
 	 wwdt_irqhandler();  //this is a weak function defined in wwdt_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	 
 #endif
+	ISR_PROF_END(PROF_ID_ISR_WWDT);
 }
 
 void gpta0_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_GPTA0);
 #if GPTA0_INT_HANDLE_EN
     gpta0_irqhandler(GPTA0); //this is a weak function defined in gpta_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_GPTA0);
 }
 
 void gpta1_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_GPTA1);
 #if GPTA1_INT_HANDLE_EN
     gpta1_irqhandler(GPTA1); //this is a weak function defined in gpta_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_GPTA1);
 }
 
 void gptb0_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_GPTB0);
 #if GPTB0_INT_HANDLE_EN
 	gptb_irqhandler(GPTB0);//this is a weak function defined in gptb_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_GPTB0);
 }
 
 void gptb1_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_GPTB1);
 #if GPTB1_INT_HANDLE_EN
     gptb_irqhandler(GPTB1);//this is a weak function defined in gptb_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_GPTB1);
 }
 
 void rtc_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_RTC);
 #if	RTC_INT_HANDLE_EN
     //ISR content ...
 	rtc_irqhandler(RTC);
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_RTC);
 }
 
 void uart0_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_UART0);
 #if	UART0_INT_HANDLE_EN
     // ISR content ...
 	uart_irqhandler(UART0, 0);
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_UART0);
 }
 void uart1_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_UART1);
 #if	UART1_INT_HANDLE_EN
     // ISR content ...
 	uart_irqhandler(UART1, 1);
 	
 #endif	
+	ISR_PROF_END(PROF_ID_ISR_UART1);
 }
 void uart2_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_UART2);
 #if	UART2_INT_HANDLE_EN
     // ISR content ...
 	uart_irqhandler(UART2, 2);
 #endif
+	ISR_PROF_END(PROF_ID_ISR_UART2);
 }
 
 void usart0_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_USART0);
 // when use lin demo,please uncomment lin_irqhandler function,and comment USART0_irqhandler function.
 #if	USART0_INT_HANDLE_EN
 	// ISR content ...
 	usart_irqhandler(USART0, 0);
 	//lin_irqhandler(LIN0, 0);
 #endif
+	ISR_PROF_END(PROF_ID_ISR_USART0);
 }
 
 void sio_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_SIO);
 #if	SIO_INT_HANDLE_EN
    // ISR content ...
    sio_irqhandler(SIO0);
    
 #endif
+	ISR_PROF_END(PROF_ID_ISR_SIO);
 }
 
 void i2c_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_I2C);
 #if	I2C_INT_HANDLE_EN
     // ISR content ...
 	i2c_irqhandler(I2C0);   //this is a weak function defined in i2c_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_I2C);
 }
 void spi0_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_SPI0);
 #if	SPI_INT_HANDLE_EN
     // ISR content ...
 	spi_irqhandler(SPI0);//this is a weak function defined in spi_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 #endif
+	ISR_PROF_END(PROF_ID_ISR_SPI0);
 }
 
 void exi0_int_handler(void) 			
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_EXI0);
 #if	EXI0_INT_HANDLE_EN
     // ISR content ...
 	gpio_irqhandler(0);
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_EXI0);
 }
 void exi1_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_EXI1);
 #if	EXI1_INT_HANDLE_EN
     // ISR content ...
 	gpio_irqhandler(1);
 
 #endif
+	ISR_PROF_END(PROF_ID_ISR_EXI1);
 }
 void exi2_3_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_EXI2_3);
 #if	EXI2_3_INT_HANDLE_EN
     // ISR content ...
 	gpio_irqhandler(2);
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_EXI2_3);
 }
 void exi4_9_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_EXI4_9);
 #if	EXI4_9_INT_HANDLE_EN
     // ISR content ...
 	gpio_irqhandler(3);
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_EXI4_9);
 }
 void exi10_15_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_EXI10_15);
 #if	EXI10_15_INT_HANDLE_EN
     // ISR content ...
 	gpio_irqhandler(4);
 #endif
+	ISR_PROF_END(PROF_ID_ISR_EXI10_15);
 }
 
 void cnta_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_CNTA);
 #if	CNTA_INT_HANDLE_EN
     // ISR content ...
 	cnta_irqhandler(CNTA);
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_CNTA);
 }
 void tkey_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_TKEY);
 #if	TKEY_INT_HANDLE_EN
 	#if	defined(IS_CHIP_1103)
 	// ISR content ...
 	csi_tkey_int_process();
 	#endif
 #endif
+	ISR_PROF_END(PROF_ID_ISR_TKEY);
 }
 void lpt_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_LPT);
 #if	LPT_INT_HANDLE_EN
     // ISR content ...
 	lpt_irqhandler(LPT);   //this is a weak function defined in lpt_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 #endif
+	ISR_PROF_END(PROF_ID_ISR_LPT);
 }
 void led_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_LED);
 #if	LED_INT_HANDLE_EN
 	#if	defined(IS_CHIP_1101) || defined(IS_CHIP_1103)
 		led_irqhandler(LED);//this is a weak function defined in led_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	#endif
 #endif
+	ISR_PROF_END(PROF_ID_ISR_LED);
 }
 void cmp_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_CMP);
 #if	CMP_INT_HANDLE_EN
 	#if	defined(IS_CHIP_1101) || defined(IS_CHIP_1103) || defined(IS_CHIP_1104)
 		// ISR content ...
 		cmp_irqhandler(CMP0); //this is a weak function defined in cmp_demo.c, for better efficiency, we recommand user directly implement IRQ handler here without any function call.
 	#endif
 #endif
+	ISR_PROF_END(PROF_ID_ISR_CMP);
 }
 void bt0_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_BT0);
 #if	BT0_INT_HANDLE_EN
     // ISR content ...
 	bt_irqhandler(BT0);
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_BT0);
 }
 
 void bt1_int_handler(void) 
 {
-#if	BT1_INT_HANDLE_EN
+	ISR_PROF_BEGIN(PROF_ID_ISR_BT1);
+#if	LAT_BENCH_EN
+	lat_bench_bt_irqhandler(BT1);
+#elif	BT1_INT_HANDLE_EN
     // ISR content ...
 	bt_irqhandler(BT1);
 	
 #endif
+	ISR_PROF_END(PROF_ID_ISR_BT1);
 }
 
 void lcd_int_handler(void) 
 {
+	ISR_PROF_BEGIN(PROF_ID_ISR_LCD);
 #if	LCD_INT_HANDLE_EN
 	#if	defined(IS_CHIP_1103) || defined(IS_CHIP_1104)
 		// ISR content ...
 		lcd_irqhandler(LCD);
 	#endif
 #endif
+	ISR_PROF_END(PROF_ID_ISR_LCD);
 }
 
 /*************************************************************/
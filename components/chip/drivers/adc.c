@@ -15,6 +15,8 @@
 #include <drv/clk.h>
 #include <sys_clk.h>
 #include <drv/gpio.h>
+#include <drv/etb.h>
+#include <drv/dma.h>
 #include "csp_common.h"
 #include "csp_adc.h"
 /* Private macro-----------------------------------------------------------*/
@@ -25,6 +27,16 @@
 /* Private variablesr------------------------------------------------------*/
 csi_adc_samp_t	g_tAdcSamp;
 
+//adc stream(dma ring over two halves) handle
+static struct {
+	uint32_t			*pwBuf;			//pointer of stream buffer(two halves)
+	uint16_t			hwSeqNum;		//sequences per half buffer
+	uint8_t				byDmaCh;		//dma channel, DMA_CH_MAX_NUM: not init
+	uint8_t				byHalf;			//half buffer being filled by dma, 0/1
+	csi_adc_stream_cb_t	callback;		//half buffer complete callback, NULL: stopped
+	void				*pArg;
+} s_tAdcStream = {NULL, 0, DMA_CH_MAX_NUM, 0, NULL, NULL};
+
 /** \brief initialize adc data structure
  * 
  *  \param[in] ptAdcBase: pointer of adc register structure
@@ -474,3 +486,123 @@ void csi_adc_bufout_enable(csp_adc_t *ptAdcBase, csi_adc_bufsel_e eBufSel, bool
 	csp_adc_bufsel_set(ptAdcBase, (adc_bufsel_e)eBufSel);
 	csp_adc_bufout_enable(ptAdcBase, bEnable);
 }
+
+/** \brief adc stream dma sequence moved(LTCIT), hand over a half once dma writes the other one
+ *         The dma runs over both halves and reloads itself at the end, so no sequence end finds
+ *         it stopped. The half is taken from the dma write position: LTCITs merged by a late
+ *         interrupt hand over the same half once.
+ */
+static void apt_adc_stream_dma_cb(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, void *pArg)
+{
+	uint32_t wHalfLen = (uint32_t)s_tAdcStream.hwSeqNum * g_tAdcSamp.byChnlNum;
+	uint32_t wPos, *pwFull;
+	uint8_t byHalf;
+	
+	if(s_tAdcStream.callback == NULL)								//stopped
+		return;
+	
+	wPos = (csp_dma_get_curr_dst((csp_dma_t *)DMA_REG_BASE(ptDmaBase, eDmaCh)) - (uint32_t)s_tAdcStream.pwBuf) >> 2;
+	byHalf = (wPos >= wHalfLen && wPos < 2 * wHalfLen);			//end of buffer, not reloaded yet: half 0 is next
+	if(byHalf == s_tAdcStream.byHalf)
+		return;
+	
+	pwFull = s_tAdcStream.pwBuf + (s_tAdcStream.byHalf ? wHalfLen : 0);
+	s_tAdcStream.byHalf = byHalf;
+	s_tAdcStream.callback((csp_adc_t *)pArg, pwFull, s_tAdcStream.hwSeqNum, s_tAdcStream.pArg);
+}
+
+/** \brief adc stream init, adc sequence end(EOC) triggers the dma channel through etb
+ *         call after csi_adc_set_seqx, every dma request moves one whole sequence(ADC_DR[0~n-1])
+ * 
+ *  \param[in] ptAdcBase: pointer of ADC reg structure.
+ *  \param[in] eDmaCh: channel number of dma, eDmaCh: DMA_CH0` DMA_CH3
+ *  \param[in] eEtbCh: channel id number of etb, eEtbCh >= ETB_CH8
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_adc_stream_init(csp_adc_t *ptAdcBase, csi_dma_ch_e eDmaCh, csi_etb_ch_e eEtbCh)
+{
+	csi_error_t ret = CSI_OK;
+	csi_dma_ch_config_t tDmaConfig;				
+	csi_etb_config_t 	tEtbConfig;	
+	
+	if(eDmaCh >= DMA_CH_MAX_NUM || g_tAdcSamp.byChnlNum == 0)
+		return CSI_ERROR;
+	
+	//dma config
+	tDmaConfig.bySrcLinc 	= DMA_ADDR_INC;				//低位传输原地址自增, ADC_DR[0~n-1]
+	tDmaConfig.bySrcHinc 	= DMA_ADDR_CONSTANT;		//高位传输原地址固定不变, 每个序列从ADC_DR[0]开始
+	tDmaConfig.byDetLinc 	= DMA_ADDR_INC;				//低位传输目标地址自增
+	tDmaConfig.byDetHinc 	= DMA_ADDR_INC;				//高位传输目标地址自增
+	tDmaConfig.byDataWidth 	= DMA_DSIZE_32_BITS;		//传输数据宽度32bit，ADC_DRx[]为32位
+	tDmaConfig.byReload 	= DMA_RELOAD_ENABLE;		//自动重载，整个缓存写满后DMA不停，从头继续
+	tDmaConfig.byTransMode 	= DMA_TRANS_ONCE;			//DMA服务模式(传输模式)，连续服务
+	tDmaConfig.byTsizeMode  = DMA_TSIZE_ONE_DSIZE;		//传输数据大小，一个 DSIZE , 即DSIZE定义大小
+	tDmaConfig.byReqMode	= DMA_REQ_HARDWARE;			//DMA请求模式，硬件请求
+	tDmaConfig.wInt			= DMA_INTSRC_LTCIT;			//使用LTCIT中断，每个序列一次，由写位置判断半缓存
+	
+	//etb config
+	tEtbConfig.byChType = ETB_ONE_TRG_ONE_DMA;			//单个源触发单个目标，DMA方式
+	tEtbConfig.bySrcIp 	= ETB_ADC_TRGOUT0;				//ADC触发端口0作为触发源
+	tEtbConfig.byDstIp 	= ETB_DMA_CH0 + eDmaCh;			//ETB DMA通道 作为目标实际
+	tEtbConfig.byTrgMode = ETB_HARDWARE_TRG;			//通道触发模式采样硬件触发
+	
+	ret = csi_etb_ch_config(eEtbCh, &tEtbConfig);		//初始化ETB，DMA ETB CHANNEL = ETB_CH8~ETB_CH11
+	if(ret < CSI_OK)
+		return CSI_ERROR;
+	ret = csi_dma_ch_init(DMA, eDmaCh, &tDmaConfig);	//初始化DMA
+	if(ret < CSI_OK)
+		return CSI_ERROR;
+	
+	csi_adc_set_evtrg(ptAdcBase, ADC_TRGOUT0, ADC_TRGSRC_EOC);		//序列转换结束(EOC)在触发端口0输出
+	csi_adc_evtrg_enable(ptAdcBase, ADC_TRGOUT0, DISABLE);			//start之前禁止输出
+	
+	s_tAdcStream.byDmaCh = eDmaCh;
+	s_tAdcStream.callback = NULL;
+	csi_dma_attach_callback(eDmaCh, apt_adc_stream_dma_cb, ptAdcBase);
+	
+	return ret;
+}
+
+/** \brief start adc stream, dma moves every converted sequence into the stream buffer, 
+ *         callback gets the full half while dma fills the other half, it has to return
+ *         within hwSeqNum sequence periods, before dma comes back to that half
+ *         conversions are paced by the user's sync trigger(e.g. BT/GPTA/LPT -> ETB -> ADC_SYNCINx)
+ * 
+ *  \param[in] ptAdcBase: pointer of ADC reg structure.
+ *  \param[in] pwBuf: pointer of stream buffer, size = 2 * hwSeqNum * byChnlNum words
+ *  \param[in] hwSeqNum: number of sequences per half buffer(1~0x7ff)
+ *  \param[in] callback: half buffer complete callback, called in dma interrupt
+ *  \param[in] pArg: user param of callback
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_adc_stream_start(csp_adc_t *ptAdcBase, uint32_t *pwBuf, uint16_t hwSeqNum, csi_adc_stream_cb_t callback, void *pArg)
+{
+	if(s_tAdcStream.byDmaCh >= DMA_CH_MAX_NUM || pwBuf == NULL || callback == NULL || hwSeqNum == 0 || hwSeqNum > 0x7ff)
+		return CSI_ERROR;
+	if(s_tAdcStream.callback != NULL)
+		return CSI_BUSY;
+	
+	s_tAdcStream.pwBuf = pwBuf;
+	s_tAdcStream.hwSeqNum = hwSeqNum;
+	s_tAdcStream.byHalf = 0;
+	s_tAdcStream.pArg = pArg;
+	s_tAdcStream.callback = callback;
+	
+	csi_dma_ch_start(DMA, s_tAdcStream.byDmaCh, (void *)&(ptAdcBase->DR[0]), (void *)pwBuf, 2 * hwSeqNum, g_tAdcSamp.byChnlNum);
+	csi_adc_evtrg_enable(ptAdcBase, ADC_TRGOUT0, ENABLE);
+	
+	return CSI_OK;
+}
+
+/** \brief stop adc stream, data of the half buffer being filled is dropped
+ * 
+ *  \param[in] ptAdcBase: pointer of ADC reg structure.
+ *  \return none
+ */
+void csi_adc_stream_stop(csp_adc_t *ptAdcBase)
+{
+	csi_adc_evtrg_enable(ptAdcBase, ADC_TRGOUT0, DISABLE);
+	s_tAdcStream.callback = NULL;
+	if(s_tAdcStream.byDmaCh < DMA_CH_MAX_NUM)
+		csi_dma_ch_stop(DMA, s_tAdcStream.byDmaCh);
+}
@@ -0,0 +1,134 @@
+/***********************************************************************//**
+ * \file  adc_ovs.c
+ * \brief  adc oversampling and decimation, plain C without register access,
+ *         feed it with dma blocks from csi_adc_stream_start
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+
+#include <stddef.h>
+#include <drv/adc_ovs.h>
+
+/* Private macro------------------------------------------------------*/
+/* externs function---------------------------------------------------*/
+/* externs variablesr-------------------------------------------------*/
+/* Private variablesr-------------------------------------------------*/
+
+
+/** \brief  init oversampling accumulator
+  *
+  * \param[in] ptOvs: pointer of accumulator
+  * \param[in] byChnlNum: channel number of sequence(1~16)
+  * \param[in] hwRatio: samples per output, power of two(1~4096), 4^n gives n extra bits
+  * \return 0: ok, -1: parameter error
+  */
+int32_t csi_adc_ovs_init(csi_adc_ovs_t *ptOvs, uint8_t byChnlNum, uint16_t hwRatio)
+{
+	uint8_t byShift = 0;
+
+	if(ptOvs == NULL || byChnlNum == 0 || byChnlNum > ADC_OVS_CHNL_MAX ||
+		hwRatio == 0 || hwRatio > ADC_OVS_RATIO_MAX || (hwRatio & (hwRatio - 1)))
+		return -1;
+
+	while((1u << byShift) < hwRatio)
+		byShift++;
+
+	ptOvs->byChnlNum = byChnlNum;
+	ptOvs->hwRatio = hwRatio;
+	ptOvs->byShift = byShift;
+	ptOvs->byExtBits = byShift >> 1;
+	csi_adc_ovs_reset(ptOvs);
+
+	return 0;
+}
+
+/** \brief  clear accumulated samples, keep config
+  *
+  * \param[in] ptOvs: pointer of accumulator
+  * \return none
+  */
+void csi_adc_ovs_reset(csi_adc_ovs_t *ptOvs)
+{
+	uint8_t i;
+
+	for(i = 0; i < ptOvs->byChnlNum; i++)
+	{
+		ptOvs->wSum[i] = 0;
+		ptOvs->hwMin[i] = ADC_OVS_DATA_MSK;
+		ptOvs->hwMax[i] = 0;
+	}
+	ptOvs->hwCount = 0;
+}
+
+/** \brief  accumulate a block of sequences in one pass; the block is split at output
+  *         boundaries so the inner loop is only add/compare per sample
+  *
+  * \param[in] ptOvs: pointer of accumulator
+  * \param[in] pwData: interleaved samples, hwSeqNum sequences of byChnlNum words(ADC_DR[] format)
+  * \param[in] hwSeqNum: number of sequences in pwData
+  * \param[out] ptResult: output, byChnlNum results per completed output,
+  *                       room for (hwSeqNum / hwRatio + 1) * byChnlNum results
+  * \return number of outputs completed(each one is byChnlNum results)
+  */
+uint16_t csi_adc_ovs_accumulate(csi_adc_ovs_t *ptOvs, const uint32_t *pwData, uint16_t hwSeqNum, csi_adc_ovs_result_t *ptResult)
+{
+	uint8_t i, byChnlNum = ptOvs->byChnlNum;
+	uint8_t byValShift = ptOvs->byShift - ptOvs->byExtBits;
+	uint16_t j, hwRun, hwOut = 0;
+	uint16_t hwVal;
+	uint32_t wSum;
+	const uint32_t *pwSamp;
+
+	while(hwSeqNum)
+	{
+		hwRun = ptOvs->hwRatio - ptOvs->hwCount;				//sequences left of current output
+		if(hwRun > hwSeqNum)
+			hwRun = hwSeqNum;
+
+		for(i = 0; i < byChnlNum; i++)
+		{
+			uint16_t hwMin = ptOvs->hwMin[i];
+			uint16_t hwMax = ptOvs->hwMax[i];
+
+			wSum = ptOvs->wSum[i];
+			pwSamp = pwData + i;
+			for(j = 0; j < hwRun; j++)
+			{
+				hwVal = *pwSamp & ADC_OVS_DATA_MSK;
+				pwSamp += byChnlNum;
+				wSum += hwVal;
+				if(hwVal < hwMin)
+					hwMin = hwVal;
+				if(hwVal > hwMax)
+					hwMax = hwVal;
+			}
+			ptOvs->wSum[i] = wSum;
+			ptOvs->hwMin[i] = hwMin;
+			ptOvs->hwMax[i] = hwMax;
+		}
+
+		pwData += (uint32_t)hwRun * byChnlNum;
+		hwSeqNum -= hwRun;
+		ptOvs->hwCount += hwRun;
+
+		if(ptOvs->hwCount == ptOvs->hwRatio)						//output complete, decimate
+		{
+			for(i = 0; i < byChnlNum; i++)
+			{
+				wSum = ptOvs->wSum[i];
+				ptResult->wValue = byValShift ? (wSum + (1ul << (byValShift - 1))) >> byValShift : wSum;
+				ptResult->hwMean = ptOvs->byShift ? (wSum + (1ul << (ptOvs->byShift - 1))) >> ptOvs->byShift : wSum;
+				ptResult->hwMin = ptOvs->hwMin[i];
+				ptResult->hwMax = ptOvs->hwMax[i];
+				ptResult++;
+			}
+			csi_adc_ovs_reset(ptOvs);
+			hwOut++;
+		}
+	}
+
+	return hwOut;
+}
@@ -54,7 +54,7 @@ uint16_t csi_crc16(uint16_t hwCrcSeed, uint8_t* pbyData, uint32_t wSize)
 	csp_crc_set_seed(CRC, hwCrcSeed);      //Set CRC seed value
 	for (i=0; i<wSize; i++)                
 	{
-		*(uint8_t *)(AHB_CRC_BASE + 0x14 + (i%4)) = *pbyData; //Write data
+		*(uint8_t *)(AHB_CRC_BASE + 0x14 + (i & 0x03)) = *pbyData; //Write data
 		pbyData ++;
 	}
 	return ((uint16_t)csp_crc_get_result(CRC));  //Return the result of calculation
@@ -79,7 +79,7 @@ uint16_t csi_crc16_ccitt( uint16_t hwCrcSeed, uint8_t *pbyData, uint32_t wSize)
 	csp_crc_set_seed(CRC, hwCrcSeed);    //Set CRC seed value
 	for (i=0; i<wSize; i++)
 	{
-		*(uint8_t *)(AHB_CRC_BASE + 0x14 + (i%4)) = *pbyData; //Write data
+		*(uint8_t *)(AHB_CRC_BASE + 0x14 + (i & 0x03)) = *pbyData; //Write data
 		pbyData ++;
 	}
 	return ((uint16_t)csp_crc_get_result(CRC));  //Return the result of calculation
@@ -105,7 +105,7 @@ uint16_t csi_crc16_itu(uint16_t hwCrcSeed, uint8_t* pbyData, uint32_t wSize)
 	csp_crc_set_seed(CRC, hwCrcSeed);    //Set CRC seed value
 	for (i=0; i<wSize; i++)
 	{
-		*(uint8_t *)(AHB_CRC_BASE + 0x14 + (i%4)) = *pbyData;  //Write data
+		*(uint8_t *)(AHB_CRC_BASE + 0x14 + (i & 0x03)) = *pbyData;  //Write data
 		pbyData ++;
 	}
 	return ((uint16_t)csp_crc_get_result(CRC));  //Return the result of calculation
@@ -131,7 +131,7 @@ uint32_t csi_crc32_be(uint32_t wCrcSeed, uint8_t* pbyData, uint32_t wSize)
 	csp_crc_set_seed(CRC, wCrcSeed);     //Set CRC seed value
 	for (i=0; i<wSize; i++) 
 	{
-		*(uint8_t *)(AHB_CRC_BASE + 0x14 + (i%4)) = *pbyData; //Write data
+		*(uint8_t *)(AHB_CRC_BASE + 0x14 + (i & 0x03)) = *pbyData; //Write data
 		pbyData++;
 	}
 	return (csp_crc_get_result(CRC)); //Return the result of calculation
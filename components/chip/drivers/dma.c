@@ -20,6 +20,16 @@
 /* externs variablesr------------------------------------------------------*/
 /* Private variablesr------------------------------------------------------*/
 static uint16_t s_hwDmaMsg	= 0;
+static csi_dma_callback_t s_fnDmaCallback[DMA_CH_MAX_NUM];
+static void *s_pDmaCallbackArg[DMA_CH_MAX_NUM];
+
+//scatter-gather chain state of dma channel
+typedef struct {
+	const csi_iovec_t	*ptIov;		//next segment
+	void				*pDstAddr;	//fixed destination address
+	uint8_t				byRemain;	//segments left after current
+} dma_sg_t;
+static dma_sg_t s_tDmaSg[DMA_CH_MAX_NUM];
 
 /** \brief dma interrupt handle function
  * 
@@ -39,6 +49,52 @@ static uint8_t apt_dma_post_msg(csi_dma_int_msg_e eIntMsg, uint8_t byPost)
 		return false;
 }
 
+/** \brief load transfer count and addresses of dma channel and start it
+ * 
+ *  \param[in] ptDmaBase: pointer of dma reg structure.
+ *  \param[in] eDmaCh: channel num of dma(4channel: 0->3)
+ *  \param[in] pSrcAddr: src addr of transfer 
+ *  \param[in] pDstAddr: dst addr of transfer 
+ *  \param[in] hwHTranNum: high transfer num
+ *  \param[in] hwLTranNum: low transfer num
+ *  \return none
+ */ 
+static void apt_dma_ch_load(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, void *pSrcAddr, void *pDstAddr, uint16_t hwHTranNum, uint16_t hwLTranNum)
+{
+	csp_dma_t *ptDmaChBase = (csp_dma_t *)DMA_REG_BASE(ptDmaBase, eDmaCh);
+	
+	csp_dma_set_ch_trans_num(ptDmaChBase, hwLTranNum, hwHTranNum);	//continuous mode: data length
+	csp_dma_set_ch_src_addr(ptDmaChBase, (uint32_t)pSrcAddr);		//Src addr
+	csp_dma_set_ch_dst_addr(ptDmaChBase, (uint32_t)pDstAddr);		//dst addr
+	csp_dma_ch_en(ptDmaChBase);										//channel enable
+	if(!csp_dma_get_rsrx(ptDmaChBase))
+		csp_dma_ch_swtrig(ptDmaChBase);								//sw triger 
+}
+
+/** \brief start next non-empty scatter-gather segment of dma channel
+ * 
+ *  \param[in] ptDmaBase: pointer of dma register structure
+ *  \param[in] byCh: dma channel number
+ *  \return true: next segment started; false: chain complete
+ */ 
+static bool apt_dma_sg_next(csp_dma_t *ptDmaBase, uint8_t byCh)
+{
+	dma_sg_t *ptSg = &s_tDmaSg[byCh];
+	
+	while(ptSg->byRemain)
+	{
+		const csi_iovec_t *ptIov = ptSg->ptIov ++;
+		ptSg->byRemain --;
+		if(ptIov->wLen)
+		{
+			apt_dma_ch_load(ptDmaBase, (csi_dma_ch_e)byCh, (void *)ptIov->pBase, ptSg->pDstAddr, (uint16_t)ptIov->wLen, 1);
+			return true;
+		}
+	}
+	
+	return false;
+}
+
 /** \brief dma interrupt handle function
  * 
  *  \param[in] ptDmaBase: pointer of dma register structure
@@ -46,29 +102,33 @@ static uint8_t apt_dma_post_msg(csi_dma_int_msg_e eIntMsg, uint8_t byPost)
  */ 
 __attribute__((weak)) void dma_irqhandler(csp_dma_t *ptDmaBase)
 {
-	volatile uint32_t wIsr = csp_dma_get_isr(ptDmaBase) & 0x000f000f;
+	uint32_t wIsr = csp_dma_get_isr(ptDmaBase) & 0x000f000f;
+	uint32_t wChSr;
+	uint8_t byCh;
 	
-	switch(wIsr)
+	//channels may complete together(spi tx + rx, circular rx + another channel), serve every set bit
+	for(byCh = 0; wIsr; byCh++)
 	{
-		//LTCIT
-		case DMA_CH0_LTCIT_SR:
-		case DMA_CH1_LTCIT_SR:
-		case DMA_CH2_LTCIT_SR:
-		case DMA_CH3_LTCIT_SR:
-			csp_dma_clr_isr(ptDmaBase, (uint8_t)wIsr);		//clear LTCIT status
-			apt_dma_post_msg(wIsr, 1);						//post LTCIT interrupt message
-			break;
+		wChSr = wIsr & ((DMA_CH0_LTCIT_SR | DMA_CH0_TCIT_SR) << byCh);
+		if(0 == wChSr)
+			continue;
+		wIsr &= ~wChSr;
+		csp_dma_clr_isr(ptDmaBase, (dma_icr_e)(DMA_CH0_IT << byCh));		//clear LTCIT/TCIT status of channel
 		
-		//TCIT 
-		case DMA_CH0_TCIT_SR:
-		case DMA_CH1_TCIT_SR:
-		case DMA_CH2_TCIT_SR:
-		case DMA_CH3_TCIT_SR:
-			csp_dma_clr_isr(ptDmaBase, (wIsr >> 16));		//clear LTCIT status
-			apt_dma_post_msg((wIsr >> 12), 1);				//post TCIT interrupt message
-			break;
-		default:
-			break;
+		if((wChSr & (DMA_CH0_TCIT_SR << byCh)) && apt_dma_sg_next(ptDmaBase, byCh))
+			continue;														//scatter-gather, chain next segment
+		
+		//callback on TCIT, and on LTCIT when the channel enables it
+		if(s_fnDmaCallback[byCh] && ((wChSr & (DMA_CH0_TCIT_SR << byCh)) || 
+			(((csp_dma_t *)DMA_REG_BASE(ptDmaBase, byCh))->CRX & DMA_LTCIT)))
+		{
+			s_fnDmaCallback[byCh](ptDmaBase, (csi_dma_ch_e)byCh, s_pDmaCallbackArg[byCh]);
+			continue;
+		}
+		if(wChSr & (DMA_CH0_LTCIT_SR << byCh))
+			apt_dma_post_msg((csi_dma_int_msg_e)(DMA_CH0_LTCIT_MSG << byCh), 1);	//post LTCIT interrupt message
+		if(wChSr & (DMA_CH0_TCIT_SR << byCh))
+			apt_dma_post_msg((csi_dma_int_msg_e)(DMA_CH0_TCIT_MSG << byCh), 1);	//post TCIT interrupt message
 	}
 }
 /** \brief get dma idx 
@@ -131,11 +191,13 @@ csi_error_t csi_dma_ch_start(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, void *pS
 {
 //	uint32_t wTranLtc = wLen;
 //	uint32_t wTranHtc = 0x01;
-	csp_dma_t *ptDmaChBase = (csp_dma_t *)DMA_REG_BASE(ptDmaBase, eDmaCh);
+//	csp_dma_t *ptDmaChBase = (csp_dma_t *)DMA_REG_BASE(ptDmaBase, eDmaCh);
 	
 	if((eDmaCh >= DMA_CH_MAX_NUM) || ((hwHTranNum == 0) && (hwLTranNum == 0)))
 		return CSI_ERROR;
 	
+	s_tDmaSg[eDmaCh].byRemain = 0;									//plain transfer, no chain left from an earlier sg transfer
+	
 //	if(csp_dma_get_crx(ptDmaChBase) & DMA_TSIZE_MSK)			//Tsize mode 4byte mode
 //	{
 //		if((wLen % 4) == 0)
@@ -155,12 +217,40 @@ csi_error_t csi_dma_ch_start(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, void *pS
 //	else
 //		csp_dma_set_ch_trans_num(ptDmaChBase, hwHTranNum, hwLTranNum);	//once mode: data length switch
 		
-	csp_dma_set_ch_trans_num(ptDmaChBase, hwLTranNum, hwHTranNum);	//continuous mode: data length
-	csp_dma_set_ch_src_addr(ptDmaChBase, (uint32_t)pSrcAddr);		//Src addr
-	csp_dma_set_ch_dst_addr(ptDmaChBase, (uint32_t)pDstAddr);		//dst addr
-	csp_dma_ch_en(ptDmaChBase);										//channel enable
-	if(!csp_dma_get_rsrx(ptDmaChBase))
-		csp_dma_ch_swtrig(ptDmaChBase);								//sw triger 
+	apt_dma_ch_load(ptDmaBase, eDmaCh, pSrcAddr, pDstAddr, hwHTranNum, hwLTranNum);
+	
+	return CSI_OK;
+}
+
+/** \brief dma channel scatter-gather transfer start, to a fixed(peripheral) address
+ * 
+ *  \param[in] ptDmaBase: pointer of dma reg structure.
+ *  \param[in] eDmaCh: channel num of dma(4channel: 0->3)
+ *  \param[in] ptIov: segment array, each segment length <= 0xfff, must stay valid until complete
+ *  \param[in] byIovCnt: segment number
+ *  \param[in] pDstAddr: dst addr of transfer 
+ *  \return error code \ref csi_error_t
+ *  \note   the channel must enable TCIT interrupt, segments are chained in dma_irqhandler
+ */
+csi_error_t csi_dma_ch_start_sg(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, const csi_iovec_t *ptIov, uint8_t byIovCnt, void *pDstAddr)
+{
+	uint8_t i;
+	
+	if((eDmaCh >= DMA_CH_MAX_NUM) || (NULL == ptIov) || (0 == byIovCnt))
+		return CSI_ERROR;
+	
+	for(i = 0; i < byIovCnt; i++)
+	{
+		if(ptIov[i].wLen > 0xfff)
+			return CSI_ERROR;
+	}
+	
+	s_tDmaSg[eDmaCh].ptIov = ptIov;
+	s_tDmaSg[eDmaCh].pDstAddr = pDstAddr;
+	s_tDmaSg[eDmaCh].byRemain = byIovCnt;
+	
+	if(!apt_dma_sg_next(ptDmaBase, eDmaCh))		//all segments empty, byRemain is 0 again
+		return CSI_ERROR;
 	
 	return CSI_OK;
 }
@@ -215,6 +305,9 @@ void csi_dma_int_enable(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, csi_dma_intsr
 void csi_dma_ch_stop(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh)
 {
 	csp_dma_t *ptDmaChBase = (csp_dma_t *)DMA_REG_BASE(ptDmaBase, eDmaCh);
+	
+	if(eDmaCh < DMA_CH_MAX_NUM)
+		s_tDmaSg[eDmaCh].byRemain = 0;				//drop the rest of a sg chain
 	csp_dma_ch_stop(ptDmaChBase);
 }
 
@@ -255,3 +348,31 @@ bool csi_dma_get_msg(csi_dma_ch_e eDmaCh, bool bClrEn)
 	return bRet;
 }
 
+/** \brief attach transfer complete(TCIT) callback to dma channel
+ * 
+ *  \param[in] eDmaCh: dma channel number, channel 0 -> 3
+ *  \param[in] callback: callback function, called in dma_irqhandler
+ *  \param[in] pArg: user param passed to callback
+ *  \return error code \ref csi_error_t
+ */ 
+csi_error_t csi_dma_attach_callback(csi_dma_ch_e eDmaCh, csi_dma_callback_t callback, void *pArg)
+{
+	if(eDmaCh >= DMA_CH_MAX_NUM)
+		return CSI_ERROR;
+	
+	s_pDmaCallbackArg[eDmaCh] = pArg;
+	s_fnDmaCallback[eDmaCh] = callback;
+	
+	return CSI_OK;
+}
+
+/** \brief detach transfer complete callback of dma channel
+ * 
+ *  \param[in] eDmaCh: dma channel number, channel 0 -> 3
+ *  \return none
+ */ 
+void csi_dma_detach_callback(csi_dma_ch_e eDmaCh)
+{
+	if(eDmaCh < DMA_CH_MAX_NUM)
+		s_fnDmaCallback[eDmaCh] = NULL;
+}
@@ -10,26 +10,70 @@
  * *********************************************************************
 */
 
+#include <stddef.h>
 #include <soc.h>
 #include "csp_hwdiv.h"
+#include <drv/hwdiv.h>
+#include <drv/lat_bench.h>
 
 #define HWDIV_REG_BASE	(csp_hwdiv_t *)AHB_HWD_BASE
 
-//!!!This function is to replace the div function in stdio.h
-//!!!This function will be called AUTOMATICALLY when "/" is used.
-int __divsi3(int wDividend, int wDivisor)
+#if HWDIV_MODE == HWDIV_MODE_SEQ_RETRY
+//bumped after every divider access; a change across an access means an isr
+//used the divider in between and the result has to be recalculated
+static volatile uint32_t s_wHwdivSeq = 0;
+#endif
+
+/** \brief one divider access, interrupt safe according to HWDIV_MODE
+ * 
+ *  \param[in] wCr: 0: signed, 1: unsigned
+ *  \param[in] wDividend: dividend
+ *  \param[in] wDivisor: divisor
+ *  \param[out] pwQt: quotient, NULL: not needed
+ *  \param[out] pwRm: remainder, NULL: not needed
+ *  \return none
+ */
+static inline __attribute__((always_inline)) void apt_hwdiv_calc(uint32_t wCr, uint32_t wDividend, uint32_t wDivisor, uint32_t *pwQt, uint32_t *pwRm)
 {
-	uint32_t wPsr,wQt;
-	wPsr = __get_PSR();
-	__disable_excp_irq(); 
-	
 	csp_hwdiv_t * ptHwdivBase = (csp_hwdiv_t *)HWDIV_REG_BASE;
-	ptHwdivBase->CR = 0;
+#if HWDIV_MODE == HWDIV_MODE_SEQ_RETRY
+	uint32_t wSeq;
 	
-	ptHwdivBase->DIVIDEND = wDividend;
-	ptHwdivBase->DIVISOR = wDivisor;
-	wQt = ptHwdivBase->QUOTIENT;
+	do{
+		wSeq = s_wHwdivSeq;
+		csp_hwdiv_set_mode(ptHwdivBase, wCr);
+		csp_hwdiv_set_dividend(ptHwdivBase, wDividend);
+		csp_hwdiv_set_divisor(ptHwdivBase, wDivisor);
+		if(pwQt)
+			*pwQt = csp_hwdiv_get_quotient(ptHwdivBase);
+		if(pwRm)
+			*pwRm = csp_hwdiv_get_remain(ptHwdivBase);
+	}while(wSeq != s_wHwdivSeq);
+	s_wHwdivSeq = wSeq + 1;
+#else
+	uint32_t wPsr;
+	
+	wPsr = __get_PSR();
+	__disable_excp_irq(); 
+	LAT_CRIT_ENTER(LAT_CRIT_HWDIV);
+	csp_hwdiv_set_mode(ptHwdivBase, wCr);
+	csp_hwdiv_set_dividend(ptHwdivBase, wDividend);
+	csp_hwdiv_set_divisor(ptHwdivBase, wDivisor);
+	if(pwQt)
+		*pwQt = csp_hwdiv_get_quotient(ptHwdivBase);
+	if(pwRm)
+		*pwRm = csp_hwdiv_get_remain(ptHwdivBase);
+	LAT_CRIT_EXIT(LAT_CRIT_HWDIV);
 	__set_PSR(wPsr);
+#endif
+}
+
+//!!!This function is to replace the div function in stdio.h
+//!!!This function will be called AUTOMATICALLY when "/" is used.
+int __divsi3(int wDividend, int wDivisor)
+{
+	uint32_t wQt;
+	apt_hwdiv_calc(0, wDividend, wDivisor, &wQt, NULL);
 	return (wQt);
 }
 
@@ -37,16 +81,8 @@ int __divsi3(int wDividend, int wDivisor)
 //!!!This function will be called AUTOMATICALLY when "%" is used.
 int __modsi3(int wDividend, int wDivisor)
 {
-	uint32_t wPsr,wRm;
-	wPsr = __get_PSR();
-	__disable_excp_irq();  
-	csp_hwdiv_t * ptHwdivBase = (csp_hwdiv_t *)HWDIV_REG_BASE;
-	ptHwdivBase->CR = 0;
-	
-	ptHwdivBase->DIVIDEND = wDividend;
-	ptHwdivBase->DIVISOR = wDivisor;
-	wRm = ptHwdivBase->REMAIN;
-	__set_PSR(wPsr);
+	uint32_t wRm;
+	apt_hwdiv_calc(0, wDividend, wDivisor, NULL, &wRm);
 	return (wRm);
 }
 
@@ -54,16 +90,8 @@ int __modsi3(int wDividend, int wDivisor)
 //!!!This function will be called AUTOMATICALLY when "/" is used.
 unsigned int __udivsi3(unsigned int wDividend, unsigned int wDivisor)
 {
-	uint32_t wPsr,wQt;
-	wPsr = __get_PSR();
-	__disable_excp_irq(); 
-	csp_hwdiv_t * ptHwdivBase = (csp_hwdiv_t *)HWDIV_REG_BASE;
-	ptHwdivBase->CR = 1;
-	
-	ptHwdivBase->DIVIDEND = wDividend;
-	ptHwdivBase->DIVISOR = wDivisor;
-	wQt = ptHwdivBase->QUOTIENT;
-	__set_PSR(wPsr);
+	uint32_t wQt;
+	apt_hwdiv_calc(1, wDividend, wDivisor, &wQt, NULL);
 	return (wQt);
 }
 
@@ -71,15 +99,211 @@ unsigned int __udivsi3(unsigned int wDividend, unsigned int wDivisor)
 //!!!This function will be called AUTOMATICALLY when "%" is used.
 unsigned int __umodsi3(unsigned int wDividend, unsigned int wDivisor)
 {
-	uint32_t wPsr,wRm;
-	wPsr = __get_PSR();
-	__disable_excp_irq(); 
-	csp_hwdiv_t * ptHwdivBase = (csp_hwdiv_t *)HWDIV_REG_BASE;
-	ptHwdivBase->CR = 1;
-	
-	ptHwdivBase->DIVIDEND = wDividend;
-	ptHwdivBase->DIVISOR = wDivisor;
-	wRm = ptHwdivBase->REMAIN;
-	__set_PSR(wPsr);
+	uint32_t wRm;
+	apt_hwdiv_calc(1, wDividend, wDivisor, NULL, &wRm);
 	return (wRm);
-}
\ No newline at end of file
+}
+
+/** \brief unsigned divide, quotient and remainder by one divider access
+ * 
+ *  \param[in] wDiviend: dividend
+ *  \param[in] wDivisor: divisor
+ *  \return quotient and remainder
+ */
+hwdiv_urslt_t csi_hwdiv_unsigned_calc(uint32_t wDiviend, uint32_t wDivisor)
+{
+	hwdiv_urslt_t tRslt;
+	apt_hwdiv_calc(1, wDiviend, wDivisor, &tRslt.wQuot, &tRslt.wRem);
+	return tRslt;
+}
+
+/** \brief signed divide, quotient and remainder by one divider access
+ * 
+ *  \param[in] wDiviend: dividend
+ *  \param[in] wDivisor: divisor
+ *  \return quotient and remainder
+ */
+hwdiv_rslt_t csi_hwdiv_signed_calc(int wDiviend, int wDivisor)
+{
+	hwdiv_rslt_t tRslt;
+	apt_hwdiv_calc(0, wDiviend, wDivisor, (uint32_t *)&tRslt.wQuot, (uint32_t *)&tRslt.wRem);
+	return tRslt;
+}
+
+/** \brief 64/32 division with u1 < v(quotient fits 32 bits), normalized long division in
+ *         16 bit digits, each digit estimated by one 32/32 divider access(Hacker's Delight divlu)
+ * 
+ *  \param[in] u1: high word of dividend, u1 < v
+ *  \param[in] u0: low word of dividend
+ *  \param[in] v: divisor, v != 0
+ *  \param[out] pwRm: remainder
+ *  \return quotient
+ */
+static uint32_t apt_hwdiv_divlu(uint32_t u1, uint32_t u0, uint32_t v, uint32_t *pwRm)
+{
+	uint32_t un32, un21, un10, un1, un0, vn1, vn0, q1, q0, rhat;
+	uint8_t s = __builtin_clz(v);
+	
+	v <<= s;
+	vn1 = v >> 16;
+	vn0 = v & 0xffff;
+	un32 = s ? ((u1 << s) | (u0 >> (32 - s))) : u1;
+	un10 = u0 << s;
+	un1 = un10 >> 16;
+	un0 = un10 & 0xffff;
+	
+	apt_hwdiv_calc(1, un32, vn1, &q1, &rhat);
+	while(q1 >= 0x10000 || q1 * vn0 > ((rhat << 16) | un1))
+	{
+		q1--;
+		rhat += vn1;
+		if(rhat >= 0x10000)
+			break;
+	}
+	
+	un21 = (un32 << 16) + un1 - q1 * v;
+	apt_hwdiv_calc(1, un21, vn1, &q0, &rhat);
+	while(q0 >= 0x10000 || q0 * vn0 > ((rhat << 16) | un0))
+	{
+		q0--;
+		rhat += vn1;
+		if(rhat >= 0x10000)
+			break;
+	}
+	
+	*pwRm = ((un21 << 16) + un0 - q0 * v) >> s;
+	return (q1 << 16) + q0;
+}
+
+/** \brief unsigned 64 bit division by the 32 bit divider
+ *         64/32 needs two or three divider accesses, 64/64 normalizes to one 64/32 step
+ * 
+ *  \param[in] dwDividend: dividend
+ *  \param[in] dwDivisor: divisor
+ *  \param[out] pdwRm: remainder, NULL: not needed
+ *  \return quotient
+ */
+static uint64_t apt_hwdiv_udivmod64(uint64_t dwDividend, uint64_t dwDivisor, uint64_t *pdwRm)
+{
+	uint32_t wNh = (uint32_t)(dwDividend >> 32), wNl = (uint32_t)dwDividend;
+	uint32_t wDh = (uint32_t)(dwDivisor >> 32), wDl = (uint32_t)dwDivisor;
+	uint32_t wQh = 0, wQl, wRm;
+	uint64_t dwQt;
+	uint8_t s;
+	
+	if(wDh == 0)
+	{
+		if(wNh == 0 || wDl == 0)								//32/32, one divider access(x/0 as hardware)
+		{
+			apt_hwdiv_calc(1, wNl, wDl, &wQl, &wRm);
+		}
+		else
+		{
+			if(wNh >= wDl)										//high word first, remainder < divisor
+				apt_hwdiv_calc(1, wNh, wDl, &wQh, &wNh);
+			wQl = apt_hwdiv_divlu(wNh, wNl, wDl, &wRm);
+		}
+		if(pdwRm)
+			*pdwRm = wRm;
+		return ((uint64_t)wQh << 32) | wQl;
+	}
+	
+	if(wNh < wDh)												//divisor > dividend
+	{
+		if(pdwRm)
+			*pdwRm = dwDividend;
+		return 0;
+	}
+	
+	//divisor >= 2^32, quotient < 2^32: divide (n >> 1) by the top 32 bits of the normalized divisor,
+	//the estimate is the quotient or one too large
+	s = __builtin_clz(wDh);
+	dwQt = apt_hwdiv_divlu(wNh >> 1, (wNh << 31) | (wNl >> 1), (uint32_t)((dwDivisor << s) >> 32), &wRm);
+	dwQt = (dwQt << s) >> 31;
+	if(dwQt)
+		dwQt--;
+	if(dwDividend - dwQt * dwDivisor >= dwDivisor)
+		dwQt++;
+	if(pdwRm)
+		*pdwRm = dwDividend - dwQt * dwDivisor;
+	
+	return dwQt;
+}
+
+//!!!This function is to replace the 64 bit div function in libgcc
+//!!!This function will be called AUTOMATICALLY when "/" is used on 64 bit unsigned.
+unsigned long long __udivdi3(unsigned long long dwDividend, unsigned long long dwDivisor)
+{
+	return apt_hwdiv_udivmod64(dwDividend, dwDivisor, NULL);
+}
+
+//!!!This function is to replace the 64 bit mod function in libgcc
+//!!!This function will be called AUTOMATICALLY when "%" is used on 64 bit unsigned.
+unsigned long long __umoddi3(unsigned long long dwDividend, unsigned long long dwDivisor)
+{
+	uint64_t dwRm;
+	apt_hwdiv_udivmod64(dwDividend, dwDivisor, &dwRm);
+	return dwRm;
+}
+
+//!!!This function is to replace the 64 bit div function in libgcc
+//!!!This function will be called AUTOMATICALLY when "/" is used on 64 bit signed.
+long long __divdi3(long long dwDividend, long long dwDivisor)
+{
+	uint64_t dwQt = apt_hwdiv_udivmod64(dwDividend < 0 ? 0 - (uint64_t)dwDividend : (uint64_t)dwDividend, 
+										dwDivisor < 0 ? 0 - (uint64_t)dwDivisor : (uint64_t)dwDivisor, NULL);
+	return ((dwDividend < 0) != (dwDivisor < 0)) ? (long long)(0 - dwQt) : (long long)dwQt;
+}
+
+//!!!This function is to replace the 64 bit mod function in libgcc
+//!!!This function will be called AUTOMATICALLY when "%" is used on 64 bit signed.
+long long __moddi3(long long dwDividend, long long dwDivisor)
+{
+	uint64_t dwRm;
+	apt_hwdiv_udivmod64(dwDividend < 0 ? 0 - (uint64_t)dwDividend : (uint64_t)dwDividend, 
+						dwDivisor < 0 ? 0 - (uint64_t)dwDivisor : (uint64_t)dwDivisor, &dwRm);
+	return (dwDividend < 0) ? (long long)(0 - dwRm) : (long long)dwRm;
+}
+
+/** \brief precompute reciprocal of a divisor(round-up method), call at configuration time;
+ *         2^(32+l)/d is done by shift-subtract so no divider is used here either
+ * 
+ *  \param[out] ptRecip: pointer of reciprocal
+ *  \param[in] wDivisor: divisor, must not be 0
+ *  \return none
+ */
+void csi_hwdiv_recip_init(hwdiv_recip_t *ptRecip, uint32_t wDivisor)
+{
+	uint8_t i, byLog2 = 31 - __builtin_clz(wDivisor);
+	uint32_t wQt = 0, wRm = 1ul << byLog2, wCarry;
+	
+	ptRecip->wDivisor = wDivisor;
+	ptRecip->byShift = byLog2;
+	ptRecip->byAdd = 0;
+	ptRecip->wMul = 0;
+	
+	if((wDivisor & (wDivisor - 1)) == 0)						//power of two, shift only
+		return;
+	
+	for(i = 0; i < 32; i++)										//wQt = 2^(32+l) / d, wRm = remainder
+	{
+		wCarry = wRm >> 31;
+		wRm <<= 1;
+		wQt <<= 1;
+		if(wCarry || wRm >= wDivisor)
+		{
+			wRm -= wDivisor;
+			wQt |= 1;
+		}
+	}
+	
+	if((wDivisor - wRm) >= (1ul << byLog2))						//multiplier does not fit 32 bits, add fixup
+	{
+		wQt += wQt;
+		wCarry = wRm + wRm;
+		if(wCarry >= wDivisor || wCarry < wRm)
+			wQt += 1;
+		ptRecip->byAdd = 1;
+	}
+	ptRecip->wMul = wQt + 1;
+}
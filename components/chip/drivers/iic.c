@@ -21,6 +21,8 @@
 
 
 /* Private macro-----------------------------------------------------------*/
+#define IIC_FIFO_DEPTH		8			//tx/rx fifo deep
+#define IIC_ASYNC_TX_FL		2			//async master: TX_EMPTY when tx fifo <= 2 entries
 /* externs function--------------------------------------------------------*/
 /* externs variablesr------------------------------------------------------*/
 /* Private variablesr------------------------------------------------------*/
@@ -31,6 +33,13 @@ volatile uint8_t g_bySendIndex = 0;
 volatile uint8_t g_byWriteIndex = 0;
 volatile uint32_t g_wIicSlaveWriteAddress;
 
+static csi_iic_xfer_t *s_ptIicXferQueue[IIC_XFER_QUEUE_LEN];	//async master transaction queue
+static volatile uint8_t s_byIicXferIn = 0;
+static volatile uint8_t s_byIicXferOut = 0;
+static uint16_t s_hwIicCmdIdx;			//commands(register + data) pushed of current transaction
+static uint16_t s_hwIicRxIdx;			//data received of current transaction
+static uint8_t s_byIicXferErr;			//abort/scl stuck of current transaction
+
 
 /** \brief deinit iic 
  * 
@@ -647,5 +656,222 @@ void csi_iic_spklen_set(csp_i2c_t *ptIicBase, uint8_t bySpklen)
 	csp_i2c_set_spklen(ptIicBase,bySpklen);
 }
 
+//-----------------------------------------------------------------------------------------------------------
+//async master
+//-----------------------------------------------------------------------------------------------------------
 
+/** \brief  push register/data commands of current transaction while tx fifo not full; read commands
+ *          are limited to the rx fifo room, so rx fifo never overflows
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \param[in] ptXfer: current transaction
+ *  \return none
+ */ 
+static void apt_iic_xfer_fill(csp_i2c_t *ptIicBase, csi_iic_xfer_t *ptXfer)
+{
+	uint16_t hwTotal = ptXfer->byRegLen + ptXfer->hwLen;
+	uint16_t hwIdx, hwCmd;
+	bool bRxWait = false;
+	
+	while((s_hwIicCmdIdx < hwTotal) && (csp_i2c_get_status(ptIicBase) & I2C_TFNF))
+	{
+		hwIdx = s_hwIicCmdIdx;
+		if(hwIdx < ptXfer->byRegLen)
+			hwCmd = I2C_CMD_WRITE | (uint8_t)(ptXfer->wReg >> ((ptXfer->byRegLen - 1 - hwIdx) << 3));
+		else
+		{
+			hwIdx -= ptXfer->byRegLen;
+			if(ptXfer->byRead)
+			{
+				if((hwIdx - s_hwIicRxIdx) >= IIC_FIFO_DEPTH)				//rx fifo room
+				{
+					bRxWait = true;
+					break;
+				}
+				hwCmd = I2C_CMD_READ;
+				if((hwIdx == 0) && ptXfer->byRegLen)
+					hwCmd |= I2C_CMD_RESTART1;
+			}
+			else
+				hwCmd = I2C_CMD_WRITE | ptXfer->pbyBuf[hwIdx];
+		}
+		if(s_hwIicCmdIdx == hwTotal - 1)
+			hwCmd |= I2C_CMD_STOP;
+		csp_i2c_set_data_cmd(ptIicBase, hwCmd);
+		s_hwIicCmdIdx++;
+	}
+	
+	//all pushed or waiting rx room(RX_FULL continues): no TX_EMPTY, it is level triggered
+	if((s_hwIicCmdIdx >= hwTotal) || bRxWait)
+		csp_i2c_imcr_disable(ptIicBase, I2C_TX_EMPTY_INT);
+	else
+		csp_i2c_imcr_enable(ptIicBase, I2C_TX_EMPTY_INT);
+}
 
+/** \brief  read rx fifo of current transaction and set rx threshold for the rest
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \param[in] ptXfer: current transaction
+ *  \return none
+ */ 
+static void apt_iic_xfer_drain(csp_i2c_t *ptIicBase, csi_iic_xfer_t *ptXfer)
+{
+	uint16_t hwRemain;
+	
+	while((s_hwIicRxIdx < ptXfer->hwLen) && (csp_i2c_get_status(ptIicBase) & I2C_RFNE))
+		ptXfer->pbyBuf[s_hwIicRxIdx++] = csp_i2c_get_data(ptIicBase);
+	
+	hwRemain = ptXfer->hwLen - s_hwIicRxIdx;
+	if(hwRemain)
+		csp_i2c_set_rx_flsel(ptIicBase, (hwRemain > IIC_FIFO_DEPTH ? IIC_FIFO_DEPTH : hwRemain) - 1);
+}
+
+/** \brief  start the transaction at queue head
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \return none
+ */ 
+static void apt_iic_xfer_start(csp_i2c_t *ptIicBase)
+{
+	csi_iic_xfer_t *ptXfer = s_ptIicXferQueue[s_byIicXferOut & (IIC_XFER_QUEUE_LEN - 1)];
+	
+	s_hwIicCmdIdx = 0;
+	s_hwIicRxIdx = 0;
+	s_byIicXferErr = 0;
+	
+	csi_iic_disable(ptIicBase);
+	csp_i2c_set_taddr(ptIicBase, ptXfer->hwDevAddr >> 1);
+	csi_iic_enable(ptIicBase);
+	
+	csp_i2c_set_tx_flsel(ptIicBase, IIC_ASYNC_TX_FL);
+	csp_i2c_clr_all_isr(ptIicBase);
+	csp_i2c_set_imcr(ptIicBase, I2C_STOP_DET_INT | I2C_TX_ABRT_INT | I2C_SCL_SLOW_INT);
+	if(ptXfer->byRead)
+	{
+		apt_iic_xfer_drain(ptIicBase, ptXfer);				//rx threshold
+		csp_i2c_imcr_enable(ptIicBase, I2C_RX_FULL_INT);
+	}
+	apt_iic_xfer_fill(ptIicBase, ptXfer);
+}
+
+/** \brief  finish current transaction, start next one then call back
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \param[in] ptXfer: current transaction
+ *  \return none
+ */ 
+static void apt_iic_xfer_done(csp_i2c_t *ptIicBase, csi_iic_xfer_t *ptXfer)
+{
+	csi_iic_event_e eEvent;
+	
+	if(s_byIicXferErr || (ptXfer->byRead && (s_hwIicRxIdx < ptXfer->hwLen)))
+		eEvent = IIC_EVENT_ERROR;
+	else
+		eEvent = ptXfer->byRead ? IIC_EVENT_RECEIVE_COMPLETE : IIC_EVENT_SEND_COMPLETE;
+	
+	csp_i2c_set_imcr(ptIicBase, 0);
+	s_byIicXferOut++;
+	if(s_byIicXferIn != s_byIicXferOut)						//back-to-back, bus is not left idle for the callback
+		apt_iic_xfer_start(ptIicBase);
+	
+	if(ptXfer->callback)
+		ptXfer->callback(ptXfer, eEvent);
+}
+
+/** \brief  queue an async master transaction; it is started at once when the bus is idle, 
+ *          the following ones are started from the interrupt. Init master with hwInt = IIC_INTSRC_NONE,
+ *          the interrupt mask is driven by the async transfer.
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \param[in] ptXfer: transaction, must stay valid until its callback
+ *  \return error code \ref csi_error_t, CSI_BUSY: queue full
+ */ 
+csi_error_t csi_iic_master_xfer_async(csp_i2c_t *ptIicBase, csi_iic_xfer_t *ptXfer)
+{
+	uint32_t wIrq;
+	
+	if((ptIicBase == NULL) || (ptXfer == NULL) || (ptXfer->byRegLen > 4) || 
+		((ptXfer->hwLen == 0) && (ptXfer->byRead || (ptXfer->byRegLen == 0))) ||
+		(ptXfer->hwLen && (ptXfer->pbyBuf == NULL)))
+		return CSI_ERROR;
+	
+	wIrq = csi_irq_save();
+	if((uint8_t)(s_byIicXferIn - s_byIicXferOut) >= IIC_XFER_QUEUE_LEN)
+	{
+		csi_irq_restore(wIrq);
+		return CSI_BUSY;
+	}
+	s_ptIicXferQueue[s_byIicXferIn & (IIC_XFER_QUEUE_LEN - 1)] = ptXfer;
+	s_byIicXferIn++;
+	if((uint8_t)(s_byIicXferIn - s_byIicXferOut) == 1)		//bus idle
+		apt_iic_xfer_start(ptIicBase);
+	csi_irq_restore(wIrq);
+	
+	return CSI_OK;
+}
+
+/** \brief  number of async master transactions queued or in progress
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \return transaction number
+ */ 
+uint8_t csi_iic_master_xfer_pending(csp_i2c_t *ptIicBase)
+{
+	return (uint8_t)(s_byIicXferIn - s_byIicXferOut);
+}
+
+/** \brief  async master interrupt process(to be called in IIC IRQhandler)
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \return true: handled by async master, false: no async transaction
+ */ 
+bool csi_iic_master_async_irq(csp_i2c_t *ptIicBase)
+{
+	csi_iic_xfer_t *ptXfer;
+	uint16_t hwIsr;
+	
+	if(s_byIicXferIn == s_byIicXferOut)
+		return false;
+	
+	ptXfer = s_ptIicXferQueue[s_byIicXferOut & (IIC_XFER_QUEUE_LEN - 1)];
+	hwIsr = csp_i2c_get_isr(ptIicBase);
+	
+	if(hwIsr & I2C_SCL_SLOW_INT)								//SCLK锁死, 不会有STOP
+	{
+		csi_iic_disable(ptIicBase);
+		csi_iic_enable(ptIicBase);
+		csp_i2c_clr_isr(ptIicBase, I2C_SCL_SLOW_INT);
+		s_byIicXferErr = 1;
+		apt_iic_xfer_done(ptIicBase, ptXfer);
+		return true;
+	}
+	
+	if(hwIsr & I2C_TX_ABRT_INT)									//nack/arbitration lost, fifo flushed, STOP follows
+	{
+		csp_i2c_get_tx_abrt(ptIicBase);
+		csp_i2c_clr_isr(ptIicBase, I2C_TX_ABRT_INT);
+		csp_i2c_imcr_disable(ptIicBase, I2C_TX_EMPTY_INT | I2C_RX_FULL_INT);
+		s_hwIicCmdIdx = ptXfer->byRegLen + ptXfer->hwLen;
+		s_byIicXferErr = 1;
+	}
+	
+	if(hwIsr & I2C_RX_FULL_INT)
+	{
+		apt_iic_xfer_drain(ptIicBase, ptXfer);
+		if(s_hwIicRxIdx >= ptXfer->hwLen)
+			csp_i2c_imcr_disable(ptIicBase, I2C_RX_FULL_INT);
+		apt_iic_xfer_fill(ptIicBase, ptXfer);					//read commands waiting rx room
+	}
+	else if(hwIsr & I2C_TX_EMPTY_INT)
+		apt_iic_xfer_fill(ptIicBase, ptXfer);
+	
+	if(hwIsr & I2C_STOP_DET_INT)
+	{
+		csp_i2c_clr_isr(ptIicBase, I2C_STOP_DET_INT);
+		if(ptXfer->byRead)
+			apt_iic_xfer_drain(ptIicBase, ptXfer);
+		apt_iic_xfer_done(ptIicBase, ptXfer);
+	}
+	
+	return true;
+}
@@ -0,0 +1,329 @@
+/***********************************************************************//**
+ * \file  lat_bench.c
+ * \brief  interrupt latency/jitter harness core: log2 histograms, masked section
+ *         tracker, text report; no register access, so the same file builds on
+ *         the host(demo/script/lat_host.c) and on the chip(latency_demo.c)
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <stddef.h>
+#include <drv/lat_bench.h>
+
+/* Private macro------------------------------------------------------*/
+/* externs function---------------------------------------------------*/
+/* externs variablesr-------------------------------------------------*/
+/* Private variablesr-------------------------------------------------*/
+static lat_putc_t s_fnLatPutc = NULL;
+static const char *s_pLatUnit = "";
+
+#ifdef CONFIG_LAT_CRIT_HOOK
+static lat_crit_t s_tLatCrit[LAT_CRIT_NUM];
+
+static const char * const s_pLatCritName[LAT_CRIT_NUM] = {
+	"hwdiv", "stimer_idle", "spi_tx_isr", "user0", "user1", "user2", "user3"
+};
+#endif
+
+//decimal output without division, the report may run on the hwdiv hook
+static const uint32_t s_wLatPow10[] = {
+	1000000000ul, 100000000ul, 10000000ul, 1000000ul, 100000ul, 10000ul, 1000ul, 100ul, 10ul, 1ul
+};
+
+/** \brief floor(log2(wVal)), wVal > 0, no clz instruction on ck802
+ */
+static uint8_t apt_lat_log2(uint32_t wVal)
+{
+	uint8_t byRet = 0;
+
+	if(wVal >> 16) { wVal >>= 16; byRet += 16; }
+	if(wVal >> 8)  { wVal >>= 8;  byRet += 8; }
+	if(wVal >> 4)  { wVal >>= 4;  byRet += 4; }
+	if(wVal >> 2)  { wVal >>= 2;  byRet += 2; }
+	if(wVal >> 1)  { byRet += 1; }
+
+	return byRet;
+}
+
+static void apt_lat_puts(const char *pStr)
+{
+	while(*pStr)
+		s_fnLatPutc(*pStr++);
+}
+
+static void apt_lat_putu(uint32_t wVal)
+{
+	uint8_t i, byDigit, bySeen = 0;
+
+	for(i = 0; i < sizeof(s_wLatPow10) / sizeof(s_wLatPow10[0]); i++)
+	{
+		byDigit = 0;
+		while(wVal >= s_wLatPow10[i])
+		{
+			wVal -= s_wLatPow10[i];
+			byDigit++;
+		}
+		if(byDigit || bySeen || s_wLatPow10[i] == 1)
+		{
+			s_fnLatPutc((char)('0' + byDigit));
+			bySeen = 1;
+		}
+	}
+}
+
+/** \brief " key=value"
+ */
+static void apt_lat_field(const char *pKey, uint32_t wVal)
+{
+	s_fnLatPutc(' ');
+	apt_lat_puts(pKey);
+	s_fnLatPutc('=');
+	apt_lat_putu(wVal);
+}
+
+/** \brief clear a histogram
+ *
+ *  \param[in] ptHist: pointer of histogram
+ *  \return none
+ */
+void lat_hist_reset(lat_hist_t *ptHist)
+{
+	uint8_t i;
+
+	ptHist->wCount = 0;
+	ptHist->wMin = 0;
+	ptHist->wMax = 0;
+	for(i = 0; i < LAT_HIST_BINS; i++)
+		ptHist->wHist[i] = 0;
+}
+
+/** \brief add one sample; no locking, the caller adds from one context only
+ *         (e.g. the timer isr) and stops it before reporting
+ *
+ *  \param[in] ptHist: pointer of histogram
+ *  \param[in] wVal: latency
+ *  \return none
+ */
+void lat_hist_add(lat_hist_t *ptHist, uint32_t wVal)
+{
+	uint8_t byBin = (wVal >> 1) ? apt_lat_log2(wVal) : 0;
+
+	if(byBin >= LAT_HIST_BINS)
+		byBin = LAT_HIST_BINS - 1;
+
+	if(ptHist->wCount == 0 || wVal < ptHist->wMin)
+		ptHist->wMin = wVal;
+	if(wVal > ptHist->wMax)
+		ptHist->wMax = wVal;
+	ptHist->wCount++;
+	ptHist->wHist[byBin]++;
+}
+
+/** \brief percentile, upper bound of the bin holding it, clipped to min/max
+ *
+ *  \param[in] ptHist: pointer of histogram
+ *  \param[in] byPct: percent, 1 ~ 100
+ *  \return latency, 0: no samples
+ */
+uint32_t lat_hist_percentile(const lat_hist_t *ptHist, uint8_t byPct)
+{
+	uint64_t dwNeed = (uint64_t)ptHist->wCount * byPct;
+	uint64_t dwSum = 0;
+	uint32_t wVal = ptHist->wMax;
+	uint8_t i;
+
+	if(ptHist->wCount == 0)
+		return 0;
+
+	for(i = 0; i < LAT_HIST_BINS - 1; i++)
+	{
+		dwSum += ptHist->wHist[i];
+		if(dwSum * 100 >= dwNeed)
+		{
+			wVal = (2ul << i) - 1;
+			break;
+		}
+	}
+
+	if(wVal > ptHist->wMax)
+		wVal = ptHist->wMax;
+	if(wVal < ptHist->wMin)
+		wVal = ptHist->wMin;
+
+	return wVal;
+}
+
+/** \brief set report output and unit string
+ *
+ *  \param[in] putc: character output
+ *  \param[in] pUnit: unit name, e.g. "cyc" or "ns"
+ *  \return none
+ */
+void lat_report_init(lat_putc_t putc, const char *pUnit)
+{
+	s_fnLatPutc = putc;
+	s_pLatUnit = pUnit ? pUnit : "";
+}
+
+/** \brief print one histogram, summary line then one line per used bin
+ *
+ *  \param[in] pName: load name
+ *  \param[in] ptHist: pointer of histogram
+ *  \param[in] wLimit: max allowed latency, 0: no check
+ *  \return 0: pass; -1: max over limit or no samples
+ */
+int lat_report(const char *pName, const lat_hist_t *ptHist, uint32_t wLimit)
+{
+	int iRet = 0;
+	uint8_t i;
+
+	if(ptHist->wCount == 0 || (wLimit && ptHist->wMax > wLimit))
+		iRet = -1;
+
+	if(s_fnLatPutc == NULL)
+		return iRet;
+
+	apt_lat_puts("LAT ");
+	apt_lat_puts(pName);
+	apt_lat_field("n", ptHist->wCount);
+	apt_lat_field("min", ptHist->wMin);
+	apt_lat_field("p50", lat_hist_percentile(ptHist, 50));
+	apt_lat_field("p99", lat_hist_percentile(ptHist, 99));
+	apt_lat_field("max", ptHist->wMax);
+	apt_lat_field("jitter", ptHist->wMax - ptHist->wMin);
+	s_fnLatPutc(' ');
+	apt_lat_puts(s_pLatUnit);
+	apt_lat_puts(iRet ? " FAIL\n" : " PASS\n");
+
+	for(i = 0; i < LAT_HIST_BINS; i++)
+	{
+		if(ptHist->wHist[i] == 0)
+			continue;
+		apt_lat_puts("  [");
+		apt_lat_putu(i ? (1ul << i) : 0);
+		apt_lat_puts(", ");
+		if(i == LAT_HIST_BINS - 1)
+			apt_lat_puts("inf");
+		else
+			apt_lat_putu((2ul << i) - 1);
+		apt_lat_puts("] ");
+		apt_lat_putu(ptHist->wHist[i]);
+		s_fnLatPutc('\n');
+	}
+
+	return iRet;
+}
+
+#ifdef CONFIG_LAT_CRIT_HOOK
+
+/** \brief clear all section sites
+ *
+ *  \param[in] none
+ *  \return none
+ */
+void lat_crit_reset(void)
+{
+	uint8_t *pbyTab = (uint8_t *)s_tLatCrit;
+	uint32_t i, wIrq;
+
+	wIrq = lat_port_irq_save();
+	for(i = 0; i < sizeof(s_tLatCrit); i++)
+		pbyTab[i] = 0;
+	lat_port_irq_restore(wIrq);
+}
+
+/** \brief masked section begins; the site state is updated with interrupts masked,
+ *         so a LAT_CRIT_USER site entered from both main loop and isr is not torn
+ *
+ *  \param[in] bySite: \ref lat_crit_site_e
+ *  \return none
+ */
+void lat_crit_enter(uint8_t bySite)
+{
+	lat_crit_t *ptCrit;
+	uint32_t wIrq;
+
+	if(bySite >= LAT_CRIT_NUM)
+		return;
+
+	ptCrit = &s_tLatCrit[bySite];
+	wIrq = lat_port_irq_save();
+	if(ptCrit->byDepth++ == 0)
+		ptCrit->wStart = lat_port_cycles();
+	lat_port_irq_restore(wIrq);
+}
+
+/** \brief masked section ends, the outermost exit records the length
+ *
+ *  \param[in] bySite: \ref lat_crit_site_e
+ *  \return none
+ */
+void lat_crit_exit(uint8_t bySite)
+{
+	lat_crit_t *ptCrit;
+	uint32_t wLen, wIrq;
+
+	if(bySite >= LAT_CRIT_NUM)
+		return;
+
+	ptCrit = &s_tLatCrit[bySite];
+	wIrq = lat_port_irq_save();
+	if(ptCrit->byDepth && --ptCrit->byDepth == 0)
+	{
+		wLen = lat_port_cycles() - ptCrit->wStart;
+		if(wLen > ptCrit->wMax)
+			ptCrit->wMax = wLen;
+		ptCrit->wCount++;
+	}
+	lat_port_irq_restore(wIrq);
+}
+
+/** \brief get statistics of a site
+ *
+ *  \param[in] bySite: \ref lat_crit_site_e
+ *  \return pointer of statistics, NULL: site out of range
+ */
+const lat_crit_t *lat_crit_get(uint8_t bySite)
+{
+	if(bySite >= LAT_CRIT_NUM)
+		return NULL;
+
+	return &s_tLatCrit[bySite];
+}
+
+/** \brief print used sites, longest masked section of each
+ *
+ *  \param[in] wLimit: max allowed section length, 0: no check
+ *  \return 0: pass; -1: a section over limit
+ */
+int lat_crit_report(uint32_t wLimit)
+{
+	int iRet = 0;
+	uint8_t i, byFail;
+
+	for(i = 0; i < LAT_CRIT_NUM; i++)
+	{
+		if(s_tLatCrit[i].wCount == 0)
+			continue;
+
+		byFail = (wLimit && s_tLatCrit[i].wMax > wLimit);
+		if(byFail)
+			iRet = -1;
+		if(s_fnLatPutc == NULL)
+			continue;
+
+		apt_lat_puts("CRIT ");
+		apt_lat_puts(s_pLatCritName[i]);
+		apt_lat_field("n", s_tLatCrit[i].wCount);
+		apt_lat_field("max", s_tLatCrit[i].wMax);
+		s_fnLatPutc(' ');
+		apt_lat_puts(s_pLatUnit);
+		apt_lat_puts(byFail ? " FAIL\n" : " PASS\n");
+	}
+
+	return iRet;
+}
+
+#endif
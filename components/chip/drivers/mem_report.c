@@ -0,0 +1,174 @@
+/***********************************************************************//**
+ * \file  mem_report.c
+ * \brief  stack/heap headroom telemetry core: painted stack high-water mark,
+ *         heap low-water mark, collision watch; no register access, so the same
+ *         file builds on the host(demo/script/mem_host.c) and on the chip
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <stddef.h>
+#include <drv/mem_report.h>
+
+/* Private macro------------------------------------------------------*/
+/* externs function---------------------------------------------------*/
+/* externs variablesr-------------------------------------------------*/
+/* Private variablesr-------------------------------------------------*/
+static const csi_mem_map_t *s_ptMemMap = NULL;
+
+static uint32_t *s_pwMemLine = NULL;		//stack alarm line, NULL: stack watch off
+static uint32_t	s_wMemStackMargin = 0;
+static uint32_t	s_wMemHeapMargin = 0;
+static csi_mem_alarm_t s_fnMemAlarm = NULL;
+static volatile uint8_t s_byMemAlarm = 0;
+
+/** \brief lowest free heap of the map, MEM_UNKNOWN if not tracked
+ */
+static uint32_t apt_mem_heap_minfree(const csi_mem_map_t *ptMap)
+{
+	int iFree;
+
+	if(ptMap->pfnHeapMinFree == NULL)
+		return MEM_UNKNOWN;
+
+	iFree = ptMap->pfnHeapMinFree();
+	return (iFree < 0) ? MEM_UNKNOWN : (uint32_t)iFree;
+}
+
+/** \brief latch alarm sources, the callback sees each source once
+ */
+static void apt_mem_alarm(uint8_t byWhat, uint32_t wLeft)
+{
+	byWhat &= ~s_byMemAlarm;
+	if(byWhat)
+	{
+		s_byMemAlarm |= byWhat;
+		if(s_fnMemAlarm)
+			s_fnMemAlarm(byWhat, wLeft);
+	}
+}
+
+/** \brief paint [pwFrom, pwTo) with MEM_PAINT_WORD
+ *
+ *  \param[in] pwFrom: first word
+ *  \param[in] pwTo: end, not painted
+ *  \return none
+ */
+void csi_mem_paint(uint32_t *pwFrom, uint32_t *pwTo)
+{
+	while(pwFrom < pwTo)
+		*pwFrom++ = MEM_PAINT_WORD;
+}
+
+/** \brief set the memory map of csi_mem_report and the watch
+ *
+ *  \param[in] ptMap: pointer of memory map, must stay valid
+ *  \return none
+ */
+void csi_mem_map_init(const csi_mem_map_t *ptMap)
+{
+	s_ptMemMap = ptMap;
+	csi_mem_watch_init(s_wMemStackMargin, s_wMemHeapMargin, s_fnMemAlarm);	//line follows the map
+}
+
+/** \brief take a headroom snapshot, the painted stack is scanned from the limit
+ *         up to the first word in use(a word holding the pattern by chance only
+ *         lowers the mark by one word)
+ *
+ *  \param[out] ptRep: report
+ *  \return 0: ok, -1: no memory map
+ */
+int csi_mem_report(csi_mem_report_t *ptRep)
+{
+	const csi_mem_map_t *ptMap = s_ptMemMap;
+	uint32_t *pwWord;
+
+	if(ptMap == NULL)
+		return -1;
+
+	for(pwWord = ptMap->pwStackLimit; pwWord < ptMap->pwStackTop; pwWord++)
+	{
+		if(*pwWord != MEM_PAINT_WORD)
+			break;
+	}
+
+	ptRep->wStackSize   = (uint32_t)(ptMap->pwStackTop - ptMap->pwStackLimit) * 4;
+	ptRep->wStackPeak   = (uint32_t)(ptMap->pwStackTop - pwWord) * 4;
+	ptRep->wGap         = ptRep->wStackSize - ptRep->wStackPeak;
+	ptRep->wHeapSize    = (uint32_t)(ptMap->pwHeapEnd - ptMap->pwHeapStart) * 4;
+	ptRep->wHeapMinFree = apt_mem_heap_minfree(ptMap);
+
+	return 0;
+}
+
+/** \brief arm the collision watch, clears latched alarms
+ *
+ *  \param[in] wStackMargin: bytes above the stack limit, 0: stack watch off
+ *  \param[in] wHeapMargin: bytes of free heap, 0: heap watch off
+ *  \param[in] fnAlarm: alarm callback, NULL: no callback
+ *  \return none
+ */
+void csi_mem_watch_init(uint32_t wStackMargin, uint32_t wHeapMargin, csi_mem_alarm_t fnAlarm)
+{
+	const csi_mem_map_t *ptMap = s_ptMemMap;
+	uint32_t *pwLine = NULL;
+
+	s_pwMemLine = NULL;							//the tick may run in between
+	s_wMemStackMargin = wStackMargin;
+	s_wMemHeapMargin = wHeapMargin;
+	s_fnMemAlarm = fnAlarm;
+	s_byMemAlarm = 0;
+
+	if(ptMap && wStackMargin)
+	{
+		pwLine = ptMap->pwStackLimit + (wStackMargin + 3) / 4;
+		if(pwLine + MEM_WATCH_PROBE > ptMap->pwStackTop)
+			pwLine = NULL;						//margin beyond the stack
+	}
+	s_pwMemLine = pwLine;
+}
+
+/** \brief periodic check without scanning: MEM_WATCH_PROBE painted words at the
+ *         alarm line(a frame may skip one word, not several) and the lowest stack
+ *         word; called from the coret handler when MEM_WATCH_EN=1
+ *
+ *  \return alarm sources latched so far(MEM_ALARM_xxx)
+ */
+uint8_t csi_mem_watch_tick(void)
+{
+	const csi_mem_map_t *ptMap = s_ptMemMap;
+	uint32_t *pwLine = s_pwMemLine;
+	uint32_t wFree;
+	uint8_t i;
+
+	if(ptMap == NULL)
+		return s_byMemAlarm;
+
+	if(pwLine)
+	{
+		if(*ptMap->pwStackLimit != MEM_PAINT_WORD)
+			apt_mem_alarm(MEM_ALARM_STACK | MEM_ALARM_CRASH, 0);
+		else
+		{
+			for(i = 0; i < MEM_WATCH_PROBE; i++)
+			{
+				if(pwLine[i] != MEM_PAINT_WORD)
+				{
+					apt_mem_alarm(MEM_ALARM_STACK, s_wMemStackMargin);
+					break;
+				}
+			}
+		}
+	}
+
+	if(s_wMemHeapMargin)
+	{
+		wFree = apt_mem_heap_minfree(ptMap);
+		if(wFree != MEM_UNKNOWN && wFree < s_wMemHeapMargin)
+			apt_mem_alarm(MEM_ALARM_HEAP, wFree);
+	}
+
+	return s_byMemAlarm;
+}
@@ -0,0 +1,214 @@
+/***********************************************************************//**
+ * \file  prof.c
+ * \brief  cycle profiler, PROF_BEGIN/PROF_END read coret(counts down), a probe
+ *         measures up to one tick period; statistics in a static table
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <sys_clk.h>
+#include <drv/irq.h>
+#include <drv/prof.h>
+
+#ifdef CONFIG_PROF
+
+/* Private macro------------------------------------------------------*/
+#define PROF_DUMP_MAGIC0		'P'
+#define PROF_DUMP_MAGIC1		'F'
+#define PROF_DUMP_VER			1
+
+/* externs function---------------------------------------------------*/
+/* externs variablesr-------------------------------------------------*/
+/* Private variablesr-------------------------------------------------*/
+static csi_prof_probe_t s_tProfProbe[PROF_ID_NUM];
+static uint32_t s_wProfOverhead = 0;					//cycles of an empty PROF_BEGIN/PROF_END
+
+//dump checksum, fletcher-16
+static uint16_t s_hwProfSum1, s_hwProfSum2;
+
+
+/** \brief floor(log2(wVal)), wVal > 0, no clz instruction on ck802
+ */
+static uint8_t apt_prof_log2(uint32_t wVal)
+{
+	uint8_t byRet = 0;
+
+	if(wVal >> 16) { wVal >>= 16; byRet += 16; }
+	if(wVal >> 8)  { wVal >>= 8;  byRet += 8; }
+	if(wVal >> 4)  { wVal >>= 4;  byRet += 4; }
+	if(wVal >> 2)  { wVal >>= 2;  byRet += 2; }
+	if(wVal >> 1)  { byRet += 1; }
+
+	return byRet;
+}
+
+/** \brief coret cycles since wStart, at most one wrap
+ */
+static inline uint32_t apt_prof_cycles(uint32_t wStart)
+{
+	uint32_t wEnd = csi_coret_get_value();
+
+	if(wStart >= wEnd)
+		return wStart - wEnd;
+	else
+		return wStart + csi_coret_get_load() + 1U - wEnd;
+}
+
+/** \brief clear all probes and calibrate the PROF_BEGIN/PROF_END overhead
+ *
+ *  \param[in] none
+ *  \return none
+ */
+void csi_prof_init(void)
+{
+	uint32_t i, wCyc, wMin = 0xffffffff;
+	uint8_t *pbyTab = (uint8_t *)s_tProfProbe;
+
+	for(i = 0; i < sizeof(s_tProfProbe); i++)
+		pbyTab[i] = 0;
+
+	//same path as PROF_END, minimum of a few runs
+	s_wProfOverhead = 0;
+	for(i = 0; i < 8; i++)
+	{
+		csi_prof_record(PROF_ID_USER, csi_coret_get_value());
+		wCyc = s_tProfProbe[PROF_ID_USER].wMin;
+		if(wCyc < wMin)
+			wMin = wCyc;
+	}
+	s_wProfOverhead = wMin;
+
+	pbyTab = (uint8_t *)&s_tProfProbe[PROF_ID_USER];
+	for(i = 0; i < sizeof(csi_prof_probe_t); i++)
+		pbyTab[i] = 0;
+}
+
+/** \brief record one measurement, called by PROF_END; the probe is updated with
+ *         interrupts disabled, so one id may be used in main loop and isr
+ *
+ *  \param[in] eId: probe id
+ *  \param[in] wStart: coret value at PROF_BEGIN
+ *  \return none
+ */
+void csi_prof_record(csi_prof_id_e eId, uint32_t wStart)
+{
+	uint32_t wCyc = apt_prof_cycles(wStart);
+	uint32_t wIrq;
+	uint8_t byBin;
+	csi_prof_probe_t *ptProbe;
+
+	if(eId >= PROF_ID_NUM)
+		return;
+
+	wCyc = (wCyc > s_wProfOverhead) ? (wCyc - s_wProfOverhead) : 0;
+
+	byBin = (wCyc >> (PROF_HIST_SHIFT + 1)) ? (apt_prof_log2(wCyc) - PROF_HIST_SHIFT) : 0;
+	if(byBin >= PROF_HIST_BINS)
+		byBin = PROF_HIST_BINS - 1;
+
+	ptProbe = &s_tProfProbe[eId];
+	wIrq = csi_irq_save();
+	if(ptProbe->wCount == 0 || wCyc < ptProbe->wMin)
+		ptProbe->wMin = wCyc;
+	if(wCyc > ptProbe->wMax)
+		ptProbe->wMax = wCyc;
+	ptProbe->wCount++;
+	if(ptProbe->hwHist[byBin] != 0xffff)
+		ptProbe->hwHist[byBin]++;
+	csi_irq_restore(wIrq);
+}
+
+/** \brief get statistics of a probe
+ *
+ *  \param[in] eId: probe id
+ *  \return pointer of statistics, NULL: id out of range
+ */
+const csi_prof_probe_t *csi_prof_get(csi_prof_id_e eId)
+{
+	if(eId >= PROF_ID_NUM)
+		return NULL;
+
+	return &s_tProfProbe[eId];
+}
+
+/** \brief send little endian value and add it to the checksum
+ */
+static void apt_prof_put(csp_uart_t *ptUartBase, uint32_t wVal, uint8_t byLen)
+{
+	uint8_t byData;
+
+	while(byLen--)
+	{
+		byData = (uint8_t)wVal;
+		wVal >>= 8;
+		s_hwProfSum1 += byData;
+		if(s_hwProfSum1 >= 255)
+			s_hwProfSum1 -= 255;
+		s_hwProfSum2 += s_hwProfSum1;
+		if(s_hwProfSum2 >= 255)
+			s_hwProfSum2 -= 255;
+		csi_uart_putc(ptUartBase, byData);
+	}
+}
+
+/** \brief dump all used probes in binary, blocking, decode with demo/script/prof_decode.py
+ *         header: 'P' 'F' ver bins shift first_user_id records 0 coret_hz(4) overhead(4)
+ *         record: id count(4) min(4) max(4) hist(2 * bins)
+ *         trailer: fletcher-16 of all bytes before(sum1, sum2), all values little endian
+ *
+ *  \param[in] ptUartBase: uart to send, e.g. the console uart
+ *  \return bytes sent
+ */
+uint32_t csi_prof_dump(csp_uart_t *ptUartBase)
+{
+	csi_prof_probe_t tProbe;
+	uint32_t wIrq, wBytes = 16;
+	uint8_t i, j, bySum2, byNum = 0;
+
+	for(i = 0; i < PROF_ID_NUM; i++)
+	{
+		if(s_tProfProbe[i].wCount)
+			byNum++;
+	}
+
+	s_hwProfSum1 = 0;
+	s_hwProfSum2 = 0;
+	apt_prof_put(ptUartBase, PROF_DUMP_MAGIC0, 1);
+	apt_prof_put(ptUartBase, PROF_DUMP_MAGIC1, 1);
+	apt_prof_put(ptUartBase, PROF_DUMP_VER, 1);
+	apt_prof_put(ptUartBase, PROF_HIST_BINS, 1);
+	apt_prof_put(ptUartBase, PROF_HIST_SHIFT, 1);
+	apt_prof_put(ptUartBase, PROF_ID_USER, 1);
+	apt_prof_put(ptUartBase, byNum, 1);
+	apt_prof_put(ptUartBase, 0, 1);
+	apt_prof_put(ptUartBase, soc_get_coret_freq(), 4);
+	apt_prof_put(ptUartBase, s_wProfOverhead, 4);
+
+	for(i = 0; i < PROF_ID_NUM && byNum; i++)
+	{
+		wIrq = csi_irq_save();								//consistent snapshot of one probe
+		tProbe = s_tProfProbe[i];
+		csi_irq_restore(wIrq);
+		if(tProbe.wCount == 0)
+			continue;
+
+		apt_prof_put(ptUartBase, i, 1);
+		apt_prof_put(ptUartBase, tProbe.wCount, 4);
+		apt_prof_put(ptUartBase, tProbe.wMin, 4);
+		apt_prof_put(ptUartBase, tProbe.wMax, 4);
+		for(j = 0; j < PROF_HIST_BINS; j++)
+			apt_prof_put(ptUartBase, tProbe.hwHist[j], 2);
+		wBytes += 13 + 2 * PROF_HIST_BINS;
+		byNum--;
+	}
+
+	bySum2 = (uint8_t)s_hwProfSum2;
+	csi_uart_putc(ptUartBase, (uint8_t)s_hwProfSum1);
+	csi_uart_putc(ptUartBase, bySum2);
+
+	return wBytes + 2;
+}
+
+#endif
@@ -18,6 +18,17 @@
 /* Private macro------------------------------------------------------*/
 #define min(a, b)  (((a) < (b)) ? (a) : (b))
 
+//index + len never exceeds 2*size, wrap by compare instead of % (no hw divider in byte paths)
+#define RB_WRAP(idx, size)	(((idx) >= (size)) ? ((idx) - (size)) : (idx))
+
+//spsc index publish barrier; single core target only needs the compiler
+//to keep buffer accesses on the right side of the index update
+#if defined(__CSKY__) || defined(__csky__)
+#define RB_BARRIER()	__asm__ volatile("" ::: "memory")
+#else
+#define RB_BARRIER()	__sync_synchronize()
+#endif
+
 /* externs function---------------------------------------------------*/
 /* externs variablesr-------------------------------------------------*/
 /* Private variablesr-------------------------------------------------*/
@@ -66,7 +77,7 @@ uint32_t ringbuffer_in(ringbuffer_t *ptFifo, const void *pDataIn, uint16_t hwLen
                 memcpy((void *)ptFifo->pbyBuf, (uint8_t *)pDataIn + tmplen, writelen - tmplen);
             }
         }
-        ptFifo->hwWrite = (ptFifo->hwWrite + writelen) % ptFifo->hwSize;
+        ptFifo->hwWrite = RB_WRAP(ptFifo->hwWrite + writelen, ptFifo->hwSize);
         ptFifo->hwDataLen += writelen;
     }
 
@@ -104,7 +115,7 @@ uint32_t ringbuffer_out(ringbuffer_t *ptFifo, void *pOutBuf, uint16_t hwLen)
 		}
 	}
 	
-	ptFifo->hwRead = (ptFifo->hwRead + readlen) % ptFifo->hwSize;
+	ptFifo->hwRead = RB_WRAP(ptFifo->hwRead + readlen, ptFifo->hwSize);
 	ptFifo->hwDataLen -= readlen;
 	
 	return readlen;
@@ -122,7 +133,7 @@ void ringbuffer_byte_in(ringbuffer_t *ptFifo, uint8_t byDataIn)
 	if(ptFifo->hwDataLen < ptFifo->hwSize)
 	{
 		ptFifo->pbyBuf[ptFifo->hwWrite] = byDataIn;
-		ptFifo->hwWrite = (ptFifo->hwWrite + 1) % ptFifo->hwSize;
+		ptFifo->hwWrite = RB_WRAP(ptFifo->hwWrite + 1, ptFifo->hwSize);
 		ptFifo->hwDataLen ++;
 	}
 }
@@ -142,10 +153,290 @@ uint8_t ringbuffer_byte_out(ringbuffer_t *ptFifo, void *pOutBuf)
 	else
 	{
 		*((uint8_t*)pOutBuf) = ptFifo->pbyBuf[ptFifo->hwRead];
-		ptFifo->hwRead = (ptFifo->hwRead + 1) % ptFifo->hwSize;
+		ptFifo->hwRead = RB_WRAP(ptFifo->hwRead + 1, ptFifo->hwSize);
 		ptFifo->hwDataLen --;
 		
 	}
 	return 1;
 }
 
+/** \brief  gets the largest contiguous free region of the FIFO.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[out] phwLen: The length of the free region.
+  * \return Pointer to the free region, NULL when the FIFO is full.
+  * \note   The region ends at the FIFO end or at hwRead, fill it (e.g. by DMA)
+  *         then call ringbuffer_write_commit.
+  */
+uint8_t *ringbuffer_write_acquire(ringbuffer_t *ptFifo, uint16_t *phwLen)
+{
+	if(ringbuffer_is_full(ptFifo))
+	{
+		*phwLen = 0U;
+		return NULL;
+	}
+	
+	if(ptFifo->hwWrite < ptFifo->hwRead)
+		*phwLen = ptFifo->hwRead - ptFifo->hwWrite;
+	else
+		*phwLen = ptFifo->hwSize - ptFifo->hwWrite;
+	
+	return &ptFifo->pbyBuf[ptFifo->hwWrite];
+}
+/** \brief  commits data written into the acquired region.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[in] hwLen: The length of data written.
+  * \return None.
+  */
+void ringbuffer_write_commit(ringbuffer_t *ptFifo, uint16_t hwLen)
+{
+	uint32_t wWrite = ptFifo->hwWrite + hwLen;
+	
+	if(wWrite >= ptFifo->hwSize)
+		wWrite -= ptFifo->hwSize;
+	ptFifo->hwWrite = wWrite;
+	ptFifo->hwDataLen += hwLen;
+}
+/** \brief  gets the largest contiguous data region of the FIFO.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[out] phwLen: The length of the data region.
+  * \return Pointer to the data region, NULL when the FIFO is empty.
+  * \note   Parse or transmit the data in place, then call ringbuffer_read_release.
+  */
+uint8_t *ringbuffer_read_peek(ringbuffer_t *ptFifo, uint16_t *phwLen)
+{
+	if(ringbuffer_is_empty(ptFifo))
+	{
+		*phwLen = 0U;
+		return NULL;
+	}
+	
+	*phwLen = min(ptFifo->hwDataLen, ptFifo->hwSize - ptFifo->hwRead);
+	
+	return &ptFifo->pbyBuf[ptFifo->hwRead];
+}
+/** \brief  releases data got by ringbuffer_read_peek.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[in] hwLen: The length of data consumed.
+  * \return None.
+  */
+void ringbuffer_read_release(ringbuffer_t *ptFifo, uint16_t hwLen)
+{
+	uint32_t wRead = ptFifo->hwRead + hwLen;
+	
+	if(wRead >= ptFifo->hwSize)
+		wRead -= ptFifo->hwSize;
+	ptFifo->hwRead = wRead;
+	ptFifo->hwDataLen -= hwLen;
+}
+
+/** \brief  init a spsc FIFO on user buffer.
+  * 
+  * \param[in] ptFifo: The fifo to be initialized.
+  * \param[in] pbyBuf: The data buffer of fifo.
+  * \param[in] wSize: The size of data buffer, must be power of two.
+  * \return true: init ok; false: wSize is not power of two.
+  */
+bool ringbuffer_spsc_init(ringbuffer_spsc_t *ptFifo, uint8_t *pbyBuf, uint32_t wSize)
+{
+	if((NULL == pbyBuf) || (wSize == 0U) || (wSize & (wSize - 1U)))
+		return false;
+	
+	ptFifo->pbyBuf = pbyBuf;
+	ptFifo->wMask  = wSize - 1U;
+	ptFifo->wWrite = 0U;
+	ptFifo->wRead  = 0U;
+	
+	return true;
+}
+
+/** \brief  removes the entire spsc FIFO contents.
+  * 
+  * \param[in] ptFifo: The fifo to be emptied.
+  * \return None.
+  * \note   Producer and consumer must both be stopped. 
+  */
+void ringbuffer_spsc_reset(ringbuffer_spsc_t *ptFifo)
+{
+	ptFifo->wWrite = 0U;
+	ptFifo->wRead  = 0U;
+}
+
+/** \brief  puts some data into the spsc FIFO, producer side.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[in] pDataIn: The data to be added.
+  * \param[in] wLen: The length of the data to be added.
+  * \return The number of bytes copied.
+  * \note   Only wWrite is stored here, the index is published after the
+  *         data copy so the consumer never sees unwritten bytes.
+  */
+uint32_t ringbuffer_spsc_in(ringbuffer_spsc_t *ptFifo, const void *pDataIn, uint32_t wLen)
+{
+	uint32_t wWrite = ptFifo->wWrite;
+	uint32_t wRead  = ptFifo->wRead;
+	uint32_t wOffset, wTmpLen;
+	
+	RB_BARRIER();													//consumer has finished with the slots before reuse
+	
+	wLen = min(wLen, (ptFifo->wMask + 1U) - (wWrite - wRead));
+	if(wLen == 0U)
+		return 0U;
+	
+	wOffset = wWrite & ptFifo->wMask;
+	wTmpLen = min(wLen, (ptFifo->wMask + 1U) - wOffset);
+	
+	memcpy(&ptFifo->pbyBuf[wOffset], pDataIn, wTmpLen);
+	memcpy(ptFifo->pbyBuf, (const uint8_t *)pDataIn + wTmpLen, wLen - wTmpLen);
+	
+	RB_BARRIER();
+	ptFifo->wWrite = wWrite + wLen;
+	
+	return wLen;
+}
+
+/** \brief  gets some data from the spsc FIFO, consumer side.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[in] pOutBuf: Where the data must be copied, NULL: discard data.
+  * \param[in] wLen: The size of the destination buffer.
+  * \return The number of copied bytes.
+  */
+uint32_t ringbuffer_spsc_out(ringbuffer_spsc_t *ptFifo, void *pOutBuf, uint32_t wLen)
+{
+	uint32_t wRead  = ptFifo->wRead;
+	uint32_t wWrite = ptFifo->wWrite;
+	uint32_t wOffset, wTmpLen;
+	
+	RB_BARRIER();													//data is visible before it is read
+	
+	wLen = min(wLen, wWrite - wRead);
+	wLen = min(wLen, ptFifo->wMask + 1U);							//an overrun producer(dma) may run ahead by more than the size
+	if(wLen == 0U)
+		return 0U;
+	
+	if(NULL != pOutBuf)
+	{
+		wOffset = wRead & ptFifo->wMask;
+		wTmpLen = min(wLen, (ptFifo->wMask + 1U) - wOffset);
+		
+		memcpy(pOutBuf, &ptFifo->pbyBuf[wOffset], wTmpLen);
+		memcpy((uint8_t *)pOutBuf + wTmpLen, ptFifo->pbyBuf, wLen - wTmpLen);
+	}
+	
+	RB_BARRIER();
+	ptFifo->wRead = wRead + wLen;
+	
+	return wLen;
+}
+
+/** \brief  puts one byte into the spsc FIFO, producer side.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[in] byDataIn: The data to be added.
+  * \return The number of bytes copied, 0/1
+  */
+uint8_t ringbuffer_spsc_byte_in(ringbuffer_spsc_t *ptFifo, uint8_t byDataIn)
+{
+	uint32_t wWrite = ptFifo->wWrite;
+	
+	if((wWrite - ptFifo->wRead) > ptFifo->wMask)					//full
+		return 0;
+	
+	RB_BARRIER();
+	ptFifo->pbyBuf[wWrite & ptFifo->wMask] = byDataIn;
+	RB_BARRIER();
+	ptFifo->wWrite = wWrite + 1U;
+	
+	return 1;
+}
+
+/** \brief  gets one byte from the spsc FIFO, consumer side.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[in] pOutBuf: Where the data must be copied.
+  * \return The number of read bytes, 0/1
+  */
+uint8_t ringbuffer_spsc_byte_out(ringbuffer_spsc_t *ptFifo, void *pOutBuf)
+{
+	uint32_t wRead = ptFifo->wRead;
+	
+	if(wRead == ptFifo->wWrite)										//empty
+		return 0;
+	
+	RB_BARRIER();
+	*((uint8_t*)pOutBuf) = ptFifo->pbyBuf[wRead & ptFifo->wMask];
+	RB_BARRIER();
+	ptFifo->wRead = wRead + 1U;
+	
+	return 1;
+}
+
+/** \brief  gets the largest contiguous free region of the spsc FIFO, producer side.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[out] pwLen: The length of the free region.
+  * \return Pointer to the free region, NULL when the FIFO is full.
+  */
+uint8_t *ringbuffer_spsc_write_acquire(ringbuffer_spsc_t *ptFifo, uint32_t *pwLen)
+{
+	uint32_t wWrite  = ptFifo->wWrite;
+	uint32_t wOffset = wWrite & ptFifo->wMask;
+	uint32_t wAvail  = (ptFifo->wMask + 1U) - (wWrite - ptFifo->wRead);
+	
+	RB_BARRIER();
+	
+	*pwLen = min(wAvail, (ptFifo->wMask + 1U) - wOffset);
+	if(*pwLen == 0U)
+		return NULL;
+	
+	return &ptFifo->pbyBuf[wOffset];
+}
+
+/** \brief  publishes data written into the acquired region, producer side.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[in] wLen: The length of data written.
+  * \return None.
+  */
+void ringbuffer_spsc_write_commit(ringbuffer_spsc_t *ptFifo, uint32_t wLen)
+{
+	RB_BARRIER();
+	ptFifo->wWrite = ptFifo->wWrite + wLen;
+}
+
+/** \brief  gets the largest contiguous data region of the spsc FIFO, consumer side.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[out] pwLen: The length of the data region.
+  * \return Pointer to the data region, NULL when the FIFO is empty.
+  */
+uint8_t *ringbuffer_spsc_read_peek(ringbuffer_spsc_t *ptFifo, uint32_t *pwLen)
+{
+	uint32_t wRead   = ptFifo->wRead;
+	uint32_t wOffset = wRead & ptFifo->wMask;
+	uint32_t wUsed   = ptFifo->wWrite - wRead;
+	
+	RB_BARRIER();
+	
+	*pwLen = min(wUsed, (ptFifo->wMask + 1U) - wOffset);
+	if(*pwLen == 0U)
+		return NULL;
+	
+	return &ptFifo->pbyBuf[wOffset];
+}
+
+/** \brief  frees data got by ringbuffer_spsc_read_peek, consumer side.
+  * 
+  * \param[in] ptFifo: The fifo to be used.
+  * \param[in] wLen: The length of data consumed.
+  * \return None.
+  */
+void ringbuffer_spsc_read_release(ringbuffer_spsc_t *ptFifo, uint32_t wLen)
+{
+	RB_BARRIER();
+	ptFifo->wRead = ptFifo->wRead + wLen;
+}
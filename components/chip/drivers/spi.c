@@ -16,16 +16,24 @@
 #include <drv/pin.h>
 #include <drv/porting.h>
 #include <drv/tick.h>
+#include <drv/etb.h>
+#include <drv/dma.h>
+#include <drv/lat_bench.h>
 #include <iostring.h>
 #include <uart.h>
 
 #include "csp_spi.h"
+#include "csp_dma.h"
 /* Private macro------------------------------------------------------*/
 /* externs function---------------------------------------------------*/
 /* externs variablesr-------------------------------------------------*/
 /* Private variablesr-------------------------------------------------*/
 
 csi_spi_transmit_t g_tSpiTransmit; 
+static uint16_t s_hwSpiDmaChunk;			//length of dma chunk in flight
+static const uint8_t s_bySpiDmaTxZero = 0x00;	//dma tx dummy source
+static uint8_t  s_bySpiDmaRxDiscard;		//dma rx dummy sink
+static uint8_t  s_bySpiDmaSg = 0;			//1: scatter-gather send in flight, completes on the tx channel
 
 /** \brief csi_spi_nss_high 
  * 
@@ -117,9 +125,9 @@ csi_error_t csi_spi_uninit(csp_spi_t *ptSpiBase)
 	csi_irq_disable((uint32_t *)ptSpiBase);
 	csp_spi_default_init(ptSpiBase);
 	g_tSpiTransmit.pbyRxData =NULL;
-	g_tSpiTransmit.byRxSize =0;
+	g_tSpiTransmit.wRxSize =0;
 	g_tSpiTransmit.pbyTxData =NULL;
-	g_tSpiTransmit.byTxSize =0;
+	g_tSpiTransmit.wTxSize =0;
 	g_tSpiTransmit.byRxFifoLength = SPI_RXFIFO_1_2;
 	g_tSpiTransmit.byTxFifoLength = 0x04;//The spec specified
 	g_tSpiTransmit.byInt = SPI_NONE_INT;
@@ -234,7 +242,8 @@ csi_error_t csi_spi_frame_len(csp_spi_t *ptSpiBase, csi_spi_frame_len_e eLength)
     return tRet;
 }
 
-/** \brief get the tState of spi device
+/** \brief get the tState of spi device, SPI_SEND reports idle only when the
+ *         last frame has left the shifter(SPI_BSY clear), nss may then be released
  * 
  *  \param[in] eWorkMode
  *  \return read/write state or CSI_ERROR/CSI_OK
@@ -246,6 +255,8 @@ int8_t csi_spi_get_state(csi_spi_work_mode_e eWorkMode)
 	switch(eWorkMode)
    {
 	   case SPI_SEND: 
+			if(g_tSpiTransmit.byWriteable == SPI_STATE_IDLE && csp_spi_busy(SPI0))
+				return SPI_STATE_BUSY;				//fifo/shifter still sending
 			return g_tSpiTransmit.byWriteable;
 	   case SPI_RECV: 
 			return g_tSpiTransmit.byReadable;
@@ -273,7 +284,7 @@ int32_t csi_spi_send(csp_spi_t *ptSpiBase, void *pData, uint32_t wSize)
 		return CSI_BUSY;
 		
 	g_tSpiTransmit.byWriteable = SPI_STATE_BUSY;
-	g_tSpiTransmit.byTxSize = wSize;
+	g_tSpiTransmit.wTxSize = wSize;
 	g_tSpiTransmit.pbyTxData = (uint8_t *)pData;
 	csi_spi_clr_rxfifo(ptSpiBase);
 	csp_spi_en(ptSpiBase);
@@ -281,7 +292,7 @@ int32_t csi_spi_send(csp_spi_t *ptSpiBase, void *pData, uint32_t wSize)
 	switch(g_tSpiTransmit.bySendMode)
 	{
 		case SPI_TX_MODE_POLL:			
-			while(g_tSpiTransmit.byTxSize > 0)
+			while(g_tSpiTransmit.wTxSize > 0)
 			{
 				wSendStart = SPI_SEND_TIMEOUT;
 				while(!csp_spi_write_ready(ptSpiBase) && wSendStart --); 
@@ -292,7 +303,7 @@ int32_t csi_spi_send(csp_spi_t *ptSpiBase, void *pData, uint32_t wSize)
 				csp_spi_set_data(ptSpiBase, *g_tSpiTransmit.pbyTxData);
 				g_tSpiTransmit.pbyTxData ++;
 				wCount ++;
-				g_tSpiTransmit.byTxSize --;
+				g_tSpiTransmit.wTxSize --;
 			}
 			
 			wSendStart = SPI_SEND_TIMEOUT;
@@ -315,6 +326,39 @@ int32_t csi_spi_send(csp_spi_t *ptSpiBase, void *pData, uint32_t wSize)
 	}
 }
 
+/** \brief sending scatter-gather segments to spi transmitter without copying, polling mode only
+ * 
+ *  \param[in] ptSpiBase: pointer of spi register structure
+ *  \param[in] ptIov: segment array
+ *  \param[in] byIovCnt: segment number
+ *  \return  the num of data which is send successfully or CSI_ERROR/CSI_BUSY/CSI_UNSUPPORTED
+ */
+int32_t csi_spi_sendv(csp_spi_t *ptSpiBase, const csi_iovec_t *ptIov, uint8_t byIovCnt)
+{
+	uint8_t i;
+	int32_t iRet, iCount = 0;
+	
+	if(NULL == ptIov)
+		return CSI_ERROR;
+	
+	if(g_tSpiTransmit.bySendMode != SPI_TX_MODE_POLL)
+		return CSI_UNSUPPORTED;
+	
+	for(i = 0; i < byIovCnt; i++)
+	{
+		if(0 == ptIov[i].wLen)
+			continue;
+		iRet = csi_spi_send(ptSpiBase, (void *)ptIov[i].pBase, ptIov[i].wLen);
+		if(iRet < 0)
+			return iRet;
+		iCount += iRet;
+		if((uint32_t)iRet < ptIov[i].wLen)		//timeout
+			break;
+	}
+	
+	return iCount;
+}
+
 /** \brief sending data to spi transmitter, non-blocking mode(interrupt mode)
  * 
  *  \param[in] ptSpiBase: pointer of spi register structure
@@ -335,7 +379,7 @@ csi_error_t csi_spi_send_async(csp_spi_t *ptSpiBase, void *pData, uint32_t wSize
 	if(tRet == CSI_OK)
 	{
 		g_tSpiTransmit.byWriteable = SPI_STATE_BUSY;
-		g_tSpiTransmit.byTxSize = wSize;
+		g_tSpiTransmit.wTxSize = wSize;
 		g_tSpiTransmit.pbyTxData = (uint8_t *)pData;
 		csi_spi_clr_rxfifo(ptSpiBase);
 		csp_spi_en(ptSpiBase);
@@ -363,14 +407,14 @@ int32_t csi_spi_receive(csp_spi_t *ptSpiBase, void *pData, uint32_t wSize)
 		return CSI_BUSY;
 	
 	g_tSpiTransmit.byReadable = SPI_STATE_BUSY;
-	g_tSpiTransmit.byRxSize = wSize;
+	g_tSpiTransmit.wRxSize = wSize;
 	g_tSpiTransmit.pbyRxData = (uint8_t *)pData;
 	csi_spi_clr_rxfifo(ptSpiBase);
 	csp_spi_en(ptSpiBase);
 	switch(g_tSpiTransmit.byRecvMode)
 	{
 		case SPI_RX_MODE_POLL:
-			while(g_tSpiTransmit.byRxSize)
+			while(g_tSpiTransmit.wRxSize)
 			{
 				wTimeStart = SPI_RECV_TIMEOUT;
 				while(!csp_spi_read_ready(ptSpiBase) && wTimeStart --);
@@ -383,7 +427,7 @@ int32_t csi_spi_receive(csp_spi_t *ptSpiBase, void *pData, uint32_t wSize)
 				g_tSpiTransmit.pbyRxData++;
 				wCount ++;
 				
-				g_tSpiTransmit.byRxSize --;
+				g_tSpiTransmit.wRxSize --;
 			}
 			g_tSpiTransmit.byReadable = SPI_STATE_IDLE;
 			return wCount;
@@ -417,7 +461,7 @@ csi_error_t csi_spi_receive_async(csp_spi_t *ptSpiBase, void *pData, uint32_t wS
 	if(tRet == CSI_OK)
 	{
 		g_tSpiTransmit.byReadable = SPI_STATE_BUSY;
-		g_tSpiTransmit.byRxSize = wSize;
+		g_tSpiTransmit.wRxSize = wSize;
 		g_tSpiTransmit.pbyRxData = (uint8_t *)pData;
 		csp_spi_en(ptSpiBase);
 		csi_spi_clr_rxfifo(ptSpiBase);
@@ -446,8 +490,8 @@ int32_t csi_spi_send_receive(csp_spi_t *ptSpiBase, void *pDataout, void *pDatain
 	if((g_tSpiTransmit.byWriteable == SPI_STATE_BUSY) || (g_tSpiTransmit.byReadable == SPI_STATE_BUSY)) 						
 		return CSI_BUSY;
 	
-	g_tSpiTransmit.byTxSize = wSize;
-	g_tSpiTransmit.byRxSize = wSize;
+	g_tSpiTransmit.wTxSize = wSize;
+	g_tSpiTransmit.wRxSize = wSize;
 	
 	g_tSpiTransmit.byWriteable = SPI_STATE_BUSY;
 	g_tSpiTransmit.byReadable  = SPI_STATE_BUSY;
@@ -458,9 +502,9 @@ int32_t csi_spi_send_receive(csp_spi_t *ptSpiBase, void *pDataout, void *pDatain
 	switch(g_tSpiTransmit.bySendRecMode)
 	{
 		case SPI_TX_RX_MODE_POLL:
-			while((g_tSpiTransmit.byTxSize > 0U) || (g_tSpiTransmit.byRxSize > 0U))
+			while((g_tSpiTransmit.wTxSize > 0U) || (g_tSpiTransmit.wRxSize > 0U))
 			{
-				if(g_tSpiTransmit.byTxSize > 0U)
+				if(g_tSpiTransmit.wTxSize > 0U)
 				{
 					wTimeStart = SPI_SEND_TIMEOUT;
 					while(!csp_spi_write_ready(ptSpiBase) && wTimeStart --);
@@ -478,10 +522,10 @@ int32_t csi_spi_send_receive(csp_spi_t *ptSpiBase, void *pDataout, void *pDatain
 						csp_spi_set_data(ptSpiBase,0x00);
 					}
 					wCount ++;
-					g_tSpiTransmit.byTxSize --;
+					g_tSpiTransmit.wTxSize --;
 				}
 				
-				if(g_tSpiTransmit.byRxSize > 0U)
+				if(g_tSpiTransmit.wRxSize > 0U)
 				{
 					wTimeStart = SPI_RECV_TIMEOUT;
 					while(!csp_spi_read_ready(ptSpiBase) && wTimeStart --);
@@ -498,7 +542,7 @@ int32_t csi_spi_send_receive(csp_spi_t *ptSpiBase, void *pDataout, void *pDatain
 					{
 						csp_spi_get_data(ptSpiBase);
 					}
-					g_tSpiTransmit.byRxSize --;
+					g_tSpiTransmit.wRxSize --;
 				}
 			}
 			
@@ -543,8 +587,8 @@ csi_error_t csi_spi_send_receive_async(csp_spi_t *ptSpiBase, void *pDataout, voi
 		
 	if(tRet == CSI_OK) 
 	{
-		g_tSpiTransmit.byTxSize = wSize;
-		g_tSpiTransmit.byRxSize = wSize;
+		g_tSpiTransmit.wTxSize = wSize;
+		g_tSpiTransmit.wRxSize = wSize;
 	
 		g_tSpiTransmit.byWriteable = SPI_STATE_BUSY;
 		g_tSpiTransmit.byReadable  = SPI_STATE_BUSY;
@@ -569,9 +613,9 @@ csi_error_t csi_spi_send_receive_async(csp_spi_t *ptSpiBase, void *pDataout, voi
 csi_error_t csi_spi_Internal_variables_init(csi_spi_config_t *ptSpiCfg)
 {
 	g_tSpiTransmit.pbyRxData =NULL;
-	g_tSpiTransmit.byRxSize =0;
+	g_tSpiTransmit.wRxSize =0;
 	g_tSpiTransmit.pbyTxData =NULL;
-	g_tSpiTransmit.byTxSize =0;
+	g_tSpiTransmit.wTxSize =0;
 	g_tSpiTransmit.byRxFifoLength = SPI_RXFIFO_1_2;
 	g_tSpiTransmit.byTxFifoLength = 0x04;
 	if(ptSpiCfg->byInt & SPI_RXIM_INT)
@@ -584,6 +628,8 @@ csi_error_t csi_spi_Internal_variables_init(csi_spi_config_t *ptSpiCfg)
 	g_tSpiTransmit.bySendMode = ptSpiCfg->byTxMode;
 	g_tSpiTransmit.byRecvMode = ptSpiCfg->byRxMode;
 	g_tSpiTransmit.bySendRecMode = ptSpiCfg->byTxRxMode;
+	g_tSpiTransmit.byTxDmaCh = DMA_CH_MAX_NUM;			//no dma channel
+	g_tSpiTransmit.byRxDmaCh = DMA_CH_MAX_NUM;
 	
     return CSI_OK;
 }
@@ -614,7 +660,7 @@ void csi_spi_clr_rxfifo(csp_spi_t *ptSpiBase)
  */ 
 void apt_spi_intr_recv_data(csp_spi_t *ptSpiBase)
 {
-	if((g_tSpiTransmit.pbyRxData == NULL) || (g_tSpiTransmit.byRxSize == 0U))//use interrupt transceiver, but does not care about receiving
+	if((g_tSpiTransmit.pbyRxData == NULL) || (g_tSpiTransmit.wRxSize == 0U))//use interrupt transceiver, but does not care about receiving
 	{
 		csi_spi_clr_rxfifo(ptSpiBase); 
 		g_tSpiTransmit.byReadable = SPI_STATE_IDLE;
@@ -627,14 +673,14 @@ void apt_spi_intr_recv_data(csp_spi_t *ptSpiBase)
 		{
 			*g_tSpiTransmit.pbyRxData = csp_spi_get_data(ptSpiBase);
 			g_tSpiTransmit.pbyRxData++;
-			g_tSpiTransmit.byRxSize--;
-			if(g_tSpiTransmit.byRxSize == 0)
+			g_tSpiTransmit.wRxSize--;
+			if(g_tSpiTransmit.wRxSize == 0)
 			{
 				break;
 			}
 		}
 		
-		if(g_tSpiTransmit.byRxSize == 0)
+		if(g_tSpiTransmit.wRxSize == 0)
 		{
 			g_tSpiTransmit.byReadable = SPI_STATE_IDLE;
 			csp_spi_int_enable(ptSpiBase, SPI_RXIM_INT | SPI_RTIM_INT, false);
@@ -650,11 +696,12 @@ void apt_spi_intr_recv_data(csp_spi_t *ptSpiBase)
 void apt_spi_intr_send_data(csp_spi_t *ptSpiBase)
 {	
 	uint8_t byCount = 0;
-	uint32_t wTimeStart = SPI_SEND_TIMEOUT;
-	if( (ptSpiBase->CR1 & SPI_SSE_MSK) && (g_tSpiTransmit.byTxSize) )//Make sure that spi is enabled (if SPI is not enabled,just enable Tx int,Tx interrupts also come in )
+	
+	LAT_CRIT_ENTER(LAT_CRIT_SPI_TX);
+	if( (ptSpiBase->CR1 & SPI_SSE_MSK) && (g_tSpiTransmit.wTxSize) )//Make sure that spi is enabled (if SPI is not enabled,just enable Tx int,Tx interrupts also come in )
 	{
 		
-		if(g_tSpiTransmit.byTxSize >= (g_tSpiTransmit.byTxFifoLength) )
+		if(g_tSpiTransmit.wTxSize >= (g_tSpiTransmit.byTxFifoLength) )
 		{
 			for(byCount = 0; byCount < g_tSpiTransmit.byTxFifoLength;byCount++)
 			{
@@ -668,11 +715,11 @@ void apt_spi_intr_send_data(csp_spi_t *ptSpiBase)
 					csp_spi_set_data(ptSpiBase,0x00);
 				}
 			}
-			g_tSpiTransmit.byTxSize = g_tSpiTransmit.byTxSize - g_tSpiTransmit.byTxFifoLength;	
+			g_tSpiTransmit.wTxSize = g_tSpiTransmit.wTxSize - g_tSpiTransmit.byTxFifoLength;	
 		}
 		else
 		{
-			for(byCount = 0; byCount < g_tSpiTransmit.byTxSize;byCount++)
+			for(byCount = 0; byCount < g_tSpiTransmit.wTxSize;byCount++)
 			{
 				if(g_tSpiTransmit.pbyTxData)
 				{
@@ -684,22 +731,23 @@ void apt_spi_intr_send_data(csp_spi_t *ptSpiBase)
 					csp_spi_set_data(ptSpiBase,0x00);
 				}
 			}
-			g_tSpiTransmit.byTxSize = 0;	
+			g_tSpiTransmit.wTxSize = 0;	
 		}
 		
-		if (g_tSpiTransmit.byTxSize <= 0U) 
+		//last data is in fifo, do not wait SPI_BSY in interrupt; csi_spi_get_state
+		//reports busy until SPI_BSY is clear
+		if (g_tSpiTransmit.wTxSize <= 0U) 
 		{
-			while((csp_spi_get_sr(ptSpiBase) & SPI_BSY) && (wTimeStart --) );
 			g_tSpiTransmit.byWriteable =  SPI_STATE_IDLE;
 			csp_spi_int_enable(ptSpiBase,SPI_TXIM_INT, false);
 		}
 	}
 	else
 	{
-		while((csp_spi_get_sr(ptSpiBase) & SPI_BSY) && (wTimeStart --) );
 		g_tSpiTransmit.byWriteable =  SPI_STATE_IDLE;
 		csp_spi_int_enable(ptSpiBase, SPI_TXIM_INT, false);	
 	}
+	LAT_CRIT_EXIT(LAT_CRIT_SPI_TX);
 }
 
 //-----------------------------------------------------------------------------------------------------------
@@ -710,16 +758,16 @@ void apt_spi_intr_send_data(csp_spi_t *ptSpiBase)
  * 
  *  \param[in] ptSpiBase: pointer of spi register structure
  *  \param[in] pDataOut :send data buffer pointer
- *  \param[in] bySize ：length
+ *  \param[in] wSize ：length
  *  \return error code \ref csi_error_t
  */ 
-csi_error_t csi_spi_send_fast(csp_spi_t *ptSpiBase,void *pDataOut,uint8_t bySize)
+csi_error_t csi_spi_send_fast(csp_spi_t *ptSpiBase,void *pDataOut,uint32_t wSize)
 {		
 	csi_error_t tRet = CSI_OK;
-	uint8_t byIcount = 0;
+	uint32_t wIcount = 0;
 	uint32_t wTimeStart = SPI_SEND_TIMEOUT;
 	
-	if( (0 == bySize) || (NULL == pDataOut) ) 
+	if( (0 == wSize) || (NULL == pDataOut) ) 
 	{
 		tRet = CSI_ERROR;
 		return tRet;
@@ -734,11 +782,11 @@ csi_error_t csi_spi_send_fast(csp_spi_t *ptSpiBase,void *pDataOut,uint8_t bySize
 	g_tSpiTransmit.byWriteable = SPI_STATE_BUSY;
 	g_tSpiTransmit.pbyTxData = (uint8_t *)pDataOut;
 	
-	for(byIcount = 0;byIcount <bySize;byIcount++)
+	for(wIcount = 0;wIcount <wSize;wIcount++)
 	{
 		wTimeStart = SPI_SEND_TIMEOUT;
 		while( ( !((uint32_t)(ptSpiBase->SR) & SPI_TNF) ) && (wTimeStart --) ){;}
-		ptSpiBase->DR = *(g_tSpiTransmit.pbyTxData+byIcount);
+		ptSpiBase->DR = *(g_tSpiTransmit.pbyTxData+wIcount);
 	}
 	
 	wTimeStart = SPI_SEND_TIMEOUT;
@@ -967,3 +1015,251 @@ csi_error_t csi_spi_recv_dma(csp_spi_t *ptSpiBase, void *pData, uint16_t hwSize
 	
 	return CSI_OK;
 }
+
+/** \brief start next dma chunk of csi_spi_send_receive_dma, rx channel before tx channel
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \return  none
+ */
+static void apt_spi_dma_next(csp_spi_t *ptSpiBase)
+{
+	s_hwSpiDmaChunk = (g_tSpiTransmit.wTxSize > 0xfff) ? 0xfff : (uint16_t)g_tSpiTransmit.wTxSize;
+	g_tSpiTransmit.wTxSize -= s_hwSpiDmaChunk;
+	
+	if(g_tSpiTransmit.byRxDmaCh < DMA_CH_MAX_NUM)
+	{
+		csi_dma_ch_start(DMA, (csi_dma_ch_e)g_tSpiTransmit.byRxDmaCh, (void *)&(ptSpiBase->DR), 
+				g_tSpiTransmit.pbyRxData ? (void *)g_tSpiTransmit.pbyRxData : (void *)&s_bySpiDmaRxDiscard, s_hwSpiDmaChunk, 1);
+		if(g_tSpiTransmit.pbyRxData)
+			g_tSpiTransmit.pbyRxData += s_hwSpiDmaChunk;
+	}
+	
+	csi_dma_ch_start(DMA, (csi_dma_ch_e)g_tSpiTransmit.byTxDmaCh, 
+			g_tSpiTransmit.pbyTxData ? (void *)g_tSpiTransmit.pbyTxData : (void *)&s_bySpiDmaTxZero, (void *)&(ptSpiBase->DR), s_hwSpiDmaChunk, 1);
+	if(g_tSpiTransmit.pbyTxData)
+		g_tSpiTransmit.pbyTxData += s_hwSpiDmaChunk;
+}
+
+/** \brief dma chunk done, start next chunk or finish the transfer
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] eEvent: complete event
+ *  \return  none
+ */
+static void apt_spi_dma_done(csp_spi_t *ptSpiBase, csi_spi_event_e eEvent)
+{
+	if(g_tSpiTransmit.wTxSize)
+	{
+		apt_spi_dma_next(ptSpiBase);
+		return;
+	}
+	
+	g_tSpiTransmit.wRxSize = 0;
+	g_tSpiTransmit.byWriteable = SPI_STATE_IDLE;
+	g_tSpiTransmit.byReadable  = SPI_STATE_IDLE;
+	s_bySpiDmaSg = 0;
+	if(g_tSpiTransmit.callback)
+		g_tSpiTransmit.callback(ptSpiBase, eEvent, g_tSpiTransmit.pArg);
+}
+
+/** \brief dma tx channel complete, drives the transfer only when there is no rx channel
+ *         or for a scatter-gather send(called after its last segment); the last data is
+ *         then still in fifo, csi_spi_get_state reports busy until SPI_BSY is clear
+ */
+static void apt_spi_dma_tx_cb(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, void *pArg)
+{
+	if((g_tSpiTransmit.byRxDmaCh >= DMA_CH_MAX_NUM || s_bySpiDmaSg) && g_tSpiTransmit.byWriteable == SPI_STATE_BUSY)
+		apt_spi_dma_done((csp_spi_t *)pArg, SPI_EVENT_SEND_COMPLETE);
+}
+
+/** \brief dma rx channel complete, all data of the chunk is on the wire
+ */
+static void apt_spi_dma_rx_cb(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, void *pArg)
+{
+	if(g_tSpiTransmit.byReadable == SPI_STATE_BUSY)
+		apt_spi_dma_done((csp_spi_t *)pArg, SPI_EVENT_SEND_RECEIVE_COMPLETE);
+}
+
+/** \brief spi dma send mode init, spi tx fifo request triggers the dma channel through etb
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] eDmaCh: channel number of dma, eDmaCh: DMA_CH0` DMA_CH3
+ *  \param[in] eEtbCh: channel id number of etb, eEtbCh >= ETB_CH8
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_spi_dma_tx_init(csp_spi_t *ptSpiBase, csi_dma_ch_e eDmaCh, csi_etb_ch_e eEtbCh)
+{
+	csi_error_t ret = CSI_OK;
+	csi_dma_ch_config_t tDmaConfig;				
+	csi_etb_config_t 	tEtbConfig;	
+	
+	//dma config
+	tDmaConfig.bySrcLinc 	= DMA_ADDR_CONSTANT;		//低位传输原地址固定不变
+	tDmaConfig.bySrcHinc 	= DMA_ADDR_INC;				//高位传输原地址自增
+	tDmaConfig.byDetLinc 	= DMA_ADDR_CONSTANT;		//低位传输目标地址固定不变
+	tDmaConfig.byDetHinc 	= DMA_ADDR_CONSTANT;		//高位传输目标地址固定不变
+	tDmaConfig.byDataWidth 	= DMA_DSIZE_8_BITS;			//传输数据宽度8bit
+	tDmaConfig.byReload 	= DMA_RELOAD_DISABLE;		//禁止自动重载
+	tDmaConfig.byTransMode 	= DMA_TRANS_ONCE;			//DMA服务模式(传输模式)，连续服务
+	tDmaConfig.byTsizeMode  = DMA_TSIZE_ONE_DSIZE;		//传输数据大小，一个 DSIZE , 即DSIZE定义大小
+	tDmaConfig.byReqMode	= DMA_REQ_HARDWARE;			//DMA请求模式，硬件请求
+	tDmaConfig.wInt			= DMA_INTSRC_TCIT;			//使用TCIT中断
+	
+	//etb config
+	tEtbConfig.byChType = ETB_ONE_TRG_ONE_DMA;			//单个源触发单个目标，DMA方式
+	tEtbConfig.bySrcIp 	= ETB_SPI0_TXSRC;				//SPI TXSRC作为触发源
+	tEtbConfig.byDstIp 	= ETB_DMA_CH0 + eDmaCh;			//ETB DMA通道 作为目标实际
+	tEtbConfig.byTrgMode = ETB_HARDWARE_TRG;			//通道触发模式采样硬件触发
+	
+	ret = csi_etb_ch_config(eEtbCh, &tEtbConfig);		//初始化ETB，DMA ETB CHANNEL > ETB_CH9_ID
+	if(ret < CSI_OK)
+		return CSI_ERROR;
+	ret = csi_dma_ch_init(DMA, eDmaCh, &tDmaConfig);	//初始化DMA
+	if(ret < CSI_OK)
+		return CSI_ERROR;
+	
+	g_tSpiTransmit.byTxDmaCh = eDmaCh;
+	csi_dma_attach_callback(eDmaCh, apt_spi_dma_tx_cb, ptSpiBase);
+	csp_spi_set_txdma(ptSpiBase, SPI_TDMA_EN, SPI_TDMA_FIFO_NFULL);		//配置TX DMA模式并使能
+	
+	return ret;
+}
+
+/** \brief spi dma receive mode init, spi rx fifo request triggers the dma channel through etb
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] eDmaCh: channel number of dma, eDmaCh: DMA_CH0` DMA_CH3
+ *  \param[in] eEtbCh: channel id number of etb, eEtbCh >= ETB_CH8
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_spi_dma_rx_init(csp_spi_t *ptSpiBase, csi_dma_ch_e eDmaCh, csi_etb_ch_e eEtbCh)
+{
+	csi_error_t ret = CSI_OK;
+	csi_dma_ch_config_t tDmaConfig;				
+	csi_etb_config_t 	tEtbConfig;	
+	
+	//dma config
+	tDmaConfig.bySrcLinc 	= DMA_ADDR_CONSTANT;		//低位传输原地址固定不变
+	tDmaConfig.bySrcHinc 	= DMA_ADDR_CONSTANT;		//高位传输原地址固定不变
+	tDmaConfig.byDetLinc 	= DMA_ADDR_CONSTANT;		//低位传输目标地址固定不变
+	tDmaConfig.byDetHinc 	= DMA_ADDR_INC;				//高位传输目标地址自增
+	tDmaConfig.byDataWidth 	= DMA_DSIZE_8_BITS;			//传输数据宽度8bit
+	tDmaConfig.byReload 	= DMA_RELOAD_DISABLE;		//禁止自动重载
+	tDmaConfig.byTransMode 	= DMA_TRANS_ONCE;			//DMA服务模式(传输模式)，连续服务
+	tDmaConfig.byTsizeMode  = DMA_TSIZE_ONE_DSIZE;		//传输数据大小，一个 DSIZE , 即DSIZE定义大小
+	tDmaConfig.byReqMode	= DMA_REQ_HARDWARE;			//DMA请求模式，硬件请求
+	tDmaConfig.wInt			= DMA_INTSRC_TCIT;			//使用TCIT中断
+	
+	//etb config
+	tEtbConfig.byChType = ETB_ONE_TRG_ONE_DMA;			//单个源触发单个目标，DMA方式
+	tEtbConfig.bySrcIp 	= ETB_SPI0_RXSRC;				//SPI RXSRC作为触发源
+	tEtbConfig.byDstIp 	= ETB_DMA_CH0 + eDmaCh;			//ETB DMA通道 作为目标实际
+	tEtbConfig.byTrgMode = ETB_HARDWARE_TRG;			//通道触发模式采样硬件触发
+	
+	ret = csi_etb_ch_config(eEtbCh, &tEtbConfig);		//初始化ETB，DMA ETB CHANNEL > ETB_CH9_ID
+	if(ret < CSI_OK)
+		return CSI_ERROR;
+	ret = csi_dma_ch_init(DMA, eDmaCh, &tDmaConfig);	//初始化DMA
+	if(ret < CSI_OK)
+		return CSI_ERROR;
+	
+	g_tSpiTransmit.byRxDmaCh = eDmaCh;
+	csi_dma_attach_callback(eDmaCh, apt_spi_dma_rx_cb, ptSpiBase);
+	csp_spi_set_rxdma(ptSpiBase, SPI_RDMA_EN, SPI_RDMA_FIFO_NSPACE);	//配置RX DMA模式并使能
+	
+	return ret;
+}
+
+/** \brief attach dma transfer complete callback
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] callback: callback function, NULL: poll csi_spi_get_state
+ *  \param[in] pArg: user param passed to callback
+ *  \return  none
+ */
+void csi_spi_attach_callback(csp_spi_t *ptSpiBase, csi_spi_callback_t callback, void *pArg)
+{
+	g_tSpiTransmit.pArg = pArg;
+	g_tSpiTransmit.callback = callback;
+}
+
+/** \brief send and receive data of spi by DMA(8 bit frame), non-blocking; long transfers are 
+ *         split into 0xfff chunks in the dma interrupt. Needs csi_spi_dma_tx_init, and 
+ *         csi_spi_dma_rx_init when pDatain is used.
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] pDataout: pointer to send buffer, NULL: send 0x00 for receive clock
+ *  \param[in] pDatain: pointer to receive buffer, NULL: send only
+ *  \param[in] wSize: number of data to send/receive(byte)
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_spi_send_receive_dma(csp_spi_t *ptSpiBase, const void *pDataout, void *pDatain, uint32_t wSize)
+{
+	csp_dma_t *ptDmaChBase;
+	
+	if((wSize == 0) || (g_tSpiTransmit.byTxDmaCh >= DMA_CH_MAX_NUM) || 
+		((pDatain != NULL) && (g_tSpiTransmit.byRxDmaCh >= DMA_CH_MAX_NUM)))
+		return CSI_ERROR;
+	
+	if((g_tSpiTransmit.byWriteable == SPI_STATE_BUSY) || (g_tSpiTransmit.byReadable == SPI_STATE_BUSY))
+		return CSI_BUSY;
+	
+	g_tSpiTransmit.byWriteable = SPI_STATE_BUSY;
+	if(g_tSpiTransmit.byRxDmaCh < DMA_CH_MAX_NUM)
+		g_tSpiTransmit.byReadable = SPI_STATE_BUSY;
+	g_tSpiTransmit.pbyTxData = (uint8_t *)pDataout;
+	g_tSpiTransmit.pbyRxData = (uint8_t *)pDatain;
+	g_tSpiTransmit.wTxSize = wSize;
+	g_tSpiTransmit.wRxSize = wSize;
+	
+	//dummy source/sink does not increase
+	ptDmaChBase = (csp_dma_t *)DMA_REG_BASE(DMA, g_tSpiTransmit.byTxDmaCh);
+	csp_dma_set_ch_saddr_mode(ptDmaChBase, DMA_LINC_CONST, pDataout ? DMA_HINC_INC : DMA_HINC_CONST);
+	if(g_tSpiTransmit.byRxDmaCh < DMA_CH_MAX_NUM)
+	{
+		ptDmaChBase = (csp_dma_t *)DMA_REG_BASE(DMA, g_tSpiTransmit.byRxDmaCh);
+		csp_dma_set_ch_daddr_mode(ptDmaChBase, DMA_LINC_CONST, pDatain ? DMA_HINC_INC : DMA_HINC_CONST);
+		csi_spi_clr_rxfifo(ptSpiBase);
+	}
+	
+	apt_spi_dma_next(ptSpiBase);
+	
+	return CSI_OK;
+}
+
+/** \brief send scatter-gather segments of spi by DMA(8 bit frame), non-blocking; the next
+ *         segment is started from the dma TCIT interrupt, completion is reported like
+ *         csi_spi_send_receive_dma(SPI_EVENT_SEND_COMPLETE). Needs csi_spi_dma_tx_init,
+ *         received data is not read.
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] ptIov: segment array, segment length <= 0xfff, must stay valid until sent
+ *  \param[in] byIovCnt: segment number
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_spi_sendv_dma(csp_spi_t *ptSpiBase, const csi_iovec_t *ptIov, uint8_t byIovCnt)
+{
+	csi_error_t ret;
+	
+	if(g_tSpiTransmit.byTxDmaCh >= DMA_CH_MAX_NUM)
+		return CSI_ERROR;
+	
+	if((g_tSpiTransmit.byWriteable == SPI_STATE_BUSY) || (g_tSpiTransmit.byReadable == SPI_STATE_BUSY))
+		return CSI_BUSY;
+	
+	g_tSpiTransmit.byWriteable = SPI_STATE_BUSY;
+	g_tSpiTransmit.wTxSize = 0;
+	g_tSpiTransmit.wRxSize = 0;
+	s_bySpiDmaSg = 1;
+	
+	csp_dma_set_ch_saddr_mode((csp_dma_t *)DMA_REG_BASE(DMA, g_tSpiTransmit.byTxDmaCh), DMA_LINC_CONST, DMA_HINC_INC);
+	
+	ret = csi_dma_ch_start_sg(DMA, (csi_dma_ch_e)g_tSpiTransmit.byTxDmaCh, ptIov, byIovCnt, (void *)&(ptSpiBase->DR));
+	if(ret < CSI_OK)
+	{
+		s_bySpiDmaSg = 0;
+		g_tSpiTransmit.byWriteable = SPI_STATE_IDLE;
+	}
+	
+	return ret;
+}
@@ -0,0 +1,753 @@
+/***********************************************************************//**
+ * \file  spiflash.c
+ * \brief  csi spi nor flash driver, on spi0 (single line, 3 bytes address)
+ * \copyright Copyright (C) 2015-2021 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author  <th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <string.h>
+#include <drv/spiflash.h>
+#include <drv/spi.h>
+#include <drv/tick.h>
+
+#include "csp_spi.h"
+/* Private macro------------------------------------------------------*/
+#define SF_CMD_WRSR			0x01		//write status reg
+#define SF_CMD_PP			0x02		//page program
+#define SF_CMD_RDSR			0x05		//read status reg
+#define SF_CMD_WREN			0x06		//write enable
+#define SF_CMD_FAST_READ	0x0b		//fast read, one dummy byte
+#define SF_CMD_SE			0x20		//4k sector erase
+#define SF_CMD_RDSFDP		0x5a		//read sfdp, one dummy byte
+#define SF_CMD_SUSPEND		0x75		//erase/program suspend
+#define SF_CMD_RESUME		0x7a		//erase/program resume
+#define SF_CMD_RDID			0x9f		//read jedec id
+#define SF_CMD_CE			0xc7		//chip erase
+
+#define SF_SR_WIP			0x01		//write in progress
+#define SF_SR_BP_MSK		0x1c		//BP2..BP0
+
+#define SF_ADDR_SIZE		3			//address bytes
+#define SF_MAX_SIZE			(16ul << 20)//3 bytes address space
+#define SF_FIFO_DEPTH		8			//spi fifo deep
+#define SF_SFDP_DW_MAX		16			//basic parameter table dwords read
+
+#define SF_CACHE_INVALID	0xfffffffful
+
+typedef enum{
+	SF_IDLE		= 0,				//no program/erase in flight
+	SF_BUSY,						//program/chip erase/write status in flight
+	SF_BUSY_ERASE					//sector erase in flight, can be suspended
+}sf_state_e;
+
+typedef struct {
+	csi_spiflash_info_t tInfo;
+	uint8_t		byEraseCmd;			//erase cmd of tInfo.sector_size
+	uint8_t		bySusCmd;			//erase suspend cmd, 0: not support
+	uint8_t		byResCmd;			//erase resume cmd
+	uint8_t		byState;			//\ref sf_state_e
+	uint32_t	wBusyMs;			//WIP timeout of the program/erase in flight(ms)
+	uint64_t	dwResumeUs;			//time of the last erase resume(us)
+	uint32_t	wCacheAddr;			//flash address of cache line
+	uint8_t		byCache[SPIFLASH_CACHE_LINE];
+} sf_prv_t;
+
+/* Private variablesr-------------------------------------------------*/
+static sf_prv_t s_tSfPrv;
+
+/** \brief drive chip select of flash by the callback of init
+ *
+ *  \param[in] ptFlash: spiflash handle
+ *  \param[in] eValue: GPIO_PIN_LOW/GPIO_PIN_HIGH
+ *  \return none
+ */
+static void apt_sf_cs(csi_spiflash_t *ptFlash, csi_gpio_pin_state_e eValue)
+{
+	ptFlash->spi_cs_callback(eValue);
+}
+
+/** \brief full duplex exchange, keep tx fifo filled and never more than fifo deep in flight;
+ *         times out when no byte is received for SPIFLASH_XFER_TIMEOUT
+ *
+ *  \param[in] ptSpiBase: pointer of spi register structure
+ *  \param[in] pbyTx: send data, NULL: send 0xff
+ *  \param[out] pbyRx: receive data, NULL: discard
+ *  \param[in] wSize: number of data(byte)
+ *  \return error code \ref csi_error_t
+ */
+static csi_error_t apt_sf_exchange(csp_spi_t *ptSpiBase, const uint8_t *pbyTx, uint8_t *pbyRx, uint32_t wSize)
+{
+	uint32_t wTx = 0, wRx = 0;
+	uint32_t wStart = csi_tick_get_ms();
+	uint8_t byData;
+
+	while(wRx < wSize)
+	{
+		if((wTx < wSize) && ((wTx - wRx) < SF_FIFO_DEPTH) && csp_spi_write_ready(ptSpiBase))
+		{
+			csp_spi_set_data(ptSpiBase, pbyTx ? pbyTx[wTx] : 0xff);
+			wTx++;
+		}
+		if(csp_spi_read_ready(ptSpiBase))
+		{
+			byData = (uint8_t)csp_spi_get_data(ptSpiBase);
+			if(pbyRx)
+				pbyRx[wRx] = byData;
+			wRx++;
+			wStart = csi_tick_get_ms();
+		}
+		else if((csi_tick_get_ms() - wStart) > SPIFLASH_XFER_TIMEOUT)
+		{
+			csi_spi_clr_rxfifo(ptSpiBase);					//no stale byte for the next command
+			return CSI_TIMEOUT;
+		}
+	}
+	return CSI_OK;
+}
+
+/** \brief one flash command: cmd + address + dummy + data, data phase send or receive
+ *
+ *  \param[in] ptFlash: spiflash handle
+ *  \param[in] byCmd: command code
+ *  \param[in] wAddr: flash address
+ *  \param[in] byAddrSize: address bytes, 0/3/4
+ *  \param[in] byDummy: dummy bytes after address
+ *  \param[in] pTx: data to send, NULL: no send data
+ *  \param[out] pRx: data buffer of receive, NULL: no receive data
+ *  \param[in] wSize: number of data(byte)
+ *  \return error code \ref csi_error_t
+ */
+static csi_error_t apt_sf_xfer(csi_spiflash_t *ptFlash, uint8_t byCmd, uint32_t wAddr, uint8_t byAddrSize,
+						uint8_t byDummy, const void *pTx, void *pRx, uint32_t wSize)
+{
+	csp_spi_t *ptSpiBase = ptFlash->spi_qspi.spi;
+	csi_error_t tRet;
+	uint8_t byHead[6];
+	uint8_t byLen = 0;
+
+	byHead[byLen++] = byCmd;
+	while(byAddrSize--)
+		byHead[byLen++] = (uint8_t)(wAddr >> (byAddrSize << 3));
+	while(byDummy--)
+		byHead[byLen++] = 0xff;
+
+	apt_sf_cs(ptFlash, GPIO_PIN_LOW);
+	tRet = apt_sf_exchange(ptSpiBase, byHead, NULL, byLen);
+	if((tRet == CSI_OK) && wSize)
+		tRet = apt_sf_exchange(ptSpiBase, (const uint8_t *)pTx, (uint8_t *)pRx, wSize);
+	apt_sf_cs(ptFlash, GPIO_PIN_HIGH);
+	
+	return tRet;
+}
+
+/** \brief spi_send hook of csi_spiflash_t
+ *
+ *  \param[in] spi: spiflash handle
+ *  \return the num of data which is send or CSI_TIMEOUT
+ */
+static int32_t apt_sf_spi_send(void *spi, uint8_t cmd, uint32_t addr, uint32_t addr_size, const void *data, uint32_t size)
+{
+	csi_error_t tRet = apt_sf_xfer((csi_spiflash_t *)spi, cmd, addr, (uint8_t)addr_size, 0, data, NULL, size);
+	
+	return (tRet == CSI_OK) ? (int32_t)size : tRet;
+}
+
+/** \brief spi_receive hook of csi_spiflash_t
+ *
+ *  \param[in] spi: spiflash handle
+ *  \return the num of data which is received or CSI_TIMEOUT
+ */
+static int32_t apt_sf_spi_receive(void *spi, uint8_t cmd, uint32_t addr, uint32_t addr_size, void *data, uint32_t size)
+{
+	csi_error_t tRet = apt_sf_xfer((csi_spiflash_t *)spi, cmd, addr, (uint8_t)addr_size, 0, NULL, data, size);
+	
+	return (tRet == CSI_OK) ? (int32_t)size : tRet;
+}
+
+static csi_error_t apt_sf_read_sr(csi_spiflash_t *ptFlash, uint8_t *pbySr)
+{
+	return apt_sf_xfer(ptFlash, SF_CMD_RDSR, 0, 0, 0, NULL, pbySr, 1);
+}
+
+static csi_error_t apt_sf_write_enable(csi_spiflash_t *ptFlash)
+{
+	return apt_sf_xfer(ptFlash, SF_CMD_WREN, 0, 0, 0, NULL, NULL, 0);
+}
+
+/** \brief poll WIP until clear
+ *
+ *  \param[in] ptFlash: spiflash handle
+ *  \param[in] wMs: timeout(ms)
+ *  \return error code \ref csi_error_t
+ */
+static csi_error_t apt_sf_poll_wip(csi_spiflash_t *ptFlash, uint32_t wMs)
+{
+	uint32_t wStart = csi_tick_get_ms();
+	csi_error_t tRet;
+	uint8_t bySr;
+
+	while(1)
+	{
+		tRet = apt_sf_read_sr(ptFlash, &bySr);
+		if((tRet != CSI_OK) || !(bySr & SF_SR_WIP))
+			return tRet;
+		if((csi_tick_get_ms() - wStart) > wMs)
+			return CSI_TIMEOUT;
+	}
+}
+
+/** \brief wait the program/erase in flight, only the command which needs the flash idle calls it
+ *
+ *  \param[in] ptFlash: spiflash handle
+ *  \return error code \ref csi_error_t, the operation stays in flight on CSI_TIMEOUT
+ */
+static csi_error_t apt_sf_wait_ready(csi_spiflash_t *ptFlash)
+{
+	sf_prv_t *ptPrv = (sf_prv_t *)ptFlash->flash_prv_info;
+	csi_error_t tRet;
+
+	if(ptPrv->byState == SF_IDLE)
+		return CSI_OK;
+	tRet = apt_sf_poll_wip(ptFlash, ptPrv->wBusyMs);
+	if(tRet == CSI_OK)
+		ptPrv->byState = SF_IDLE;
+	return tRet;
+}
+
+/** \brief start a write command: wait the flash idle, write enable, send the command
+ *
+ *  \param[in] ptFlash: spiflash handle
+ *  \param[in] byState: \ref sf_state_e of the operation started
+ *  \param[in] wBusyMs: WIP timeout of the operation(ms)
+ *  \param[in] byCmd, wAddr, byAddrSize, pTx, wSize: command as apt_sf_xfer
+ *  \return error code \ref csi_error_t
+ */
+static csi_error_t apt_sf_write_start(csi_spiflash_t *ptFlash, uint8_t byState, uint32_t wBusyMs, uint8_t byCmd, 
+						uint32_t wAddr, uint8_t byAddrSize, const void *pTx, uint32_t wSize)
+{
+	sf_prv_t *ptPrv = (sf_prv_t *)ptFlash->flash_prv_info;
+	csi_error_t tRet;
+
+	tRet = apt_sf_wait_ready(ptFlash);
+	if(tRet == CSI_OK)
+		tRet = apt_sf_write_enable(ptFlash);
+	if(tRet == CSI_OK)
+		tRet = apt_sf_xfer(ptFlash, byCmd, wAddr, byAddrSize, 0, pTx, NULL, wSize);
+	if(tRet == CSI_OK)
+	{
+		ptPrv->byState = byState;
+		ptPrv->wBusyMs = wBusyMs;
+	}
+	return tRet;
+}
+
+/** \brief make flash readable: suspend the sector erase in flight, or wait program done
+ *
+ *  \param[in] ptFlash: spiflash handle
+ *  \param[out] pbSuspend: true: erase suspended, resume it after read
+ *  \return error code \ref csi_error_t
+ */
+static csi_error_t apt_sf_read_begin(csi_spiflash_t *ptFlash, bool *pbSuspend)
+{
+	sf_prv_t *ptPrv = (sf_prv_t *)ptFlash->flash_prv_info;
+	csi_error_t tRet;
+	uint8_t bySr = 0;
+
+	*pbSuspend = false;
+	if((ptPrv->byState == SF_BUSY_ERASE) && ptPrv->bySusCmd)
+	{
+		tRet = apt_sf_read_sr(ptFlash, &bySr);
+		if(tRet != CSI_OK)
+			return tRet;
+	}
+	if(bySr & SF_SR_WIP)
+	{
+		while((csi_tick_get_us() - ptPrv->dwResumeUs) < SPIFLASH_RESUME_US);	//tRS, or back to back reads stall the erase
+		tRet = apt_sf_xfer(ptFlash, ptPrv->bySusCmd, 0, 0, 0, NULL, NULL, 0);
+		if(tRet == CSI_OK)
+			tRet = apt_sf_poll_wip(ptFlash, SPIFLASH_XFER_TIMEOUT);		//tSUS
+		*pbSuspend = (tRet == CSI_OK);
+		return tRet;
+	}
+	return apt_sf_wait_ready(ptFlash);
+}
+
+/** \brief drop cache line overlapping with [wAddr, wAddr + wSize)
+ */
+static void apt_sf_cache_drop(sf_prv_t *ptPrv, uint32_t wAddr, uint32_t wSize)
+{
+	if((ptPrv->wCacheAddr + SPIFLASH_CACHE_LINE > wAddr) && (ptPrv->wCacheAddr < wAddr + wSize))
+		ptPrv->wCacheAddr = SF_CACHE_INVALID;
+}
+
+/** \brief probe geometry from sfdp basic flash parameter table(JESD216)
+ *
+ *  \param[in] ptFlash: spiflash handle
+ *  \param[in] ptPrv: private info to fill
+ *  \return true: sfdp found
+ */
+static bool apt_sf_sfdp_probe(csi_spiflash_t *ptFlash, sf_prv_t *ptPrv)
+{
+	uint8_t byHead[16];
+	uint32_t wDw[SF_SFDP_DW_MAX];
+	uint8_t byDwNum, i;
+	uint32_t wPtr, wVal;
+
+	if(apt_sf_xfer(ptFlash, SF_CMD_RDSFDP, 0, SF_ADDR_SIZE, 1, NULL, byHead, sizeof(byHead)) != CSI_OK)	//header + parameter header 0
+		return false;
+	if(memcmp(byHead, "SFDP", 4) || (byHead[8] != 0x00) || (byHead[15] != 0xff))			//parameter 0 must be BFPT(0xff00)
+		return false;
+
+	byDwNum = byHead[11];
+	if(byDwNum < 9)
+		return false;
+	if(byDwNum > SF_SFDP_DW_MAX)
+		byDwNum = SF_SFDP_DW_MAX;
+	wPtr = byHead[12] | ((uint32_t)byHead[13] << 8) | ((uint32_t)byHead[14] << 16);
+	if(apt_sf_xfer(ptFlash, SF_CMD_RDSFDP, wPtr, SF_ADDR_SIZE, 1, NULL, wDw, (uint32_t)byDwNum << 2) != CSI_OK)	//little endian, same as cpu
+		return false;
+
+	//DW2: density in bits
+	wVal = wDw[1];
+	if(wVal & 0x80000000)
+	{
+		wVal &= 0x7fffffff;											//2^N bits
+		ptPrv->tInfo.flash_size = (wVal >= 27) ? SF_MAX_SIZE : (1ul << (wVal - 3));
+	}
+	else
+		ptPrv->tInfo.flash_size = (wVal + 1) >> 3;					//N + 1 bits
+
+	//DW1: 4k erase; DW8/DW9: erase types, take the smallest one if no 4k erase
+	if((wDw[0] & 0x03) == 0x01)
+	{
+		ptPrv->tInfo.sector_size = 4096;
+		ptPrv->byEraseCmd = (uint8_t)(wDw[0] >> 8);
+	}
+	else
+	{
+		ptPrv->tInfo.sector_size = 0;
+		for(i = 0; i < 4; i++)
+		{
+			wVal = (wDw[7 + (i >> 1)] >> ((i & 1) << 4)) & 0xffff;		//size exponent | cmd << 8
+			if((wVal & 0xff) && ((ptPrv->tInfo.sector_size == 0) || ((1ul << (wVal & 0xff)) < ptPrv->tInfo.sector_size)))
+			{
+				ptPrv->tInfo.sector_size = 1ul << (wVal & 0xff);
+				ptPrv->byEraseCmd = (uint8_t)(wVal >> 8);
+			}
+		}
+		if(ptPrv->tInfo.sector_size == 0)
+			return false;
+	}
+
+	//DW11: page size(JESD216A); DW12/DW13: suspend/resume
+	ptPrv->tInfo.page_size = (byDwNum >= 11) ? (1ul << ((wDw[10] >> 4) & 0x0f)) : 256;
+	if((byDwNum >= 13) && !(wDw[11] & 0x80000000))
+	{
+		ptPrv->bySusCmd = (uint8_t)(wDw[12] >> 24);
+		ptPrv->byResCmd = (uint8_t)(wDw[12] >> 16);
+	}
+
+	return true;
+}
+
+/** \brief probe geometry from jedec id, for flash without sfdp
+ *
+ *  \param[in] ptPrv: private info to fill, flash_id is read
+ *  \return true: capacity code valid
+ */
+static bool apt_sf_jedec_probe(sf_prv_t *ptPrv)
+{
+	uint8_t byCap = (uint8_t)ptPrv->tInfo.flash_id;
+	uint8_t byVendor = (uint8_t)(ptPrv->tInfo.flash_id >> 16);
+
+	if((byCap < 0x10) || (byCap > 0x20))
+		return false;
+
+	ptPrv->tInfo.flash_size = 1ul << byCap;
+	ptPrv->tInfo.sector_size = 4096;
+	ptPrv->tInfo.page_size = 256;
+	ptPrv->byEraseCmd = SF_CMD_SE;
+	if((byVendor == 0xef) || (byVendor == 0xc8))		//winbond, gigadevice
+	{
+		ptPrv->bySusCmd = SF_CMD_SUSPEND;
+		ptPrv->byResCmd = SF_CMD_RESUME;
+	}
+
+	return true;
+}
+
+/** \brief initialize spiflash with spi0 and probe flash device; spi pins are configured by user
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] spi_idx: spi index, only 0
+ *  \param[in] spi_cs_callback: void (*)(csi_gpio_pin_state_e) to drive cs, must not be NULL:
+ *             hardware nss rises between bytes when the tx fifo runs empty, which ends the command
+ *  \return error code \ref csi_error_t, CSI_TIMEOUT: spi stalled
+ */
+csi_error_t csi_spiflash_spi_init(csi_spiflash_t *spiflash, uint32_t spi_idx, void *spi_cs_callback)
+{
+	csi_spi_config_t tSpiCfg;
+	uint8_t byId[3];
+	sf_prv_t *ptPrv = &s_tSfPrv;
+
+	if((spiflash == NULL) || (spi_idx != 0) || (spi_cs_callback == NULL))
+		return CSI_ERROR;
+
+	spiflash->spi_qspi.spi = SPI0;
+	spiflash->spi_cs_callback = (void (*)(csi_gpio_pin_state_e))spi_cs_callback;
+	spiflash->flash_prv_info = ptPrv;
+	spiflash->spi_send = apt_sf_spi_send;
+	spiflash->spi_receive = apt_sf_spi_receive;
+
+	tSpiCfg.bySpiMode = SPI_MASTER;
+	tSpiCfg.bySpiPolarityPhase = SPI_FORMAT_CPOL0_CPHA0;	//flash mode 0
+	tSpiCfg.bySpiFrameLen = SPI_FRAME_LEN_8;
+	tSpiCfg.wSpiBaud = SPIFLASH_SPI_BAUD;
+	tSpiCfg.byInt = SPI_INTSRC_NONE;
+	tSpiCfg.byTxMode = SPI_TX_MODE_POLL;
+	tSpiCfg.byRxMode = SPI_RX_MODE_POLL;
+	tSpiCfg.byTxRxMode = SPI_TX_RX_MODE_POLL;
+	csi_spi_init(SPI0, &tSpiCfg);
+	csi_spi_start(SPI0);
+	apt_sf_cs(spiflash, GPIO_PIN_HIGH);
+
+	memset(ptPrv, 0, sizeof(sf_prv_t));
+	ptPrv->wCacheAddr = SF_CACHE_INVALID;
+
+	if(apt_sf_xfer(spiflash, SF_CMD_RDID, 0, 0, 0, NULL, byId, 3) != CSI_OK)
+		return CSI_TIMEOUT;
+	if(((byId[0] == 0x00) && (byId[1] == 0x00)) || ((byId[0] == 0xff) && (byId[1] == 0xff)))	//no device
+		return CSI_ERROR;
+	ptPrv->tInfo.flash_id = FLASH_ID_BUILD(byId[0], ((uint16_t)byId[1] << 8) | byId[2]);
+	ptPrv->tInfo.flash_name = "spi nor";
+	ptPrv->tInfo.xip_addr = 0;
+
+	if(!apt_sf_sfdp_probe(spiflash, ptPrv) && !apt_sf_jedec_probe(ptPrv))
+		return CSI_ERROR;
+	if(ptPrv->tInfo.flash_size > SF_MAX_SIZE)					//3 bytes address only
+		ptPrv->tInfo.flash_size = SF_MAX_SIZE;
+
+	return CSI_OK;
+}
+
+/** \brief qspi is not available on this chip
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] qspi_idx: qspi index
+ *  \return CSI_UNSUPPORTED
+ */
+csi_error_t csi_spiflash_qspi_init(csi_spiflash_t *spiflash, uint32_t qspi_idx)
+{
+	return CSI_UNSUPPORTED;
+}
+
+/** \brief de-initialize spiflash, wait program/erase in flight
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \return none
+ */
+void csi_spiflash_spi_uninit(csi_spiflash_t *spiflash)
+{
+	if((spiflash == NULL) || (spiflash->flash_prv_info == NULL))
+		return;
+	apt_sf_wait_ready(spiflash);
+	csi_spi_uninit(spiflash->spi_qspi.spi);
+	spiflash->flash_prv_info = NULL;
+	spiflash->spi_send = NULL;
+	spiflash->spi_receive = NULL;
+}
+
+void csi_spiflash_qspi_uninit(csi_spiflash_t *spiflash)
+{
+}
+
+/** \brief get flash device infomation
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[out] flash_info: flash info probed by init
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_spiflash_get_flash_info(csi_spiflash_t *spiflash, csi_spiflash_info_t *flash_info)
+{
+	if((spiflash == NULL) || (spiflash->flash_prv_info == NULL) || (flash_info == NULL))
+		return CSI_ERROR;
+
+	*flash_info = ((sf_prv_t *)spiflash->flash_prv_info)->tInfo;
+	return CSI_OK;
+}
+
+/** \brief read data from flash by fast read; reads shorter than a cache line are served from
+ *         the read-ahead line, a sector erase in flight is suspended during the read
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] offset: flash address
+ *  \param[out] data: data buffer
+ *  \param[in] size: number of data(byte)
+ *  \return the num of data which is read or CSI_ERROR/CSI_TIMEOUT
+ */
+int32_t csi_spiflash_read(csi_spiflash_t *spiflash, uint32_t offset, void *data, uint32_t size)
+{
+	sf_prv_t *ptPrv;
+	uint8_t *pbyData = (uint8_t *)data;
+	uint32_t wRemain = size, wBase, wLen;
+	csi_error_t tRet;
+	bool bSuspend;
+
+	if(spiflash == NULL)
+		return CSI_ERROR;
+	ptPrv = (sf_prv_t *)spiflash->flash_prv_info;
+	if((ptPrv == NULL) || (data == NULL) || (offset + size < offset) || (offset + size > ptPrv->tInfo.flash_size))
+		return CSI_ERROR;
+	if(size == 0)
+		return 0;
+
+	tRet = apt_sf_read_begin(spiflash, &bSuspend);
+	while(wRemain && (tRet == CSI_OK))
+	{
+		wBase = offset & ~(SPIFLASH_CACHE_LINE - 1);
+		if(ptPrv->wCacheAddr == wBase)								//hit
+		{
+			wLen = wBase + SPIFLASH_CACHE_LINE - offset;
+			if(wLen > wRemain)
+				wLen = wRemain;
+			memcpy(pbyData, &ptPrv->byCache[offset - wBase], wLen);
+		}
+		else if(wRemain >= SPIFLASH_CACHE_LINE)						//long read, direct up to the last line boundary
+		{
+			wLen = ((offset + wRemain) & ~(SPIFLASH_CACHE_LINE - 1)) - offset;
+			tRet = apt_sf_xfer(spiflash, SF_CMD_FAST_READ, offset, SF_ADDR_SIZE, 1, NULL, pbyData, wLen);
+		}
+		else														//fill line, next loop hits
+		{
+			tRet = apt_sf_xfer(spiflash, SF_CMD_FAST_READ, wBase, SF_ADDR_SIZE, 1, NULL, ptPrv->byCache, SPIFLASH_CACHE_LINE);
+			if(tRet == CSI_OK)
+				ptPrv->wCacheAddr = wBase;
+			continue;
+		}
+		offset += wLen;
+		pbyData += wLen;
+		wRemain -= wLen;
+	}
+	if(bSuspend)
+	{
+		if(apt_sf_xfer(spiflash, ptPrv->byResCmd, 0, 0, 0, NULL, NULL, 0) != CSI_OK)
+			tRet = CSI_TIMEOUT;
+		ptPrv->dwResumeUs = csi_tick_get_us();
+	}
+
+	return (tRet == CSI_OK) ? (int32_t)size : tRet;
+}
+
+/** \brief program data to flash page by page; each page is started without waiting the
+ *         previous one in software, WIP is only polled before the next page/command, the
+ *         last page is left programming when return(see csi_spiflash_sync)
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] offset: flash address
+ *  \param[in] data: data to program
+ *  \param[in] size: number of data(byte)
+ *  \return the num of data which is programmed or CSI_ERROR/CSI_TIMEOUT
+ */
+int32_t csi_spiflash_program(csi_spiflash_t *spiflash, uint32_t offset, const void *data, uint32_t size)
+{
+	sf_prv_t *ptPrv;
+	const uint8_t *pbyData = (const uint8_t *)data;
+	uint32_t wRemain = size, wLen;
+	csi_error_t tRet;
+
+	if(spiflash == NULL)
+		return CSI_ERROR;
+	ptPrv = (sf_prv_t *)spiflash->flash_prv_info;
+	if((ptPrv == NULL) || (data == NULL) || (offset + size < offset) || (offset + size > ptPrv->tInfo.flash_size))
+		return CSI_ERROR;
+
+	apt_sf_cache_drop(ptPrv, offset, size);
+	while(wRemain)
+	{
+		wLen = ptPrv->tInfo.page_size - (offset & (ptPrv->tInfo.page_size - 1));	//not cross page
+		if(wLen > wRemain)
+			wLen = wRemain;
+
+		tRet = apt_sf_write_start(spiflash, SF_BUSY, SPIFLASH_WIP_TIMEOUT, SF_CMD_PP, offset, SF_ADDR_SIZE, pbyData, wLen);
+		if(tRet != CSI_OK)
+			return tRet;
+
+		offset += wLen;
+		pbyData += wLen;
+		wRemain -= wLen;
+	}
+
+	return (int32_t)size;
+}
+
+/** \brief erase flash sectors, offset aligns to sector_size, size is rounded up to sector;
+ *         the last sector is left erasing when return, reads suspend it when the flash supports
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] offset: flash address, sector aligned
+ *  \param[in] size: erase length, rounded up to sector
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_spiflash_erase(csi_spiflash_t *spiflash, uint32_t offset, uint32_t size)
+{
+	sf_prv_t *ptPrv;
+	uint32_t wSector, wEnd;
+	csi_error_t tRet;
+
+	if((spiflash == NULL) || (spiflash->flash_prv_info == NULL))
+		return CSI_ERROR;
+	ptPrv = (sf_prv_t *)spiflash->flash_prv_info;
+	wSector = ptPrv->tInfo.sector_size;
+	wEnd = (offset + size + wSector - 1) & ~(wSector - 1);
+	if((offset & (wSector - 1)) || (wEnd < offset) || (wEnd > ptPrv->tInfo.flash_size))
+		return CSI_ERROR;
+
+	apt_sf_cache_drop(ptPrv, offset, wEnd - offset);
+	if((offset == 0) && (wEnd == ptPrv->tInfo.flash_size))					//whole chip
+		return apt_sf_write_start(spiflash, SF_BUSY, SPIFLASH_CE_TIMEOUT, SF_CMD_CE, 0, 0, NULL, 0);
+
+	for(; offset < wEnd; offset += wSector)
+	{
+		tRet = apt_sf_write_start(spiflash, SF_BUSY_ERASE, SPIFLASH_WIP_TIMEOUT, ptPrv->byEraseCmd, offset, SF_ADDR_SIZE, NULL, 0);
+		if(tRet != CSI_OK)
+			return tRet;
+	}
+
+	return CSI_OK;
+}
+
+/** \brief wait until the program/erase left running is done
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_spiflash_sync(csi_spiflash_t *spiflash)
+{
+	if((spiflash == NULL) || (spiflash->flash_prv_info == NULL))
+		return CSI_ERROR;
+
+	return apt_sf_wait_ready(spiflash);
+}
+
+/** \brief read flash register, does not wait program/erase in flight
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] cmd_code: read register cmd
+ *  \param[out] data: register value
+ *  \param[in] size: register length(byte)
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_spiflash_read_reg(csi_spiflash_t *spiflash, uint8_t cmd_code, uint8_t *data, uint32_t size)
+{
+	if((spiflash == NULL) || (spiflash->flash_prv_info == NULL) || (data == NULL))
+		return CSI_ERROR;
+
+	return apt_sf_xfer(spiflash, cmd_code, 0, 0, 0, NULL, data, size);
+}
+
+/** \brief write flash register, with write enable
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] cmd_code: write register cmd
+ *  \param[in] data: register value
+ *  \param[in] size: register length(byte)
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_spiflash_write_reg(csi_spiflash_t *spiflash, uint8_t cmd_code, uint8_t *data, uint32_t size)
+{
+	if((spiflash == NULL) || (spiflash->flash_prv_info == NULL))
+		return CSI_ERROR;
+
+	return apt_sf_write_start(spiflash, SF_BUSY, SPIFLASH_WIP_TIMEOUT, cmd_code, 0, 0, data, size);
+}
+
+/** \brief write BP2..BP0 of status register and wait it done
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] byBp: BP bits, SF_SR_BP_MSK or 0
+ *  \return error code \ref csi_error_t
+ */
+static csi_error_t apt_sf_write_bp(csi_spiflash_t *spiflash, uint8_t byBp)
+{
+	csi_error_t tRet;
+	uint8_t bySr;
+
+	tRet = apt_sf_wait_ready(spiflash);
+	if(tRet == CSI_OK)
+		tRet = apt_sf_read_sr(spiflash, &bySr);
+	if(tRet == CSI_OK)
+	{
+		bySr = (bySr & ~SF_SR_BP_MSK) | byBp;
+		tRet = apt_sf_write_start(spiflash, SF_BUSY, SPIFLASH_WIP_TIMEOUT, SF_CMD_WRSR, 0, 0, &bySr, 1);
+	}
+	if(tRet == CSI_OK)
+		tRet = apt_sf_wait_ready(spiflash);
+	return tRet;
+}
+
+/** \brief write protect whole flash(BP2..BP0 all set); protect regions are vendor defined,
+ *         only offset = 0 and size = flash_size supported
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] offset: 0
+ *  \param[in] size: flash size
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_spiflash_lock(csi_spiflash_t *spiflash, uint32_t offset, uint32_t size)
+{
+	if((spiflash == NULL) || (spiflash->flash_prv_info == NULL))
+		return CSI_ERROR;
+	if((offset != 0) || (size != ((sf_prv_t *)spiflash->flash_prv_info)->tInfo.flash_size))
+		return CSI_UNSUPPORTED;
+
+	return apt_sf_write_bp(spiflash, SF_SR_BP_MSK);
+}
+
+/** \brief clear write protect(BP2..BP0), unlocks the whole flash
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] offset: flash address
+ *  \param[in] size: unlock size
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_spiflash_unlock(csi_spiflash_t *spiflash, uint32_t offset, uint32_t size)
+{
+	if((spiflash == NULL) || (spiflash->flash_prv_info == NULL))
+		return CSI_ERROR;
+
+	return apt_sf_write_bp(spiflash, 0);
+}
+
+/** \brief check flash is locked, only whole flash protect is recognized
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] offset: flash address
+ *  \param[in] size: query size
+ *  \return 1: locked, 0: unlocked or partly locked, CSI_ERROR/CSI_TIMEOUT
+ */
+int csi_spiflash_is_locked(csi_spiflash_t *spiflash, uint32_t offset, uint32_t size)
+{
+	csi_error_t tRet;
+	uint8_t bySr;
+
+	if((spiflash == NULL) || (spiflash->flash_prv_info == NULL))
+		return CSI_ERROR;
+
+	tRet = apt_sf_read_sr(spiflash, &bySr);
+	if(tRet != CSI_OK)
+		return tRet;
+	return ((bySr & SF_SR_BP_MSK) == SF_SR_BP_MSK) ? 1 : 0;
+}
+
+/** \brief set data line, spi0 is single line only
+ *
+ *  \param[in] spiflash: spiflash handle
+ *  \param[in] line: SPIFLASH_DATA_1_LINE
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_spiflash_config_data_line(csi_spiflash_t *spiflash, csi_spiflash_data_line_t line)
+{
+	return (line == SPIFLASH_DATA_1_LINE) ? CSI_OK : CSI_UNSUPPORTED;
+}
@@ -0,0 +1,406 @@
+/***********************************************************************//**
+ * \file  stimer.c
+ * \brief  software timer wheel, STIMER_WHEEL_LEVELS levels of (1 << STIMER_WHEEL_BITS) slots;
+ *         level n holds timers due in less than 2^(BITS*(n+1)) ticks and is cascaded one
+ *         slot down each time level n-1 wraps, so start/stop and each tick are O(1)
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <soc.h>
+#include <drv/irq.h>
+#include <drv/stimer.h>
+#include <drv/lat_bench.h>
+
+/* Private macro------------------------------------------------------*/
+#define STIMER_SLOTS		(1u << STIMER_WHEEL_BITS)
+#define STIMER_MASK			(STIMER_SLOTS - 1)
+#define STIMER_RANGE		(1ul << (STIMER_WHEEL_BITS * STIMER_WHEEL_LEVELS))		//max delta in the wheel
+
+#define STIMER_IDLE			0
+#define STIMER_ACTIVE		1			//in a wheel slot
+#define STIMER_FIRED		2			//in the deferred list
+
+/* externs function---------------------------------------------------*/
+/* externs variablesr-------------------------------------------------*/
+/* Private variablesr-------------------------------------------------*/
+static dlist_t s_tStimerWheel[STIMER_WHEEL_LEVELS][STIMER_SLOTS];
+static dlist_t s_tStimerDeferred;
+static uint32_t s_wStimerJiffies = 0;		//next tick to process
+static uint8_t s_byStimerInit = 0;
+
+
+/** \brief init wheel slot heads on first use
+ */
+static void apt_stimer_wheel_init(void)
+{
+	uint8_t i, j;
+
+	for(i = 0; i < STIMER_WHEEL_LEVELS; i++)
+	{
+		for(j = 0; j < STIMER_SLOTS; j++)
+			dlist_init(&s_tStimerWheel[i][j]);
+	}
+	dlist_init(&s_tStimerDeferred);
+	s_byStimerInit = 1;
+}
+
+/** \brief put a timer into the slot of its expiry, interrupt disabled by caller
+ */
+static void apt_stimer_add(csi_stimer_t *ptTimer)
+{
+	uint32_t wExpire = ptTimer->wExpire;
+	uint32_t wDelta = wExpire - s_wStimerJiffies;
+	uint8_t byLvl;
+
+	if((int32_t)wDelta < 0)									//already due, next tick
+		wExpire = s_wStimerJiffies;
+	else if(wDelta >= STIMER_RANGE)							//beyond the wheel, park in the top level
+		wExpire = s_wStimerJiffies + STIMER_RANGE - 1;
+	wDelta = wExpire - s_wStimerJiffies;
+
+	for(byLvl = 0; byLvl < STIMER_WHEEL_LEVELS - 1; byLvl++)
+	{
+		if(wDelta < (1ul << (STIMER_WHEEL_BITS * (byLvl + 1))))
+			break;
+	}
+
+	dlist_add_tail(&ptTimer->tNode, &s_tStimerWheel[byLvl][(wExpire >> (STIMER_WHEEL_BITS * byLvl)) & STIMER_MASK]);
+	ptTimer->byState = STIMER_ACTIVE;
+}
+
+/** \brief move a whole slot list to ptList(O(1)), the slot is left empty
+ */
+static void apt_stimer_take(dlist_t *ptSlot, dlist_t *ptList)
+{
+	if(dlist_empty(ptSlot))
+	{
+		dlist_init(ptList);
+		return;
+	}
+	ptList->next = ptSlot->next;
+	ptList->prev = ptSlot->prev;
+	ptList->next->prev = ptList;
+	ptList->prev->next = ptList;
+	dlist_init(ptSlot);
+}
+
+/** \brief move all timers of a slot one level down(re-add by expiry)
+ *  \return slot index, 0: the level wrapped and the next level has to cascade too
+ */
+static uint8_t apt_stimer_cascade(uint8_t byLvl)
+{
+	uint8_t byIdx = (s_wStimerJiffies >> (STIMER_WHEEL_BITS * byLvl)) & STIMER_MASK;
+	dlist_t tList, *ptNode;
+
+	//take the whole slot, timers re-add to lower levels(or this level if parked)
+	apt_stimer_take(&s_tStimerWheel[byLvl][byIdx], &tList);
+	while(!dlist_empty(&tList))
+	{
+		ptNode = tList.next;
+		dlist_del(ptNode);
+		apt_stimer_add(aos_container_of(ptNode, csi_stimer_t, tNode));
+	}
+
+	return byIdx;
+}
+
+/** \brief init a timer, call once before start
+ *
+ *  \param[in] ptTimer: pointer of timer
+ *  \param[in] callback: expiry callback
+ *  \param[in] pArg: user param of callback
+ *  \param[in] eCtx: callback context, STIMER_CTX_TICK/STIMER_CTX_DEFERRED
+ *  \return none
+ */
+void csi_stimer_init(csi_stimer_t *ptTimer, csi_stimer_cb_t callback, void *pArg, csi_stimer_ctx_e eCtx)
+{
+	uint32_t wIrq = csi_irq_save();
+
+	if(!s_byStimerInit)
+		apt_stimer_wheel_init();
+	csi_irq_restore(wIrq);
+
+	dlist_init(&ptTimer->tNode);
+	ptTimer->callback = callback;
+	ptTimer->pArg = pArg;
+	ptTimer->byCtx = eCtx;
+	ptTimer->wPeriod = 0;
+	ptTimer->byState = STIMER_IDLE;
+}
+
+/** \brief start(or restart) a timer, O(1)
+ *
+ *  \param[in] ptTimer: pointer of timer
+ *  \param[in] wTicks: ticks to first expiry, 0 is taken as 1
+ *  \param[in] wPeriod: reload ticks after expiry, 0: one shot
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_stimer_start(csi_stimer_t *ptTimer, uint32_t wTicks, uint32_t wPeriod)
+{
+	uint32_t wIrq;
+
+	if(ptTimer == NULL || ptTimer->callback == NULL || !s_byStimerInit)
+		return CSI_ERROR;
+
+	wIrq = csi_irq_save();
+	if(ptTimer->byState != STIMER_IDLE)
+		dlist_del(&ptTimer->tNode);
+	ptTimer->wPeriod = wPeriod;
+	ptTimer->wExpire = s_wStimerJiffies + (wTicks ? wTicks : 1) - 1;		//due when that tick is processed
+	apt_stimer_add(ptTimer);
+	csi_irq_restore(wIrq);
+
+	return CSI_OK;
+}
+
+/** \brief stop a timer, O(1)
+ *
+ *  \param[in] ptTimer: pointer of timer
+ *  \return none
+ */
+void csi_stimer_stop(csi_stimer_t *ptTimer)
+{
+	uint32_t wIrq = csi_irq_save();
+
+	if(ptTimer->byState != STIMER_IDLE)
+	{
+		dlist_del(&ptTimer->tNode);
+		dlist_init(&ptTimer->tNode);
+		ptTimer->byState = STIMER_IDLE;
+	}
+	csi_irq_restore(wIrq);
+}
+
+/** \brief timer is running or waiting in the deferred list
+ *
+ *  \param[in] ptTimer: pointer of timer
+ *  \return true/false
+ */
+bool csi_stimer_is_active(csi_stimer_t *ptTimer)
+{
+	return ptTimer->byState != STIMER_IDLE;
+}
+
+/** \brief cascade upper levels when level 0 wraps, interrupt disabled by caller
+ */
+static void apt_stimer_wrap(void)
+{
+	uint8_t byLvl;
+
+	for(byLvl = 1; byLvl < STIMER_WHEEL_LEVELS; byLvl++)
+	{
+		if(apt_stimer_cascade(byLvl) != 0)
+			break;
+	}
+}
+
+/** \brief expire the level 0 slot of s_wStimerJiffies and step to the next tick, interrupt 
+ *         disabled by caller, restored around tick context callbacks
+ *  \return irq state to restore
+ */
+static uint32_t apt_stimer_expire(uint32_t wIrq)
+{
+	dlist_t tList, *ptNode;
+	csi_stimer_t *ptTimer;
+
+	//detach the due slot first: periodic timers may re-add into the same slot index
+	apt_stimer_take(&s_tStimerWheel[0][s_wStimerJiffies & STIMER_MASK], &tList);
+	s_wStimerJiffies++;
+
+	while(!dlist_empty(&tList))
+	{
+		ptNode = tList.next;
+		dlist_del(ptNode);
+		ptTimer = aos_container_of(ptNode, csi_stimer_t, tNode);
+
+		if(ptTimer->byCtx == STIMER_CTX_DEFERRED)
+		{
+			dlist_add_tail(ptNode, &s_tStimerDeferred);
+			ptTimer->byState = STIMER_FIRED;
+			continue;
+		}
+
+		if(ptTimer->wPeriod)
+		{
+			ptTimer->wExpire += ptTimer->wPeriod;
+			apt_stimer_add(ptTimer);
+		}
+		else
+		{
+			dlist_init(ptNode);
+			ptTimer->byState = STIMER_IDLE;
+		}
+
+		csi_irq_restore(wIrq);
+		ptTimer->callback(ptTimer, ptTimer->pArg);
+		wIrq = csi_irq_save();
+	}
+
+	return wIrq;
+}
+
+/** \brief advance the wheel by one tick, called in tick_irqhandler;
+ *         tick context callbacks run here, periodic timers are re-added before their callback
+ *
+ *  \param[in] none
+ *  \return none
+ */
+void csi_stimer_tick(void)
+{
+	uint32_t wIrq;
+
+	if(!s_byStimerInit)
+		return;
+
+	wIrq = csi_irq_save();
+	if((s_wStimerJiffies & STIMER_MASK) == 0)
+		apt_stimer_wrap();
+	wIrq = apt_stimer_expire(wIrq);
+	csi_irq_restore(wIrq);
+}
+
+/** \brief advance the wheel by wTicks ticks at once, after the tick interrupt was suppressed;
+ *         same result as wTicks calls of csi_stimer_tick, empty slots cost one compare
+ *
+ *  \param[in] wTicks: ticks to advance
+ *  \return none
+ */
+void csi_stimer_skip(uint32_t wTicks)
+{
+	uint32_t wIrq;
+
+	if(!s_byStimerInit)
+		return;
+
+	wIrq = csi_irq_save();
+	while(wTicks--)
+	{
+		if((s_wStimerJiffies & STIMER_MASK) == 0)
+			apt_stimer_wrap();
+		if(dlist_empty(&s_tStimerWheel[0][s_wStimerJiffies & STIMER_MASK]))
+			s_wStimerJiffies++;
+		else
+			wIrq = apt_stimer_expire(wIrq);
+	}
+	csi_irq_restore(wIrq);
+}
+
+/** \brief ticks the tick interrupt can be suppressed for: ticks before the next expiry;
+ *         the first occupied slot of each level(in cascade order) holds that level's earliest timers
+ *
+ *  \param[in] none
+ *  \return -1: deferred callbacks waiting, do not sleep; 0: next tick is due; 
+ *          STIMER_IDLE_MAX: no timer running
+ */
+int32_t csi_stimer_idle_ticks(void)
+{
+	uint32_t wIrq, wDelta, wMin = STIMER_IDLE_MAX;
+	uint32_t wJiffies, wHi, wSlot;
+	uint8_t byLvl, byIdx, byOfs, i;
+	dlist_t *ptSlot, *ptNode;
+	csi_stimer_t *ptTimer;
+
+	if(!s_byStimerInit)
+		return STIMER_IDLE_MAX;
+
+	wIrq = csi_irq_save();
+	if(!dlist_empty(&s_tStimerDeferred))
+	{
+		csi_irq_restore(wIrq);
+		return -1;
+	}
+	LAT_CRIT_ENTER(LAT_CRIT_STIMER);
+
+	wJiffies = s_wStimerJiffies;
+	for(i = 0; i < STIMER_SLOTS; i++)							//level 0 is exact, slot offset is the delta
+	{
+		if(!dlist_empty(&s_tStimerWheel[0][(wJiffies + i) & STIMER_MASK]))
+		{
+			wMin = i;
+			break;
+		}
+	}
+
+	for(byLvl = 1; byLvl < STIMER_WHEEL_LEVELS && wMin > 0; byLvl++)
+	{
+		//slot of the current index cascades at this tick if the lower bits are 0, else a round later
+		wHi = wJiffies >> (STIMER_WHEEL_BITS * byLvl);
+		byOfs = (wJiffies & ((1ul << (STIMER_WHEEL_BITS * byLvl)) - 1)) ? 1 : 0;
+		byIdx = (wHi + byOfs) & STIMER_MASK;
+
+		for(i = 0; i < STIMER_SLOTS; i++)
+		{
+			ptSlot = &s_tStimerWheel[byLvl][(byIdx + i) & STIMER_MASK];
+			if(dlist_empty(ptSlot))
+				continue;
+
+			//ticks to the cascade of this slot, bound for timers parked beyond the wheel range
+			wSlot = ((wHi + byOfs + i) << (STIMER_WHEEL_BITS * byLvl)) - wJiffies;
+			for(ptNode = ptSlot->next; ptNode != ptSlot; ptNode = ptNode->next)
+			{
+				ptTimer = aos_container_of(ptNode, csi_stimer_t, tNode);
+				wDelta = ptTimer->wExpire - wJiffies;
+				if((int32_t)wDelta < 0)
+					wDelta = 0;
+				else if(wDelta >= STIMER_RANGE)
+					wDelta = wSlot;
+				if(wDelta < wMin)
+					wMin = wDelta;
+			}
+			break;
+		}
+	}
+	LAT_CRIT_EXIT(LAT_CRIT_STIMER);
+	csi_irq_restore(wIrq);
+
+	return (int32_t)wMin;
+}
+
+/** \brief run callbacks of expired STIMER_CTX_DEFERRED timers, call in main loop;
+ *         periodic timers are re-added here, from their previous expiry(no drift)
+ *
+ *  \param[in] none
+ *  \return number of callbacks run
+ */
+uint32_t csi_stimer_process(void)
+{
+	uint32_t wIrq, wNum = 0;
+	dlist_t *ptNode;
+	csi_stimer_t *ptTimer;
+
+	if(!s_byStimerInit)
+		return 0;
+
+	while(1)
+	{
+		wIrq = csi_irq_save();
+		if(dlist_empty(&s_tStimerDeferred))
+		{
+			csi_irq_restore(wIrq);
+			break;
+		}
+
+		ptNode = s_tStimerDeferred.next;
+		dlist_del(ptNode);
+		ptTimer = aos_container_of(ptNode, csi_stimer_t, tNode);
+		if(ptTimer->wPeriod)
+		{
+			ptTimer->wExpire += ptTimer->wPeriod;
+			apt_stimer_add(ptTimer);
+		}
+		else
+		{
+			dlist_init(ptNode);
+			ptTimer->byState = STIMER_IDLE;
+		}
+		csi_irq_restore(wIrq);
+
+		ptTimer->callback(ptTimer, ptTimer->pArg);
+		wNum++;
+	}
+
+	return wNum;
+}
@@ -12,6 +12,7 @@
 
 #include <string.h>
 #include "csp.h"
+#include <drv/mem_report.h>
 
 extern char _end_rodata[];
 extern char _start_data[];
@@ -20,6 +21,21 @@ extern char _end_data[];
 extern char _bss_start[];
 extern char _ebss[];
 
+//gcc_xxx.ld: heap, then the stack from __heap_end up to __kernel_stack
+extern uint32_t __heap_start[];
+extern uint32_t __heap_end[];
+extern uint32_t __kernel_stack[];
+
+//mm_mallinfo.c(CONFIG_MM_MAX_USED), NULL when mm is not linked
+extern int mm_get_min_freesize(void) __attribute__((weak));
+
+static const csi_mem_map_t s_tMemMap = {
+	.pwHeapStart	= __heap_start,
+	.pwHeapEnd		= __heap_end,
+	.pwStackLimit	= __heap_end,
+	.pwStackTop		= __kernel_stack,
+	.pfnHeapMinFree	= mm_get_min_freesize,
+};
 
 void __main( void ) 
 {
@@ -43,6 +59,9 @@ void __main( void )
     memset( _bss_start, 0x00, ( _ebss - _bss_start ));
   }
 
+  /* stack/heap telemetry(csi_mem_report), after bss is cleared
+   */
+  csi_mem_map_init(&s_tMemMap);
 	
 }
 
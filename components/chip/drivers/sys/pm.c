@@ -12,6 +12,28 @@
 
 #include <drv/pm.h>
 #include <drv/reliability.h>
+#include <drv/irq.h>
+#include <drv/tick.h>
+#include <drv/stimer.h>
+#include <drv/lpt.h>
+#include "csp_lpt.h"
+
+/* Private macro------------------------------------------------------*/
+#define PM_LPT_CNT_MAX		0xffffu
+
+/* Private variablesr-------------------------------------------------*/
+//tickless idle latency table, index: csi_pm_mode_e
+static csi_pm_latency_t s_tPmLatency[PM_MODE_SNOOZE + 1] = {
+	{0, 0, 0},							//PM_MODE_LPRUN, not used
+	PM_SLEEP_LATENCY,
+	PM_DEEPSLEEP_LATENCY,
+	PM_SNOOZE_LATENCY
+};
+
+#if PM_TICKLESS_LPT
+static uint8_t s_byPmLptInit = 0;
+static uint8_t s_byPmLptPsc = 0;
+#endif
 
 #ifdef CONFIG_USER_PM
 /// to make user defined prepaare_to_stop() and wkup_frm_stop() possible
@@ -267,3 +289,188 @@ uint8_t csi_pm_get_wkint(void)
 	return (uint8_t)((ptSysconBase->RISR >> 24) & 0x0f);
 }
 
+/** \brief set latency table entry of a mode for csi_pm_idle
+ * 
+ *  \param[in] eMode: PM_MODE_SLEEP/PM_MODE_DEEPSLEEP/PM_MODE_SNOOZE
+ *  \param[in] ptLatency: entry/exit latency and min residency, unit: us
+ *  \return error code
+ */
+csi_error_t csi_pm_set_latency(csi_pm_mode_e eMode, const csi_pm_latency_t *ptLatency)
+{
+	if(eMode < PM_MODE_SLEEP || eMode > PM_MODE_SNOOZE || ptLatency == NULL)
+		return CSI_ERROR;
+	
+	s_tPmLatency[eMode] = *ptLatency;
+	
+	return CSI_OK;
+}
+
+/** \brief deepest mode up to eMaxMode whose latency and residency fit in the idle time
+ * 
+ *  \param[in] eMaxMode: deepest mode allowed
+ *  \param[in] dwIdleUs: time to the next deadline, unit: us
+ *  \return mode, PM_MODE_LPRUN: too short for any
+ */
+static csi_pm_mode_e apt_pm_select(csi_pm_mode_e eMaxMode, uint64_t dwIdleUs)
+{
+	uint8_t byMode = eMaxMode;
+	const csi_pm_latency_t *ptLat;
+	
+#if !PM_TICKLESS_LPT
+	if(byMode > PM_MODE_SLEEP)
+		byMode = PM_MODE_SLEEP;								//no wakeup timer for deepsleep/snooze
+#endif
+	if(byMode > PM_MODE_SNOOZE)
+		byMode = PM_MODE_SNOOZE;
+	
+	for(; byMode >= PM_MODE_SLEEP; byMode--)
+	{
+		ptLat = &s_tPmLatency[byMode];
+		if(dwIdleUs >= (uint32_t)ptLat->hwEntryUs + ptLat->hwExitUs && dwIdleUs >= ptLat->hwMinResUs)
+			return (csi_pm_mode_e)byMode;
+	}
+	
+	return PM_MODE_LPRUN;
+}
+
+#if PM_TICKLESS_LPT
+/** \brief lpt counts(prescaler applied) to coret cycles
+ */
+static uint64_t apt_pm_lpt_to_cycles(uint64_t dwCnt)
+{
+	return dwCnt * soc_get_coret_freq() / ISOSC_VALUE;
+}
+
+/** \brief start lpt(ISOSC, one pulse) to wake up deepsleep/snooze
+ * 
+ *  \param[in] dwCycles: coret cycles to wakeup
+ *  \return coret cycles programmed, rounded down to lpt counts and clipped to lpt range
+ */
+static uint64_t apt_pm_lpt_arm(uint64_t dwCycles)
+{
+	uint64_t dwCnt = dwCycles * ISOSC_VALUE / soc_get_coret_freq();
+	uint8_t byPsc = 0;
+	
+	if(!s_byPmLptInit)
+	{
+		csi_isosc_enable();
+		csi_pm_clk_enable(DP_ISOSC, ENABLE);					//isosc keeps running in deepsleep
+		csi_pm_config_wakeup_source(WKUP_LPT, ENABLE);
+		csi_clk_enable((uint32_t *)LPT);
+		csp_lpt_clk_enable(LPT, ENABLE);
+		csp_lpt_set_opmd(LPT, LPT_OPM_ONCE);
+		csp_lpt_int_enable(LPT, LPT_PEND_INT, ENABLE);
+		csi_vic_enable_irq(LPT_IRQ_NUM);
+		s_byPmLptInit = 1;
+	}
+	
+	while(byPsc < LPT_PSC_DIV4096 && (dwCnt >> byPsc) > PM_LPT_CNT_MAX)
+		byPsc++;
+	dwCnt >>= byPsc;
+	if(dwCnt > PM_LPT_CNT_MAX)
+		dwCnt = PM_LPT_CNT_MAX;
+	else if(dwCnt == 0)
+		dwCnt = 1;
+	s_byPmLptPsc = byPsc;
+	
+	csp_lpt_set_clk(LPT, LPT_ISCLK, (lpt_pscdiv_e)byPsc);
+	csp_lpt_set_prdr(LPT, (uint16_t)dwCnt);
+	csp_lpt_set_cnt(LPT, 0);
+	csp_lpt_clr_isr(LPT, LPT_PEND_INT);
+	csi_lpt_start(LPT);
+	
+	return apt_pm_lpt_to_cycles(dwCnt << byPsc);
+}
+
+/** \brief stop the lpt wakeup timer, its interrupt is consumed here
+ * 
+ *  \param[in] dwArmed: return of apt_pm_lpt_arm
+ *  \param[in] dwExit: exit latency the lpt was armed early by, counted only when the lpt woke
+ *                     the cpu; on an early wakeup by another interrupt the count already
+ *                     covers the time up to here
+ *  \return coret cycles elapsed since apt_pm_lpt_arm
+ */
+static uint64_t apt_pm_lpt_disarm(uint64_t dwArmed, uint64_t dwExit)
+{
+	uint32_t wPend = csp_lpt_get_risr(LPT) & LPT_PEND_INT;
+	uint16_t hwCnt = csp_lpt_get_cnt(LPT);
+	
+	csi_lpt_stop(LPT);
+	csp_lpt_clr_isr(LPT, LPT_PEND_INT);
+	csi_vic_clear_pending_irq(LPT_IRQ_NUM);
+	
+	if(wPend)
+		return dwArmed + dwExit;
+	
+	return apt_pm_lpt_to_cycles((uint64_t)hwCnt << s_byPmLptPsc);
+}
+#endif
+
+/** \brief tickless idle, call in the main loop after csi_stimer_process; the tick interrupt is
+ *         suppressed until the next stimer expiry, the wakeup timer(coret for sleep, lpt for 
+ *         deepsleep/snooze) fires exit latency early, any other wakeup interrupt ends the idle 
+ *         early; s_wCsiTick, the cycle clock and the stimer wheel are caught up before return.
+ *         interrupts stay masked while sleeping, other wakeup sources need their vic wakeup bit
+ *         (csi_pm_config_wakeup_source/csi_vic_set_wakeup_irq) and are serviced on return
+ * 
+ *  \param[in] eMaxMode: deepest mode allowed, PM_MODE_SLEEP/PM_MODE_DEEPSLEEP/PM_MODE_SNOOZE
+ *  \return mode entered, PM_MODE_LPRUN: not slept(deferred callbacks waiting, tick due or idle too short)
+ */
+csi_pm_mode_e csi_pm_idle(csi_pm_mode_e eMaxMode)
+{
+	uint32_t wIrq, wRemain, wPeriod, wWake;
+	uint64_t dwIdle, dwElapsed, dwExit;
+	int32_t iTicks;
+	csi_pm_mode_e eMode;
+	
+	wIrq = csi_irq_save();
+	iTicks = csi_stimer_idle_ticks();
+	wRemain = csi_coret_get_value();
+	if(iTicks < 0 || wRemain == 0)
+	{
+		csi_irq_restore(wIrq);
+		return PM_MODE_LPRUN;
+	}
+	
+	wPeriod = csi_tick_get_period();
+	dwIdle = wRemain + (uint64_t)iTicks * wPeriod;				//cycles to the tick that has work
+	eMode = apt_pm_select(eMaxMode, csi_tick_cycles_to_us(dwIdle));
+	if(eMode == PM_MODE_LPRUN || (wRemain = csi_tick_stop()) == 0)
+	{
+		csi_irq_restore(wIrq);
+		return PM_MODE_LPRUN;
+	}
+	dwIdle = wRemain + (uint64_t)iTicks * wPeriod;
+	
+	if(eMode == PM_MODE_SLEEP)
+	{
+		//coret keeps running in sleep, its interrupt is the wakeup timer, exit latency ignored
+		csi_tick_arm(dwIdle > CORET_LOAD_RELOAD_Msk + 1U ? CORET_LOAD_RELOAD_Msk + 1U : (uint32_t)dwIdle);
+		wWake = csi_vic_get_wakeup_irq(CORET_IRQ_NUM);
+		csi_vic_set_wakeup_irq(CORET_IRQ_NUM);
+		csi_pm_enter_sleep(PM_MODE_SLEEP);
+		dwElapsed = csi_tick_disarm();
+		if(!wWake)
+			csi_vic_clear_wakeup_irq(CORET_IRQ_NUM);				//user wakeup setting kept
+	}
+	else
+	{
+#if PM_TICKLESS_LPT
+		//coret stops with the cpu clock, lpt measures the sleep
+		dwExit = (uint64_t)s_tPmLatency[eMode].hwExitUs * soc_get_coret_freq() / 1000000U;
+		if(dwExit >= dwIdle)
+			dwExit = 0;
+		dwElapsed = apt_pm_lpt_arm(dwIdle - dwExit);
+		csi_pm_enter_sleep(eMode);
+		dwElapsed = apt_pm_lpt_disarm(dwElapsed, dwExit);
+#else
+		dwElapsed = 0;
+		(void)dwExit;
+#endif
+	}
+	
+	csi_tick_resume(wRemain, dwElapsed);
+	csi_irq_restore(wIrq);
+	
+	return eMode;
+}
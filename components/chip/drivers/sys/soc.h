@@ -66,11 +66,49 @@ extern "C" {
 //UARTx id number
 #define UART_IDX_NUM   		3
 #define UART_RECV_MAX_LEN	128
+#define UART_TX_QUEUE_LEN	4			//interrupt send queue depth(buffers), power of two
 
 //USARTx id number
 #define USART_IDX_NUM   	1
 #define USART_RECV_MAX_LEN	128
 
+//IIC
+#define IIC_XFER_QUEUE_LEN	4			//async master transaction queue depth, power of two
+
+//SPI flash
+#define SPIFLASH_SPI_BAUD	12000000	//spi clock of csi_spiflash_spi_init
+#define SPIFLASH_CACHE_LINE	32			//read-ahead line of csi_spiflash_read(byte), power of two, >= 16
+#define SPIFLASH_XFER_TIMEOUT	10		//ms without a byte moved on spi, or erase suspend(tSUS) not done
+#define SPIFLASH_RESUME_US		100		//us an erase runs after resume before the next suspend(tRS)
+#define SPIFLASH_WIP_TIMEOUT	3000	//ms of page program/sector erase/write status
+#define SPIFLASH_CE_TIMEOUT		400000	//ms of chip erase
+
+//software timer wheel(stimer.c), range = 2^(BITS*LEVELS) ticks
+#define STIMER_WHEEL_BITS	4			//slots per level = 2^BITS
+#define STIMER_WHEEL_LEVELS	5			//16*5 slot heads = 640 bytes, range 2^20 ticks(2.9h at 100Hz)
+
+//tickless idle(csi_pm_idle), latency table defaults {entry, exit, min residency}, unit: us
+//measure on the board and set with csi_pm_set_latency
+#define PM_SLEEP_LATENCY		{2, 5, 20}
+#define PM_DEEPSLEEP_LATENCY	{300, 150, 2000}		//entry includes LPT register sync(ISOSC domain)
+#define PM_SNOOZE_LATENCY		{350, 400, 5000}
+#define PM_TICKLESS_LPT			1			//1: LPT(ISOSC) wakes deepsleep/snooze, reserved for csi_pm_idle; 0: sleep only
+
+//cycle profiler(prof.h), PROF_BEGIN/PROF_END compile in with CONFIG_PROF
+#ifndef PROF_ISR_EN
+#define PROF_ISR_EN				0			//1: ISR duration probes in board/src/interrupt.c
+#endif
+#define PROF_USER_NUM			8			//user probe ids
+#define PROF_HIST_BINS			12			//log2 bins per probe, 2 bytes each
+#define PROF_HIST_SHIFT			4			//bin 0: < 2^(SHIFT+1) cycles
+
+//HWDIV, mode of the "/" "%" runtime functions
+#define HWDIV_MODE_IRQ_LOCK		0			//mask interrupts around each divider access
+#define HWDIV_MODE_SEQ_RETRY	1			//no masking, retry when an isr divided in between
+#ifndef HWDIV_MODE
+#define HWDIV_MODE			HWDIV_MODE_IRQ_LOCK
+#endif
+
 //DMA  id number
 //max channel  number
 #define DMA_IDX_NUM			1
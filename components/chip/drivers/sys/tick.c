@@ -14,6 +14,7 @@
 #include <drv/tick.h>
 #include <drv/pin.h>
 #include <drv/uart.h>
+#include <drv/stimer.h>
 
 /* Private macro------------------------------------------------------*/
 #define __WEAK	__attribute__((weak))
@@ -24,14 +25,92 @@
 /* Private variablesr-------------------------------------------------*/
 
 static volatile uint32_t s_wCsiTick = 0U;
-static volatile uint32_t s_wLastTimeMs = 0U;
-static volatile uint64_t s_dwLastTimeUs = 0U;
+
+//64 bit cycle clock: cycles at the last tick, double buffered and published by one
+//32 bit generation store, readers retry instead of disabling interrupts and never 
+//wait for a preempted tick isr
+static volatile uint64_t s_dwTickCycles[2] = {0U, 0U};
+static volatile uint32_t s_wTickGen = 0U;
+static uint32_t s_wTickPeriod = 0U;						//coret cycles per tick, load + 1
+
+//cycles -> time, time = (cycles * wMul) >> byShift, set in csi_tick_init
+typedef struct {
+	uint32_t	wMul;
+	uint8_t		byShift;
+} tick_cyc_conv_t;
+
+static tick_cyc_conv_t s_tCycToUs = {0, 0};
+static tick_cyc_conv_t s_tCycToMs = {0, 0};
 
 csi_tick_t	g_tCoreTick;
 
+/** \brief advance tick count and cycle clock by one tick
+ */ 
+static inline void apt_tick_advance(void)
+{
+	uint32_t wGen = s_wTickGen;
+	
+	s_dwTickCycles[(wGen + 1) & 0x01] = s_dwTickCycles[wGen & 0x01] + s_wTickPeriod;
+	s_wTickGen = wGen + 1;
+	s_wCsiTick++;
+}
+
+/** \brief advance tick count and cycle clock by wTicks suppressed ticks, interrupt disabled by caller
+ */ 
+static void apt_tick_skip(uint32_t wTicks)
+{
+	uint32_t wGen = s_wTickGen;
+	
+	s_dwTickCycles[(wGen + 1) & 0x01] = s_dwTickCycles[wGen & 0x01] + (uint64_t)wTicks * s_wTickPeriod;
+	s_wTickGen = wGen + 1;
+	s_wCsiTick += wTicks;
+}
+
+/** \brief restart coret, first interrupt after wCycles, then every tick period
+ */ 
+static void apt_tick_restart(uint32_t wCycles)
+{
+	if(wCycles < 2U)
+		wCycles = 2U;
+	
+	CORET->LOAD = wCycles - 1U;
+	CORET->VAL  = 0U;
+	CORET->CTRL = CORET_CTRL_CLKSOURCE_Msk | CORET_CTRL_TICKINT_Msk | CORET_CTRL_ENABLE_Msk;
+	CORET->LOAD = s_wTickPeriod - 1U;						//taken at the next reload
+}
+
+/** \brief precompute cycles -> unit multiplier, largest shift with wMul < 2^32,
+ *         relative error < 2^-31
+ */ 
+static void apt_tick_conv_init(tick_cyc_conv_t *ptConv, uint32_t wUnitHz, uint32_t wFreq)
+{
+	uint8_t byShift = 0;
+	
+	while(byShift < 63 && ((uint64_t)wUnitHz << (byShift + 1)) < ((uint64_t)wFreq << 32))
+		byShift++;
+	
+	ptConv->byShift = byShift;
+	ptConv->wMul = ((uint64_t)wUnitHz << byShift) / wFreq;
+}
+
+/** \brief (dwCycles * wMul) >> byShift, exact 96 bit product by two 32x32 multiplies
+ */ 
+static uint64_t apt_tick_conv(const tick_cyc_conv_t *ptConv, uint64_t dwCycles)
+{
+	uint64_t dwLo = (uint64_t)(uint32_t)dwCycles * ptConv->wMul;
+	uint64_t dwHi = (uint64_t)(uint32_t)(dwCycles >> 32) * ptConv->wMul + (dwLo >> 32);
+	
+	if(ptConv->byShift >= 32)
+		return dwHi >> (ptConv->byShift - 32);
+	else if(ptConv->byShift == 0)
+		return (dwHi << 32) | (uint32_t)dwLo;
+	else
+		return (dwHi << (32 - ptConv->byShift)) | ((uint32_t)dwLo >> ptConv->byShift);
+}
+
 void csi_tick_increase(void)
 {
-    s_wCsiTick++;
+    apt_tick_advance();
 }
 
 /** \brief tick interrupt handle function
@@ -41,9 +120,11 @@ void csi_tick_increase(void)
  */ 
 __attribute__((weak)) void tick_irqhandler(void)
 {
-	s_wCsiTick++;
+	apt_tick_advance();
 	CORET->CTRL;
 	
+	csi_stimer_tick();									//software timer wheel
+	
 	if(g_tCoreTick.callback)
 		g_tCoreTick.callback((void *)s_wCsiTick);		//User callback function 
 }
@@ -56,9 +137,14 @@ __attribute__((weak)) void tick_irqhandler(void)
 csi_error_t csi_tick_init(void)
 {
     s_wCsiTick = 0U;
+    s_dwTickCycles[0] = 0U;
+    s_dwTickCycles[1] = 0U;
 
     csi_vic_set_prio(CORET_IRQ_NUM, 2U);
     csi_coret_config((soc_get_coret_freq()/ CONFIG_SYSTICK_HZ), CORET_IRQ_NUM);
+    s_wTickPeriod = csi_coret_get_load() + 1U;
+    apt_tick_conv_init(&s_tCycToUs, 1000000U, soc_get_coret_freq());
+    apt_tick_conv_init(&s_tCycToMs, 1000U, soc_get_coret_freq());
     csi_vic_enable_irq((uint32_t)CORET_IRQ_NUM);
 	
 	g_tCoreTick.callback = NULL;
@@ -92,25 +178,147 @@ uint32_t csi_tick_get(void)
 {
     return s_wCsiTick;
 }
+/** \brief  get 64 bit coret cycle count since csi_tick_init, monotonic in every context,
+ *         never disables interrupts: a tick isr between the reads changes the generation and
+ *         the snapshot is taken again, a coret wrap whose isr has not run yet(called with irq
+ *         masked, or from an isr entered before the wrap) is added from the pending bit.
+ *         The pending bit clears when the tick isr is entered, so the wrap must be published
+ *         before anything can preempt it: tick_irqhandler publishes first and coret_int_handler
+ *         calls it before interrupts may nest(ck802 clears PSR.IE on entry).
+ * 
+ *  \param[in] none
+ *  \return cycle count
+ */ 
+uint64_t csi_tick_get_cycles64(void)
+{
+	uint32_t wGen, wVal;
+	uint64_t dwBase;
+	
+	do {
+		wGen = s_wTickGen;
+		dwBase = s_dwTickCycles[wGen & 0x01];
+		wVal = csi_coret_get_value();
+		if(csi_vic_get_pending_irq(CORET_IRQ_NUM))
+		{
+			wVal = csi_coret_get_value();
+			dwBase += s_wTickPeriod;
+		}
+	} while(wGen != s_wTickGen);
+	
+	return dwBase + csi_coret_get_load() - wVal;
+}
+/** \brief  coret cycles per tick
+ * 
+ *  \param[in] none
+ *  \return cycles
+ */ 
+uint32_t csi_tick_get_period(void)
+{
+	return s_wTickPeriod;
+}
+/** \brief  stop coret for tickless idle, call with interrupt disabled
+ * 
+ *  \param[in] none
+ *  \return cycles to the next tick, 0: tick interrupt pending(coret keeps running), do not sleep
+ */ 
+uint32_t csi_tick_stop(void)
+{
+	uint32_t wVal;
+	
+	CORET->CTRL = CORET_CTRL_CLKSOURCE_Msk | CORET_CTRL_TICKINT_Msk;
+	wVal = CORET->VAL;
+	if(wVal == 0U || csi_vic_get_pending_irq(CORET_IRQ_NUM))
+	{
+		CORET->CTRL = CORET_CTRL_CLKSOURCE_Msk | CORET_CTRL_TICKINT_Msk | CORET_CTRL_ENABLE_Msk;
+		return 0U;
+	}
+	
+	return wVal;
+}
+/** \brief  run coret as wakeup timer after csi_tick_stop, its interrupt ends a sleep(doze)
+ * 
+ *  \param[in] wCycles: cycles to wakeup, 2 ~ (CORET_LOAD_RELOAD_Msk + 1)
+ *  \return none
+ */ 
+void csi_tick_arm(uint32_t wCycles)
+{
+	CORET->LOAD = wCycles - 1U;
+	CORET->VAL  = 0U;
+	CORET->CTRL = CORET_CTRL_CLKSOURCE_Msk | CORET_CTRL_TICKINT_Msk | CORET_CTRL_ENABLE_Msk;
+}
+/** \brief  stop the coret wakeup timer
+ * 
+ *  \param[in] none
+ *  \return cycles elapsed since csi_tick_arm
+ */ 
+uint32_t csi_tick_disarm(void)
+{
+	uint32_t wLoad = CORET->LOAD;
+	uint32_t wVal;
+	
+	CORET->CTRL = CORET_CTRL_CLKSOURCE_Msk | CORET_CTRL_TICKINT_Msk;
+	wVal = CORET->VAL;
+	if(CORET->CTRL & CORET_CTRL_COUNTFLAG_Msk)				//wakeup reached, counting again from load
+		return wLoad + 1U + (wLoad - wVal);
+	
+	return wLoad - wVal;
+}
+/** \brief  resume tick after tickless idle, call with interrupt disabled; ticks passed except 
+ *         the last one are skipped(count, cycle clock, stimer wheel; no user tick callback), 
+ *         the last one is pended to run tick_irqhandler, coret keeps its phase
+ * 
+ *  \param[in] wRemain: cycles to the next tick, return of csi_tick_stop
+ *  \param[in] dwElapsed: coret cycles the tick was stopped for
+ *  \return none
+ */ 
+void csi_tick_resume(uint32_t wRemain, uint64_t dwElapsed)
+{
+	uint32_t wTicks, wRem;
+	
+	CORET->CTRL;
+	csi_vic_clear_pending_irq(CORET_IRQ_NUM);
+	
+	if(dwElapsed < wRemain)
+	{
+		apt_tick_restart(wRemain - (uint32_t)dwElapsed);
+		return;
+	}
+	
+	dwElapsed -= wRemain;
+	wTicks = (uint32_t)(dwElapsed / s_wTickPeriod);
+	wRem = (uint32_t)dwElapsed - wTicks * s_wTickPeriod;
+	
+	apt_tick_skip(wTicks);
+	csi_stimer_skip(wTicks);
+	apt_tick_restart(s_wTickPeriod - wRem);
+	csi_vic_set_pending_irq(CORET_IRQ_NUM);
+}
+/** \brief  convert coret cycles to us, multiply and shift only
+ * 
+ *  \param[in] dwCycles: cycle count
+ *  \return time, unit: us
+ */ 
+uint64_t csi_tick_cycles_to_us(uint64_t dwCycles)
+{
+	return apt_tick_conv(&s_tCycToUs, dwCycles);
+}
+/** \brief  convert coret cycles to ms, multiply and shift only
+ * 
+ *  \param[in] dwCycles: cycle count
+ *  \return time, unit: ms
+ */ 
+uint64_t csi_tick_cycles_to_ms(uint64_t dwCycles)
+{
+	return apt_tick_conv(&s_tCycToMs, dwCycles);
+}
 /** \brief  get tick count time
  * 
  *  \param[in] none
- *  \return ctick count time,unit: ms 
+ *  \return ctick count time,unit: ms, wraps after 49 days, use csi_tick_get_cycles64 for longer
  */ 
 uint32_t csi_tick_get_ms(void)
 {
-    uint32_t time;
-
-    while (1) {
-        time = (s_wCsiTick * (1000U / CONFIG_SYSTICK_HZ)) + ((csi_coret_get_load() - csi_coret_get_value()) / (soc_get_coret_freq() / 1000U));
-
-        if (time >= s_wLastTimeMs) {
-            break;
-        }
-    }
-
-    s_wLastTimeMs = time;
-    return time;
+    return (uint32_t)apt_tick_conv(&s_tCycToMs, csi_tick_get_cycles64());
 }
 /** \brief  get tick count time
  * 
@@ -119,23 +327,7 @@ uint32_t csi_tick_get_ms(void)
  */ 
 uint64_t csi_tick_get_us(void)
 {
-    uint32_t temp;
-    uint64_t time;
-
-    while (1) {
-        /* the time of coretim pass */
-        temp = csi_coret_get_load() - csi_coret_get_value();
-        time = ((uint64_t)temp * 1000U) / ((uint64_t)soc_get_coret_freq() / 1000U);
-        /* the time of s_wCsiTick */
-        time += ((uint64_t)s_wCsiTick * (1000000U / CONFIG_SYSTICK_HZ));
-
-        if (time >= s_dwLastTimeUs) {
-            break;
-        }
-    }
-
-    s_dwLastTimeUs = time;
-    return time;
+    return apt_tick_conv(&s_tCycToUs, csi_tick_get_cycles64());
 }
 
 static void _500usdelay(void)
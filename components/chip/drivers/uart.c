@@ -107,6 +107,8 @@ csi_error_t csi_uart_init(csp_uart_t *ptUartBase, csi_uart_config_t *ptUartCfg)
 	g_tUartTran[byIdx].bySendMode = ptUartCfg->byTxMode;
 	g_tUartTran[byIdx].byRecvStat = UART_STATE_IDLE;
 	g_tUartTran[byIdx].bySendStat = UART_STATE_IDLE;
+	g_tUartTran[byIdx].byTxIn = 0;
+	g_tUartTran[byIdx].byTxOut = 0;
 	
 	//databits = 8/stopbits = 1; fixed, can not be configured 
 	csp_uart_set_parity(ptUartBase, eParity);							//parity
@@ -128,7 +130,7 @@ csi_error_t csi_uart_init(csp_uart_t *ptUartBase, csi_uart_config_t *ptUartCfg)
 	}
 	else
 	{
-		if((ptUartCfg->byRxMode != UART_RX_MODE_POLL) || (ptUartCfg->byTxMode != UART_TX_MODE_POLL))
+		if(ptUartCfg->byRxMode != UART_RX_MODE_POLL)					//tx interrupt is enabled by csi_uart_send
 			return CSI_ERROR;
 	}
 	
@@ -229,6 +231,27 @@ void csi_uart_set_buffer(csp_uart_t *ptUartBase, ringbuffer_t *ptRingbuf, uint8_
 	ptRingbuf->hwSize = hwLen;						//assignment ringbuf size = hwLen 
 	g_tUartTran[byIdx].ptRingBuf = ptRingbuf;		//UARTx ringbuf assignment	
 	ringbuffer_reset(g_tUartTran[byIdx].ptRingBuf);	//init UARTx ringbuf
+	g_tUartTran[byIdx].ptSpscBuf = NULL;
+}
+/** \brief set uart receive buffer as lock-free spsc ringbuf 
+ * 
+ *  \param[in] ptUartBase: pointer of uart register structure
+ *  \param[in] ptRingbuf: pointer of receive spsc ringbuf structure
+ *  \param[in] pbyRdBuf: pointer of uart receive buffer
+ *  \param[in] hwLen: uart receive buffer length, must be power of two
+ *  \return error code \ref csi_error_t
+ */ 
+csi_error_t csi_uart_set_spsc_buffer(csp_uart_t *ptUartBase, ringbuffer_spsc_t *ptRingbuf, uint8_t *pbyRdBuf, uint16_t hwLen)
+{
+	uint8_t byIdx = apt_get_uart_idx(ptUartBase);
+	
+	if(!ringbuffer_spsc_init(ptRingbuf, pbyRdBuf, hwLen))		//size must be power of two
+		return CSI_ERROR;
+	
+	g_tUartTran[byIdx].ptSpscBuf = ptRingbuf;
+	g_tUartTran[byIdx].ptRingBuf = NULL;
+	
+	return CSI_OK;
 }
 /** \brief uart send character
  * 
@@ -278,27 +301,132 @@ int16_t csi_uart_send(csp_uart_t *ptUartBase, const void *pData, uint16_t hwSize
 			return i;
 			
 		case UART_TX_MODE_INT:						//return CSI_ERROR or CSI_OK
-			if(hwSize == 0 || byIdx >= UART_IDX_NUM) 
+		{
+			csi_uart_trans_t *ptTran = &g_tUartTran[byIdx];
+			uint32_t wIrq;
+			
+			if(byIdx >= UART_IDX_NUM) 
 				return CSI_ERROR;
-				
-			g_tUartTran[byIdx].pbyTxData =(uint8_t *)pData;
-			g_tUartTran[byIdx].hwTxSize = hwSize;
-	
-			if(g_tUartTran[byIdx].bySendStat == UART_STATE_SEND)				//uart sending?
+			
+			wIrq = csi_irq_save();
+			if((uint8_t)(ptTran->byTxIn - ptTran->byTxOut) >= UART_TX_QUEUE_LEN)	//send queue full
+			{
+				csi_irq_restore(wIrq);
 				return CSI_ERROR;
-			else
+			}
+			
+			ptTran->tTxQueue[ptTran->byTxIn & (UART_TX_QUEUE_LEN - 1)].pbyData = pbySend;
+			ptTran->tTxQueue[ptTran->byTxIn & (UART_TX_QUEUE_LEN - 1)].hwSize = hwSize;
+			ptTran->byTxIn ++;
+			
+			if(ptTran->bySendStat != UART_STATE_SEND)							//uart idle, start queue head
 			{
-				g_tUartTran[byIdx].bySendStat = UART_STATE_SEND;				//set uart send status, sending
-				csp_uart_set_data(ptUartBase, *g_tUartTran[byIdx].pbyTxData);	//start uart tx,send first byte
-				
+				ptTran->bySendStat = UART_STATE_SEND;							//set uart send status, sending
+				ptTran->pbyTxData = pbySend;
+				ptTran->hwTxSize = hwSize;
+				csi_uart_send_fifo_fill(ptUartBase);							//preload tx fifo
+				csp_uart_int_enable(ptUartBase, UART_TXFIFO_INT, ENABLE);		//refill on fifo threshold
+				csi_irq_enable((uint32_t *)ptUartBase);
 			}
+			csi_irq_restore(wIrq);
+			
 			return CSI_OK;
+		}
+		default:
+			return CSI_ERROR;
+	}
+}
+
+
+/** \brief send scatter-gather segments as one frame without copying
+ * 
+ *  \param[in] ptUartBase: pointer of uart register structure
+ *  \param[in] ptIov: segment array, segment length <= 0xffff
+ *  \param[in] byIovCnt: segment number
+ *  \return  polling mode: the num of data which is send successfully; 
+ *           interrupt mode: CSI_OK or CSI_ERROR(send queue full)
+ */
+int32_t csi_uart_sendv(csp_uart_t *ptUartBase, const csi_iovec_t *ptIov, uint8_t byIovCnt)
+{
+	uint8_t i, byNum = 0;
+	uint8_t byIdx = apt_get_uart_idx(ptUartBase);
+	int32_t iRet = 0;
+	uint32_t wIrq;
+	
+	if(NULL == ptIov)
+		return CSI_ERROR;
+	
+	for(i = 0; i < byIovCnt; i++)
+	{
+		if(ptIov[i].wLen > 0xffff)
+			return CSI_ERROR;
+		if(ptIov[i].wLen)
+			byNum ++;
+	}
+	
+	switch(g_tUartTran[byIdx].bySendMode)
+	{
+		case UART_TX_MODE_POLL:
+			for(i = 0; i < byIovCnt; i++)
+				iRet += csi_uart_send(ptUartBase, ptIov[i].pBase, (uint16_t)ptIov[i].wLen);
+			return iRet;
+			
+		case UART_TX_MODE_INT:						//queue all segments or none
+			wIrq = csi_irq_save();
+			if((uint8_t)(g_tUartTran[byIdx].byTxIn - g_tUartTran[byIdx].byTxOut) + byNum > UART_TX_QUEUE_LEN)
+				iRet = CSI_ERROR;
+			else
+			{
+				for(i = 0; i < byIovCnt; i++)
+				{
+					if(ptIov[i].wLen)
+						csi_uart_send(ptUartBase, ptIov[i].pBase, (uint16_t)ptIov[i].wLen);
+				}
+				iRet = CSI_OK;
+			}
+			csi_irq_restore(wIrq);
+			return iRet;
 			
 		default:
 			return CSI_ERROR;
 	}
 }
 
+/** \brief fill uart tx fifo from the send queue, call it in uart_irqhandler on TXFIFO interrupt
+ * 
+ *  \param[in] ptUartBase: pointer of uart register structure
+ *  \return  none
+ */
+void csi_uart_send_fifo_fill(csp_uart_t *ptUartBase)
+{
+	csi_uart_trans_t *ptTran = &g_tUartTran[apt_get_uart_idx(ptUartBase)];
+	
+	csp_uart_clr_isr(ptUartBase, UART_TXFIFO_INT_S);
+	
+	if(ptTran->bySendStat != UART_STATE_SEND)								//nothing queued
+	{
+		csp_uart_int_enable(ptUartBase, UART_TXFIFO_INT, DISABLE);
+		return;
+	}
+	
+	while(csp_uart_get_sr(ptUartBase) & UART_TNF)							//tx fifo not full
+	{
+		if(0 == ptTran->hwTxSize)											//head buffer sent, next
+		{
+			ptTran->byTxOut ++;
+			if(ptTran->byTxOut == ptTran->byTxIn)								//send queue empty
+			{
+				csp_uart_int_enable(ptUartBase, UART_TXFIFO_INT, DISABLE);
+				ptTran->bySendStat = UART_STATE_DONE;							//all data in tx fifo
+				return;
+			}
+			ptTran->pbyTxData = (uint8_t *)ptTran->tTxQueue[ptTran->byTxOut & (UART_TX_QUEUE_LEN - 1)].pbyData;
+			ptTran->hwTxSize = ptTran->tTxQueue[ptTran->byTxOut & (UART_TX_QUEUE_LEN - 1)].hwSize;
+		}
+		csp_uart_set_data(ptUartBase, *ptTran->pbyTxData ++);
+		ptTran->hwTxSize --;
+	}
+}
 
 /** \brief send data from uart, this function is interrupt mode(async mode)
  * 
@@ -429,6 +557,18 @@ csi_error_t csi_uart_send_dma(csp_uart_t *ptUartBase, csi_dma_ch_e eDmaCh, const
 	
 	return CSI_OK;
 }
+/** \brief send scatter-gather segments from uart, this function is dma mode
+ * 
+ *  \param[in] ptUartBase: pointer of uart register structure
+ *  \param[in] eDmaCh: channel number of dma, eDmaCh: DMA_CH0` DMA_CH3
+ *  \param[in] ptIov: segment array, segment length <= 0xfff, must stay valid until sent
+ *  \param[in] byIovCnt: segment number
+ *  \return error code \ref csi_error_t
+ */
+csi_error_t csi_uart_sendv_dma(csp_uart_t *ptUartBase, csi_dma_ch_e eDmaCh, const csi_iovec_t *ptIov, uint8_t byIovCnt)
+{
+	return csi_dma_ch_start_sg(DMA, eDmaCh, ptIov, byIovCnt, (void *)&(ptUartBase->DATA));
+}
 /** \brief receive data from uart, this function is dma mode
  * 
  *  \param[in] ptUartBase: pointer of uart register structure
@@ -447,6 +587,135 @@ csi_error_t csi_uart_recv_dma(csp_uart_t *ptUartBase, csi_dma_ch_e eDmaCh, void
 	
 	return CSI_OK;
 }
+/** \brief circular dma receive TCIT(ring wrap) callback
+ * 
+ *  \param[in] ptDmaBase: pointer of dma register structure
+ *  \param[in] eDmaCh: channel number of dma
+ *  \param[in] pArg: pointer of uart register structure
+ *  \return  none
+ */
+static void apt_uart_dma_circ_tcit(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, void *pArg)
+{
+	csi_uart_trans_t *ptTran = &g_tUartTran[apt_get_uart_idx((csp_uart_t *)pArg)];
+	
+	ptTran->wDmaBase += ptTran->ptSpscBuf->wMask + 1;			//dma reloaded, one lap done
+	csi_uart_dma_circ_update((csp_uart_t *)pArg, false);		//at least one publish per ring lap
+}
+/** \brief uart circular dma receive start
+ * 
+ *  \param[in] ptUartBase: pointer of uart register structure
+ *  \param[in] eDmaCh: channel number of dma, eDmaCh: DMA_CH0` DMA_CH3
+ *  \param[in] eEtbCh: channel id number of etb, eEtbCh >= ETB_CH8
+ *  \param[in] ptRingbuf: pointer of receive spsc ringbuf structure
+ *  \param[in] pbyRdBuf: pointer of uart receive buffer
+ *  \param[in] hwLen: uart receive buffer length, power of two and <= 0x800
+ *  \param[in] callback: frame callback, NULL: no frame callback
+ *  \return  error code \ref csi_error_t
+ *  \note    RXTO uses the hwRecvTo set by csi_uart_init, uart_irqhandler must call
+ *           csi_uart_dma_circ_update(ptUartBase, true) on RXTO. The ring must hold the
+ *           longest frame plus the consumer latency, older data is overwritten.
+ */
+csi_error_t csi_uart_recv_dma_circ(csp_uart_t *ptUartBase, csi_dma_ch_e eDmaCh, csi_etb_ch_e eEtbCh, ringbuffer_spsc_t *ptRingbuf, 
+				uint8_t *pbyRdBuf, uint16_t hwLen, csi_uart_frame_cb_t callback)
+{
+	csi_error_t ret;
+	uint8_t byIdx = apt_get_uart_idx(ptUartBase);
+	
+	if((hwLen > 0x800) || !ringbuffer_spsc_init(ptRingbuf, pbyRdBuf, hwLen))	//dma count <= 0xfff, size must be power of two
+		return CSI_ERROR;
+	
+	ret = csi_uart_dma_rx_init(ptUartBase, DMA_RELOAD_ENABLE, eDmaCh, eEtbCh);
+	if(ret < CSI_OK)
+		return ret;
+	
+	g_tUartTran[byIdx].ptSpscBuf = ptRingbuf;
+	g_tUartTran[byIdx].ptRingBuf = NULL;
+	g_tUartTran[byIdx].byRxDmaCh = eDmaCh;
+	g_tUartTran[byIdx].wFrmStart = 0;
+	g_tUartTran[byIdx].wDmaBase = 0;
+	g_tUartTran[byIdx].wRxOverrun = 0;
+	g_tUartTran[byIdx].fnFrameCb = callback;
+	g_tUartTran[byIdx].byRecvMode = UART_RX_MODE_DMA_CIRC;
+	
+	csi_dma_attach_callback(eDmaCh, apt_uart_dma_circ_tcit, (void *)ptUartBase);
+	
+	csp_uart_rto_en(ptUartBase);								//frame end by receive timeout
+	csi_uart_int_enable(ptUartBase, UART_INTSRC_RXTO, ENABLE);
+	
+	return csi_uart_recv_dma(ptUartBase, eDmaCh, pbyRdBuf, hwLen);
+}
+/** \brief publish circular dma receive write index into the spsc ringbuf
+ * 
+ *  \param[in] ptUartBase: pointer of uart register structure
+ *  \param[in] bFrmEnd: true: end current frame and call frame callback
+ *  \return  none
+ *  \note    the write index is the dma position plus the laps counted by TCIT(here when
+ *           it is still pending), so a reader more than one ring behind is seen as
+ *           overrun instead of losing a lap
+ */
+void csi_uart_dma_circ_update(csp_uart_t *ptUartBase, bool bFrmEnd)
+{
+	uint8_t byIdx = apt_get_uart_idx(ptUartBase);
+	csi_uart_trans_t *ptTran = &g_tUartTran[byIdx];
+	ringbuffer_spsc_t *ptRing = ptTran->ptSpscBuf;
+	csp_dma_t *ptDmaChBase;
+	uint32_t wPos, wLen = 0, wIrq, wSize, wTcit, wUsed;
+	
+	if((ptTran->byRecvMode != UART_RX_MODE_DMA_CIRC) || (NULL == ptRing))
+		return;
+	
+	ptDmaChBase = (csp_dma_t *)DMA_REG_BASE(DMA, ptTran->byRxDmaCh);
+	wSize = ptRing->wMask + 1;
+	
+	wIrq = csi_irq_save();										//RXTO, dma TCIT and main loop may all publish
+	wTcit = csp_dma_get_isr(DMA) & (DMA_CH0_TCIT_SR << ptTran->byRxDmaCh);
+	wPos = csp_dma_get_curr_dst(ptDmaChBase);
+	if(!wTcit && (csp_dma_get_isr(DMA) & (DMA_CH0_TCIT_SR << ptTran->byRxDmaCh)))
+	{
+		wTcit = 1;												//wrapped while reading, take the new lap position
+		wPos = csp_dma_get_curr_dst(ptDmaChBase);
+	}
+	if(wTcit)													//lap not counted by the TCIT handler yet, count it here
+	{
+		csp_dma_clr_isr(DMA, (dma_icr_e)(DMA_CH0_IT << ptTran->byRxDmaCh));
+		ptTran->wDmaBase += wSize;
+	}
+	wPos = ptTran->wDmaBase + ((wPos - (uint32_t)ptRing->pbyBuf) & ptRing->wMask);
+	if(wPos - ptRing->wRead > wSize)							//overrun: dma lapped the reader, count the new excess only
+	{
+		wUsed = ringbuffer_spsc_len(ptRing);
+		ptTran->wRxOverrun += wPos - ptRing->wRead - ((wUsed > wSize) ? wUsed : wSize);
+	}
+	ringbuffer_spsc_write_commit(ptRing, wPos - ptRing->wWrite);
+	if(bFrmEnd)
+	{
+		wLen = ptRing->wWrite - ptTran->wFrmStart;
+		if(wLen > wSize)										//only the last lap is in the ring
+			wLen = wSize;
+		ptTran->wFrmStart = ptRing->wWrite;
+	}
+	csi_irq_restore(wIrq);
+	
+	if(wLen && ptTran->fnFrameCb)
+		ptTran->fnFrameCb(ptUartBase, ptRing, wLen);
+}
+/** \brief get and clear the circular dma receive overrun count
+ * 
+ *  \param[in] ptUartBase: pointer of uart register structure
+ *  \return  bytes lost since the last call
+ */
+uint32_t csi_uart_dma_circ_overrun(csp_uart_t *ptUartBase)
+{
+	csi_uart_trans_t *ptTran = &g_tUartTran[apt_get_uart_idx(ptUartBase)];
+	uint32_t wIrq, wLost;
+	
+	wIrq = csi_irq_save();
+	wLost = ptTran->wRxOverrun;
+	ptTran->wRxOverrun = 0;
+	csi_irq_restore(wIrq);
+	
+	return wLost;
+}
 /** \brief receive data from uart, this function is polling(sync).
  * 
  *  \param[in] ptUartBase: pointer of uart register structure
@@ -493,6 +762,13 @@ int16_t csi_uart_receive(csp_uart_t *ptUartBase, void *pData, uint16_t hwSize, u
 			break;
 		case UART_RX_MODE_INT_FIX:			//receive assign length data, handle without wTimeOut
 			
+			if(g_tUartTran[byIdx].ptSpscBuf)	//spsc ringbuffer, read only when assign length arrive
+			{
+				if(hwSize && (ringbuffer_spsc_len(g_tUartTran[byIdx].ptSpscBuf) >= hwSize))
+					hwRecvNum = ringbuffer_spsc_out(g_tUartTran[byIdx].ptSpscBuf, pData, hwSize);
+				break;
+			}
+			
 			//read ringbuffer, multiple processing methods 
 			//allow users to modify 
 			hwRecvNum = ringbuffer_len(g_tUartTran[byIdx].ptRingBuf);
@@ -523,8 +799,28 @@ int16_t csi_uart_receive(csp_uart_t *ptUartBase, void *pData, uint16_t hwSize, u
 //			if(hwRecvNum)
 //				ringbuffer_out(g_tUartTran[byIdx].ptRingBuf, pData, hwRecvNum);
 				
+			break;
+		case UART_RX_MODE_DMA_CIRC:			//circular dma receive, read what has arrived up to hwSize
+			{
+				ringbuffer_spsc_t *ptRing = g_tUartTran[byIdx].ptSpscBuf;
+				uint32_t wIrq;
+				
+				csi_uart_dma_circ_update(ptUartBase, false);
+				wIrq = csi_irq_save();
+				if(ringbuffer_spsc_len(ptRing) > ptRing->wMask + 1)			//overrun(counted by update), drop the oldest
+					ptRing->wRead = ptRing->wWrite - (ptRing->wMask + 1);
+				csi_irq_restore(wIrq);
+				hwRecvNum = ringbuffer_spsc_out(ptRing, pData, hwSize);
+			}
 			break;
 		case UART_RX_MODE_INT_DYN:			//receive dynamic length data, handle without (wTimeOut and hwSize)
+			if(g_tUartTran[byIdx].ptSpscBuf)	//spsc ringbuffer, read all received data
+			{
+				hwRecvNum = ringbuffer_spsc_out(g_tUartTran[byIdx].ptSpscBuf, pData, ringbuffer_spsc_len(g_tUartTran[byIdx].ptSpscBuf));
+				if(hwRecvNum)
+					g_tUartTran[byIdx].byRecvStat = UART_STATE_IDLE;
+				break;
+			}
 			 hwRecvNum = ringbuffer_len(g_tUartTran[byIdx].ptRingBuf);
 			if(hwRecvNum)
 			{
@@ -225,6 +225,27 @@ void csi_usart_set_buffer(csp_usart_t *ptUsartBase, ringbuffer_t *ptRingbuf, uin
 	ptRingbuf->hwSize = hwLen;							//assignment ringbuf size = hwLen 
 	g_tUsartTran[byIdx].ptRingBuf = ptRingbuf;			//UARTx ringbuf assignment	
 	ringbuffer_reset(g_tUsartTran[byIdx].ptRingBuf);	//init UARTx ringbuf
+	g_tUsartTran[byIdx].ptSpscBuf = NULL;
+}
+/** \brief set usart receive buffer as lock-free spsc ringbuf 
+ * 
+ *  \param[in] ptUsartBase: pointer of usart register structure
+ *  \param[in] ptRingbuf: pointer of receive spsc ringbuf structure
+ *  \param[in] pbyRdBuf: pointer of usart receive buffer
+ *  \param[in] hwLen: usart receive buffer length, must be power of two
+ *  \return error code \ref csi_error_t
+ */ 
+csi_error_t csi_usart_set_spsc_buffer(csp_usart_t *ptUsartBase, ringbuffer_spsc_t *ptRingbuf, uint8_t *pbyRdBuf, uint16_t hwLen)
+{
+	uint8_t byIdx = apt_get_usart_idx(ptUsartBase);
+	
+	if(!ringbuffer_spsc_init(ptRingbuf, pbyRdBuf, hwLen))		//size must be power of two
+		return CSI_ERROR;
+	
+	g_tUsartTran[byIdx].ptSpscBuf = ptRingbuf;
+	g_tUsartTran[byIdx].ptRingBuf = NULL;
+	
+	return CSI_OK;
 }
 /** \brief usart send character
  * 
@@ -295,6 +316,33 @@ int16_t csi_usart_send(csp_usart_t *ptUsartBase, const void *pData, uint16_t hwS
 			return CSI_ERROR;
 	}
 }
+/** \brief send scatter-gather segments as one frame without copying, polling mode only
+ * 
+ *  \param[in] ptUsartBase: pointer of usart register structure
+ *  \param[in] ptIov: segment array, segment length <= 0xffff
+ *  \param[in] byIovCnt: segment number
+ *  \return  the num of data which is send successfully or CSI_ERROR/CSI_UNSUPPORTED
+ */
+int32_t csi_usart_sendv(csp_usart_t *ptUsartBase, const csi_iovec_t *ptIov, uint8_t byIovCnt)
+{
+	uint8_t i;
+	int32_t iRet = 0;
+	
+	if(NULL == ptIov)
+		return CSI_ERROR;
+	
+	if(g_tUsartTran[apt_get_usart_idx(ptUsartBase)].bySendMode != USART_TX_MODE_POLL)
+		return CSI_UNSUPPORTED;
+	
+	for(i = 0; i < byIovCnt; i++)
+	{
+		if(ptIov[i].wLen > 0xffff)
+			return CSI_ERROR;
+		iRet += csi_usart_send(ptUsartBase, ptIov[i].pBase, (uint16_t)ptIov[i].wLen);
+	}
+	
+	return iRet;
+}
 /** \brief receive data from usart, this function is polling(sync).
  * 
  *  \param[in] ptUsartBase: pointer of usart register structure
@@ -340,6 +388,13 @@ int32_t csi_usart_receive(csp_usart_t *ptUsartBase, void *pData, uint16_t hwSize
 			break;
 		case USART_RX_MODE_INT_FIX:			//receive assign length data, handle without wTimeOut
 			
+			if(g_tUsartTran[byIdx].ptSpscBuf)	//spsc ringbuffer, read only when assign length arrive
+			{
+				if(hwSize && (ringbuffer_spsc_len(g_tUsartTran[byIdx].ptSpscBuf) >= hwSize))
+					hwRecvNum = ringbuffer_spsc_out(g_tUsartTran[byIdx].ptSpscBuf, pData, hwSize);
+				break;
+			}
+			
 			//read ringbuffer, multiple processing methods 
 			//allow users to modify 
 			hwRecvNum = ringbuffer_len(g_tUsartTran[byIdx].ptRingBuf);
@@ -372,6 +427,13 @@ int32_t csi_usart_receive(csp_usart_t *ptUsartBase, void *pData, uint16_t hwSize
 				
 			break;
 		case USART_RX_MODE_INT_DYN:			//receive dynamic length data, handle without (wTimeOut and hwSize)
+			if(g_tUsartTran[byIdx].ptSpscBuf)	//spsc ringbuffer, read all received data
+			{
+				hwRecvNum = ringbuffer_spsc_out(g_tUsartTran[byIdx].ptSpscBuf, pData, ringbuffer_spsc_len(g_tUsartTran[byIdx].ptSpscBuf));
+				if(hwRecvNum)
+					g_tUsartTran[byIdx].byRecvStat = USART_STATE_IDLE;
+				break;
+			}
 			 hwRecvNum = ringbuffer_len(g_tUsartTran[byIdx].ptRingBuf);
 			if(hwRecvNum)
 			{
@@ -485,6 +547,18 @@ csi_error_t csi_usart_send_dma(csp_usart_t *ptUsartBase, const void *pData, uint
 	
 	return CSI_OK;
 }
+/** \brief send scatter-gather segments from usart, this function is dma transfer
+ * 
+ *  \param[in] ptUsartBase: pointer of usart register structure
+ *  \param[in] ptIov: segment array, segment length <= 0xfff, must stay valid until sent
+ *  \param[in] byDmaCh: channel number of dma, DMA_CH0` DMA_CH3
+ *  \param[in] byIovCnt: segment number
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_usart_sendv_dma(csp_usart_t *ptUsartBase, const csi_iovec_t *ptIov, uint8_t byDmaCh, uint8_t byIovCnt)
+{
+	return csi_dma_ch_start_sg(DMA, (csi_dma_ch_e)byDmaCh, ptIov, byIovCnt, (void *)&(ptUsartBase->THR));
+}
 /** \brief receive data from usart, this function is dma transfer
  * 
  *  \param[in] ptUartBase: pointer of usart register structure
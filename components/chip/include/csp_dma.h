@@ -330,6 +330,11 @@ static inline uint32_t csp_dma_get_crx(csp_dma_t *ptDmaBase)
 	return (uint32_t)(ptDmaBase->CRX);
 }
 
+static inline uint32_t csp_dma_get_curr_dst(csp_dma_t *ptDmaBase)
+{
+	return (uint32_t)(ptDmaBase->CDRX);
+}
+
 static inline uint8_t csp_dma_get_rsrx(csp_dma_t *ptDmaBase)
 {
 	return (uint8_t)(ptDmaBase->RSRX & 0x01);
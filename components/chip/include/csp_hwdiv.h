@@ -29,6 +29,33 @@ typedef struct
 	SIGNED = 0,
 	UNSIGHED
  }csp_hwdiv_mode_e;
+
+/// the quotient/remainder are ready when DIVISOR is written; hwdiv.c accesses the
+/// divider only through these(demo/script/host has a register model of them)
+static inline void csp_hwdiv_set_mode(csp_hwdiv_t *ptHwdivBase, uint32_t wCr)
+{
+	ptHwdivBase->CR = wCr;
+}
+
+static inline void csp_hwdiv_set_dividend(csp_hwdiv_t *ptHwdivBase, uint32_t wDividend)
+{
+	ptHwdivBase->DIVIDEND = wDividend;
+}
+
+static inline void csp_hwdiv_set_divisor(csp_hwdiv_t *ptHwdivBase, uint32_t wDivisor)
+{
+	ptHwdivBase->DIVISOR = wDivisor;
+}
+
+static inline uint32_t csp_hwdiv_get_quotient(csp_hwdiv_t *ptHwdivBase)
+{
+	return ptHwdivBase->QUOTIENT;
+}
+
+static inline uint32_t csp_hwdiv_get_remain(csp_hwdiv_t *ptHwdivBase)
+{
+	return ptHwdivBase->REMAIN;
+}
  
 
 
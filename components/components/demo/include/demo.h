@@ -53,12 +53,15 @@ int etcb_mix_demo(void);
 int uart_char_demo(void);
 int uart_send_demo(void);
 int uart_send_int_demo(void);
+int uart_send_int_bench_demo(void);
 //uart receive
 int uart_receive_demo(void);
 int uart_recv_rx_int_demo(void);
 int uart_recv_rxfifo_int_demo(void);
 int uart_send_dma_demo(void);
+int uart_sendv_dma_demo(void);
 int uart_recv_dma_demo(void);
+int uart_recv_dma_ring_demo(void);
 
 //usart
 int usart_char_demo(void);
@@ -83,6 +86,8 @@ int adc_samp_oneshot_int_demo(void);
 int adc_samp_continuous_int_demo(void);
 //DMA传输
 int adc_samp_continuous_dma_transfer_demo(void);
+int adc_stream_dma_demo(void);
+int adc_stream_ovs_demo(void);
 //TS温度传感器
 float adc_ts_gettemperature_demo(void);
 void adc_ts_init_demo(void);
@@ -132,6 +137,7 @@ void rtc_trgev_demo(void);
 extern void iic_master_demo(void);
 extern void iic_master_slave_demo(void);
 extern void iic_slave_demo(void);
+extern void iic_master_async_demo(void);
 
 //cnta demo
 extern int cnta_timer_demo(void);
@@ -139,6 +145,7 @@ extern int cnta_pwm_demo(void);
 
 //spi demo
 extern int16_t spi_w25q16jvsiq_write_read_demo(void);
+extern int spiflash_log_demo(void);
 extern void spi_master_send_demo(void);
 extern void spi_master_send_int_demo(void);
 extern void spi_slave_receive_int_demo(void);
@@ -147,6 +154,7 @@ extern void spi_master_send_receive_fast_demo(void);
 extern void spi_slave_send_receive_int_demo(void);
 extern void spi_etcb_dma_send(void);
 extern void spi_etcb_dma_send_receive(void); 
+extern void spi_dma_send_receive_demo(void);
 
 //touch demo
 extern void touch_lowpower_demo(void);
@@ -185,6 +193,7 @@ void lp_exi_wakeup_shutdown_demo(void);
 void lp_rtc_wakeup_snooze_demo(void);
 void lp_lpt_wakeup_deepsleep_demo(void);
 void lp_wakeup_demo(void);
+void lp_tickless_idle_demo(void);
 
 //lcd
 int lcd_disp_demo(void);
@@ -206,4 +215,16 @@ void intvref_fvr_output(void);
 // tkey demo
 extern void tkey_demo(void);
 
+//stimer demo
+int stimer_demo(void);
+
+//prof demo
+int prof_demo(void);
+
+//latency demo
+int latency_bench_demo(void);
+
+//hwdiv demo
+int hwdiv_bench_demo(void);
+
 #endif
\ No newline at end of file
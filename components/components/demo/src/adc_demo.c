@@ -14,6 +14,7 @@
 #include <drv/pin.h>
 #include <drv/bt.h>
 #include <drv/dma.h>
+#include <drv/adc_ovs.h>
 #include <iostring.h>
 #include "demo.h"
 
@@ -402,6 +403,202 @@ int adc_samp_continuous_dma_transfer_demo(void)
 	
 	return 0;
 }
+//ADC流模式采样序列配置，8通道，BT0 PEND事件经ETB触发ADC_SYNCIN0，每次触发转换整个序列
+const csi_adc_seq_t tSeqStreamCfg[] =
+{
+	//输入通道		//连续重复采样次数		//平均系数			//触发源选择
+	{ADCIN0,		ADC_CV_COUNT_1,			ADC_AVG_COF_1,		ADCSYNC_IN0},
+	{ADCIN1,		ADC_CV_COUNT_1,			ADC_AVG_COF_1,		ADCSYNC_IN0},
+	{ADCIN2,		ADC_CV_COUNT_1,			ADC_AVG_COF_1,		ADCSYNC_IN0},
+	{ADCIN3,		ADC_CV_COUNT_1,			ADC_AVG_COF_1,		ADCSYNC_IN0},
+	{ADCIN4,		ADC_CV_COUNT_1,			ADC_AVG_COF_1,		ADCSYNC_IN0},
+	{ADCIN5,		ADC_CV_COUNT_1,			ADC_AVG_COF_1,		ADCSYNC_IN0},
+	{ADCIN6,		ADC_CV_COUNT_1,			ADC_AVG_COF_1,		ADCSYNC_IN0},
+	{ADCIN7,		ADC_CV_COUNT_1,			ADC_AVG_COF_1,		ADCSYNC_IN0},
+};
+
+#define ADC_STREAM_CHNL		8								//流模式通道数
+#define ADC_STREAM_SEQ		16								//每半个缓存的序列数
+
+static uint32_t s_wAdcStreamBuf[2 * ADC_STREAM_SEQ * ADC_STREAM_CHNL];	//DMA双半缓存，ADC_DR[]为32位
+static volatile uint16_t s_hwAdcStreamAvg[ADC_STREAM_CHNL];			//各通道最近半缓存的平均值
+static volatile uint32_t s_wAdcStreamCnt = 0;						//已完成的半缓存数
+
+/** \brief ADC流模式半缓存完成回调(DMA中断中调用)，DMA此时正在填充另外半个缓存
+ * 
+ *  \param[in] ptAdcBase: pointer of adc register structure
+ *  \param[in] pwData: 已完成的半缓存
+ *  \param[in] hwSeqNum: 半缓存中的序列数
+ *  \param[in] pArg: 用户参数
+ *  \return none
+ */
+static void adc_stream_half_done(csp_adc_t *ptAdcBase, uint32_t *pwData, uint16_t hwSeqNum, void *pArg)
+{
+	uint8_t i;
+	uint16_t j;
+	uint32_t wSum;
+	
+	for(i = 0; i < ADC_STREAM_CHNL; i++)
+	{
+		wSum = 0;
+		for(j = 0; j < hwSeqNum; j++)
+			wSum += pwData[j * ADC_STREAM_CHNL + i] & 0xfff;		//12bit ADC采样值
+		s_hwAdcStreamAvg[i] = wSum / hwSeqNum;
+	}
+	s_wAdcStreamCnt ++;
+}
+
+/** \brief ADC流模式配置：8通道序列由ADC_SYNCIN0(BT0 PEND经ETB)触发，EOC经ETB_CH8请求DMA_CH0搬运整个序列
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+static int adc_stream_config(void)
+{
+	int iRet = 0;
+	volatile int ch;
+	csi_etb_config_t 	tEtbConfig;	
+	csi_adc_config_t 	tAdcConfig;
+	
+	//adc 输入管脚配置
+	csi_pin_set_mux(PA00, PA00_ADC_AIN0);
+	csi_pin_set_mux(PA01, PA01_ADC_AIN1);
+	csi_pin_set_mux(PA03, PA03_ADC_AIN2);
+	csi_pin_set_mux(PB00, PB00_ADC_AIN3);
+	csi_pin_set_mux(PB01, PB01_ADC_AIN4);
+	csi_pin_set_mux(PB02, PB02_ADC_AIN5);
+	csi_pin_set_mux(PA06, PA06_ADC_AIN6);
+	csi_pin_set_mux(PA07, PA07_ADC_AIN7);
+	
+	//adc 参数配置初始化
+	tAdcConfig.byClkDiv = 0x02;									//ADC clk两分频：clk = pclk/2
+	tAdcConfig.bySampHold = 0x06;								//ADC 采样时间： time = 16 + 6 = 22(ADC clk周期)
+	tAdcConfig.byConvMode = ADC_CONV_ONESHOT;					//ADC 转换模式： 单次转换，由同步触发启动
+	tAdcConfig.byVrefSrc = ADCVERF_VDD_VSS;						//ADC 参考电压： 系统VDD
+	tAdcConfig.wInt = ADC_INTSRC_NONE;							//ADC 中断配置： 无中断
+	tAdcConfig.ptSeqCfg = (csi_adc_seq_t *)tSeqStreamCfg;		//ADC 采样序列： 具体参考结构体变量 tSeqStreamCfg
+	
+	csi_adc_init(ADC0, &tAdcConfig);							//初始化ADC参数配置	
+	csi_adc_set_seqx(ADC0, tAdcConfig.ptSeqCfg, ADC_STREAM_CHNL);	//配置ADC采样序列
+	csi_adc_set_sync(ADC0, ADC_TRG_SYNCEN0, ADC_TRG_CONTINU, 0);	//选择ADC_SYNCEN0同步事件
+	
+	//BT0 PEND -> ETB -> ADC_SYNCIN0
+	csi_etb_init();												//使能ETB模块
+	tEtbConfig.byChType = ETB_ONE_TRG_ONE;  					//单个源触发单个目标
+	tEtbConfig.bySrcIp  = ETB_BT0_TRGOUT;  	    				//BT0 触发输出作为触发源
+	tEtbConfig.byDstIp =  ETB_ADC_SYNCIN0;   	    			//ADC 同步输入0作为目标事件
+	tEtbConfig.byTrgMode = ETB_HARDWARE_TRG;
+	ch = csi_etb_ch_alloc(tEtbConfig.byChType);	    			//自动获取空闲通道号,ch >= 0 获取成功
+	if(ch < 0)
+		return -1;								    			//ch < 0,则获取通道号失败
+	iRet = csi_etb_ch_config(ch, &tEtbConfig);
+	if(iRet < CSI_OK)
+		return CSI_ERROR;
+	
+	//ADC EOC -> ETB_CH8 -> DMA_CH0
+	iRet = csi_adc_stream_init(ADC0, DMA_CH0, ETB_CH8);
+	if(iRet < CSI_OK)
+		return CSI_ERROR;
+	
+	return iRet;
+}
+
+/** \brief ADC流模式：BT0每50us(20kHz)经ETB触发一次8通道序列转换，EOC经ETB请求DMA搬运整个序列
+ *  \brief DMA连续写两个半缓存并自动重载，不丢序列；每个序列一次LTCIT短中断，回调只在每半个缓存(16个序列)完成后一次
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+int adc_stream_dma_demo(void)
+{
+	int iRet = adc_stream_config();
+	
+	if(iRet < CSI_OK)
+		return iRet;
+	
+	csi_adc_start(ADC0);										//启动ADC，等待同步触发
+	csi_adc_stream_start(ADC0, s_wAdcStreamBuf, ADC_STREAM_SEQ, adc_stream_half_done, NULL);
+	
+	csi_bt_timer_init(BT0, 50);									//BT0定时50us，序列采样率20kHz
+	csi_bt_set_evtrg(BT0, BT_TRGOUT, BT_TRGSRC_PEND);			//BT0 PEND事件触发输出
+	csi_bt_start(BT0);											//启动定时器
+	
+	while(s_wAdcStreamCnt < 2000);								//处理2000个半缓存(1.6s)
+	
+	csi_bt_stop(BT0);
+	csi_adc_stream_stop(ADC0);
+	csi_adc_stop(ADC0);
+	
+	return iRet;
+}
+
+#define ADC_OVS_RATIO		64								//过采样倍数，4^3 = 64，增加3bit有效位(15bit)
+
+static csi_adc_ovs_t s_tAdcOvs;										//过采样累加器
+static csi_adc_ovs_result_t s_tAdcOvsOut[(ADC_STREAM_SEQ / ADC_OVS_RATIO + 1) * ADC_STREAM_CHNL];
+static volatile csi_adc_ovs_result_t s_tAdcOvsLast[ADC_STREAM_CHNL];	//各通道最近一次抽取结果
+static volatile uint32_t s_wAdcOvsCnt = 0;							//抽取输出次数
+
+/** \brief 过采样半缓存回调(DMA中断中调用)，一次遍历累加半缓存，满ADC_OVS_RATIO个序列输出一次
+ * 
+ *  \param[in] ptAdcBase: pointer of adc register structure
+ *  \param[in] pwData: 已完成的半缓存
+ *  \param[in] hwSeqNum: 半缓存中的序列数
+ *  \param[in] pArg: 过采样累加器
+ *  \return none
+ */
+static void adc_ovs_half_done(csp_adc_t *ptAdcBase, uint32_t *pwData, uint16_t hwSeqNum, void *pArg)
+{
+	uint8_t i;
+	uint16_t hwOut = csi_adc_ovs_accumulate((csi_adc_ovs_t *)pArg, pwData, hwSeqNum, s_tAdcOvsOut);
+	
+	if(hwOut)
+	{
+		for(i = 0; i < ADC_STREAM_CHNL; i++)
+			s_tAdcOvsLast[i] = s_tAdcOvsOut[(hwOut - 1) * ADC_STREAM_CHNL + i];		//保留最后一次输出
+		s_wAdcOvsCnt += hwOut;
+	}
+}
+
+/** \brief ADC过采样/抽取：在流模式上每通道累加64个采样输出一次15bit结果及min/max/mean
+ *  \brief 序列采样率20kHz，抽取后输出率 20kHz/64 = 312.5Hz
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+int adc_stream_ovs_demo(void)
+{
+	uint32_t wPrintCnt = 0;
+	int iRet = adc_stream_config();
+	
+	if(iRet < CSI_OK)
+		return iRet;
+	
+	csi_adc_ovs_init(&s_tAdcOvs, ADC_STREAM_CHNL, ADC_OVS_RATIO);	//8通道，64倍过采样
+	
+	csi_adc_start(ADC0);										//启动ADC，等待同步触发
+	csi_adc_stream_start(ADC0, s_wAdcStreamBuf, ADC_STREAM_SEQ, adc_ovs_half_done, &s_tAdcOvs);
+	
+	csi_bt_timer_init(BT0, 50);									//BT0定时50us，序列采样率20kHz
+	csi_bt_set_evtrg(BT0, BT_TRGOUT, BT_TRGSRC_PEND);			//BT0 PEND事件触发输出
+	csi_bt_start(BT0);											//启动定时器
+	
+	while(s_wAdcOvsCnt < 1000)									//输出1000次(3.2s)
+	{
+		if(s_wAdcOvsCnt >= wPrintCnt)							//每100次输出打印一次通道0
+		{
+			wPrintCnt += 100;
+			my_printf("ch0: %d min: %d max: %d\n", s_tAdcOvsLast[0].wValue, s_tAdcOvsLast[0].hwMin, s_tAdcOvsLast[0].hwMax);
+		}
+	}
+	
+	csi_bt_stop(BT0);
+	csi_adc_stream_stop(ADC0);
+	csi_adc_stop(ADC0);
+	
+	return iRet;
+}
+
 /** \brief bt interrupt handle function,使用时把函数的weak属性注释掉，bt的demo中也有weak属性的bt_irqhandler函数
  * 
  *  \param[in] ptBtBase: pointer of bt register structure
@@ -0,0 +1,95 @@
+/***********************************************************************//**
+ * \file  hwdiv_demo.c
+ * \brief  hardware divider cycle bench demo
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author  <th>Description
+ * </table>
+ * *********************************************************************
+*/
+/* Includes ---------------------------------------------------------------*/
+#include <soc.h>
+#include <sys_clk.h>
+#include <drv/hwdiv.h>
+#include <drv/tick.h>
+#include <iostring.h>
+
+#include "demo.h"
+/* externs function--------------------------------------------------------*/
+/* externs variablesr------------------------------------------------------*/
+/* Private macro-----------------------------------------------------------*/
+#define HWDIV_BENCH_N			256						//每项的除法次数，2的幂，结果用移位求平均
+
+typedef enum {
+	HWDIV_BENCH_LOOP = 0,								//空循环，作为开销扣除
+	HWDIV_BENCH_UDIV,									// "/" 无符号, __udivsi3
+	HWDIV_BENCH_SDIV,									// "/" 有符号, __divsi3
+	HWDIV_BENCH_CALC,									//商和余数一次访问, csi_hwdiv_unsigned_calc
+	HWDIV_BENCH_RECIP,									//预计算倒数, csi_hwdiv_recip_div
+	HWDIV_BENCH_UDIV64,									//64/32, __udivdi3
+	HWDIV_BENCH_NUM
+} hwdiv_bench_e;
+
+/* Private variablesr------------------------------------------------------*/
+static const char * const s_pHwdivBenchName[HWDIV_BENCH_NUM] = {
+	"loop", "udiv", "sdiv", "calc", "recip", "udiv64"
+};
+
+volatile uint32_t g_wHwdivBench[HWDIV_BENCH_NUM];		//每项HWDIV_BENCH_N次的coret周期，已扣除空循环，调试器可直接查看
+static volatile uint32_t s_wHwdivSink;
+
+/** \brief 运行一项，返回HWDIV_BENCH_N次的coret周期
+ */
+static uint32_t hwdiv_bench_run(hwdiv_bench_e eItem, const volatile uint32_t *pwOp, const hwdiv_recip_t *ptRecip)
+{
+	uint64_t dwStart;
+	uint32_t i, wAcc = 0;
+
+	dwStart = csi_tick_get_cycles64();
+	for(i = 0; i < HWDIV_BENCH_N; i++)
+	{
+		switch(eItem)
+		{
+			case HWDIV_BENCH_UDIV:	wAcc += pwOp[0] / pwOp[1]; break;
+			case HWDIV_BENCH_SDIV:	wAcc += (int32_t)pwOp[2] / (int32_t)pwOp[1]; break;
+			case HWDIV_BENCH_CALC:	wAcc += csi_hwdiv_unsigned_calc(pwOp[0], pwOp[1]).wRem; break;
+			case HWDIV_BENCH_RECIP:	wAcc += csi_hwdiv_recip_div(ptRecip, pwOp[0]); break;
+			case HWDIV_BENCH_UDIV64: wAcc += (uint32_t)((((uint64_t)pwOp[0] << 24) | pwOp[2]) / pwOp[1]); break;
+			default:				wAcc += pwOp[0]; break;
+		}
+	}
+	s_wHwdivSink = wAcc;
+
+	return (uint32_t)(csi_tick_get_cycles64() - dwStart);
+}
+
+/** \brief hwdiv bench demo：在芯片上测量各种除法的平均周期(coret时钟)，
+ *         "/" "%"的结果随soc.h中HWDIV_MODE变化(IRQ_LOCK: 关中断，SEQ_RETRY: 不关中断，被中断打断时重算)，
+ *         分别以两种模式编译运行即可对比；正确性检查见demo/script/hwdiv_host.c
+ *
+ *  \param[in] none
+ *  \return error code
+ */
+int hwdiv_bench_demo(void)
+{
+	volatile uint32_t wOp[3] = {0x12345678, 1000003, (uint32_t)-98765432};	//volatile: 防止编译期算出结果
+	hwdiv_recip_t tRecip;
+	uint32_t wLoop, wCyc;
+	uint8_t i;
+
+	csi_hwdiv_recip_init(&tRecip, wOp[1]);
+
+	my_printf("hwdiv bench, HWDIV_MODE %s, coret %d Hz, cycles per %d:\r\n",
+		(HWDIV_MODE == HWDIV_MODE_SEQ_RETRY) ? "SEQ_RETRY" : "IRQ_LOCK", soc_get_coret_freq(), HWDIV_BENCH_N);
+
+	wLoop = hwdiv_bench_run(HWDIV_BENCH_LOOP, wOp, &tRecip);
+	g_wHwdivBench[HWDIV_BENCH_LOOP] = wLoop;
+	for(i = HWDIV_BENCH_UDIV; i < HWDIV_BENCH_NUM; i++)
+	{
+		wCyc = hwdiv_bench_run((hwdiv_bench_e)i, wOp, &tRecip);
+		g_wHwdivBench[i] = (wCyc > wLoop) ? (wCyc - wLoop) : 0;
+		my_printf("%s: %d\r\n", s_pHwdivBenchName[i], g_wHwdivBench[i]);
+	}
+
+	return 0;
+}
@@ -84,6 +84,66 @@ void iic_master_slave_demo(void)
 		
 	}
 }
+/**************************************************
+*	主机异步传输: 事务排队, 由IIC中断驱动FIFO, 传输期间CPU不参与
+*	需要在IIC中断里调用 i2c_irqhandler(I2C0) 函数
+***************************************************/
+static volatile uint8_t s_byIicAsyncDone = 0;
+
+static void iic_async_done(csi_iic_xfer_t *ptXfer, csi_iic_event_e eEvent)
+{
+	if(eEvent != IIC_EVENT_ERROR)
+		s_byIicAsyncDone++;					//中断中调用, 此时下一个事务已经开始
+}
+
+void iic_master_async_demo(void)
+{
+	static uint8_t byTemp[2];
+	static uint8_t byAccel[6];
+	static csi_iic_xfer_t tXfer[2];
+	
+	csi_pin_output_mode(PA07,GPIO_OPEN_DRAIN);
+	csi_pin_output_mode(PA08,GPIO_OPEN_DRAIN);
+	csi_pin_set_mux(PA07,PA07_I2C0_SCL);//PIN2 ->	I2C_SCL
+	csi_pin_set_mux(PA08,PA08_I2C0_SDA);//PIN3 -> 	I2C_SDA
+	
+	g_tIicMasterCfg.byAddrMode = IIC_ADDRESS_7BIT;			//设置主机地址模式 7/10 bit
+	g_tIicMasterCfg.byReStart = ENABLE;						//使能重复起始位
+	g_tIicMasterCfg.bySpeedMode = IIC_BUS_SPEED_STANDARD;	//100kHz
+	g_tIicMasterCfg.hwInt = IIC_INTSRC_NONE;				//中断由异步传输控制
+	g_tIicMasterCfg.wSdaTimeout = 0XFFFF;					//SDA 超时时间设置
+	g_tIicMasterCfg.wSclTimeout = 0XFFFF;					//SCL 超时时间设置
+	csi_iic_master_init(I2C0,&g_tIicMasterCfg);				//主机初始化
+	
+	//传感器1: 温度寄存器0x00读2字节
+	tXfer[0].hwDevAddr = 0x90;
+	tXfer[0].byRead = 1;
+	tXfer[0].byRegLen = 1;
+	tXfer[0].wReg = 0x00;
+	tXfer[0].pbyBuf = byTemp;
+	tXfer[0].hwLen = sizeof(byTemp);
+	tXfer[0].callback = iic_async_done;
+	tXfer[0].pArg = NULL;
+	
+	//传感器2: 加速度寄存器0x28读6字节
+	tXfer[1] = tXfer[0];
+	tXfer[1].hwDevAddr = 0x32;
+	tXfer[1].wReg = 0x28 | 0x80;
+	tXfer[1].pbyBuf = byAccel;
+	tXfer[1].hwLen = sizeof(byAccel);
+	
+	while(1)
+	{
+		csi_iic_master_xfer_async(I2C0, &tXfer[0]);			//两个事务连续传输
+		csi_iic_master_xfer_async(I2C0, &tXfer[1]);
+		
+		//...主循环其他任务
+		
+		while(csi_iic_master_xfer_pending(I2C0));
+		mdelay(10);
+	}
+}
+
 /**************************************************
 *	作为从机时需要在IIC中断里调用 i2c_irqhandler(I2C0) 函数；
 * 	如下：
@@ -120,6 +180,8 @@ void iic_slave_demo(void)
  */
 __attribute__((weak)) void i2c_irqhandler(csp_i2c_t *ptIicBase)
 {
+	if(csi_iic_master_async_irq(ptIicBase))		//主机异步传输
+		return;
 	
 	csi_iic_slave_receive_send(ptIicBase);
 	
@@ -0,0 +1,178 @@
+/***********************************************************************//**
+ * \file  latency_demo.c
+ * \brief  interrupt latency/jitter harness demo
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author  <th>Description
+ * </table>
+ * *********************************************************************
+*/
+/* Includes ---------------------------------------------------------------*/
+#include <sys_clk.h>
+#include <drv/bt.h>
+#include <drv/crc.h>
+#include <drv/ifc.h>
+#include <drv/tick.h>
+#include <drv/lat_bench.h>
+#include <iostring.h>
+
+#include "demo.h"
+#include "board_config.h"
+#include "sys_console.h"
+/* externs function--------------------------------------------------------*/
+/* externs variablesr------------------------------------------------------*/
+/* Private macro-----------------------------------------------------------*/
+#define LAT_BENCH_PERIOD_US		100						//BT1中断周期
+#define LAT_BENCH_SAMPLES		2000					//每种负载的采样次数
+#define LAT_BENCH_LIMIT			0						//最大允许延迟(pclk周期)，0: 不判定
+#define LAT_BENCH_CRIT_LIMIT	0						//最长关中断时间(coret周期)，0: 不判定
+#define LAT_BENCH_FLASH_ADDR	(DFLASHLIMIT - DFLASH_PAGE_SZ * 4)	//flash负载使用dflash最后一页(DFLASH_PAGE_SZ: word)
+
+typedef enum {
+	LAT_LOAD_IDLE = 0,
+	LAT_LOAD_PRINTF,
+	LAT_LOAD_CRC,
+	LAT_LOAD_DIV,
+	LAT_LOAD_FLASH,
+	LAT_LOAD_NUM
+} lat_load_e;
+
+/* Private variablesr------------------------------------------------------*/
+static const char * const s_pLatLoadName[LAT_LOAD_NUM] = {
+	"idle", "printf", "crc", "div", "flash"
+};
+
+static lat_hist_t s_tLatHist;
+static volatile uint8_t s_byLatRun = 0;
+static volatile uint32_t s_wLatSamples = 0;			//isr写，主循环读
+static uint8_t s_byLatBuf[64];
+
+static void lat_bench_putc(char c)
+{
+	if(c == '\n')
+		csi_uart_putc(g_tConsole.uart, '\r');
+	csi_uart_putc(g_tConsole.uart, c);
+}
+
+#ifdef CONFIG_LAT_CRIT_HOOK
+/** \brief 关中断区段计时的时间戳，coret周期，不能使用除法
+ */
+uint32_t lat_port_cycles(void)
+{
+	return (uint32_t)csi_tick_get_cycles64();
+}
+
+/** \brief 关中断区段统计的状态保护
+ */
+uint32_t lat_port_irq_save(void)
+{
+	return csi_irq_save();
+}
+
+void lat_port_irq_restore(uint32_t wState)
+{
+	csi_irq_restore(wState);
+}
+#endif
+
+/** \brief BT1中断，interrupt.c中LAT_BENCH_EN = 1时调用
+ * 		   PEND时计数器从0重新计数，进入中断后立即读计数器即为中断延迟(BT时钟)
+ *
+ *  \param[in] ptBtBase: pointer of bt register structure
+ *  \return none
+ */
+void lat_bench_bt_irqhandler(csp_bt_t *ptBtBase)
+{
+	uint32_t wCnt = csp_bt_get_cnt(ptBtBase);				//尽早读取
+
+	csp_bt_clr_isr(ptBtBase, BT_PEND_INT);
+	if(s_byLatRun && s_wLatSamples < LAT_BENCH_SAMPLES)
+	{
+		lat_hist_add(&s_tLatHist, wCnt * (csp_bt_get_pscr(ptBtBase) + 1));
+		s_wLatSamples++;
+	}
+}
+
+/** \brief 执行一次背景负载
+ */
+static void lat_bench_load(lat_load_e eLoad, uint32_t wLoop)
+{
+	volatile uint32_t wDiv = 0x7fffffff;
+	uint32_t i, wData[DFLASH_PAGE_SZ];
+
+	switch(eLoad)
+	{
+		case LAT_LOAD_PRINTF:								//串口查询发送
+			my_printf("latency load %d\r\n", wLoop);
+			break;
+		case LAT_LOAD_CRC:
+			csi_crc16_ccitt(0, s_byLatBuf, sizeof(s_byLatBuf));
+			break;
+		case LAT_LOAD_DIV:									//HWDIV_MODE_IRQ_LOCK时除法关中断
+			for(i = 1; i < 32; i++)
+				wDiv = wDiv / i + wDiv % i;
+			break;
+		case LAT_LOAD_FLASH:								//编程期间不能读取flash，会延长中断响应；注意擦写寿命
+			for(i = 0; i < DFLASH_PAGE_SZ; i++)
+				wData[i] = wLoop + i;
+			csi_ifc_dflash_page_program(IFC, LAT_BENCH_FLASH_ADDR, wData, DFLASH_PAGE_SZ);
+			break;
+		case LAT_LOAD_IDLE:
+		default:
+			break;
+	}
+}
+
+/** \brief 中断延迟/抖动测试：BT1周期中断，进入中断时读取计数器得到延迟，
+ * 		   依次在不同背景负载(空闲/printf/CRC/除法/flash编程)下统计log2直方图并打印
+ * 		   - board_config.h中LAT_BENCH_EN = 1，BT1中断交给本测试
+ * 		   - 工程中定义CONFIG_LAT_CRIT_HOOK时同时统计hwdiv/stimer空闲扫描/spi发送等关中断区段的最长时间
+ * 		   - 每种负载一行"LAT <load> ... PASS|FAIL"，便于脚本判定
+ *
+ *  \param[in] none
+ *  \return error code
+ */
+int latency_bench_demo(void)
+{
+	int iRet = 0;
+#if	LAT_BENCH_EN
+	uint32_t i, wLoop;
+
+	for(i = 0; i < sizeof(s_byLatBuf); i++)
+		s_byLatBuf[i] = (uint8_t)i;
+	csi_crc_init();
+
+	csi_bt_timer_init(BT1, LAT_BENCH_PERIOD_US);			//PEND中断
+	csp_bt_set_pscr(BT1, 0);								//不分频，计数器分辨率为1个pclk
+	csp_bt_set_prdr(BT1, (uint16_t)(csi_get_pclk_freq() / 1000000 * LAT_BENCH_PERIOD_US));
+
+	lat_report_init(lat_bench_putc, "pclk");
+	for(i = 0; i < LAT_LOAD_NUM; i++)
+	{
+		lat_hist_reset(&s_tLatHist);
+		s_wLatSamples = 0;
+#ifdef CONFIG_LAT_CRIT_HOOK
+		lat_crit_reset();
+#endif
+		s_byLatRun = 1;
+		csi_bt_start(BT1);
+
+		wLoop = 0;
+		while(s_wLatSamples < LAT_BENCH_SAMPLES)
+			lat_bench_load((lat_load_e)i, wLoop++);
+
+		csi_bt_stop(BT1);
+		s_byLatRun = 0;
+
+		if(lat_report(s_pLatLoadName[i], &s_tLatHist, LAT_BENCH_LIMIT) < 0)
+			iRet = -1;
+#ifdef CONFIG_LAT_CRIT_HOOK
+		lat_report_init(lat_bench_putc, "coret");
+		if(lat_crit_report(LAT_BENCH_CRIT_LIMIT) < 0)
+			iRet = -1;
+		lat_report_init(lat_bench_putc, "pclk");
+#endif
+	}
+#endif
+	return iRet;
+}
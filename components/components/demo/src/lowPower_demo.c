@@ -17,6 +17,7 @@
 #include <drv/irq.h>
 #include <drv/iwdt.h>
 #include <drv/tick.h>
+#include <drv/stimer.h>
 #include <drv/common.h> 
 #include <drv/reliability.h>
 
@@ -585,3 +586,32 @@ void lp_shutdown_sram1_demo(void)
 		mdelay(100);
 	}
 }
+
+static void tickless_led_cb(csi_stimer_t *ptTimer, void *pArg)
+{
+	csi_pin_toggle(PA05);											//主循环上下文执行
+}
+
+/** \brief tickless idle示例：无定时器到期时关闭tick中断，按下一个软件定时器到期时间和
+ * 		   延迟表选择sleep/deepsleep，deepsleep由LPT唤醒，唤醒后补齐tick计数
+ * 
+ *  \param  none
+ *  \return none
+ */
+void lp_tickless_idle_demo(void)
+{
+	static csi_stimer_t s_tLedTimer;
+	csi_pm_mode_e ePmMode;
+	
+	csi_pin_set_mux(PA05,PA05_OUTPUT);								//PA05 OUTPUT
+	
+	csi_stimer_init(&s_tLedTimer, tickless_led_cb, NULL, STIMER_CTX_DEFERRED);
+	csi_stimer_start(&s_tLedTimer, CSI_STIMER_MS(1000), CSI_STIMER_MS(1000));	//1s周期
+	
+	while(1) 
+	{
+		csi_stimer_process();										//先执行到期的定时器回调
+		ePmMode = csi_pm_idle(PM_MODE_DEEPSLEEP);					//最深允许deepsleep，1s内只唤醒一次
+		(void)ePmMode;
+	}
+}
@@ -0,0 +1,56 @@
+/***********************************************************************//** 
+ * \file  prof_demo.c
+ * \brief  cycle profiler demo
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author  <th>Description
+ * </table>
+ * *********************************************************************
+*/
+/* Includes ---------------------------------------------------------------*/
+#include <string.h>
+#include <drv/prof.h>
+#include <drv/tick.h>
+
+#include "demo.h"
+#include "sys_console.h"
+/* externs function--------------------------------------------------------*/
+/* externs variablesr------------------------------------------------------*/
+/* Private macro-----------------------------------------------------------*/
+#define PROF_ID_MEMCPY		(PROF_ID_USER + 0)
+#define PROF_ID_MEMSET		(PROF_ID_USER + 1)
+
+/* Private variablesr------------------------------------------------------*/
+static uint8_t s_byProfBuf[2][128];
+
+/** \brief prof demo：测量代码段的执行周期，统计最小/最大/次数和log2直方图，
+ *         通过串口以二进制格式输出，PC端用demo/script/prof_decode.py解析
+ *         需要在工程设置compiler tab下加入define CONFIG_PROF; soc.h中PROF_ISR_EN=1时同时统计各中断的执行时间
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+int prof_demo(void)
+{
+	int iRet = 0;
+#ifdef CONFIG_PROF
+	uint32_t i;
+	
+	csi_prof_init();										//清除统计，校准探针本身的开销
+	
+	for(i = 0; i < 1000; i++)
+	{
+		PROF_BEGIN(PROF_ID_MEMCPY);
+		memcpy(s_byProfBuf[0], s_byProfBuf[1], (i & 0x7f) + 1);
+		PROF_END(PROF_ID_MEMCPY);
+		
+		PROF_BEGIN(PROF_ID_MEMSET);
+		memset(s_byProfBuf[1], i, 128);
+		PROF_END(PROF_ID_MEMSET);
+	}
+	
+	mdelay(10);
+	csi_prof_dump(g_tConsole.uart);							//二进制输出到console串口
+#endif
+	return iRet;
+}
@@ -21,6 +21,7 @@
 
 /* include ----------------------------------------------------------------*/
 #include "spi.h"
+#include "spiflash.h"
 #include "pin.h"
 #include <iostring.h>
 
@@ -566,6 +567,73 @@ int16_t spi_w25q16jvsiq_write_read_demo(void)
 	return iRet;
 }
 
+//spiflash demo
+//csi_spiflash驱动: JEDEC/SFDP自动识别, 页编程流水, 读缓存, 读时挂起扇区擦除
+static csi_spiflash_t s_tSpiFlash;
+
+static void spiflash_cs(csi_gpio_pin_state_e eValue)
+{
+	if(eValue == GPIO_PIN_LOW)
+		csi_spi_nss_low(PA07);
+	else
+		csi_spi_nss_high(PA07);
+}
+
+int spiflash_log_demo(void)
+{
+	csi_spiflash_info_t tInfo;
+	uint8_t byRecord[16];
+	uint8_t byRdBuf[16];
+	uint32_t wAddr;
+	int iRet = 0;
+	
+	//端口配置
+	csi_pin_set_mux(PA07, PA07_OUTPUT);                     //PA07 as output
+	csi_pin_output_mode(PA07, GPIO_PUSH_PULL);              //PA07 push pull mode
+	csi_spi_nss_high(PA07);									//PA07 NSS init high												    
+	csi_pin_set_mux(PA08,PA08_SPI0_SCK);					//PA08 = SPI0_SCK
+	csi_pin_set_mux(PA09,PA09_SPI0_MISO);					//PA09 = SPI0_MISO
+	csi_pin_set_mux(PA06,PA06_SPI0_MOSI);					//PA06 = SPI0_MOSI
+	
+	if(csi_spiflash_spi_init(&s_tSpiFlash, 0, (void *)spiflash_cs) != CSI_OK)	//初始化spi0并识别flash
+	{
+		my_printf("spiflash probe fail!\r\n");
+		return -1;
+	}
+	csi_spiflash_get_flash_info(&s_tSpiFlash, &tInfo);
+	my_printf("flash id:0x%x size:%d sector:%d page:%d\r\n", tInfo.flash_id, tInfo.flash_size, tInfo.sector_size, tInfo.page_size);
+	
+	csi_spiflash_erase(&s_tSpiFlash, 0x1000, tInfo.sector_size);		//擦除不等待完成
+	csi_spiflash_read(&s_tSpiFlash, 0x0000, byRdBuf, 16);				//读其他扇区, 擦除被挂起/恢复
+	
+	//记录数据, 每条16字节顺序写入
+	for(wAddr = 0x1000; wAddr < 0x1000 + 256; wAddr += sizeof(byRecord))
+	{
+		for(uint8_t i = 0; i < sizeof(byRecord); i++)
+			byRecord[i] = (uint8_t)(wAddr + i);
+		if(csi_spiflash_program(&s_tSpiFlash, wAddr, byRecord, sizeof(byRecord)) < 0)	//只在下一条命令前查询WIP
+		{
+			my_printf("spiflash timeout!\r\n");								//CSI_TIMEOUT: flash无响应
+			return -1;
+		}
+	}
+	
+	//顺序读回, 16字节读取命中32字节读缓存
+	for(wAddr = 0x1000; wAddr < 0x1000 + 256; wAddr += sizeof(byRdBuf))
+	{
+		if(csi_spiflash_read(&s_tSpiFlash, wAddr, byRdBuf, sizeof(byRdBuf)) < 0)
+			iRet = -1;
+		for(uint8_t i = 0; i < sizeof(byRdBuf); i++)
+		{
+			if(byRdBuf[i] != (uint8_t)(wAddr + i))
+				iRet = -1;
+		}
+	}
+	my_printf("spiflash log %s\r\n", iRet ? "error" : "ok");
+	
+	return iRet;
+}
+
 //spi dma demo
 //spi_etcb_dma send
 void spi_etcb_dma_send(void)
@@ -760,6 +828,68 @@ void spi_etcb_dma_send_receive(void)
 
 }
 
+//spi dma demo
+//csi_spi_send_receive_dma, 长度为32位, DMA中断里按0xfff分段, 传输完成回调
+static volatile uint8_t s_bySpiDmaDone = 0;
+
+static void spi_dma_done_cb(csp_spi_t *ptSpiBase, csi_spi_event_e eEvent, void *pArg)
+{
+	if(eEvent == SPI_EVENT_SEND_RECEIVE_COMPLETE)		//rx dma完成, 数据已全部移出
+		s_bySpiDmaDone = 1;
+}
+
+void spi_dma_send_receive_demo(void)
+{
+	static uint8_t bySrcBuf[256];
+	static uint8_t byDesBuf[256];
+	csi_spi_config_t t_SpiConfig;   //spi初始化参数配置结构体
+	
+	for(uint16_t i = 0; i < sizeof(bySrcBuf); i++)
+	{
+		bySrcBuf[i] = (uint8_t)i;
+	}
+	
+	//端口配置
+	csi_pin_set_mux(PA07, PA07_OUTPUT);                     //PA07 as output
+	csi_pin_output_mode(PA07, GPIO_PUSH_PULL);              //PA07 push pull mode
+	csi_spi_nss_high(PA07);									//PA07 NSS init high												    
+	csi_pin_set_mux(PA08,PA08_SPI0_SCK);					//PA08 = SPI0_SCK
+	csi_pin_set_mux(PA09,PA09_SPI0_MISO);					//PA09 = SPI0_MISO
+	csi_pin_set_mux(PA06,PA06_SPI0_MOSI);					//PA06 = SPI0_MOSI
+	
+	//spi para config
+	t_SpiConfig.bySpiMode = SPI_MASTER;						//作为主机
+	t_SpiConfig.bySpiPolarityPhase = SPI_FORMAT_CPOL0_CPHA1; //clk空闲电平为0，相位为在第二个边沿采集数据
+	t_SpiConfig.bySpiFrameLen = SPI_FRAME_LEN_8;             //帧数据长度为8bit
+	t_SpiConfig.wSpiBaud = 12000000; 						//通讯速率12兆			
+	t_SpiConfig.byInt= SPI_INTSRC_NONE;						//不使用spi中断
+	
+	csi_spi_init(SPI0,&t_SpiConfig);						//初始化spi
+	
+	csi_etb_init();											//使能ETB模块
+	csi_dma_soft_rst(DMA);
+	csi_spi_dma_tx_init(SPI0, DMA_CH0, ETB_CH8);			//dma通道0, etb通道8用于发送
+	csi_spi_dma_rx_init(SPI0, DMA_CH1, ETB_CH9);			//dma通道1, etb通道9用于接收
+	csi_spi_attach_callback(SPI0, spi_dma_done_cb, NULL);	//传输完成回调
+	csi_spi_start(SPI0);
+	
+	while(1)
+	{
+		s_bySpiDmaDone = 0;
+		csi_spi_nss_low(PA07);
+		csi_spi_send_receive_dma(SPI0, bySrcBuf, byDesBuf, sizeof(bySrcBuf));	//非阻塞
+		while(!s_bySpiDmaDone);									//CPU可处理其他任务
+		csi_spi_nss_high(PA07);
+		
+		s_bySpiDmaDone = 0;
+		csi_spi_nss_low(PA07);
+		csi_spi_send_receive_dma(SPI0, NULL, byDesBuf, sizeof(byDesBuf));		//只接收, 发送0x00产生时钟
+		while(!s_bySpiDmaDone);
+		csi_spi_nss_high(PA07);
+		nop;
+	}
+}
+
 /** \brief spi interrupt handle weak function
  * 
  *  \param[in] ptSpiBase: pointer of spi register structure
@@ -807,7 +937,7 @@ __attribute__((weak)) void spi_irqhandler(csp_spi_t *ptSpiBase)
 				break;
 			}			
 		}		
-		g_tSpiTransmit.byRxSize = 0;
+		g_tSpiTransmit.wRxSize = 0;
 		g_tSpiTransmit.byReadable = SPI_STATE_IDLE;
 		csp_spi_int_enable(ptSpiBase, SPI_RXIM_INT | SPI_RTIM_INT, false);
 
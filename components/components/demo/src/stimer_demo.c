@@ -0,0 +1,78 @@
+/***********************************************************************//** 
+ * \file  stimer_demo.c
+ * \brief  software timer wheel demo
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author  <th>Description
+ * </table>
+ * *********************************************************************
+*/
+/* Includes ---------------------------------------------------------------*/
+#include <drv/stimer.h>
+#include <drv/pin.h>
+
+#include "demo.h"
+/* externs function--------------------------------------------------------*/
+/* externs variablesr------------------------------------------------------*/
+/* Private macro-----------------------------------------------------------*/
+#define STIMER_DEMO_NUM		4
+
+/* Private variablesr------------------------------------------------------*/
+static csi_stimer_t s_tLedTimer;
+static csi_stimer_t s_tTaskTimer[STIMER_DEMO_NUM];
+static volatile uint32_t s_wTaskCnt[STIMER_DEMO_NUM];
+
+static void led_timer_cb(csi_stimer_t *ptTimer, void *pArg)
+{
+	csi_pin_toggle((pin_name_e)(uint32_t)pArg);				//tick中断里执行，只做短操作
+}
+
+static void task_timer_cb(csi_stimer_t *ptTimer, void *pArg)
+{
+	uint32_t wIdx = (uint32_t)pArg;
+	
+	s_wTaskCnt[wIdx]++;										//主循环里执行，可以做耗时操作
+	if(s_wTaskCnt[wIdx] < 10)
+		csi_stimer_start(ptTimer, CSI_STIMER_MS(100) * (wIdx + 1), 0);	//单次定时器在回调里重启
+}
+
+/** \brief stimer demo：软件定时器轮demo，一个tick中断上下文的周期定时器翻转LED，
+ *         多个主循环上下文的单次定时器，由csi_stimer_process执行回调
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+int stimer_demo(void)
+{
+	int iRet = 0;
+	uint32_t i;
+	
+	csi_pin_set_mux(PA06, PA06_OUTPUT);						//PA06 输出，LED
+	
+	csi_stimer_init(&s_tLedTimer, led_timer_cb, (void *)PA06, STIMER_CTX_TICK);
+	csi_stimer_start(&s_tLedTimer, CSI_STIMER_MS(500), CSI_STIMER_MS(500));	//500ms周期翻转
+	
+	for(i = 0; i < STIMER_DEMO_NUM; i++)
+	{
+		s_wTaskCnt[i] = 0;
+		csi_stimer_init(&s_tTaskTimer[i], task_timer_cb, (void *)i, STIMER_CTX_DEFERRED);
+		csi_stimer_start(&s_tTaskTimer[i], CSI_STIMER_MS(100) * (i + 1), 0);
+	}
+	
+	while(1)
+	{
+		csi_stimer_process();								//执行到期的主循环上下文定时器回调
+		
+		for(i = 0; i < STIMER_DEMO_NUM; i++)
+		{
+			if(csi_stimer_is_active(&s_tTaskTimer[i]))
+				break;
+		}
+		if(i == STIMER_DEMO_NUM)							//所有单次定时器结束
+			break;
+	}
+	
+	csi_stimer_stop(&s_tLedTimer);
+	
+	return iRet;
+}
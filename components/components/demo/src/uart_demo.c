@@ -12,6 +12,8 @@
 #include <string.h>
 #include <drv/uart.h>
 #include <drv/pin.h>
+#include <drv/ringbuf.h>
+#include <drv/tick.h>
 
 #include "demo.h"
 
@@ -22,6 +24,9 @@
 
 static uint8_t s_byRecvBuf[64];					//接收缓存
 static uint8_t s_byRecvLen = 0;	
+static uint8_t s_byRingBuf[64];					//DMA零拷贝环形缓存
+static ringbuffer_t s_tDmaRingbuf;
+static volatile uint32_t s_wTxIrqCnt = 0;		//发送中断次数统计
 				
 /** \brief uart dma send data
  *  \brief 串口通过DMA发送数据，使用时请确认ETCB已初始化(使能)，ETCB初始化调用csi_etb_init()函数
@@ -71,6 +76,51 @@ int uart_send_dma_demo(void)
 	
 	return iRet;
 }
+/** \brief uart dma send scatter-gather frame
+ *  \brief 串口DMA分段发送：帧头/数据/校验分别在不同buffer，DMA在TCIT中断中衔接下一段，无需拷贝到临时buffer
+ *			使用时请确认ETCB已初始化(使能)
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+int uart_sendv_dma_demo(void)
+{
+	int iRet = 0;
+	uint8_t byHead[4] = {0x5a, 0xa5, 0x00, 0x10};
+	uint8_t byPayload[16] = {1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16};
+	uint8_t byCrc[2] = {0x12, 0x34};
+	csi_iovec_t tFrame[3] = {
+		{byHead, sizeof(byHead)},
+		{byPayload, sizeof(byPayload)},
+		{byCrc, sizeof(byCrc)}
+	};
+	csi_uart_config_t tUartConfig;				//UART1 参数配置结构体
+	
+	csi_pin_set_mux(PB02, PB02_UART1_TX);		//TX	
+	csi_pin_set_mux(PA06, PA06_UART1_RX);		//RX
+	
+	tUartConfig.byParity = UART_PARITY_ODD;		//校验位，奇校验
+	tUartConfig.wBaudRate = 115200;				//波特率，115200
+	tUartConfig.hwRecvTo = 88;					//UART接收超时时间
+	tUartConfig.wInt = UART_INTSRC_NONE;		//UART中断关闭
+	tUartConfig.byTxMode = UART_TX_MODE_POLL;	//发送 轮询模式
+	tUartConfig.byRxMode = UART_RX_MODE_POLL;	//接收 轮询模式
+	
+	csi_uart_init(UART1, &tUartConfig);			//初始化串口
+	csi_uart_start(UART1, UART_FUNC_RX_TX);		//开启UART的RX和TX功能
+
+	csi_etb_init();								//使能ETB模块
+	csi_uart_dma_tx_init(UART1, DMA_CH1, ETB_CH10);	//DMA发送初始化，使能TCIT中断
+	
+	while(1)
+	{
+		csi_uart_sendv_dma(UART1, DMA_CH1, tFrame, 3);	//DMA分段发送一帧
+		while(!csi_dma_get_msg(DMA_CH1, ENABLE));		//最后一段完成后才产生发送完成消息
+		mdelay(10);
+	}
+	
+	return iRet;
+}
 /** \brief uart dma receive data and send data
  *  \brief 串口通过DMA接收数据.DMA发送数据，使用时请确认ETCB已初始化(使能)，ETCB初始化调用csi_etb_init()函数
  * 
@@ -151,6 +201,77 @@ int uart_recv_dma_demo(void)
 	
 	return iRet;
 }
+/** \brief uart dma receive into ringbuffer without staging copy
+ *  \brief 串口DMA直接接收到环形缓存，并从环形缓存原地DMA发送(零拷贝)，使用时请确认ETCB已初始化(使能)
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+int uart_recv_dma_ring_demo(void)
+{
+	int iRet = 0;
+	uint8_t *pbyRx = NULL, *pbyTx = NULL;
+	uint16_t hwRxLen = 0, hwTxLen = 0;
+	csi_uart_config_t tUartConfig;				//UART1 参数配置结构体
+	
+	csi_pin_set_mux(PB02, PB02_UART1_TX);		//TX	
+	csi_pin_set_mux(PA06, PA06_UART1_RX);		//RX
+	csi_pin_pull_mode(PA06,GPIO_PULLUP);		//RX管脚上拉使能, 建议配置
+	
+	tUartConfig.byParity = UART_PARITY_ODD;		//校验位，奇校验
+	tUartConfig.wBaudRate = 115200;				//波特率，115200
+	tUartConfig.hwRecvTo = 88;					//UART接收超时时间，单位：bit位周期
+	tUartConfig.wInt = UART_INTSRC_NONE;		//UART中断关闭
+	tUartConfig.byTxMode = UART_TX_MODE_POLL;	//发送 轮询模式
+	tUartConfig.byRxMode = UART_RX_MODE_POLL;	//接收 轮询模式
+	
+	csi_uart_init(UART1, &tUartConfig);			//初始化串口
+	csi_uart_start(UART1, UART_FUNC_RX_TX);		//开启UART的RX和TX功能
+
+	csi_etb_init();								//使能ETB模块
+	csi_uart_dma_tx_init(UART1, DMA_CH1, ETB_CH10);								//DMA发送初始化
+	csi_uart_dma_rx_init(UART1, DMA_RELOAD_DISABLE, DMA_CH3, ETB_CH8);			//DMA接收初始化，每次接收重新指定目标地址
+	
+	s_tDmaRingbuf.pbyBuf = s_byRingBuf;
+	s_tDmaRingbuf.hwSize = sizeof(s_byRingBuf);
+	ringbuffer_reset(&s_tDmaRingbuf);
+	
+	while(1)
+	{
+		//生产者: DMA直接写入环形缓存空闲区域(到缓存末尾或读指针为止)
+		if(pbyRx == NULL)
+		{
+			pbyRx = ringbuffer_write_acquire(&s_tDmaRingbuf, &hwRxLen);
+			if(pbyRx)
+			{
+				if(hwRxLen > 16)
+					hwRxLen = 16;												//每次接收16 bytes
+				csi_uart_recv_dma(UART1, DMA_CH3, (void*)pbyRx, hwRxLen);		//采用DMA方式接收
+			}
+		}
+		else if(csi_dma_get_msg(DMA_CH3, ENABLE))								//获取接收完成消息，并清除消息
+		{
+			ringbuffer_write_commit(&s_tDmaRingbuf, hwRxLen);
+			pbyRx = NULL;
+		}
+		
+		//消费者: 从环形缓存原地DMA发送，发送完成后释放
+		if(pbyTx == NULL)
+		{
+			pbyTx = ringbuffer_read_peek(&s_tDmaRingbuf, &hwTxLen);
+			if(pbyTx)
+				csi_uart_send_dma(UART1, DMA_CH1, (void *)pbyTx, hwTxLen);		//采用DMA方式发送
+		}
+		else if(csi_dma_get_msg(DMA_CH1, ENABLE))								//获取发送完成消息，并清除消息
+		{
+			ringbuffer_read_release(&s_tDmaRingbuf, hwTxLen);
+			pbyTx = NULL;
+		}
+		nop;
+	}
+	
+	return iRet;
+}
 /** \brief uart char receive and send 
  *  \brief 串口接收/发送一个字符，轮询方式
  * 
@@ -250,7 +371,7 @@ int uart_send_int_demo(void)
 	tUartConfig.byParity = UART_PARITY_ODD;		//校验位，奇校验
 	tUartConfig.wBaudRate = 115200;				//波特率，115200
 	tUartConfig.hwRecvTo = 88;					//UART接收超时时间，单位：bit位周期，8个bytes(11bit*8=88, 115200波特率时=764us)
-	tUartConfig.wInt = UART_INTSRC_TXDONE ;		//UART发送中断使能，采用(发送完成)TXDONE中断
+	tUartConfig.wInt = UART_INTSRC_NONE;		//UART发送中断(TXFIFO)由csi_uart_send按需使能，批量填充FIFO
 	tUartConfig.byTxMode = UART_TX_MODE_INT;	//发送模式：中断模式
 	tUartConfig.byRxMode = UART_RX_MODE_POLL;	//接收模式：轮询模式
 	
@@ -283,6 +404,96 @@ int uart_send_int_demo(void)
 	return iRet;
 }
 
+/** \brief uart interrupt send throughput and interrupt cost
+ *  \brief 串口中断发送前后对比测试：同一负载(64 x 64 bytes, 115200)分别用
+ *         0: 原每字节一次TXDONE中断的发送方式(在本demo中复现)
+ *         1: 驱动的TXFIFO批量填充 + 发送队列(csi_uart_send)
+ *         统计发送中断次数、总耗时(us)和发送中断处理占用的CPU周期(不含中断进出开销，约为中断次数 x 进出周期)，
+ *         CPU占用率(千分比) = 中断周期 / 总周期，在调试器中查看g_tUartTxBench[0/1]
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+typedef struct {
+	uint32_t	wIrq;									//发送中断次数
+	uint32_t	wUs;									//发送总耗时(us)
+	uint32_t	wIsrCycles;								//发送中断处理周期总和
+	uint32_t	wCpuPermille;							//发送中断CPU占用率(千分比)
+} uart_tx_bench_t;
+
+volatile uart_tx_bench_t g_tUartTxBench[2];				//测试结果: [0]每字节中断, [1]FIFO批量
+static volatile uint8_t s_byTxBenchOn = 0;				//1: 测试进行中，中断函数才读取周期计数
+static volatile uint8_t s_byTxBenchLegacy = 0;			//1: 中断函数按原每字节TXDONE方式发送
+static volatile uint32_t s_wTxIsrCycles = 0;			//发送中断处理周期统计
+static const uint8_t *s_pbyLegacyTx;
+static volatile uint16_t s_hwLegacyTxLen = 0;
+
+int uart_send_int_bench_demo(void)
+{
+	int iRet = 0;
+	uint32_t i, byPass;
+	uint64_t dwStart, dwCycles;
+	uint8_t bySendData[64];
+	csi_uart_config_t tUartConfig;				//UART1 参数配置结构体
+	
+	for(i = 0; i < sizeof(bySendData); i++)
+		bySendData[i] = 0x30 + (i & 0x3f);
+	
+	csi_pin_set_mux(PB02, PB02_UART1_TX);		//TX	
+	csi_pin_set_mux(PA06, PA06_UART1_RX);		//RX
+	
+	tUartConfig.byParity = UART_PARITY_NONE;	//校验位，无校验
+	tUartConfig.wBaudRate = 115200;				//波特率，115200
+	tUartConfig.hwRecvTo = 88;					//UART接收超时时间
+	tUartConfig.wInt = UART_INTSRC_NONE;		//发送中断由csi_uart_send(或本demo)按需使能
+	tUartConfig.byTxMode = UART_TX_MODE_INT;	//发送模式：中断模式
+	tUartConfig.byRxMode = UART_RX_MODE_POLL;	//接收模式：轮询模式
+	
+	csi_uart_init(UART1, &tUartConfig);			//初始化串口
+	csi_uart_start(UART1, UART_FUNC_TX);		//开启UART的TX功能
+	
+	s_byTxBenchOn = 1;
+	for(byPass = 0; byPass < 2; byPass++)
+	{
+		s_byTxBenchLegacy = (byPass == 0);
+		s_wTxIrqCnt = 0;
+		s_wTxIsrCycles = 0;
+		dwStart = csi_tick_get_cycles64();
+		
+		if(s_byTxBenchLegacy)					//原方式：一次只能发送一个buffer，每字节一次TXDONE中断
+		{
+			csi_uart_int_enable(UART1, UART_INTSRC_TXDONE, ENABLE);
+			for(i = 0; i < 64; i++)
+			{
+				s_pbyLegacyTx = bySendData;
+				s_hwLegacyTxLen = sizeof(bySendData);
+				csp_uart_set_data(UART1, *s_pbyLegacyTx);				//发送第一个字节
+				while(s_hwLegacyTxLen);									//发送中返回CSI_ERROR，等待完成
+			}
+			csi_uart_int_enable(UART1, UART_INTSRC_TXDONE, DISABLE);
+		}
+		else									//FIFO批量填充，队列满时等待
+		{
+			for(i = 0; i < 64; i++)
+			{
+				while(csi_uart_send(UART1, (void *)bySendData, sizeof(bySendData)) != CSI_OK);
+			}
+			while(!csi_uart_get_msg(UART1, UART_SEND, ENABLE));
+		}
+		while(!(csp_uart_get_sr(UART1) & UART_TFE));					//发送FIFO空(两种方式相同的收尾)
+		
+		dwCycles = csi_tick_get_cycles64() - dwStart;
+		g_tUartTxBench[byPass].wIrq = s_wTxIrqCnt;
+		g_tUartTxBench[byPass].wUs = (uint32_t)csi_tick_cycles_to_us(dwCycles);
+		g_tUartTxBench[byPass].wIsrCycles = s_wTxIsrCycles;
+		g_tUartTxBench[byPass].wCpuPermille = (uint32_t)(((uint64_t)s_wTxIsrCycles * 1000) / dwCycles);
+	}
+	s_byTxBenchLegacy = 0;
+	s_byTxBenchOn = 0;
+	
+	return iRet;
+}
+
 /** \brief uart receive a bunch of data; polling(sync) mode
  *  \brief 串口接收指定长度数据，RX使用轮询(不使用中断)，带超时处理(单位：ms)
  * 
@@ -381,8 +592,26 @@ int uart_recv_rxfifo_int_demo(void)
  */
 __attribute__((weak)) void uart_irqhandler(csp_uart_t *ptUartBase,uint8_t byIdx)
 {
-	//此中断例程支持RXFIFO/RX/TXDONE/RXTO四种中断，基本满足UART的各种处理
-	switch(csp_uart_get_isr(ptUartBase) & 0x080242)							//获取RXFIFO/TXDONE/RXTO/RX 中断状态
+	//此中断例程支持RXFIFO/RX/TXFIFO/RXTO四种中断，基本满足UART的各种处理
+	uint64_t dwIsrStart = s_byTxBenchOn ? csi_tick_get_cycles64() : 0;	//非测试时不读周期计数
+	
+	if(csp_uart_get_isr(ptUartBase) & UART_TXFIFO_INT_S)					//TXFIFO中断，批量填充发送FIFO，支持csi_uart_send接口
+	{
+		s_wTxIrqCnt ++;
+		csi_uart_send_fifo_fill(ptUartBase);
+		if(s_byTxBenchOn)
+			s_wTxIsrCycles += (uint32_t)(csi_tick_get_cycles64() - dwIsrStart);
+	}
+	else if(s_byTxBenchLegacy && (csp_uart_get_isr(ptUartBase) & UART_TXDONE_INT_S))	//uart_send_int_bench_demo对比用，原每字节一次中断的发送
+	{
+		s_wTxIrqCnt ++;
+		csp_uart_clr_isr(ptUartBase, UART_TXDONE_INT_S);
+		if(--s_hwLegacyTxLen)
+			csp_uart_set_data(ptUartBase, *(++s_pbyLegacyTx));
+		s_wTxIsrCycles += (uint32_t)(csi_tick_get_cycles64() - dwIsrStart);
+	}
+	
+	switch(csp_uart_get_isr(ptUartBase) & 0x000242)							//获取RXFIFO/RXTO/RX 中断状态
 	{
 		case UART_RXFIFO_INT_S:		
 			//使用RXFIFO中断接收数据
@@ -409,25 +638,15 @@ __attribute__((weak)) void uart_irqhandler(csp_uart_t *ptUartBase,uint8_t byIdx)
 				csi_uart_send(ptUartBase,(void *)s_byRecvBuf, s_byRecvLen);	//UART发送采用轮询方式，发送接收到的48bytes
 				s_byRecvLen = 0;
 			}
-			break;
-		case UART_TXDONE_INT_S:		
-			//使用TXDONE中断发送数据，下面处理支持csi_uart_send接口
-			//用户可按自己习惯方式处理中断发送（此时不支持csi_uart_send接口）
-			csp_uart_clr_isr(ptUartBase,UART_TXDONE_INT_S);					//清除中断状态
-			g_tUartTran[byIdx].hwTxSize --;
-			g_tUartTran[byIdx].pbyTxData ++;
-			
-			if(g_tUartTran[byIdx].hwTxSize == 0)		
-				g_tUartTran[byIdx].bySendStat = UART_STATE_DONE;			//发送完成
-			else
-				csp_uart_set_data(ptUartBase, *g_tUartTran[byIdx].pbyTxData);//发送数据
-				
 			break;
 		case UART_RXTO_INT_S:
 			//字节接收超时中断，可以作为一串字符是否结束的依据，若使用此功能，需在接收数据时使能接收超时
 			//用户添加自己的处理
 			csp_uart_clr_isr(ptUartBase, UART_RXTO_INT_S);					//清除中断状态							
-			csp_uart_rto_dis(ptUartBase);									//关闭接收超时	
+			if(g_tUartTran[byIdx].byRecvMode == UART_RX_MODE_DMA_CIRC)
+				csi_uart_dma_circ_update(ptUartBase, true);					//DMA循环接收，一帧结束
+			else
+				csp_uart_rto_dis(ptUartBase);								//关闭接收超时	
 			break;
 		default:
 			break;
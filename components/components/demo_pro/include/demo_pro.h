@@ -22,6 +22,8 @@
 int uart_recv_int_demo(void);
 int uart_recv_dynamic_demo(void);
 int uart_recv_dynamic_int_demo(void);
+int uart_recv_spsc_demo(void);
+int uart_recv_dma_circ_demo(void);
 
 //usart
 int usart_recv_dynamic_demo(void);
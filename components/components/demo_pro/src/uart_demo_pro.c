@@ -22,6 +22,7 @@
 
 ringbuffer_t g_tRingbuf;						//循环buffer
 uint8_t 	 g_byRxBuf[UART_RECV_MAX_LEN];		//接收缓存
+ringbuffer_spsc_t g_tSpscRingbuf;				//无锁循环buffer(SPSC)，长度须为2的幂
 
 //volatile uint8_t byRvUart[30]={0};
 
@@ -83,6 +84,111 @@ int uart_recv_int_demo(void)
 }
 
 
+/** \brief uart receive data with lock-free spsc ringbuf; interrupt(async) mode
+ *  \brief 串口接收数据，RX使用中断，接收缓存使用无锁SPSC循环buffer(中断写/主循环读，无需关中断)
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+int uart_recv_spsc_demo(void)
+{
+	int iRet = 0;
+	uint8_t  byRxBuf[32];
+	volatile uint16_t hwRecvLen;
+	
+	csi_uart_config_t tUartConfig;				//UART1 参数配置结构体
+	
+	csi_pin_set_mux(PB02, PB02_UART1_TX);		//TX	
+	csi_pin_set_mux(PA06, PA06_UART1_RX);		//RX
+	csi_pin_pull_mode(PA06,GPIO_PULLUP);		//RX管脚上拉使能, 建议配置
+	
+	//接收缓存配置，使用无锁SPSC循环buffer，buffer长度必须是2的幂(UART_RECV_MAX_LEN = 128)
+	if(csi_uart_set_spsc_buffer(UART1, &g_tSpscRingbuf, g_byRxBuf, sizeof(g_byRxBuf)) != CSI_OK)
+		return -1;
+	
+	tUartConfig.byParity = UART_PARITY_NONE;	//校验位，无校验
+	tUartConfig.wBaudRate = 1000000;			//波特率，1M
+	tUartConfig.hwRecvTo = 88;					//UART接收超时时间，单位：bit位周期
+	tUartConfig.wInt = UART_INTSRC_RXFIFO 
+					| UART_INTSRC_RXTO;			//串口接收中断打开，使用RXFIFO中断和接收超时中断
+	tUartConfig.byTxMode = UART_TX_MODE_POLL;	//发送模式：轮询模式
+	tUartConfig.byRxMode = UART_RX_MODE_INT_FIX;//接收模式：中断指定接收模式
+	
+	csi_uart_init(UART1, &tUartConfig);			//初始化串口
+	csi_uart_start(UART1, UART_FUNC_RX_TX);		//开启UART的RX和TX功能，也可单独开启RX或者TX功能
+	
+	while(1)
+	{
+		hwRecvLen = csi_uart_receive(UART1,(void *)byRxBuf, sizeof(byRxBuf), 0);	//收满32个字节后读出
+		if(hwRecvLen)
+			csi_uart_send(UART1,(void *)byRxBuf, hwRecvLen);					//UART发送采用轮询方式(同步)
+	}
+	
+	return iRet;
+}
+
+/** \brief uart circular dma receive frame callback, called in RXTO interrupt
+ * 
+ *  \param[in] ptUartBase: pointer of uart register structure
+ *  \param[in] ptRingbuf: spsc ringbuf holding the frame
+ *  \param[in] wLen: frame length
+ *  \return none
+ */
+static volatile uint32_t s_wFrmCnt = 0;
+static volatile uint32_t s_wFrmLen = 0;
+static void uart_frame_callback(csp_uart_t *ptUartBase, ringbuffer_spsc_t *ptRingbuf, uint32_t wLen)
+{
+	s_wFrmCnt ++;								//一帧接收完成(接收超时)，用户可在此解析或通知任务
+	s_wFrmLen = wLen;
+}
+
+/** \brief uart receive frames of unknown length; circular dma mode
+ *  \brief 串口DMA循环接收到无锁循环buffer，接收超时(RXTO)分帧，每帧一次中断而非每字节一次中断
+ *			使用时请确认ETCB已初始化(使能)
+ * 
+ *  \param[in] none
+ *  \return error code
+ */
+int uart_recv_dma_circ_demo(void)
+{
+	int iRet = 0;
+	uint8_t  byRxBuf[32];
+	volatile uint16_t hwRecvLen;
+	volatile uint32_t wLost = 0;
+	
+	csi_uart_config_t tUartConfig;				//UART1 参数配置结构体
+	
+	csi_pin_set_mux(PB02, PB02_UART1_TX);		//TX	
+	csi_pin_set_mux(PA06, PA06_UART1_RX);		//RX
+	csi_pin_pull_mode(PA06,GPIO_PULLUP);		//RX管脚上拉使能, 建议配置
+	
+	tUartConfig.byParity = UART_PARITY_NONE;	//校验位，无校验
+	tUartConfig.wBaudRate = 921600;				//波特率，921600
+	tUartConfig.hwRecvTo = 22;					//UART接收超时时间，单位：bit位周期，2个bytes空闲即为一帧结束
+	tUartConfig.wInt = UART_INTSRC_NONE;		//RXTO中断由csi_uart_recv_dma_circ打开
+	tUartConfig.byTxMode = UART_TX_MODE_POLL;	//发送模式：轮询模式
+	tUartConfig.byRxMode = UART_RX_MODE_POLL;	//接收模式由csi_uart_recv_dma_circ设置
+	
+	csi_uart_init(UART1, &tUartConfig);			//初始化串口
+	csi_uart_start(UART1, UART_FUNC_RX_TX);		//开启UART的RX和TX功能
+	
+	csi_etb_init();								//使能ETB模块
+	
+	//DMA循环接收，buffer长度必须是2的幂(UART_RECV_MAX_LEN = 128)
+	if(csi_uart_recv_dma_circ(UART1, DMA_CH3, ETB_CH8, &g_tSpscRingbuf, g_byRxBuf, sizeof(g_byRxBuf), uart_frame_callback) != CSI_OK)
+		return -1;
+	
+	while(1)
+	{
+		hwRecvLen = csi_uart_receive(UART1,(void *)byRxBuf, sizeof(byRxBuf), 0);	//读出已接收数据，最多32个字节
+		if(hwRecvLen)
+			csi_uart_send(UART1,(void *)byRxBuf, hwRecvLen);					//UART发送采用轮询方式(同步)
+		wLost += csi_uart_dma_circ_overrun(UART1);							//读取过慢被DMA覆盖(已丢弃)的字节数
+	}
+	
+	return iRet;
+}
+
 /** \brief uart receive a bunch of data; interrupt(async) mode
  *  \brief 串口接收到一串字符串，RX使用中断模式，TX不使用中断
  *
@@ -156,8 +262,7 @@ int uart_recv_dynamic_int_demo(void)
 	tUartConfig.byParity = UART_PARITY_ODD;							//校验位，奇校验
 	tUartConfig.wBaudRate = 115200;									//波特率，115200
 	tUartConfig.hwRecvTo = 88;										//UART接收超时时间，单位：bit位周期，8个bytes(11bit*8=88, 115200波特率时=764us)
-	tUartConfig.wInt = UART_INTSRC_RXFIFO | UART_INTSRC_TXDONE 
-				| UART_INTSRC_RXTO;									//串口接收/发送中断打开，使用RXFIFO/TXDONE中断(默认推荐使用)和接收超时中断
+	tUartConfig.wInt = UART_INTSRC_RXFIFO | UART_INTSRC_RXTO;		//串口接收中断打开，使用RXFIFO中断和接收超时中断，发送中断(TXFIFO)由csi_uart_send按需使能
 	tUartConfig.byTxMode = UART_TX_MODE_INT;						//发送模式：中断发送
 	tUartConfig.byRxMode = UART_RX_MODE_INT_DYN;					//接收模式：中断动态接收模式
 	
@@ -183,7 +288,10 @@ int uart_recv_dynamic_int_demo(void)
  */ 
 __attribute__((weak)) void uart_irqhandler(csp_uart_t *ptUartBase,uint8_t byIdx)
 {
-	switch(csp_uart_get_isr(ptUartBase) & 0x080242)			//get RXFIFO/TXDONE/RXTO/RX interrupt
+	if(csp_uart_get_isr(ptUartBase) & UART_TXFIFO_INT_S)	//tx fifo interrupt, fill tx fifo in bulk from send queue
+		csi_uart_send_fifo_fill(ptUartBase);
+	
+	switch(csp_uart_get_isr(ptUartBase) & 0x000242)			//get RXFIFO/RXTO/RX interrupt
 	{
 		case UART_RXFIFO_INT_S:								//rx fifo interrupt; recommended use RXFIFO interrupt
 			
@@ -191,7 +299,12 @@ __attribute__((weak)) void uart_irqhandler(csp_uart_t *ptUartBase,uint8_t byIdx)
 				csp_uart_rto_en(ptUartBase);					//enable  receive timeout
 			//uint8_t byData = csp_uart_get_data(ptUartBase);
 			//ringbuffer_byte_in(g_tUartTran[byIdx].ptRingBuf, byData);
-			if(g_tUartTran[byIdx].ptRingBuf->hwDataLen < g_tUartTran[byIdx].ptRingBuf->hwSize)	//the same as previous line of code 
+			if(g_tUartTran[byIdx].ptSpscBuf)													//lock-free spsc ringbuf
+			{
+				while(csp_uart_get_sr(ptUartBase) & UART_RNE)
+					ringbuffer_spsc_byte_in(g_tUartTran[byIdx].ptSpscBuf, csp_uart_get_data(ptUartBase));	//drop data when full
+			}
+			else if(g_tUartTran[byIdx].ptRingBuf->hwDataLen < g_tUartTran[byIdx].ptRingBuf->hwSize)	//the same as previous line of code 
 			{
 				while(csp_uart_get_sr(ptUartBase) & UART_RNE)
 				{
@@ -209,27 +322,29 @@ __attribute__((weak)) void uart_irqhandler(csp_uart_t *ptUartBase,uint8_t byIdx)
 				csp_uart_rto_en(ptUartBase);													//enable  receive timeout
 				
 			csp_uart_clr_isr(ptUartBase, UART_RX_INT_S);										//clear interrupt
-			if(g_tUartTran[byIdx].ptRingBuf->hwDataLen < g_tUartTran[byIdx].ptRingBuf->hwSize)	
+			if(g_tUartTran[byIdx].ptSpscBuf)
+				ringbuffer_spsc_byte_in(g_tUartTran[byIdx].ptSpscBuf, csp_uart_get_data(ptUartBase));
+			else if(g_tUartTran[byIdx].ptRingBuf->hwDataLen < g_tUartTran[byIdx].ptRingBuf->hwSize)	
 			{
 				g_tUartTran[byIdx].ptRingBuf->pbyBuf[g_tUartTran[byIdx].ptRingBuf->hwWrite] = csp_uart_get_data(ptUartBase);
 				g_tUartTran[byIdx].ptRingBuf->hwWrite = (g_tUartTran[byIdx].ptRingBuf->hwWrite + 1) % g_tUartTran[byIdx].ptRingBuf->hwSize;
 				g_tUartTran[byIdx].ptRingBuf->hwDataLen ++;
 			}
 			
-			break;
-		case UART_TXDONE_INT_S:													//tx send complete; recommended use TXDONE interrupt
-			csp_uart_clr_isr(ptUartBase,UART_TXDONE_INT_S);						//clear interrupt status
-			g_tUartTran[byIdx].hwTxSize --;
-			g_tUartTran[byIdx].pbyTxData ++;
-			
-			if(g_tUartTran[byIdx].hwTxSize == 0)		
-				g_tUartTran[byIdx].bySendStat = UART_STATE_DONE;				//send complete
-			else
-				csp_uart_set_data(ptUartBase, *g_tUartTran[byIdx].pbyTxData);	//send data
-				
 			break;
 		case UART_RXTO_INT_S:
-			if(g_tUartTran[byIdx].ptRingBuf->hwDataLen < g_tUartTran[byIdx].ptRingBuf->hwSize)	//the same as previous line of code 
+			if(g_tUartTran[byIdx].byRecvMode == UART_RX_MODE_DMA_CIRC)		//circular dma receive, data is moved by dma
+			{
+				csp_uart_clr_isr(ptUartBase, UART_RXTO_INT_S);	
+				csi_uart_dma_circ_update(ptUartBase, true);				//publish write index, one frame end
+				break;
+			}
+			if(g_tUartTran[byIdx].ptSpscBuf)
+			{
+				while(csp_uart_get_sr(ptUartBase) & UART_RNE)
+					ringbuffer_spsc_byte_in(g_tUartTran[byIdx].ptSpscBuf, csp_uart_get_data(ptUartBase));
+			}
+			else if(g_tUartTran[byIdx].ptRingBuf->hwDataLen < g_tUartTran[byIdx].ptRingBuf->hwSize)	//the same as previous line of code 
 			{
 				while(csp_uart_get_sr(ptUartBase) & UART_RNE)
 				{
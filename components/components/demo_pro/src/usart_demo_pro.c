@@ -159,7 +159,12 @@ __attribute__((weak)) void usart_irqhandler(csp_usart_t *ptUsartBase,uint8_t byI
 	switch(csp_usart_get_isr(ptUsartBase) & 0x5100)			//rxfifo/txfifo/rxtimeout interrupt	
 	{
 		case US_RXRIS_INT:					//rx fifo interrupt
-			if(g_tUsartTran[byIdx].ptRingBuf->hwDataLen < g_tUsartTran[byIdx].ptRingBuf->hwSize)	
+			if(g_tUsartTran[byIdx].ptSpscBuf)									//lock-free spsc ringbuf
+			{
+				while(csp_usart_get_sr(ptUsartBase) & US_RNE)
+					ringbuffer_spsc_byte_in(g_tUsartTran[byIdx].ptSpscBuf, csp_usart_get_data(ptUsartBase));	//drop data when full
+			}
+			else if(g_tUsartTran[byIdx].ptRingBuf->hwDataLen < g_tUsartTran[byIdx].ptRingBuf->hwSize)	
 			{
 				while(csp_usart_get_sr(ptUsartBase) & US_RNE)		//Rxfifo non empty 
 				{
@@ -189,7 +194,12 @@ __attribute__((weak)) void usart_irqhandler(csp_usart_t *ptUsartBase,uint8_t byI
 			break;
 		case US_TIMEOUT_INT:				//receive timeout interrupt
 		
-			if(g_tUsartTran[byIdx].ptRingBuf->hwDataLen < g_tUsartTran[byIdx].ptRingBuf->hwSize)	
+			if(g_tUsartTran[byIdx].ptSpscBuf)
+			{
+				while(csp_usart_get_sr(ptUsartBase) & US_RNE)
+					ringbuffer_spsc_byte_in(g_tUsartTran[byIdx].ptSpscBuf, csp_usart_get_data(ptUsartBase));
+			}
+			else if(g_tUsartTran[byIdx].ptRingBuf->hwDataLen < g_tUsartTran[byIdx].ptRingBuf->hwSize)	
 			{
 				while(csp_usart_get_sr(ptUsartBase) & US_RNE)	
 				{
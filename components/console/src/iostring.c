@@ -17,6 +17,7 @@
 #include "stddef.h"
 #include "stdio.h"
 #include "sys_console.h"
+#include <drv/hwdiv.h>
 
 //extern unsigned int RxDataFlag;
 //extern unsigned int TxDataFlag;
@@ -67,6 +68,7 @@ char *myitoa(int value, int* string, int radix)
 		int sign;
 		//char* sp;
 		int* sp;
+		const hwdiv_recip_t tRecip10 = HWDIV_RECIP_10;
 		
 		if (radix > 36 || radix <= 1)
 		{
@@ -80,8 +82,22 @@ char *myitoa(int value, int* string, int radix)
 		v = (unsigned)value;
 		while (v || tp == tmp)
 		{
-			i = v % radix;
-			v = v / radix;
+			if (radix == 10)					//decimal by reciprocal, power of two by mask/shift
+			{
+				unsigned q = csi_hwdiv_recip_div(&tRecip10, v);
+				i = v - q * 10;
+				v = q;
+			}
+			else if ((radix & (radix - 1)) == 0)
+			{
+				i = v & (radix - 1);
+				v = v >> __builtin_ctz(radix);
+			}
+			else
+			{
+				i = v % radix;
+				v = v / radix;
+			}
 			if (i < 10) {
 			*tp++ = i+'0';
 			
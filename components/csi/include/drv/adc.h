@@ -15,6 +15,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <drv/common.h>
+#include <drv/dma.h>
 
 #include "csp.h"
 
@@ -295,6 +296,16 @@ typedef struct {
 
 extern csi_adc_samp_t g_tAdcSamp;
 
+/**
+  \brief      adc stream half buffer complete callback, called in dma interrupt, returns
+  *			  before dma wraps back to pwData(hwSeqNum sequence periods)
+  \param[in]  ptAdcBase	pointer of adc register structure
+  \param[in]  pwData		completed half buffer, hwSeqNum sequences of byChnlNum words(ADC_DR[] format)
+  \param[in]  hwSeqNum		number of sequences in pwData
+  \param[in]  pArg		user param passed by csi_adc_stream_start
+  */
+typedef void (*csi_adc_stream_cb_t)(csp_adc_t *ptAdcBase, uint32_t *pwData, uint16_t hwSeqNum, void *pArg);
+
 
 /**
   \brief       Initialize adc Interface. Initialize the resources needed for the adc interface
@@ -485,6 +496,34 @@ void csi_adc_fvrout_enable(csp_adc_t *ptAdcBase, csi_adc_fvrsel_e eLvl, bool bEn
   \return 	   none
  */
 void csi_adc_bufout_enable(csp_adc_t *ptAdcBase, csi_adc_bufsel_e eBufSel, bool bEnable);
+
+/** 
+  \brief 	   adc stream init, adc sequence end(EOC) triggers the dma channel through etb
+  \param[in]   ptAdcBase	pointer of ADC reg structure.
+  \param[in]   eDmaCh		channel number of dma, DMA_CH0~DMA_CH3
+  \param[in]   eEtbCh		channel id number of etb, eEtbCh >= ETB_CH8
+  \return 	   error code \ref csi_error_t
+ */
+csi_error_t csi_adc_stream_init(csp_adc_t *ptAdcBase, csi_dma_ch_e eDmaCh, csi_etb_ch_e eEtbCh);
+
+/** 
+  \brief 	   start adc stream, dma moves every sequence into two half buffers in turn,
+  *			   without stopping between them
+  \param[in]   ptAdcBase	pointer of ADC reg structure.
+  \param[in]   pwBuf		pointer of stream buffer, size = 2 * hwSeqNum * byChnlNum words
+  \param[in]   hwSeqNum		number of sequences per half buffer(1~0x7ff)
+  \param[in]   callback		half buffer complete callback
+  \param[in]   pArg			user param of callback
+  \return 	   error code \ref csi_error_t
+ */
+csi_error_t csi_adc_stream_start(csp_adc_t *ptAdcBase, uint32_t *pwBuf, uint16_t hwSeqNum, csi_adc_stream_cb_t callback, void *pArg);
+
+/** 
+  \brief 	   stop adc stream
+  \param[in]   ptAdcBase	pointer of ADC reg structure.
+  \return 	   none
+ */
+void csi_adc_stream_stop(csp_adc_t *ptAdcBase);
  
  
 #ifdef __cplusplus
@@ -0,0 +1,76 @@
+/***********************************************************************//**
+ * \file  adc_ovs.h
+ * \brief  head file for adc oversampling and decimation
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#ifndef _DRV_ADC_OVS_H_
+#define _DRV_ADC_OVS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stdint.h"
+
+#define ADC_OVS_CHNL_MAX		16			//max channel of sequence
+#define ADC_OVS_RATIO_MAX		4096		//max samples per output, sum of 12bit samples fits in 24bit
+#define ADC_OVS_DATA_MSK		0xfff		//12bit adc data in ADC_DR[]
+
+/// \struct csi_adc_ovs_result_t
+/// \brief  decimated output of one channel
+typedef struct {
+	uint32_t			wValue;			//oversampled value, (12 + byExtBits) bits
+	uint16_t			hwMean;			//rounded mean of raw samples, 12 bits
+	uint16_t			hwMin;			//min raw sample
+	uint16_t			hwMax;			//max raw sample
+} csi_adc_ovs_result_t;
+
+/// \struct csi_adc_ovs_t
+/// \brief  oversampling accumulator, plain C, no register access
+typedef struct {
+	uint32_t			wSum[ADC_OVS_CHNL_MAX];		//sum of raw samples
+	uint16_t			hwMin[ADC_OVS_CHNL_MAX];
+	uint16_t			hwMax[ADC_OVS_CHNL_MAX];
+	uint16_t			hwRatio;		//samples per output, power of two
+	uint16_t			hwCount;		//samples accumulated of current output
+	uint8_t				byChnlNum;		//channel number of sequence
+	uint8_t				byShift;		//log2(hwRatio)
+	uint8_t				byExtBits;		//extra bits, byShift/2
+} csi_adc_ovs_t;
+
+/**
+  \brief  init oversampling accumulator
+  \param  [in] ptOvs: pointer of accumulator
+  \param  [in] byChnlNum: channel number of sequence(1~16)
+  \param  [in] hwRatio: samples per output, power of two(1~4096), 4^n gives n extra bits
+  \return 0: ok, -1: parameter error
+  */
+int32_t csi_adc_ovs_init(csi_adc_ovs_t *ptOvs, uint8_t byChnlNum, uint16_t hwRatio);
+
+/**
+  \brief  clear accumulated samples, keep config
+  \param  [in] ptOvs: pointer of accumulator
+  \return none
+  */
+void csi_adc_ovs_reset(csi_adc_ovs_t *ptOvs);
+
+/**
+  \brief  accumulate a block of sequences(e.g. a dma half buffer) in one pass
+  \param  [in] ptOvs: pointer of accumulator
+  \param  [in] pwData: interleaved samples, hwSeqNum sequences of byChnlNum words(ADC_DR[] format)
+  \param  [in] hwSeqNum: number of sequences in pwData
+  \param  [out] ptResult: output, byChnlNum results per completed output,
+  *                        room for (hwSeqNum / hwRatio + 1) * byChnlNum results
+  \return number of outputs completed(each one is byChnlNum results)
+  */
+uint16_t csi_adc_ovs_accumulate(csi_adc_ovs_t *ptOvs, const uint32_t *pwData, uint16_t hwSeqNum, csi_adc_ovs_result_t *ptResult);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DRV_ADC_OVS_H_ */
@@ -77,6 +77,13 @@ typedef enum {
     CSI_UNSUPPORTED = -4,
 } csi_error_t;
 
+/// \struct csi_iovec_t
+/// \brief  scatter-gather segment for xxx_sendv, the array must stay valid until sent
+typedef struct {
+	const void	*pBase;			//segment address
+	uint32_t	wLen;			//segment length(byte)
+} csi_iovec_t;
+
 typedef struct {
    uint8_t    readable;
    uint8_t    writeable;
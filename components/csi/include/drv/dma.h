@@ -137,6 +137,15 @@ typedef struct
 	uint32_t	wInt;			//interrupt  
 } csi_dma_ch_config_t;
 
+/**
+  \brief      dma channel transfer complete(TCIT) callback, called in dma interrupt,
+  *			  also on every LTCIT when the channel enables DMA_INTSRC_LTCIT
+  \param[in]  ptDmaBase	pointer of dma register structure
+  \param[in]  eDmaCh		channel num of dma(4 channel: 0->3)
+  \param[in]  pArg		user param passed by csi_dma_attach_callback
+  */
+typedef void (*csi_dma_callback_t)(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, void *pArg);
+
 /** 
   \brief 	   Init dma channel parameter config structure
   \param[in]   ptDmaBase	pointer of dma reg structure.
@@ -159,6 +168,18 @@ csi_error_t csi_dma_ch_init(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, csi_dma_c
 */
 csi_error_t csi_dma_ch_start(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, void *pSrcAddr, void *pDstAddr, uint16_t hwHTranNum, uint16_t hwLTranNum);
 
+/**
+  \brief       Start a dma channel scatter-gather transfer to a fixed(peripheral) address, each 
+  *			   segment is chained from the TCIT interrupt, TCIT message/callback after the last one
+  \param[in]   ptDmaBase	pointer of dma register structure
+  \param[in]   eDmaCh       channel num of dma(4 channel: 0->3)
+  \param[in]   ptIov		segment array, must stay valid until transfer complete
+  \param[in]   byIovCnt		segment number
+  \param[in]   pDstAddr     transfer destination address
+  \return      error code \ref csi_error_t
+*/
+csi_error_t csi_dma_ch_start_sg(csp_dma_t *ptDmaBase, csi_dma_ch_e eDmaCh, const csi_iovec_t *ptIov, uint8_t byIovCnt, void *pDstAddr);
+
 /** \brief dma channel transfer restart
  * 
  *  \param[in] ptDmaBase: pointer of dma reg structure.
@@ -208,6 +229,23 @@ void csi_dma_soft_rst(csp_dma_t *ptDmaBase);
  */ 
 bool csi_dma_get_msg(csi_dma_ch_e eDmaCh, bool bClrEn);
 
+/** 
+  \brief 	   attach transfer complete(TCIT) callback to dma channel, the callback runs
+  *			   in dma_irqhandler instead of posting the TCIT message
+  \param[in]   eDmaCh		dma channel number, channel 0->3
+  \param[in]   callback		callback function \ref csi_dma_callback_t
+  \param[in]   pArg			user param passed to callback
+  \return 	   error code \ref csi_error_t
+ */ 
+csi_error_t csi_dma_attach_callback(csi_dma_ch_e eDmaCh, csi_dma_callback_t callback, void *pArg);
+
+/** 
+  \brief 	   detach transfer complete callback of dma channel
+  \param[in]   eDmaCh		dma channel number, channel 0->3
+  \return 	   none
+ */ 
+void csi_dma_detach_callback(csi_dma_ch_e eDmaCh);
+
 /**
   \brief       enable dma power manage
   \param[in]   dma  dma handle to operate.
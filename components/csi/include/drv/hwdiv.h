@@ -1,21 +1,87 @@
-
-
 #ifndef _DRV_HWDIV_H_
 #define _DRV_HWDIV_H_
 
+#include <stdint.h>
 
  typedef struct{
 	uint32_t wQuot;
 	uint32_t wRem;
  }hwdiv_urslt_t;
- 
+
   typedef struct{
 	int wQuot;
 	int wRem;
  }hwdiv_rslt_t;
 
+/// \struct hwdiv_recip_t
+/// \brief  precomputed reciprocal of a constant divisor, quotient = mulhi(n, wMul) >> byShift,
+///         no hardware divider access and no interrupt masking when dividing
+ typedef struct{
+	uint32_t wMul;			//magic multiplier, 0: divisor is power of two
+	uint32_t wDivisor;		//divisor, for remainder
+	uint8_t  byShift;		//post shift
+	uint8_t  byAdd;			//1: 33bit multiplier, needs add fixup
+ }hwdiv_recip_t;
+
+/// reciprocal of 10, for decimal conversion without csi_hwdiv_recip_init
+#define HWDIV_RECIP_10		{0xCCCCCCCDul, 10ul, 3, 0}
+
 hwdiv_urslt_t csi_hwdiv_unsigned_calc(uint32_t wDiviend, uint32_t wDivisor);
 hwdiv_rslt_t csi_hwdiv_signed_calc(int wDiviend, int wDivisor);
 
+/**
+  \brief 	   precompute reciprocal of a divisor, call at configuration time
+  \param[out]  ptRecip		pointer of reciprocal
+  \param[in]   wDivisor		divisor, must not be 0
+  \return 	   none
+ */
+void csi_hwdiv_recip_init(hwdiv_recip_t *ptRecip, uint32_t wDivisor);
+
+/**
+  \brief 	   high 32 bits of 32x32 bit product, four 16x16 multiplies
+  \param[in]   wA, wB		factors
+  \return 	   (wA * wB) >> 32
+ */
+static inline uint32_t csi_hwdiv_mulhi(uint32_t wA, uint32_t wB)
+{
+	uint32_t wLL = (wA & 0xffff) * (wB & 0xffff);
+	uint32_t wHL = (wA >> 16) * (wB & 0xffff);
+	uint32_t wLH = (wA & 0xffff) * (wB >> 16);
+	uint32_t wHH = (wA >> 16) * (wB >> 16);
+	uint32_t wMid = (wLL >> 16) + (wHL & 0xffff) + wLH;
+
+	return wHH + (wHL >> 16) + (wMid >> 16);
+}
+
+/**
+  \brief 	   unsigned divide by precomputed reciprocal
+  \param[in]   ptRecip		pointer of reciprocal
+  \param[in]   wDividend	dividend
+  \return 	   wDividend / divisor
+ */
+static inline uint32_t csi_hwdiv_recip_div(const hwdiv_recip_t *ptRecip, uint32_t wDividend)
+{
+	uint32_t wQ;
+
+	if(ptRecip->wMul == 0)
+		return wDividend >> ptRecip->byShift;
+
+	wQ = csi_hwdiv_mulhi(wDividend, ptRecip->wMul);
+	if(ptRecip->byAdd)
+		wQ = ((wDividend - wQ) >> 1) + wQ;
+
+	return wQ >> ptRecip->byShift;
+}
+
+/**
+  \brief 	   unsigned modulo by precomputed reciprocal
+  \param[in]   ptRecip		pointer of reciprocal
+  \param[in]   wDividend	dividend
+  \return 	   wDividend % divisor
+ */
+static inline uint32_t csi_hwdiv_recip_mod(const hwdiv_recip_t *ptRecip, uint32_t wDividend)
+{
+	return wDividend - csi_hwdiv_recip_div(ptRecip, wDividend) * ptRecip->wDivisor;
+}
 
-#endif /* _CSI_CLK_H_*/
\ No newline at end of file
+#endif /* _DRV_HWDIV_H_*/
@@ -92,6 +92,22 @@ typedef enum {
 } csi_iic_event_e;
 
 
+/**
+  \brief       async master transaction, owned by caller until the callback
+ */
+typedef struct csi_iic_xfer csi_iic_xfer_t;
+typedef void (*csi_iic_xfer_cb_t)(csi_iic_xfer_t *ptXfer, csi_iic_event_e eEvent);
+struct csi_iic_xfer {
+	uint16_t			hwDevAddr;		//slave device address(bit7~1 for 7 bit address, same as csi_iic_write_nbyte)
+	uint8_t				byRead;			//1: read, 0: write
+	uint8_t				byRegLen;		//register address length(byte), 0~4
+	uint32_t			wReg;			//register address, high byte first on bus
+	uint8_t				*pbyBuf;		//data buffer
+	uint16_t			hwLen;			//data length
+	csi_iic_xfer_cb_t	callback;		//called in interrupt: IIC_EVENT_SEND_COMPLETE/IIC_EVENT_RECEIVE_COMPLETE/IIC_EVENT_ERROR
+	void				*pArg;			//user param
+};
+
 typedef enum
 {
 	IIC_INTSRC_NONE     	= (0x00ul << 0),
@@ -167,6 +183,30 @@ csi_error_t csi_iic_write_nbyte(csp_i2c_t *ptIicBase,uint32_t wDevAddr, uint32_t
 csi_error_t csi_iic_read_nbyte(csp_i2c_t *ptIicBase,uint32_t wDevAddr, uint32_t wReadAdds, uint8_t wReadAddrNumByte,volatile uint8_t *pbyIicData,uint32_t wNumByteRead);
 
 
+/** \brief  queue an async master transaction; it is started at once when the bus is idle, 
+ *          the following ones are started from the interrupt. Init master with hwInt = IIC_INTSRC_NONE,
+ *          the interrupt mask is driven by the async transfer.
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \param[in] ptXfer: transaction, must stay valid until its callback
+ *  \return error code \ref csi_error_t, CSI_BUSY: queue full
+ */ 
+csi_error_t csi_iic_master_xfer_async(csp_i2c_t *ptIicBase, csi_iic_xfer_t *ptXfer);
+
+/** \brief  number of async master transactions queued or in progress
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \return transaction number
+ */ 
+uint8_t csi_iic_master_xfer_pending(csp_i2c_t *ptIicBase);
+
+/** \brief  async master interrupt process(to be called in IIC IRQhandler)
+ * 
+ *  \param[in] ptIicBase: pointer of iic register structure
+ *  \return true: handled by async master, false: no async transaction
+ */ 
+bool csi_iic_master_async_irq(csp_i2c_t *ptIicBase);
+
 /** \brief  IIC slave handler
  * 
  *  \param[in] ptIicBase: pointer of iic register structure
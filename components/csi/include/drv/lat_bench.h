@@ -0,0 +1,171 @@
+/***********************************************************************//**
+ * \file  lat_bench.h
+ * \brief  head file for interrupt latency/jitter harness: histograms, masked
+ *         section tracker and text report; no register access, builds on host
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#ifndef _DRV_LAT_BENCH_H_
+#define _DRV_LAT_BENCH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//soc.h is not included(host build), defaults may be overridden by compiler defines
+#ifndef LAT_HIST_BINS
+#define LAT_HIST_BINS		16			//bin 0: [0, 2), bin n: [2^n, 2^(n+1)), last bin open
+#endif
+
+/// masked section sites instrumented by LAT_CRIT_ENTER/LAT_CRIT_EXIT
+typedef enum {
+	LAT_CRIT_HWDIV = 0,					//hwdiv.c, HWDIV_MODE_IRQ_LOCK divider access
+	LAT_CRIT_STIMER,					//csi_stimer_idle_ticks, wheel scan before a tickless sleep
+	LAT_CRIT_SPI_TX,					//apt_spi_intr_send_data, fifo fill in spi isr
+	LAT_CRIT_USER,						//first user site, LAT_CRIT_USER + (0 ~ 3)
+	LAT_CRIT_NUM = LAT_CRIT_USER + 4
+} lat_crit_site_e;
+
+/// \struct lat_hist_t
+/// \brief  latency statistics of one run, unit of lat_port_cycles or of the caller
+typedef struct {
+	uint32_t			wCount;
+	uint32_t			wMin;
+	uint32_t			wMax;
+	uint32_t			wHist[LAT_HIST_BINS];
+} lat_hist_t;
+
+/// \struct lat_crit_t
+/// \brief  one masked section site, the outermost enter/exit pair is timed
+typedef struct {
+	uint32_t			wCount;
+	uint32_t			wMax;
+	uint32_t			wStart;
+	uint8_t				byDepth;
+} lat_crit_t;
+
+/// report output, one character
+typedef void (*lat_putc_t)(char c);
+
+#ifdef CONFIG_LAT_CRIT_HOOK
+
+#define LAT_CRIT_ENTER(site)	lat_crit_enter(site)
+#define LAT_CRIT_EXIT(site)		lat_crit_exit(site)
+
+#else
+
+#define LAT_CRIT_ENTER(site)
+#define LAT_CRIT_EXIT(site)
+
+#endif
+
+/**
+  \brief 	   free running time stamp for the section tracker, counts up, wraps at 2^32,
+  			   provided by the platform(board: coret cycles, host: thread cpu time ns);
+  			   called with interrupts masked, must not divide(hwdiv.c hook)
+  \return 	   time stamp
+ */
+extern uint32_t lat_port_cycles(void);
+
+/**
+  \brief 	   mask interrupts around the section tracker state, provided by the platform
+  			   (board: csi_irq_save, host: a mutex); the LAT_CRIT_USER sites may be used
+  			   outside a masked section, the byDepth/wStart pair must not be torn
+  \return 	   state for lat_port_irq_restore
+ */
+extern uint32_t lat_port_irq_save(void);
+
+/**
+  \brief 	   restore interrupts masked by lat_port_irq_save
+  \param[in]   wState		return of lat_port_irq_save
+  \return 	   none
+ */
+extern void lat_port_irq_restore(uint32_t wState);
+
+/**
+  \brief 	   clear a histogram
+  \param[in]   ptHist		pointer of histogram
+  \return 	   none
+ */
+void lat_hist_reset(lat_hist_t *ptHist);
+
+/**
+  \brief 	   add one sample, no locking, add from one context only
+  \param[in]   ptHist		pointer of histogram
+  \param[in]   wVal			latency
+  \return 	   none
+ */
+void lat_hist_add(lat_hist_t *ptHist, uint32_t wVal);
+
+/**
+  \brief 	   percentile, upper bound of the bin holding it, clipped to min/max
+  \param[in]   ptHist		pointer of histogram
+  \param[in]   byPct		percent, 1 ~ 100
+  \return 	   latency, 0: no samples
+ */
+uint32_t lat_hist_percentile(const lat_hist_t *ptHist, uint8_t byPct);
+
+/**
+  \brief 	   set report output and unit string, call before lat_report/lat_crit_report
+  \param[in]   putc			character output
+  \param[in]   pUnit		unit name, e.g. "cyc" or "ns"
+  \return 	   none
+ */
+void lat_report_init(lat_putc_t putc, const char *pUnit);
+
+/**
+  \brief 	   print one histogram:
+  			   "LAT <name> n=.. min=.. p50=.. p99=.. max=.. jitter=.. <unit> PASS|FAIL"
+  			   followed by one "  [lo, hi] count" line per used bin
+  \param[in]   pName		load name
+  \param[in]   ptHist		pointer of histogram
+  \param[in]   wLimit		max allowed latency, 0: no check
+  \return 	   0: pass; -1: max over limit or no samples
+ */
+int lat_report(const char *pName, const lat_hist_t *ptHist, uint32_t wLimit);
+
+//masked section tracker, built with CONFIG_LAT_CRIT_HOOK only
+/**
+  \brief 	   clear all section sites
+  \return 	   none
+ */
+void lat_crit_reset(void);
+
+/**
+  \brief 	   masked section begins, called by LAT_CRIT_ENTER inside the section
+  \param[in]   bySite		\ref lat_crit_site_e
+  \return 	   none
+ */
+void lat_crit_enter(uint8_t bySite);
+
+/**
+  \brief 	   masked section ends, called by LAT_CRIT_EXIT inside the section
+  \param[in]   bySite		\ref lat_crit_site_e
+  \return 	   none
+ */
+void lat_crit_exit(uint8_t bySite);
+
+/**
+  \brief 	   get statistics of a site
+  \param[in]   bySite		\ref lat_crit_site_e
+  \return 	   pointer of statistics, NULL: site out of range
+ */
+const lat_crit_t *lat_crit_get(uint8_t bySite);
+
+/**
+  \brief 	   print used sites, "CRIT <site> n=.. max=.. <unit> PASS|FAIL"
+  \param[in]   wLimit		max allowed section length, 0: no check
+  \return 	   0: pass; -1: a section over limit
+ */
+int lat_crit_report(uint32_t wLimit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DRV_LAT_BENCH_H_ */
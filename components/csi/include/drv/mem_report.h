@@ -0,0 +1,102 @@
+/***********************************************************************//**
+ * \file  mem_report.h
+ * \brief  head file for stack/heap headroom telemetry: stack high-water mark
+ *         from the painted stack, heap low-water mark, collision watch on the
+ *         tick; no register access, builds on host
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#ifndef _DRV_MEM_REPORT_H_
+#define _DRV_MEM_REPORT_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MEM_PAINT_WORD		0xA5A5A5A5ul	//stack paint pattern, startup.S uses the same literal
+#define MEM_UNKNOWN			0xFFFFFFFFul	//value not tracked(heap low-water mark without CONFIG_MM_MAX_USED)
+
+#ifndef MEM_WATCH_PROBE
+#define MEM_WATCH_PROBE		4				//painted words checked at the alarm line per tick
+#endif
+
+/// alarm source, bit of csi_mem_alarm_t byWhat
+#define MEM_ALARM_STACK		(0x01ul)		//stack reached the alarm line(limit + stack margin)
+#define MEM_ALARM_HEAP		(0x02ul)		//free heap fell below the heap margin
+#define MEM_ALARM_CRASH		(0x04ul)		//lowest stack word overwritten, stack ran into the heap region
+
+/// \struct csi_mem_map_t
+/// \brief  memory map, word aligned; the stack grows down from pwStackTop to pwStackLimit
+typedef struct {
+	uint32_t			*pwHeapStart;		//heap region [pwHeapStart, pwHeapEnd)
+	uint32_t			*pwHeapEnd;
+	uint32_t			*pwStackLimit;		//lowest stack word, painted up to pwStackTop
+	uint32_t			*pwStackTop;		//initial sp
+	int					(*pfnHeapMinFree)(void);	//lowest free heap in bytes, < 0 or NULL: not tracked
+} csi_mem_map_t;
+
+/// \struct csi_mem_report_t
+/// \brief  headroom snapshot, bytes
+typedef struct {
+	uint32_t			wStackSize;
+	uint32_t			wStackPeak;			//deepest stack use since painting
+	uint32_t			wHeapSize;
+	uint32_t			wHeapMinFree;		//lowest free heap, MEM_UNKNOWN if not tracked
+	uint32_t			wGap;				//stack never reached above the limit, 0: collided
+} csi_mem_report_t;
+
+/// alarm callback, called once per source from csi_mem_watch_tick(interrupt context)
+typedef void (*csi_mem_alarm_t)(uint8_t byWhat, uint32_t wLeft);
+
+/**
+  \brief 	   paint [pwFrom, pwTo) with MEM_PAINT_WORD; the board stack is painted
+  			   by startup.S(MEM_STACK_PAINT_EN), this is for other stacks and the host
+  \param[in]   pwFrom		first word
+  \param[in]   pwTo			end, not painted
+  \return 	   none
+ */
+void csi_mem_paint(uint32_t *pwFrom, uint32_t *pwTo);
+
+/**
+  \brief 	   set the memory map used by csi_mem_report and the watch, the board
+  			   map is set by __main(mem_init.c)
+  \param[in]   ptMap		pointer of memory map, must stay valid
+  \return 	   none
+ */
+void csi_mem_map_init(const csi_mem_map_t *ptMap);
+
+/**
+  \brief 	   take a headroom snapshot; scans the painted stack from the limit up
+  			   to the first word in use, call from thread level
+  \param[out]  ptRep		report
+  \return 	   0: ok, -1: no memory map
+ */
+int csi_mem_report(csi_mem_report_t *ptRep);
+
+/**
+  \brief 	   arm the collision watch, margins are bytes above the stack limit and
+  			   of free heap; 0 disables the source
+  \param[in]   wStackMargin	alarm when the stack gets closer than this to its limit
+  \param[in]   wHeapMargin	alarm when the free heap falls below this
+  \param[in]   fnAlarm		alarm callback, NULL: no alarm(sources still latched)
+  \return 	   none
+ */
+void csi_mem_watch_init(uint32_t wStackMargin, uint32_t wHeapMargin, csi_mem_alarm_t fnAlarm);
+
+/**
+  \brief 	   periodic check, MEM_WATCH_PROBE words at the alarm line plus the lowest
+  			   stack word, no scan; called from the coret handler when MEM_WATCH_EN=1
+  \return 	   alarm sources latched so far(MEM_ALARM_xxx)
+ */
+uint8_t csi_mem_watch_tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DRV_MEM_REPORT_H_ */
@@ -73,6 +73,14 @@ typedef enum {
 	PM_MODE_SHUTDOWN,			///< ShutDown mode of DeepSleep	
 } csi_pm_mode_e;
 
+/// \struct csi_pm_latency_t
+/// \brief  cost of a low power mode for tickless idle, unit: us
+typedef struct {
+	uint16_t	hwEntryUs;		//decision to sleep
+	uint16_t	hwExitUs;		//wakeup to code running, wakeup timer fires this early
+	uint16_t	hwMinResUs;		//break-even residency, shorter idles use a lighter mode
+} csi_pm_latency_t;
+
 /**
   \brief       SoC enter low-power mode, each chip's implementation is different
                called by csi_pm_enter_sleep
@@ -129,6 +137,22 @@ uint8_t csi_pm_get_wkint(void);
 */
 void csi_pm_attach_callback(csi_pm_mode_e eMd, void *pBeforeSlp, void *pWkup);
 
+/**
+  \brief       set latency table entry of a mode for csi_pm_idle
+  \param[in]   eMode		PM_MODE_SLEEP/PM_MODE_DEEPSLEEP/PM_MODE_SNOOZE
+  \param[in]   ptLatency	entry/exit latency and min residency
+  \return      error code
+*/
+csi_error_t csi_pm_set_latency(csi_pm_mode_e eMode, const csi_pm_latency_t *ptLatency);
+
+/**
+  \brief       tickless idle, sleep until the next stimer expiry(or any wakeup interrupt) 
+               in the deepest mode up to eMaxMode that the idle time pays for, tick is caught up on wakeup
+  \param[in]   eMaxMode		deepest mode allowed, PM_MODE_SLEEP/PM_MODE_DEEPSLEEP/PM_MODE_SNOOZE
+  \return      mode entered, PM_MODE_LPRUN: not slept(work pending or idle too short)
+*/
+csi_pm_mode_e csi_pm_idle(csi_pm_mode_e eMaxMode);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,118 @@
+/***********************************************************************//**
+ * \file  prof.h
+ * \brief  head file for cycle profiler: coret based probes, log2 histograms, binary dump
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#ifndef _DRV_PROF_H_
+#define _DRV_PROF_H_
+
+#include <stdint.h>
+#include <soc.h>
+#include <csi_core.h>
+#include <drv/common.h>
+#include <drv/uart.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// probe ids, ISR probes of board/src/interrupt.c first(PROF_ISR_EN), then user probes
+typedef enum {
+#if PROF_ISR_EN
+	PROF_ID_ISR_CORET = 0,
+	PROF_ID_ISR_SYSCON,
+	PROF_ID_ISR_IFC,
+	PROF_ID_ISR_ADC,
+	PROF_ID_ISR_EPT0,
+	PROF_ID_ISR_DMA,
+	PROF_ID_ISR_WWDT,
+	PROF_ID_ISR_GPTA0,
+	PROF_ID_ISR_GPTA1,
+	PROF_ID_ISR_GPTB0,
+	PROF_ID_ISR_GPTB1,
+	PROF_ID_ISR_RTC,
+	PROF_ID_ISR_UART0,
+	PROF_ID_ISR_UART1,
+	PROF_ID_ISR_UART2,
+	PROF_ID_ISR_USART0,
+	PROF_ID_ISR_SIO,
+	PROF_ID_ISR_I2C,
+	PROF_ID_ISR_SPI0,
+	PROF_ID_ISR_EXI0,
+	PROF_ID_ISR_EXI1,
+	PROF_ID_ISR_EXI2_3,
+	PROF_ID_ISR_EXI4_9,
+	PROF_ID_ISR_EXI10_15,
+	PROF_ID_ISR_CNTA,
+	PROF_ID_ISR_TKEY,
+	PROF_ID_ISR_LPT,
+	PROF_ID_ISR_LED,
+	PROF_ID_ISR_CMP,
+	PROF_ID_ISR_BT0,
+	PROF_ID_ISR_BT1,
+	PROF_ID_ISR_LCD,
+#endif
+	PROF_ID_USER,								//first user probe, PROF_ID_USER + (0 ~ PROF_USER_NUM-1)
+	PROF_ID_NUM = PROF_ID_USER + PROF_USER_NUM
+} csi_prof_id_e;
+
+/// \struct csi_prof_probe_t
+/// \brief  statistics of one probe, cycles of coret clock
+typedef struct {
+	uint32_t			wCount;
+	uint32_t			wMin;
+	uint32_t			wMax;
+	uint16_t			hwHist[PROF_HIST_BINS];	//bin n: [2^(n+SHIFT), 2^(n+SHIFT+1)), first/last bins open, saturating
+} csi_prof_probe_t;
+
+#ifdef CONFIG_PROF
+
+/// start a probe, declares the start stamp in the current scope
+#define PROF_BEGIN(id)		uint32_t wProfStart_##id = csi_coret_get_value()
+/// stop a probe and record the cycles since PROF_BEGIN(id) of the same scope
+#define PROF_END(id)		csi_prof_record((id), wProfStart_##id)
+
+#else
+
+#define PROF_BEGIN(id)
+#define PROF_END(id)
+
+#endif
+
+/**
+  \brief 	   clear all probes and calibrate the PROF_BEGIN/PROF_END overhead
+  \return 	   none
+ */
+void csi_prof_init(void);
+
+/**
+  \brief 	   record one measurement, called by PROF_END
+  \param[in]   eId			probe id
+  \param[in]   wStart		coret value at PROF_BEGIN
+  \return 	   none
+ */
+void csi_prof_record(csi_prof_id_e eId, uint32_t wStart);
+
+/**
+  \brief 	   get statistics of a probe
+  \param[in]   eId			probe id
+  \return 	   pointer of statistics, NULL: id out of range
+ */
+const csi_prof_probe_t *csi_prof_get(csi_prof_id_e eId);
+
+/**
+  \brief 	   dump all used probes in binary(demo/script/prof_decode.py), blocking
+  \param[in]   ptUartBase	uart to send, e.g. the console uart
+  \return 	   bytes sent
+ */
+uint32_t csi_prof_dump(csp_uart_t *ptUartBase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DRV_PROF_H_ */
@@ -27,6 +27,18 @@ typedef struct ringbuffer {
     uint16_t hwDataLen;
 } ringbuffer_t;
 
+/// \struct ringbuffer_spsc_t
+/// \brief  single-producer/single-consumer ring buffer, size must be power of two.
+///         wWrite/wRead are free-running counters, only the producer writes wWrite
+///         and only the consumer writes wRead, so no shared length field and no lock
+///         is needed between an ISR and the main loop.
+typedef struct ringbuffer_spsc {
+    uint8_t 			*pbyBuf;
+    uint32_t 			wMask;			//size - 1
+    volatile uint32_t 	wWrite;			//producer index, free-running
+    volatile uint32_t 	wRead;			//consumer index, free-running
+} ringbuffer_spsc_t;
+
 /** 
   \brief  Removes the entire FIFO contents.
   \param  [in] ptFifo: The fifo to be emptied.
@@ -79,6 +91,40 @@ void ringbuffer_byte_in(ringbuffer_t *ptFifo, uint8_t in);
   */
 uint8_t ringbuffer_byte_out(ringbuffer_t *ptFifo, void *pOutBuf);
 
+/** 
+  \brief  Gets the largest contiguous free region of the FIFO, for DMA or in-place fill.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [out] phwLen: The length of the free region.
+  \return Pointer to the free region, NULL when the FIFO is full.
+  */
+uint8_t *ringbuffer_write_acquire(ringbuffer_t *ptFifo, uint16_t *phwLen);
+
+/** 
+  \brief  Commits data written into the region got by ringbuffer_write_acquire.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [in] hwLen: The length of data written, <= the acquired length.
+  \return None.
+  */
+void ringbuffer_write_commit(ringbuffer_t *ptFifo, uint16_t hwLen);
+
+/** 
+  \brief  Gets the largest contiguous data region of the FIFO, for DMA or in-place parse.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [out] phwLen: The length of the data region.
+  \return Pointer to the data region, NULL when the FIFO is empty.
+  */
+uint8_t *ringbuffer_read_peek(ringbuffer_t *ptFifo, uint16_t *phwLen);
+
+/** 
+  \brief  Releases data got by ringbuffer_read_peek.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [in] hwLen: The length of data consumed, <= the peeked length.
+  \return None.
+  \note   commit/release both update hwDataLen, use ringbuffer_spsc_xxx when 
+  *       producer and consumer run in different contexts(ISR/main loop).
+  */
+void ringbuffer_read_release(ringbuffer_t *ptFifo, uint16_t hwLen);
+
 /** 
   \brief  Returns the size of the FIFO in bytes.
   \param  [in] ptFifo: The fifo to be used.
@@ -130,6 +176,141 @@ static inline bool ringbuffer_is_full(ringbuffer_t *ptFifo)
     return (ringbuffer_avail(ptFifo) == 0U);
 }
 
+/** 
+  \brief  Init a spsc FIFO on user buffer.
+  \param  [in] ptFifo: The fifo to be initialized.
+  \param  [in] pbyBuf: The data buffer of fifo.
+  \param  [in] wSize: The size of data buffer, must be power of two.
+  \retval true:  init ok.
+  \retval false: wSize is not power of two.
+  */
+bool ringbuffer_spsc_init(ringbuffer_spsc_t *ptFifo, uint8_t *pbyBuf, uint32_t wSize);
+
+/** 
+  \brief  Removes the entire spsc FIFO contents, must not race with producer/consumer.
+  \param  [in] ptFifo: The fifo to be emptied.
+  \return None.
+  */
+void ringbuffer_spsc_reset(ringbuffer_spsc_t *ptFifo);
+
+/** 
+  \brief  Puts some data into the spsc FIFO, producer side.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [in] pDataIn: The data to be added.
+  \param  [in] wLen: The length of the data to be added.
+  \return The number of bytes copied.
+  */
+uint32_t ringbuffer_spsc_in(ringbuffer_spsc_t *ptFifo, const void *pDataIn, uint32_t wLen);
+
+/** 
+  \brief  Gets some data from the spsc FIFO, consumer side.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [in] pOutBuf: Where the data must be copied, NULL: discard data.
+  \param  [in] wLen: The size of the destination buffer.
+  \return The number of copied bytes.
+  */
+uint32_t ringbuffer_spsc_out(ringbuffer_spsc_t *ptFifo, void *pOutBuf, uint32_t wLen);
+
+/** 
+  \brief  Puts one byte into the spsc FIFO, producer side.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [in] byDataIn: The data to be added.
+  \return The number of bytes copied, 0/1
+  */
+uint8_t ringbuffer_spsc_byte_in(ringbuffer_spsc_t *ptFifo, uint8_t byDataIn);
+
+/** 
+  \brief  Gets one byte from the spsc FIFO, consumer side.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [in] pOutBuf: Where the data must be copied.
+  \return The number of read bytes, 0/1
+  */
+uint8_t ringbuffer_spsc_byte_out(ringbuffer_spsc_t *ptFifo, void *pOutBuf);
+
+/** 
+  \brief  Gets the largest contiguous free region of the spsc FIFO, producer side.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [out] pwLen: The length of the free region.
+  \return Pointer to the free region, NULL when the FIFO is full.
+  */
+uint8_t *ringbuffer_spsc_write_acquire(ringbuffer_spsc_t *ptFifo, uint32_t *pwLen);
+
+/** 
+  \brief  Publishes data written into the acquired region, producer side.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [in] wLen: The length of data written, <= the acquired length.
+  \return None.
+  */
+void ringbuffer_spsc_write_commit(ringbuffer_spsc_t *ptFifo, uint32_t wLen);
+
+/** 
+  \brief  Gets the largest contiguous data region of the spsc FIFO, consumer side.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [out] pwLen: The length of the data region.
+  \return Pointer to the data region, NULL when the FIFO is empty.
+  */
+uint8_t *ringbuffer_spsc_read_peek(ringbuffer_spsc_t *ptFifo, uint32_t *pwLen);
+
+/** 
+  \brief  Frees data got by ringbuffer_spsc_read_peek, consumer side.
+  \param  [in] ptFifo: The fifo to be used.
+  \param  [in] wLen: The length of data consumed, <= the peeked length.
+  \return None.
+  */
+void ringbuffer_spsc_read_release(ringbuffer_spsc_t *ptFifo, uint32_t wLen);
+
+/** 
+  \brief  Returns the size of the spsc FIFO in bytes.
+  \param  [in] ptFifo: The fifo to be used.
+  \return The size of the FIFO.
+  */
+static inline uint32_t ringbuffer_spsc_size(ringbuffer_spsc_t *ptFifo)
+{
+    return ptFifo->wMask + 1U;
+}
+
+/** 
+  \brief  Returns the number of used bytes in the spsc FIFO.
+  \param  [in] ptFifo: The fifo to be used.
+  \return The number of used bytes.
+  */
+static inline uint32_t ringbuffer_spsc_len(ringbuffer_spsc_t *ptFifo)
+{
+    return ptFifo->wWrite - ptFifo->wRead;
+}
+
+/** 
+  \brief  Returns the number of bytes available in the spsc FIFO.
+  \param  [in] ptFifo: The fifo to be used.
+  \return The number of bytes available.
+  */
+static inline uint32_t ringbuffer_spsc_avail(ringbuffer_spsc_t *ptFifo)
+{
+    return ringbuffer_spsc_size(ptFifo) - ringbuffer_spsc_len(ptFifo);
+}
+
+/** 
+  \brief  Is the spsc FIFO empty?
+  \param  [in] ptFifo: The fifo to be used.
+  \retval true: Yes.
+  \retval false: No.
+  */
+static inline bool ringbuffer_spsc_is_empty(ringbuffer_spsc_t *ptFifo)
+{
+    return (ptFifo->wWrite == ptFifo->wRead);
+}
+
+/** 
+  \brief  Is the spsc FIFO full?
+  \param  [in] ptFifo: The fifo to be used.
+  \retval true: Yes.
+  \retval false: No.
+  */
+static inline bool ringbuffer_spsc_is_full(ringbuffer_spsc_t *ptFifo)
+{
+    return (ringbuffer_spsc_len(ptFifo) > ptFifo->wMask);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -143,14 +143,22 @@ typedef struct
 	uint8_t      byTxRxMode;          //send/receive mode: polling/interrupt
 }csi_spi_config_t;
 
+/**
+  \brief      spi transfer complete callback, called in dma interrupt
+  \param[in]  ptSpiBase	pointer of spi register structure
+  \param[in]  eEvent		transfer event \ref csi_spi_event_e
+  \param[in]  pArg			user param passed by csi_spi_attach_callback
+  */
+typedef void (*csi_spi_callback_t)(csp_spi_t *ptSpiBase, csi_spi_event_e eEvent, void *pArg);
+
 typedef struct
 {
 	uint8_t             *pbyTxData;      //< Output data buf
 	uint8_t             *pbyRxData;      //< Input  data buf
 	uint8_t             bySendMode;      // send mode
 	uint8_t             byRecvMode;      // receive mode
-    uint16_t            byTxSize;        //< Output data size specified by user
-    uint16_t            byRxSize;        //< Input  data size specified by user
+    uint32_t            wTxSize;         //< Output data size specified by user
+    uint32_t            wRxSize;         //< Input  data size specified by user
 	uint8_t             byRxFifoLength;  //< receive fifo length
 	uint8_t             byTxFifoLength;  // send fifo  threshold
 	uint8_t             byInt;  		 //< interrupt
@@ -160,6 +168,10 @@ typedef struct
 	uint8_t             byReadable;
 	uint8_t             byWriteable;
 	uint8_t             bySendRecMode;
+	uint8_t             byTxDmaCh;       //tx dma channel, set by csi_spi_dma_tx_init
+	uint8_t             byRxDmaCh;       //rx dma channel, set by csi_spi_dma_rx_init
+	csi_spi_callback_t  callback;        //dma transfer complete callback
+	void                *pArg;           //user param of callback
 	
 }csi_spi_transmit_t;
 extern csi_spi_transmit_t g_tSpiTransmit; 
@@ -249,6 +261,15 @@ int8_t csi_spi_get_state(csi_spi_work_mode_e eWorkMode);
  */
 int32_t csi_spi_send(csp_spi_t *ptSpiBase, void *pData, uint32_t wSize);
 
+/** \brief sending scatter-gather segments to spi transmitter without copying, polling mode only
+ * 
+ *  \param[in] ptSpiBase: pointer of spi register structure
+ *  \param[in] ptIov: segment array
+ *  \param[in] byIovCnt: segment number
+ *  \return  the num of data which is send successfully or CSI_ERROR/CSI_BUSY/CSI_UNSUPPORTED
+ */
+int32_t csi_spi_sendv(csp_spi_t *ptSpiBase, const csi_iovec_t *ptIov, uint8_t byIovCnt);
+
 /** \brief sending data to spi transmitter, non-blocking mode(interrupt mode)
  * 
  *  \param[in] ptSpiBase: pointer of spi register structure
@@ -327,10 +348,10 @@ void csi_spi_clr_rxfifo(csp_spi_t *ptSpiBase);
  * 
  *  \param[in] ptSpiBase: pointer of spi register structure
  *  \param[in] pDataOut :send data buffer pointer
- *  \param[in] bySize ：length
+ *  \param[in] wSize ：length
  *  \return error code \ref csi_error_t
  */ 
-csi_error_t csi_spi_send_fast(csp_spi_t *ptSpiBase,void *pDataOut,uint8_t bySize);
+csi_error_t csi_spi_send_fast(csp_spi_t *ptSpiBase,void *pDataOut,uint32_t wSize);
 
 /** \brief spi send and receive fast
  * 
@@ -363,6 +384,57 @@ csi_error_t csi_spi_send_dma(csp_spi_t *ptSpiBase, const void *pData, uint16_t h
  */
 csi_error_t csi_spi_recv_dma(csp_spi_t *ptSpiBase, void *pData, uint16_t hwSize,  uint8_t byDmaCh);
 
+/** \brief spi dma send mode init, spi tx fifo request triggers the dma channel through etb
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] eDmaCh: channel number of dma, eDmaCh: DMA_CH0` DMA_CH3
+ *  \param[in] eEtbCh: channel id number of etb, eEtbCh >= ETB_CH8
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_spi_dma_tx_init(csp_spi_t *ptSpiBase, csi_dma_ch_e eDmaCh, csi_etb_ch_e eEtbCh);
+
+/** \brief spi dma receive mode init, spi rx fifo request triggers the dma channel through etb
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] eDmaCh: channel number of dma, eDmaCh: DMA_CH0` DMA_CH3
+ *  \param[in] eEtbCh: channel id number of etb, eEtbCh >= ETB_CH8
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_spi_dma_rx_init(csp_spi_t *ptSpiBase, csi_dma_ch_e eDmaCh, csi_etb_ch_e eEtbCh);
+
+/** \brief attach dma transfer complete callback
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] callback: callback function, NULL: poll csi_spi_get_state
+ *  \param[in] pArg: user param passed to callback
+ *  \return  none
+ */
+void csi_spi_attach_callback(csp_spi_t *ptSpiBase, csi_spi_callback_t callback, void *pArg);
+
+/** \brief send and receive data of spi by DMA(8 bit frame), non-blocking; long transfers are 
+ *         split into 0xfff chunks in the dma interrupt. Needs csi_spi_dma_tx_init, and 
+ *         csi_spi_dma_rx_init when pDatain is used.
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] pDataout: pointer to send buffer, NULL: send 0x00 for receive clock
+ *  \param[in] pDatain: pointer to receive buffer, NULL: send only
+ *  \param[in] wSize: number of data to send/receive(byte)
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_spi_send_receive_dma(csp_spi_t *ptSpiBase, const void *pDataout, void *pDatain, uint32_t wSize);
+
+/** \brief send scatter-gather segments of spi by DMA(8 bit frame), non-blocking; the next
+ *         segment is started from the dma TCIT interrupt, completion is reported like
+ *         csi_spi_send_receive_dma(SPI_EVENT_SEND_COMPLETE). Needs csi_spi_dma_tx_init,
+ *         received data is not read.
+ * 
+ *  \param[in] ptSpiBase: pointer of SPI reg structure.
+ *  \param[in] ptIov: segment array, segment length <= 0xfff, must stay valid until sent
+ *  \param[in] byIovCnt: segment number
+ *  \return  error code \ref csi_error_t
+ */
+csi_error_t csi_spi_sendv_dma(csp_spi_t *ptSpiBase, const csi_iovec_t *ptIov, uint8_t byIovCnt);
+
 /** \brief spi receive data,interrupt call 
  * 
  *  \param[in] ptSpiBase: pointer of SPI reg structure.
@@ -17,7 +17,6 @@
 
 #include <drv/gpio.h>
 #include <drv/spi.h>
-#include <drv/qspi.h>
 #include <drv/common.h>
 
 #ifdef __cplusplus
@@ -30,7 +29,7 @@ extern "C" {
 * \return    24bit flash id
 */
 
-#define FLASH_ID_BUILD(VENDOR_ID,DEVICE_ID)
+#define FLASH_ID_BUILD(VENDOR_ID,DEVICE_ID)	(((uint32_t)(VENDOR_ID) << 16) | ((DEVICE_ID) & 0xffff))
 
 /**
 * \struct csi_spiflash_lock_info_t
@@ -93,8 +92,7 @@ typedef enum {
 } csi_spiflash_data_line_t;
 
 typedef union {
-    csi_spi_t   spi;
-    csi_qspi_t  qspi;
+    csp_spi_t   *spi;                      ///< SPI register base, the chip has no qspi controler
 } csi_spi_qspi_t;
 
 /**
@@ -114,7 +112,7 @@ typedef struct {
 */
 typedef struct {
     csi_spi_qspi_t spi_qspi;               ///< Spi/qspi handle
-    void (*spi_cs_callback)(csi_gpio_pin_state_t value);
+    void (*spi_cs_callback)(csi_gpio_pin_state_e value);
     void           *flash_prv_info;        ///< Point to vendor private feature struct
     int32_t (*spi_send)(void *spi, uint8_t cmd, uint32_t addr, uint32_t addr_size, const void *data, uint32_t size);
     int32_t (*spi_receive)(void *spi, uint8_t cmD, uint32_t addr, uint32_t addr_size, void *data, uint32_t size);
@@ -125,7 +123,7 @@ typedef struct {
   \brief       Initialize SPIFLASH with spi controler  and probe flash device
   \param[in]   spi        SPIFLASH handle
   \param[in]   spi_idx    SPI controler index
-  \param[in]   spi_cs     GPIO info for chip select,if NULL, not use gpio cs
+  \param[in]   spi_cs     callback to drive chip select by gpio, required(CSI_ERROR if NULL)
   \return      Error code
 */
 csi_error_t csi_spiflash_spi_init(csi_spiflash_t *spiflash, uint32_t spi_idx, void *spi_cs_callback);
@@ -239,6 +237,7 @@ csi_error_t csi_spiflash_unlock(csi_spiflash_t *spiflash, uint32_t offset, uint3
   \param[in]   offset      Protect flash offset,offset need protect block size aligned
   \param[in]   size        Locked size
   \return      0:unlocked if query region overlay with locked region 1: locked if query reigon is fully in locked region
+               < 0: error code
 */
 int csi_spiflash_is_locked(csi_spiflash_t *spiflash, uint32_t offset, uint32_t size);
 
@@ -250,6 +249,13 @@ int csi_spiflash_is_locked(csi_spiflash_t *spiflash, uint32_t offset, uint32_t s
 */
 csi_error_t csi_spiflash_config_data_line(csi_spiflash_t *spiflash, csi_spiflash_data_line_t line);
 
+/**
+  \brief       Wait until the program/erase left running by csi_spiflash_program/csi_spiflash_erase is done
+  \param[in]   spiflash    SPIFLASH handle to operate
+  \return      Error code
+*/
+csi_error_t csi_spiflash_sync(csi_spiflash_t *spiflash);
+
 
 #ifdef __cplusplus
 }
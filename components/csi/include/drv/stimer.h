@@ -0,0 +1,116 @@
+/***********************************************************************//**
+ * \file  stimer.h
+ * \brief  head file for software timer wheel driven by the system tick
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#ifndef _DRV_STIMER_H_
+#define _DRV_STIMER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <drv/common.h>
+#include <drv/tick.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// ms to ticks(round up), for constant ms only, runtime values divide
+#define CSI_STIMER_MS(ms)		((uint32_t)(((ms) * CONFIG_SYSTICK_HZ + 999U) / 1000U))
+
+/// csi_stimer_idle_ticks: no timer running
+#define STIMER_IDLE_MAX			0x7fffffffl
+
+typedef enum{
+	STIMER_CTX_TICK	= 0,		//callback runs in tick interrupt
+	STIMER_CTX_DEFERRED			//callback runs in csi_stimer_process(main loop)
+}csi_stimer_ctx_e;
+
+typedef struct csi_stimer csi_stimer_t;
+
+/**
+  \brief       software timer callback
+  \param[in]   ptTimer		the expired timer
+  \param[in]   pArg			user param passed by csi_stimer_init
+  */
+typedef void (*csi_stimer_cb_t)(csi_stimer_t *ptTimer, void *pArg);
+
+/// \struct csi_stimer
+/// \brief  software timer, allocated by the user(static), intrusive wheel node
+struct csi_stimer {
+	dlist_t				tNode;			//wheel slot or deferred list link
+	uint32_t			wExpire;		//absolute expiry tick
+	uint32_t			wPeriod;		//reload ticks, 0: one shot
+	csi_stimer_cb_t		callback;
+	void				*pArg;
+	uint8_t				byCtx;			//csi_stimer_ctx_e
+	uint8_t				byState;		//idle/active/fired, not open to users
+};
+
+/**
+  \brief 	   init a timer, call once before start
+  \param[in]   ptTimer		pointer of timer
+  \param[in]   callback		expiry callback
+  \param[in]   pArg			user param of callback
+  \param[in]   eCtx			callback context, tick interrupt or main loop
+  \return 	   none
+ */
+void csi_stimer_init(csi_stimer_t *ptTimer, csi_stimer_cb_t callback, void *pArg, csi_stimer_ctx_e eCtx);
+
+/**
+  \brief 	   start(or restart) a timer, O(1)
+  \param[in]   ptTimer		pointer of timer
+  \param[in]   wTicks		ticks to first expiry, 0 is taken as 1
+  \param[in]   wPeriod		reload ticks after expiry, 0: one shot
+  \return 	   error code \ref csi_error_t
+ */
+csi_error_t csi_stimer_start(csi_stimer_t *ptTimer, uint32_t wTicks, uint32_t wPeriod);
+
+/**
+  \brief 	   stop a timer, O(1), also drops a fired but not yet processed deferred expiry
+  \param[in]   ptTimer		pointer of timer
+  \return 	   none
+ */
+void csi_stimer_stop(csi_stimer_t *ptTimer);
+
+/**
+  \brief 	   timer is running or waiting in the deferred list
+  \param[in]   ptTimer		pointer of timer
+  \return 	   true/false
+ */
+bool csi_stimer_is_active(csi_stimer_t *ptTimer);
+
+/**
+  \brief 	   advance the wheel by one tick, called in tick_irqhandler
+  \return 	   none
+ */
+void csi_stimer_tick(void);
+
+/**
+  \brief 	   advance the wheel by wTicks ticks at once, after the tick interrupt was suppressed
+  \param[in]   wTicks		ticks to advance
+  \return 	   none
+ */
+void csi_stimer_skip(uint32_t wTicks);
+
+/**
+  \brief 	   ticks the tick interrupt can be suppressed for(tickless idle)
+  \return 	   -1: deferred callbacks waiting; 0: next tick is due; STIMER_IDLE_MAX: no timer running
+ */
+int32_t csi_stimer_idle_ticks(void);
+
+/**
+  \brief 	   run callbacks of expired STIMER_CTX_DEFERRED timers, call in main loop
+  \return 	   number of callbacks run
+ */
+uint32_t csi_stimer_process(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DRV_STIMER_H_ */
@@ -64,6 +64,57 @@ uint32_t csi_tick_get_ms(void);
 */
 uint64_t csi_tick_get_us(void);
 
+/**
+  \brief       Get the coret cycles which start from csi_tick_init, lock-free snapshot, monotonic in every context
+  \return      64 bit cycle count
+*/
+uint64_t csi_tick_get_cycles64(void);
+
+/**
+  \brief       Convert coret cycles to time, precomputed multiplier, no division
+  \param[in]   dwCycles    cycle count
+  \return      time (us)
+*/
+uint64_t csi_tick_cycles_to_us(uint64_t dwCycles);
+
+/**
+  \brief       Convert coret cycles to time, precomputed multiplier, no division
+  \param[in]   dwCycles    cycle count
+  \return      time (ms)
+*/
+uint64_t csi_tick_cycles_to_ms(uint64_t dwCycles);
+
+/**
+  \brief       Get coret cycles per tick
+  \return      cycles
+*/
+uint32_t csi_tick_get_period(void);
+
+/**
+  \brief       Stop coret for tickless idle, call with interrupt disabled
+  \return      cycles to the next tick, 0: tick pending, do not sleep
+*/
+uint32_t csi_tick_stop(void);
+
+/**
+  \brief       Run coret as wakeup timer after csi_tick_stop
+  \param[in]   wCycles    cycles to wakeup, 2 ~ (CORET_LOAD_RELOAD_Msk + 1)
+*/
+void csi_tick_arm(uint32_t wCycles);
+
+/**
+  \brief       Stop the coret wakeup timer
+  \return      cycles elapsed since csi_tick_arm
+*/
+uint32_t csi_tick_disarm(void);
+
+/**
+  \brief       Resume tick after tickless idle, catch up tick count, cycle clock and stimer wheel
+  \param[in]   wRemain    return of csi_tick_stop
+  \param[in]   dwElapsed  coret cycles the tick was stopped for
+*/
+void csi_tick_resume(uint32_t wRemain, uint64_t dwElapsed);
+
 /**
   \brief       Increase the sys-tick
 */
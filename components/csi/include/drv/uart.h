@@ -123,12 +123,13 @@ typedef enum
 typedef enum{
 	//send mode
 	UART_TX_MODE_POLL		=	0,			//polling mode, no interrupt
-	UART_TX_MODE_INT		=	1,			//tx use interrupt mode(TXDONE)
+	UART_TX_MODE_INT		=	1,			//tx use interrupt mode(TXFIFO), fill fifo in bulk, queue UART_TX_QUEUE_LEN buffers
 	//receive
 	UART_RX_MODE_POLL		=	0,			//polling mode, no interrupt
 	UART_RX_MODE_INT_FIX	=	1,			//rx use interrupt mode(RXFIFO), receive assign(fixed) length data		
 	UART_RX_MODE_INT_DYN	=	2,			//rx use interrupt mode(RXFIFO), receive a bunch of data(dynamic length data)
-	UART_RX_MODE_INT		=	3			//rx use interrupt mode
+	UART_RX_MODE_INT		=	3,			//rx use interrupt mode
+	UART_RX_MODE_DMA_CIRC	=	4			//rx use circular dma into spsc ringbuf, frame end by RXTO
 }csi_uart_work_e;
 
 /// \struct csi_uart_config_t
@@ -144,6 +145,21 @@ typedef struct {
 } csi_uart_config_t;
 
 
+/**
+  \brief      uart circular dma receive frame callback, called in interrupt when RXTO ends a frame
+  \param[in]  ptUartBase	pointer of uart register structure
+  \param[in]  ptRingbuf	spsc ringbuf holding the frame, the frame is the last wLen bytes written
+  \param[in]  wLen			frame length(byte)
+  */
+typedef void (*csi_uart_frame_cb_t)(csp_uart_t *ptUartBase, ringbuffer_spsc_t *ptRingbuf, uint32_t wLen);
+
+/// \struct csi_uart_txbuf_t
+/// \brief  uart interrupt send queue entry, not open to users  
+typedef struct {
+	const uint8_t		*pbyData;			//pointer of send buf 
+	uint16_t            hwSize;				//send data size
+} csi_uart_txbuf_t;
+
 /// \struct csi_uart_transfer_t
 /// \brief  uart transport handle, not open to users  
 typedef struct {
@@ -155,6 +171,15 @@ typedef struct {
 	uint16_t            hwRxSize;			//rx receive data size
 	uint8_t				*pbyTxData;			//pointer of send buf 
 	ringbuffer_t		*ptRingBuf;			//pointer of ringbuffer		
+	ringbuffer_spsc_t	*ptSpscBuf;			//pointer of lock-free spsc ringbuffer, used instead of ptRingBuf when set
+	uint8_t				byRxDmaCh;			//circular rx dma channel
+	uint32_t			wFrmStart;			//circular rx current frame start(free-running index)
+	uint32_t			wDmaBase;			//circular rx bytes dma wrote before the current lap(free-running)
+	uint32_t			wRxOverrun;			//circular rx bytes overwritten before they were read
+	csi_uart_frame_cb_t	fnFrameCb;			//circular rx frame callback
+	uint8_t				byTxIn;				//send queue in index(free-running)
+	uint8_t				byTxOut;			//send queue out index(free-running)
+	csi_uart_txbuf_t	tTxQueue[UART_TX_QUEUE_LEN];	//interrupt send queue, head is being sent
 } csi_uart_trans_t;
 
 extern csi_uart_trans_t g_tUartTran[UART_IDX_NUM];	
@@ -202,15 +227,45 @@ csi_error_t csi_uart_stop(csp_uart_t *ptUartBase, csi_uart_func_e eFunc);
  */ 
 void csi_uart_set_buffer(csp_uart_t *ptUartBase, ringbuffer_t *ptRingbuf, uint8_t *pbyRdBuf,  uint16_t hwLen);
 
+/** 
+  \brief 	   set uart receive buffer as lock-free spsc ringbuf, replace csi_uart_set_buffer
+  \param[in]   ptUartBase	pointer of uart register structure
+  \param[in]   ptRingbuf	pointer of receive spsc ringbuf
+  \param[in]   pbyRdBuf		pointer of uart receive buffer
+  \param[in]   hwLen		uart receive buffer length, must be power of two
+  \return 	   error code \ref csi_error_t
+ */ 
+csi_error_t csi_uart_set_spsc_buffer(csp_uart_t *ptUartBase, ringbuffer_spsc_t *ptRingbuf, uint8_t *pbyRdBuf, uint16_t hwLen);
+
 /**
-  \brief       Start send data to UART transmitter, this function is blocking.
+  \brief       Start send data to UART transmitter, polling mode is blocking; interrupt mode 
+  *			   queues the buffer and returns, the buffer must stay valid until sent
   \param[in]   uart     	uart handle to operate.
   \param[in]   data     	pointer to buffer with data to send to UART transmitter.
   \param[in]   size     	number of data to send (byte).
-  \return      the num of data which is sent successfully or CSI_ERROR.
+  \return      polling mode: the num of data which is sent successfully; 
+  *			   interrupt mode: CSI_OK or CSI_ERROR(send queue full)
 */
 int16_t csi_uart_send(csp_uart_t *ptUartBase, const void *pData, uint16_t hwSize);
 
+/**
+  \brief       send scatter-gather segments as one frame without copying, polling mode is blocking;
+  *			   interrupt mode queues every segment(segments <= UART_TX_QUEUE_LEN) and returns
+  \param[in]   ptUartBase	pointer of uart register structure
+  \param[in]   ptIov		segment array, segment length <= 0xffff
+  \param[in]   byIovCnt		segment number
+  \return      polling mode: the num of data which is sent successfully; 
+  *			   interrupt mode: CSI_OK or CSI_ERROR(send queue full)
+*/
+int32_t csi_uart_sendv(csp_uart_t *ptUartBase, const csi_iovec_t *ptIov, uint8_t byIovCnt);
+
+/** 
+  \brief 	   fill uart tx fifo from the send queue, call it in uart_irqhandler on TXFIFO interrupt
+  \param[in]   ptUartBase	pointer of uart register structure
+  \return 	   none
+ */
+void csi_uart_send_fifo_fill(csp_uart_t *ptUartBase);
+
 /** 
   \brief 	   send data to uart transmitter, this function is interrupt mode(async/non-blocking)
   \param[in]   ptUartBase	pointer of uart register structure
@@ -230,6 +285,38 @@ int16_t csi_uart_send(csp_uart_t *ptUartBase, const void *pData, uint16_t hwSize
  */
 csi_error_t csi_uart_dma_rx_init(csp_uart_t *ptUartBase, csi_dma_reload_e eReload, csi_dma_ch_e eDmaCh, csi_etb_ch_e eEtbCh);
 
+/** 
+  \brief 	   uart circular dma receive start, dma reloads into the spsc ringbuf forever and 
+  *			   RXTO/dma TCIT publish the write index, no per-byte interrupt
+  \param[in]   ptUartBase	pointer of uart register structure
+  \param[in]   eDmaCh		channel id number of dma, eDmaCh: DMA_CH0 ` DMA_CH3
+  \param[in]   eEtbCh		channel id number of etb, eEtbCh >= ETB_CH8
+  \param[in]   ptRingbuf	pointer of receive spsc ringbuf
+  \param[in]   pbyRdBuf		pointer of uart receive buffer
+  \param[in]   hwLen		uart receive buffer length, power of two and <= 0x800
+  \param[in]   callback		frame callback \ref csi_uart_frame_cb_t, NULL: no frame callback
+  \return      error code \ref csi_error_t
+ */
+csi_error_t csi_uart_recv_dma_circ(csp_uart_t *ptUartBase, csi_dma_ch_e eDmaCh, csi_etb_ch_e eEtbCh, ringbuffer_spsc_t *ptRingbuf, 
+				uint8_t *pbyRdBuf, uint16_t hwLen, csi_uart_frame_cb_t callback);
+
+/** 
+  \brief 	   publish circular dma receive write index into the spsc ringbuf, call it in 
+  *			   uart_irqhandler on RXTO(bFrmEnd = true), or in main loop to poll(bFrmEnd = false)
+  \param[in]   ptUartBase	pointer of uart register structure
+  \param[in]   bFrmEnd		true: end current frame and call frame callback
+  \return      none
+ */
+void csi_uart_dma_circ_update(csp_uart_t *ptUartBase, bool bFrmEnd);
+
+/** 
+  \brief 	   get and clear the circular dma receive overrun count; on overrun the oldest
+  *			   data is dropped by csi_uart_receive, so received data has a gap there
+  \param[in]   ptUartBase	pointer of uart register structure
+  \return      bytes lost since the last call
+ */
+uint32_t csi_uart_dma_circ_overrun(csp_uart_t *ptUartBase);
+
 /** 
   \brief 	   uart dma send mode init
   \param[in]   ptUartBase	pointer of uart register structure
@@ -249,6 +336,17 @@ csi_error_t csi_uart_dma_tx_init(csp_uart_t *ptUartBase, csi_dma_ch_e eDmaCh, cs
  */
 csi_error_t csi_uart_send_dma(csp_uart_t *ptUartBase, csi_dma_ch_e eDmaCh, const void *pData, uint16_t hwSize);
 
+/** 
+  \brief 	   send scatter-gather segments from uart, this function is dma mode, the next
+  *			   segment is started from the dma TCIT interrupt, get completion by csi_dma_get_msg
+  \param[in]   ptUartBase	pointer of uart register structure
+  \param[in]   eDmaCh		channel number of dma, eDmaCh: DMA_CH0` DMA_CH3
+  \param[in]   ptIov		segment array, segment length <= 0xfff, must stay valid until sent
+  \param[in]   byIovCnt		segment number
+  \return  	   error code \ref csi_error_t
+ */
+csi_error_t csi_uart_sendv_dma(csp_uart_t *ptUartBase, csi_dma_ch_e eDmaCh, const csi_iovec_t *ptIov, uint8_t byIovCnt);
+
 /** 
   \brief 	   receive data from uart, this function is dma mode
   \param[in]   ptUartBase	pointer of uart register structure
@@ -187,6 +187,7 @@ typedef struct {
 	uint16_t            hwRxSize;			//rx receive data size
 	uint8_t				*pbyTxData;			//pointer of send buf 
 	ringbuffer_t		*ptRingBuf;			//pointer of ringbuffer		
+	ringbuffer_spsc_t	*ptSpscBuf;			//pointer of lock-free spsc ringbuffer, used instead of ptRingBuf when set
 } csi_usart_trans_t;
 
 extern csi_usart_trans_t g_tUsartTran[USART_IDX_NUM];	
@@ -234,6 +235,16 @@ csi_error_t csi_usart_stop(csp_usart_t *ptUsartBase, csi_usart_func_e eFunc);
  */ 
 void csi_usart_set_buffer(csp_usart_t *ptUsartBase, ringbuffer_t *ptRingbuf, uint8_t *pbyRdBuf,  uint16_t hwLen);
 
+/** 
+  \brief 	   set usart receive buffer as lock-free spsc ringbuf, replace csi_usart_set_buffer
+  \param[in]   ptUsartBase	pointer of usart register structure
+  \param[in]   ptRingbuf	pointer of receive spsc ringbuf
+  \param[in]   pbyRdBuf		pointer of usart receive buffer
+  \param[in]   hwLen		usart receive buffer length, must be power of two
+  \return 	   error code \ref csi_error_t
+ */ 
+csi_error_t csi_usart_set_spsc_buffer(csp_usart_t *ptUsartBase, ringbuffer_spsc_t *ptRingbuf, uint8_t *pbyRdBuf, uint16_t hwLen);
+
 /**
   \brief       Start send data to USART transmitter, this function is blocking.
   \param[in]   usart     	usart handle to operate.
@@ -244,6 +255,15 @@ void csi_usart_set_buffer(csp_usart_t *ptUsartBase, ringbuffer_t *ptRingbuf, uin
 */
 int16_t csi_usart_send(csp_usart_t *ptUsartBase, const void *pData, uint16_t hwSize);
 
+/**
+  \brief       send scatter-gather segments as one frame without copying, polling mode only
+  \param[in]   ptUsartBase	pointer of usart register structure
+  \param[in]   ptIov		segment array, segment length <= 0xffff
+  \param[in]   byIovCnt		segment number
+  \return      the num of data which is sent successfully or CSI_UNSUPPORTED
+*/
+int32_t csi_usart_sendv(csp_usart_t *ptUsartBase, const csi_iovec_t *ptIov, uint8_t byIovCnt);
+
 /** 
   \brief 	   send data to usart transmitter, this function is interrupt mode(async/non-blocking)
   \param[in]   ptUsartBase	pointer of usart register structure
@@ -281,6 +301,17 @@ csi_error_t csi_usart_dma_tx_init(csp_usart_t *ptUsartBase, csi_dma_ch_e eDmaCh,
  */
 csi_error_t csi_usart_send_dma(csp_usart_t *ptUsartBase, const void *pData, uint8_t byDmaCh, uint16_t hwSize);
 
+/** 
+  \brief 	   send scatter-gather segments to usart transmitter, this function is dma mode, the 
+  *			   next segment is started from the dma TCIT interrupt, get completion by csi_dma_get_msg
+  \param[in]   ptUsartBase	pointer of usart register structure
+  \param[in]   ptIov		segment array, segment length <= 0xfff, must stay valid until sent
+  \param[in]   byDmaCh		channel number of dma, DMA_CH0` DMA_CH3
+  \param[in]   byIovCnt		segment number
+  \return      error code \ref csi_error_t
+ */
+csi_error_t csi_usart_sendv_dma(csp_usart_t *ptUsartBase, const csi_iovec_t *ptIov, uint8_t byDmaCh, uint8_t byIovCnt);
+
 /** 
   \brief 	   receive data to usart transmitter, this function is dma mode
   \param[in]   ptUsartBase	pointer of usart register structure
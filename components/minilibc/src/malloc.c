@@ -16,11 +16,15 @@
 
 //#include <csi_config.h>
 #include <string.h>
+#include <errno.h>
 #ifndef CONFIG_KERNEL_NONE
 //#include <csi_kernel.h>
 #else
 #include <umm_heap.h>
 #endif
+#ifdef CONFIG_MM_POOL
+#include <mm_pool.h>
+#endif
 
 #ifndef MALLOC_WEAK
 #define MALLOC_WEAK __attribute__((weak))
@@ -30,6 +34,16 @@ MALLOC_WEAK void *malloc(size_t size)
 {
     void *ret;
 
+#ifdef CONFIG_MM_POOL
+    /* small objects from the fixed-size pools, the heap when they are full */
+    if (size <= CONFIG_MM_POOL_MAXSIZE) {
+        ret = mm_pool_alloc(size);
+        if (ret) {
+            return ret;
+        }
+    }
+#endif
+
 #ifdef CONFIG_KERNEL_NONE
     ret = mm_malloc(USR_HEAP, size, __builtin_return_address(0U));
 #else
@@ -41,6 +55,12 @@ MALLOC_WEAK void *malloc(size_t size)
 
 MALLOC_WEAK void free(void *ptr)
 {
+#ifdef CONFIG_MM_POOL
+    if (mm_pool_free(ptr)) {
+        return;
+    }
+#endif
+
 #ifdef CONFIG_KERNEL_NONE
     mm_free(USR_HEAP, ptr, __builtin_return_address(0U));
 #else
@@ -52,25 +72,36 @@ MALLOC_WEAK void *realloc(void *ptr, size_t size)
 {
     void *new_ptr;
 
-#ifdef CONFIG_KERNEL_NONE
-    new_ptr = mm_malloc(USR_HEAP, size, __builtin_return_address(0U));
-#else
-    new_ptr = csi_kernel_malloc(size, __builtin_return_address(0U));
-#endif
-
-    if (new_ptr == NULL) {
+#ifdef CONFIG_MM_POOL
+    /* a pool block keeps its place while it is large enough, else it moves
+     * to malloc() with min(block size, size) copied
+     */
+    if (ptr && mm_pool_member(ptr)) {
+        size_t blksize = mm_pool_blksize(ptr);
+
+        if (size == 0) {
+            mm_pool_free(ptr);
+            return NULL;
+        }
+        if (size <= blksize) {
+            return ptr;
+        }
+
+        new_ptr = malloc(size);
+        if (new_ptr) {
+            memcpy(new_ptr, ptr, size < blksize ? size : blksize);
+            mm_pool_free(ptr);
+        }
         return new_ptr;
     }
+#endif
 
-    if (ptr) {
-        memcpy(new_ptr, ptr, size);
-
+    /* in place when the heap allows, otherwise move with the old size copied */
 #ifdef CONFIG_KERNEL_NONE
-        mm_free(USR_HEAP, ptr, __builtin_return_address(0U));
+    new_ptr = mm_realloc(USR_HEAP, ptr, size, __builtin_return_address(0U));
 #else
-        csi_kernel_free(ptr, __builtin_return_address(0U));
+    new_ptr = csi_kernel_realloc(ptr, size, __builtin_return_address(0U));
 #endif
-    }
 
     return new_ptr;
 }
@@ -79,6 +110,12 @@ MALLOC_WEAK void *calloc(size_t nmemb, size_t size)
 {
     void *ptr = NULL;
 
+#ifdef CONFIG_MM_POOL
+    if (size * nmemb <= CONFIG_MM_POOL_MAXSIZE) {
+        ptr = mm_pool_alloc(size * nmemb);
+    }
+    if (ptr == NULL)
+#endif
 #ifdef CONFIG_KERNEL_NONE
     ptr = mm_malloc(USR_HEAP, size * nmemb, __builtin_return_address(0U));
 #else
@@ -91,3 +128,35 @@ MALLOC_WEAK void *calloc(size_t nmemb, size_t size)
 
     return ptr;
 }
+
+#ifdef CONFIG_KERNEL_NONE
+/* aligned allocation for DMA and word access buffers, the leading slack is
+ * given back to the heap; released with free() as usual
+ */
+MALLOC_WEAK void *memalign(size_t alignment, size_t size)
+{
+    return mm_memalign(USR_HEAP, alignment, size, __builtin_return_address(0U));
+}
+
+MALLOC_WEAK void *aligned_alloc(size_t alignment, size_t size)
+{
+    return mm_memalign(USR_HEAP, alignment, size, __builtin_return_address(0U));
+}
+
+MALLOC_WEAK int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    void *ptr;
+
+    if (alignment < sizeof(void *) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+
+    ptr = mm_memalign(USR_HEAP, alignment, size, __builtin_return_address(0U));
+    if (ptr == NULL && size != 0) {
+        return ENOMEM;
+    }
+
+    *memptr = ptr;
+    return 0;
+}
+#endif
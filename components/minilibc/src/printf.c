@@ -37,6 +37,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <drv/uart.h>
+#include <drv/hwdiv.h>
 #include <sys_console.h>
 
 
@@ -326,12 +327,24 @@ static size_t _ntoa_long(out_fct_type out, char* buffer, size_t idx, size_t maxl
   }
 
   // write if precision != 0 and value is != 0
+  // base is 2/8/10/16: decimal by reciprocal, others by shift, no hw divider per digit
   if (!(flags & FLAGS_PRECISION) || value) {
-    do {
-      const char digit = (char)(value % base);
-      buf[len++] = digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10;
-      value /= base;
-    } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+    if (base == 10U) {
+      const hwdiv_recip_t tRecip10 = HWDIV_RECIP_10;
+      do {
+        const unsigned long quot = csi_hwdiv_recip_div(&tRecip10, value);
+        buf[len++] = (char)('0' + (value - quot * 10U));
+        value = quot;
+      } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+    }
+    else {
+      const unsigned int shift = (unsigned int)__builtin_ctzl(base);
+      do {
+        const char digit = (char)(value & (base - 1U));
+        buf[len++] = digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10;
+        value >>= shift;
+      } while (value && (len < PRINTF_NTOA_BUFFER_SIZE));
+    }
   }
 
   return _ntoa_format(out, buffer, idx, maxlen, buf, len, negative, (unsigned int)base, prec, width, flags);
@@ -139,9 +139,10 @@
 #  define MM_MIN_SHIFT    4  /* 16 bytes */
 #  define MM_MAX_SHIFT   15  /* 32 Kb */
 
-#elif defined(CONFIG_HAVE_LONG_LONG)
+#elif defined(CONFIG_HAVE_LONG_LONG) || UINTPTR_MAX > UINT32_MAX
 /* Four byte offsets; Pointers may be 4 or 8 bytes
  * sizeof(struct mm_freenode_s) is 16 or 24 bytes.
+ * (Native 64-bit host builds of the replay tools land here too.)
  */
   
 #  if UINTPTR_MAX <= UINT32_MAX
@@ -160,12 +161,47 @@
 #  define MM_MAX_SHIFT   22  /*  4 Mb */
 #endif
 
+/* Project overrides, e.g. to compare granule sizes with the host replay
+ * benchmark (demo/script/mm_bench.sh).  MM_MIN_CHUNK must stay at least
+ * SIZEOF_MM_FREENODE.
+ */
+
+#ifdef CONFIG_MM_MIN_SHIFT
+#  undef  MM_MIN_SHIFT
+#  define MM_MIN_SHIFT   CONFIG_MM_MIN_SHIFT
+#endif
+#ifdef CONFIG_MM_MAX_SHIFT
+#  undef  MM_MAX_SHIFT
+#  define MM_MAX_SHIFT   CONFIG_MM_MAX_SHIFT
+#endif
+
 /* All other definitions derive from these two */
 
 #define MM_MIN_CHUNK     (1 << MM_MIN_SHIFT)
 #define MM_MAX_CHUNK     (1 << MM_MAX_SHIFT)
 #define MM_NNODES        (MM_MAX_SHIFT - MM_MIN_SHIFT + 1)
 
+/* TLSF free lists (CONFIG_MM_TLSF): two-level segregated fit, a first level
+ * per power of two and MM_TLSF_SLI linear second level classes in each, so
+ * malloc and free find a list with two bitmap scans instead of a list walk.
+ *
+ * Level 0 holds chunks below 1 << MM_TLSF_FLSHIFT in classes of one
+ * granule each; level fl >= 1 holds [2^(fl+FLSHIFT-1), 2^(fl+FLSHIFT)).
+ * CONFIG_MM_TLSF_MAXSHIFT bounds the table to the RAM actually present,
+ * larger chunks share the top class.
+ */
+
+#ifndef CONFIG_MM_TLSF_SLI_LOG2
+#  define CONFIG_MM_TLSF_SLI_LOG2   3
+#endif
+#ifndef CONFIG_MM_TLSF_MAXSHIFT
+#  define CONFIG_MM_TLSF_MAXSHIFT   14  /* 16 Kb */
+#endif
+
+#define MM_TLSF_SLI      (1 << CONFIG_MM_TLSF_SLI_LOG2)
+#define MM_TLSF_FLSHIFT  (MM_MIN_SHIFT + CONFIG_MM_TLSF_SLI_LOG2)
+#define MM_TLSF_FLI      (CONFIG_MM_TLSF_MAXSHIFT - MM_TLSF_FLSHIFT + 1)
+
 #define MM_GRAN_MASK     (MM_MIN_CHUNK-1)
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
@@ -223,6 +259,8 @@ struct mm_allocnode_s
 
 #ifdef CONFIG_MM_SMALL
 # define SIZEOF_MM_ALLOCNODE   4
+#elif UINTPTR_MAX > UINT32_MAX
+# define SIZEOF_MM_ALLOCNODE   16  /* 64-bit host builds */
 #else
 # define SIZEOF_MM_ALLOCNODE   8
 #endif
@@ -245,6 +283,10 @@ struct mm_freenode_s
 #define MM_PTR_SIZE sizeof(struct mm_freenode_s *)
 #define SIZEOF_MM_FREENODE (SIZEOF_MM_ALLOCNODE + 2*MM_PTR_SIZE)
 
+/* A free chunk must fit in the smallest chunk (CONFIG_MM_MIN_SHIFT) */
+
+typedef char mm_min_chunk_check[(MM_MIN_CHUNK >= SIZEOF_MM_FREENODE) ? 1 : -1];
+
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
@@ -278,12 +320,22 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Free nodes are kept in one doubly linked list per size class, the
+   * bitmaps tell which lists are non-empty.
+   */
+
+  uint32_t mm_flbitmap;
+  uint32_t mm_slbitmap[MM_TLSF_FLI];
+  struct mm_freenode_s *mm_freelist[MM_TLSF_FLI][MM_TLSF_SLI];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
 };
 
 /****************************************************************************
@@ -407,7 +459,7 @@ struct m_dbg_hdr {
 
 static inline bool mdbg_calc_magic(struct m_dbg_hdr *hdr)
 {
-    uint32_t magic = (uint32_t)hdr->caller;
+    uint32_t magic = (uint32_t)(uintptr_t)hdr->caller;
     magic ^= hdr->size;
     magic ^= hdr->pid;
     magic ^= MAGIC_INUSE;
@@ -422,7 +474,7 @@ static inline bool mdbg_check_magic_hdr(struct m_dbg_hdr *hdr)
 static inline bool mdbg_check_magic_end(struct m_dbg_hdr *hdr)
 {
     void *p = hdr + 1;
-    uint32_t *m = (uint32_t *)((uint32_t)p + hdr->size);
+    uint32_t *m = (uint32_t *)((uintptr_t)p + hdr->size);
     uint32_t magic = MAGIC_END ^ hdr->magic;
     int i;
 
@@ -442,7 +494,7 @@ static inline void mdbg_set_magic_hdr(struct m_dbg_hdr *hdr)
 static inline void mdbg_set_magic_end(struct m_dbg_hdr *hdr)
 {
     void *p = hdr + 1;
-    uint32_t *m = (uint32_t *)((uint32_t)p + hdr->size);
+    uint32_t *m = (uint32_t *)((uintptr_t)p + hdr->size);
     int i;
 
     for (i=0;i<MDBG_SZ_TAIL/4;i++) {
@@ -455,9 +507,20 @@ void *mm_malloc(struct mm_heap_s *heap, size_t size, void *caller);
 
 #if (CONFIG_MM_MAX_USED)
 int mm_get_max_usedsize(void);
+int mm_get_min_freesize(void);
 int mm_max_usedsize_update(struct mm_heap_s *heap);
 #endif
 
+/* Functions contained in mm_trace.c ****************************************/
+
+#ifdef CONFIG_MM_TRACE
+void mm_trace_alloc(struct mm_heap_s *heap, void *mem, size_t size);
+void mm_trace_free(struct mm_heap_s *heap, void *mem);
+#else
+#  define mm_trace_alloc(heap, mem, size)
+#  define mm_trace_free(heap, mem)
+#endif
+
 /* Functions contained in kmm_malloc.c **************************************/
 
 #ifdef CONFIG_MM_KERNEL_HEAP
@@ -477,7 +540,7 @@ void kmm_free(void *mem);
 /* Functions contained in mm_realloc.c **************************************/
 
 void *mm_realloc(struct mm_heap_s *heap, void *oldmem,
-                     size_t size);
+                 size_t size, void *caller);
 
 /* Functions contained in kmm_realloc.c *************************************/
 
@@ -508,7 +571,7 @@ void *kmm_zalloc(size_t size);
 /* Functions contained in mm_memalign.c *************************************/
 
 void *mm_memalign(struct mm_heap_s *heap, size_t alignment,
-                      size_t size);
+                  size_t size, void *caller);
 
 /* Functions contained in kmm_memalign.c ************************************/
 
@@ -590,10 +653,15 @@ int kmm_mallinfo(struct mallinfo *info);
 void mm_shrinkchunk(struct mm_heap_s *heap,
                     struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c (mm_tlsf.c if CONFIG_MM_TLSF) */
 
 void mm_addfreechunk(struct mm_heap_s *heap,
                      struct mm_freenode_s *node);
+void mm_initfreelists(struct mm_heap_s *heap);
+void mm_remfreechunk(struct mm_heap_s *heap,
+                     struct mm_freenode_s *node);
+struct mm_freenode_s *mm_findfreechunk(struct mm_heap_s *heap,
+                                       size_t size);
 
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
@@ -0,0 +1,203 @@
+/****************************************************************************
+ * mm/include/mm_arena.h
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ * Scoped arena (bump) allocator for short-lived objects that die together,
+ * e.g. everything allocated while handling one received frame.  An arena
+ * is a region carved from an mm heap or a static buffer; allocation bumps a
+ * pointer, mm_arena_mark()/mm_arena_rewind() release everything allocated
+ * after a mark and mm_arena_reset() releases everything, all without
+ * per-object headers, list searches or the heap lock.
+ *
+ * Requests the region cannot hold may overflow into mm_malloc() on the
+ * arena's heap; those blocks are freed again by rewind/reset.
+ *
+ * An arena has a single owner and takes no lock.
+ *
+ ****************************************************************************/
+
+#ifndef __MM_MM_ARENA_H
+#define __MM_MM_ARENA_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Alignment used when mm_arena_alloc() is given align 0 */
+
+#ifndef CONFIG_MM_ARENA_ALIGN
+#  define CONFIG_MM_ARENA_ALIGN  8
+#endif
+
+#define MM_ARENA_OWNED     0x01  /* Region was carved from heap */
+#define MM_ARENA_OVERFLOW  0x02  /* Fall back to mm_malloc() on heap */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct mm_heap_s;
+struct mm_arena_ovf_s;
+
+struct mm_arena_s
+{
+  uint8_t *base;                /* Start of the region */
+  uint8_t *cur;                 /* Next free byte */
+  uint8_t *end;                 /* End of the region */
+  struct mm_heap_s *heap;       /* Owner of the region and/or overflow */
+  struct mm_arena_ovf_s *ovf;   /* Overflow blocks, newest first */
+  size_t peak;                  /* High-water mark of cur - base */
+  uint8_t flags;
+};
+
+/* Position returned by mm_arena_mark() */
+
+struct mm_arena_mark_s
+{
+  uint8_t *cur;
+  struct mm_arena_ovf_s *ovf;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Use a caller provided buffer as the region.  heap may be NULL, otherwise
+ * requests that do not fit overflow into mm_malloc(heap, ...).
+ * Returns OK or -EINVAL.
+ */
+
+int mm_arena_init(struct mm_arena_s *arena, void *buf, size_t size,
+                  struct mm_heap_s *heap);
+
+/* Carve a size byte region from heap, optionally overflowing into the same
+ * heap.  Returns OK, -EINVAL or -ENOMEM.
+ */
+
+int mm_arena_create(struct mm_arena_s *arena, struct mm_heap_s *heap,
+                    size_t size, bool overflow);
+
+/* Free overflow blocks and, for mm_arena_create(), the region itself */
+
+void mm_arena_release(struct mm_arena_s *arena);
+
+/* Slow path of mm_arena_alloc(): the region is full */
+
+void *mm_arena_overflow(struct mm_arena_s *arena, size_t size, size_t align);
+
+/* Free the overflow blocks allocated after mark (mm_arena_rewind()) */
+
+void mm_arena_freeovf(struct mm_arena_s *arena, struct mm_arena_ovf_s *mark);
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_arena_alloc
+ *
+ * Description:
+ *   Allocate size bytes aligned to align (a power of two, 0 for
+ *   CONFIG_MM_ARENA_ALIGN).  NULL when neither the region nor the overflow
+ *   heap can hold the request.
+ *
+ ****************************************************************************/
+
+static inline void *mm_arena_alloc(struct mm_arena_s *arena, size_t size,
+                                   size_t align)
+{
+  uintptr_t mem;
+
+  if (align == 0)
+    {
+      align = CONFIG_MM_ARENA_ALIGN;
+    }
+
+  mem = ((uintptr_t)arena->cur + align - 1) & ~(uintptr_t)(align - 1);
+  if (mem <= (uintptr_t)arena->end &&
+      size <= (size_t)((uintptr_t)arena->end - mem))
+    {
+      arena->cur = (uint8_t *)(mem + size);
+      return (void *)mem;
+    }
+
+  return mm_arena_overflow(arena, size, align);
+}
+
+/****************************************************************************
+ * Name: mm_arena_mark / mm_arena_rewind / mm_arena_reset
+ *
+ * Description:
+ *   mark remembers the current position, rewind releases everything
+ *   allocated after it (marks nest like a stack), reset releases
+ *   everything.  Constant time unless overflow blocks must be freed.
+ *
+ ****************************************************************************/
+
+static inline struct mm_arena_mark_s mm_arena_mark(struct mm_arena_s *arena)
+{
+  struct mm_arena_mark_s mark;
+
+  mark.cur = arena->cur;
+  mark.ovf = arena->ovf;
+  return mark;
+}
+
+static inline void mm_arena_rewind(struct mm_arena_s *arena,
+                                   struct mm_arena_mark_s mark)
+{
+  if ((size_t)(arena->cur - arena->base) > arena->peak)
+    {
+      arena->peak = (size_t)(arena->cur - arena->base);
+    }
+
+  arena->cur = mark.cur;
+  if (arena->ovf != mark.ovf)
+    {
+      mm_arena_freeovf(arena, mark.ovf);
+    }
+}
+
+static inline void mm_arena_reset(struct mm_arena_s *arena)
+{
+  struct mm_arena_mark_s mark;
+
+  mark.cur = arena->base;
+  mark.ovf = NULL;
+  mm_arena_rewind(arena, mark);
+}
+
+/* Bytes in use in the region, and its high-water mark (updated by
+ * rewind/reset and here).
+ */
+
+static inline size_t mm_arena_used(struct mm_arena_s *arena)
+{
+  return (size_t)(arena->cur - arena->base);
+}
+
+static inline size_t mm_arena_peak(struct mm_arena_s *arena)
+{
+  size_t used = mm_arena_used(arena);
+
+  return used > arena->peak ? used : arena->peak;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MM_MM_ARENA_H */
@@ -0,0 +1,96 @@
+/****************************************************************************
+ * mm/include/mm_pool.h
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ * Fixed-size block pools beside the mm heap: compile-time declared pools in
+ * static storage, O(1) allocation and free, usable from interrupt context,
+ * no per-block header.  Built with CONFIG_MM_POOL, which also makes the
+ * minilibc malloc()/free() route small requests to the pools.
+ *
+ ****************************************************************************/
+
+#ifndef __MM_MM_POOL_H
+#define __MM_MM_POOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Pool table, one MM_POOL(block size, block count) per pool in ascending
+ * block size.  Block sizes must be multiples of 8 (the alignment mm_malloc
+ * gives).  Override by defining CONFIG_MM_POOL_TABLE in the project, e.g.
+ *
+ *   -DCONFIG_MM_POOL_TABLE="MM_POOL(16, 32) MM_POOL(48, 8)"
+ */
+
+#ifndef CONFIG_MM_POOL_TABLE
+#  define CONFIG_MM_POOL_TABLE  MM_POOL(16, 16) MM_POOL(32, 8) MM_POOL(64, 4)
+#endif
+
+/* Requests up to this size are tried in the pools first by malloc() */
+
+#ifndef CONFIG_MM_POOL_MAXSIZE
+#  define CONFIG_MM_POOL_MAXSIZE 64
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct mm_poolinfo_s
+{
+  uint16_t blksize;   /* Block size in bytes */
+  uint16_t nblks;     /* Number of blocks */
+  uint16_t used;      /* Blocks handed out now */
+  uint16_t peak;      /* High-water mark of used */
+  uint32_t fails;     /* Requests this pool could not serve */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Allocate a block of at least size bytes from the smallest fitting pool,
+ * spilling to the next larger pool when that one is empty.  NULL if no
+ * pool can serve the request.
+ */
+
+void *mm_pool_alloc(size_t size);
+
+/* Return a block to its pool.  Returns false (and does nothing) when mem
+ * is not a pool block, so callers can fall back to mm_free().
+ */
+
+bool mm_pool_free(void *mem);
+
+/* True if mem lies in one of the pools */
+
+bool mm_pool_member(void *mem);
+
+/* Usable size of a pool block, 0 if mem is not a pool block */
+
+size_t mm_pool_blksize(void *mem);
+
+/* Statistics of pool ndx (0 .. mm_pool_count() - 1), -1 if out of range */
+
+int mm_pool_count(void);
+int mm_pool_info(int ndx, struct mm_poolinfo_s *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MM_MM_POOL_H */
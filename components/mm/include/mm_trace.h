@@ -0,0 +1,91 @@
+/****************************************************************************
+ * mm/include/mm_trace.h
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ * Allocation trace of the mm heap, built with CONFIG_MM_TRACE: mm_malloc,
+ * mm_free and mm_realloc append one compact record per operation to a RAM
+ * ring, mm_trace_dump() drains it to the console as text lines that
+ * demo/script/mm_bench replays on the host:
+ *
+ *   @mm a <id> <size> <stamp>     allocation
+ *   @mm f <id> <stamp>            free
+ *   @mm x <size> <stamp>          failed allocation
+ *   @mm lost <n>                  records overwritten before a dump
+ *
+ * The id is the chunk offset in the heap in granules, unique among live
+ * blocks, so the replay can pair frees with their allocations.
+ *
+ ****************************************************************************/
+
+#ifndef __MM_MM_TRACE_H
+#define __MM_MM_TRACE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Ring depth in records (8 bytes each), a power of two */
+
+#ifndef CONFIG_MM_TRACE_DEPTH
+#  define CONFIG_MM_TRACE_DEPTH  128
+#endif
+
+#define MM_TRACE_FREE     0x8000  /* opsize: free record */
+#define MM_TRACE_SIZE     0x7fff  /* opsize: size, saturated */
+#define MM_TRACE_FAILID   0xffff  /* id of a failed allocation */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+struct mm_trace_s
+{
+  uint32_t stamp;     /* mm_trace_stamp() at the operation */
+  uint16_t id;        /* Chunk offset in granules, MM_TRACE_FAILID */
+  uint16_t opsize;    /* Request size | MM_TRACE_FREE */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Time stamp of a record.  Weak, microseconds from the tick driver by
+ * default; a board may return a cycle counter instead.
+ */
+
+uint32_t mm_trace_stamp(void);
+
+/* Take the oldest record out of the ring, 0 when it is empty */
+
+int mm_trace_read(struct mm_trace_s *rec);
+
+/* Records overwritten since the last call (the ring was not drained in
+ * time), cleared by reading.
+ */
+
+uint32_t mm_trace_lost(void);
+
+/* Drain the ring to the console (printf), returns the records written.
+ * Call it from the main loop often enough to keep up with the allocations
+ * and the whole run is captured.
+ */
+
+int mm_trace_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MM_MM_TRACE_H */
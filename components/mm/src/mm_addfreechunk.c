@@ -39,8 +39,11 @@
 
 //#include <csi_config.h>
 
+#include <string.h>
 #include "mm.h"
 
+#ifndef CONFIG_MM_TLSF
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -90,3 +93,89 @@ void mm_addfreechunk(struct mm_heap_s *heap, struct mm_freenode_s *node)
       next->blink = node;
     }
 }
+
+/****************************************************************************
+ * Name: mm_initfreelists
+ *
+ * Description:
+ *   Link the empty hook nodes of the size-ordered free list.
+ *
+ ****************************************************************************/
+
+void mm_initfreelists(struct mm_heap_s *heap)
+{
+  int i;
+
+  memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
+  for (i = 1; i < MM_NNODES; i++)
+    {
+      heap->mm_nodelist[i-1].flink = &heap->mm_nodelist[i];
+      heap->mm_nodelist[i].blink   = &heap->mm_nodelist[i-1];
+    }
+}
+
+/****************************************************************************
+ * Name: mm_remfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the free list.  It is assumed that the caller
+ *   holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_remfreechunk(struct mm_heap_s *heap, struct mm_freenode_s *node)
+{
+  (void)heap;
+
+  /* There must be a predecessor, but there may not be a successor node. */
+
+  //DEBUGASSERT(node->blink);
+  node->blink->flink = node->flink;
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find the smallest free chunk of at least size bytes (chunk size,
+ *   header included), NULL if none.  The chunk stays in the list.
+ *
+ ****************************************************************************/
+
+struct mm_freenode_s *mm_findfreechunk(struct mm_heap_s *heap, size_t size)
+{
+  struct mm_freenode_s *node;
+  int ndx;
+
+  /* Get the location in the node list to start the search. Special case
+   * really big allocations
+   */
+
+  if (size >= MM_MAX_CHUNK)
+    {
+      ndx = MM_NNODES-1;
+    }
+  else
+    {
+      /* Convert the request size into a nodelist index */
+
+      ndx = mm_size2ndx(size);
+    }
+
+  /* Search for a large enough chunk in the list of nodes. This list is
+   * ordered by size, but will have occasional zero sized nodes as we visit
+   * other mm_nodelist[] entries.
+   */
+
+  for (node = heap->mm_nodelist[ndx].flink;
+       node && node->size < size;
+       node = node->flink);
+
+  return node;
+}
+
+#endif /* !CONFIG_MM_TLSF */
@@ -0,0 +1,163 @@
+/****************************************************************************
+ * mm/src/mm_arena.c
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ * Setup, teardown and the overflow path of the arena allocator; the bump
+ * allocation itself is inline in mm_arena.h.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <errno.h>
+#include "mm.h"
+#include "mm_arena.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Header in front of each overflow block, linking them newest first */
+
+struct mm_arena_ovf_s
+{
+  struct mm_arena_ovf_s *next;
+};
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_arena_init
+ ****************************************************************************/
+
+int mm_arena_init(struct mm_arena_s *arena, void *buf, size_t size,
+                  struct mm_heap_s *heap)
+{
+  if (arena == NULL || (buf == NULL && size > 0))
+    {
+      return -EINVAL;
+    }
+
+  arena->base  = (uint8_t *)buf;
+  arena->cur   = arena->base;
+  arena->end   = arena->base + size;
+  arena->heap  = heap;
+  arena->ovf   = NULL;
+  arena->peak  = 0;
+  arena->flags = heap ? MM_ARENA_OVERFLOW : 0;
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_arena_create
+ ****************************************************************************/
+
+int mm_arena_create(struct mm_arena_s *arena, struct mm_heap_s *heap,
+                    size_t size, bool overflow)
+{
+  void *buf;
+
+  if (arena == NULL || heap == NULL || size < 1)
+    {
+      return -EINVAL;
+    }
+
+  buf = mm_malloc(heap, size, __builtin_return_address(0));
+  if (buf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mm_arena_init(arena, buf, size, heap);
+  arena->flags = MM_ARENA_OWNED | (overflow ? MM_ARENA_OVERFLOW : 0);
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mm_arena_release
+ ****************************************************************************/
+
+void mm_arena_release(struct mm_arena_s *arena)
+{
+  mm_arena_freeovf(arena, NULL);
+
+  if (arena->flags & MM_ARENA_OWNED)
+    {
+      mm_free(arena->heap, arena->base, __builtin_return_address(0));
+    }
+
+  arena->base  = NULL;
+  arena->cur   = NULL;
+  arena->end   = NULL;
+  arena->flags = 0;
+}
+
+/****************************************************************************
+ * Name: mm_arena_overflow
+ *
+ * Description:
+ *   The region cannot hold the request: take it from the heap with room
+ *   for the link header and the alignment, so the block can be released by
+ *   the next rewind or reset.
+ *
+ ****************************************************************************/
+
+void *mm_arena_overflow(struct mm_arena_s *arena, size_t size, size_t align)
+{
+  struct mm_arena_ovf_s *blk;
+  uintptr_t mem;
+
+  if ((arena->flags & MM_ARENA_OVERFLOW) == 0 || size < 1)
+    {
+      return NULL;
+    }
+
+  /* Header + size + alignment slack must not wrap */
+
+  if (align - 1 > SIZE_MAX - sizeof(struct mm_arena_ovf_s) ||
+      size > SIZE_MAX - sizeof(struct mm_arena_ovf_s) - (align - 1))
+    {
+      return NULL;
+    }
+
+  blk = (struct mm_arena_ovf_s *)
+        mm_malloc(arena->heap, sizeof(struct mm_arena_ovf_s) + size + align - 1,
+                  __builtin_return_address(0));
+  if (blk == NULL)
+    {
+      return NULL;
+    }
+
+  blk->next  = arena->ovf;
+  arena->ovf = blk;
+
+  mem = ((uintptr_t)(blk + 1) + align - 1) & ~(uintptr_t)(align - 1);
+  return (void *)mem;
+}
+
+/****************************************************************************
+ * Name: mm_arena_freeovf
+ *
+ * Description:
+ *   Free overflow blocks newer than mark (NULL for all of them).
+ *
+ ****************************************************************************/
+
+void mm_arena_freeovf(struct mm_arena_s *arena, struct mm_arena_ovf_s *mark)
+{
+  struct mm_arena_ovf_s *blk;
+
+  while (arena->ovf != NULL && arena->ovf != mark)
+    {
+      blk        = arena->ovf;
+      arena->ovf = blk->next;
+      mm_free(arena->heap, blk, __builtin_return_address(0));
+    }
+}
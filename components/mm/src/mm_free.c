@@ -83,6 +83,8 @@ void mm_free(struct mm_heap_s *heap, void *mem, void *caller)
       return;
     }
 
+  mm_trace_free(heap, mem);
+
 #if defined(CONFIG_MM_DETECT_ERROR)
   struct m_dbg_hdr *hdr = (struct m_dbg_hdr *)((uint8_t *)mem - MDBG_SZ_HEAD);
   if (!mdbg_check_magic_hdr(hdr)) {
@@ -110,12 +112,12 @@ void mm_free(struct mm_heap_s *heap, void *mem, void *caller)
 
   /* Map the memory chunk into a free node */
 
-  node = (struct mm_freenode_s *)((uint32_t)mem - SIZEOF_MM_ALLOCNODE);
+  node = (struct mm_freenode_s *)((uintptr_t)mem - SIZEOF_MM_ALLOCNODE);
   node->preceding &= ~MM_ALLOC_BIT;
 
   /* Check if the following node is free and, if so, merge it */
 
-  next = (struct mm_freenode_s *)((uint32_t)node + node->size);
+  next = (struct mm_freenode_s *)((uintptr_t)node + node->size);
   if ((next->preceding & MM_ALLOC_BIT) == 0)
     {
       struct mm_allocnode_s *andbeyond;
@@ -125,18 +127,11 @@ void mm_free(struct mm_heap_s *heap, void *mem, void *caller)
        * index past the tail chunk because it is always allocated.
        */
 
-      andbeyond = (struct mm_allocnode_s *)((uint32_t)next + next->size);
+      andbeyond = (struct mm_allocnode_s *)((uintptr_t)next + next->size);
 
-      /* Remove the next node.  There must be a predecessor,
-       * but there may not be a successor node.
-       */
+      /* Remove the next node */
 
-      //DEBUGASSERT(next->blink);
-      next->blink->flink = next->flink;
-      if (next->flink)
-        {
-          next->flink->blink = next->blink;
-        }
+      mm_remfreechunk(heap, next);
 
       /* Then merge the two chunks */
 
@@ -149,19 +144,12 @@ void mm_free(struct mm_heap_s *heap, void *mem, void *caller)
    * it with this node
    */
 
-  prev = (struct mm_freenode_s *)((uint32_t)node - node->preceding);
+  prev = (struct mm_freenode_s *)((uintptr_t)node - node->preceding);
   if ((prev->preceding & MM_ALLOC_BIT) == 0)
     {
-      /* Remove the node.  There must be a predecessor, but there may
-       * not be a successor node.
-       */
+      /* Remove the node */
 
-      //DEBUGASSERT(prev->blink);
-      prev->blink->flink = prev->flink;
-      if (prev->flink)
-        {
-          prev->flink->blink = prev->blink;
-        }
+      mm_remfreechunk(heap, prev);
 
       /* Then merge the two chunks */
 
@@ -174,8 +174,6 @@ void mm_addregion(struct mm_heap_s *heap, void *heapstart,
 void mm_initialize(struct mm_heap_s *heap, void *heapstart,
                    size_t heapsize)
 {
-  int i;
-
   //mlldbg("Heap: start=%p size=%u\n", heapstart, heapsize);
 
   /* The following two lines have cause problems for some older ZiLog
@@ -196,14 +194,9 @@ void mm_initialize(struct mm_heap_s *heap, void *heapstart,
   heap->mm_nregions = 0;
 #endif
 
-  /* Initialize the node array */
+  /* Initialize the free lists */
 
-  memset(heap->mm_nodelist, 0, sizeof(struct mm_freenode_s) * MM_NNODES);
-  for (i = 1; i < MM_NNODES; i++)
-    {
-      heap->mm_nodelist[i-1].flink = &heap->mm_nodelist[i];
-      heap->mm_nodelist[i].blink   = &heap->mm_nodelist[i-1];
-    }
+  mm_initfreelists(heap);
 
   /* Initialize the malloc semaphore to one (to support one-at-
    * a-time access to private data sets).
@@ -218,6 +211,6 @@ void mm_initialize(struct mm_heap_s *heap, void *heapstart,
 
 void mm_heap_initialize(void)
 {
-    mm_initialize(&g_mmheap, &__heap_start, (uint32_t)(&__heap_end) - (uint32_t)(&__heap_start));
+    mm_initialize(&g_mmheap, &__heap_start, (size_t)((uintptr_t)(&__heap_end) - (uintptr_t)(&__heap_start)));
 }
 
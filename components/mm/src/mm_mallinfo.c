@@ -144,11 +144,16 @@ int mm_mallinfo(struct mm_heap_s *heap, struct mallinfo *info)
 
 #if (CONFIG_MM_MAX_USED)
 static int g_max_used_size = 0;
+static int g_min_free_size = -1;			//-1: nothing allocated yet
 int mm_max_usedsize_update(struct mm_heap_s *heap)
 {
     struct mallinfo info;
     mm_mallinfo(heap, &info);
 
+    //free space only shrinks on allocation, the low-water mark is taken here too
+    if(g_min_free_size < 0 || info.fordblks < g_min_free_size)
+        g_min_free_size = info.fordblks;
+
     if(info.uordblks > g_max_used_size)
     {
         g_max_used_size = info.uordblks;
@@ -168,5 +173,11 @@ int mm_get_max_usedsize(void)
     return g_max_used_size;
 }
 
+//lowest free heap seen after an allocation, -1 before the first one
+int mm_get_min_freesize(void)
+{
+    return g_min_free_size;
+}
+
 #endif
 
@@ -94,10 +94,14 @@ void *mm_malloc(struct mm_heap_s *heap, size_t size, void *caller)
 {
   struct mm_freenode_s *node;
   void *ret = NULL;
-  int ndx;
 #if defined(CONFIG_MM_DETECT_ERROR)
   size_t real_size;
 #endif
+#if defined(CONFIG_MM_TRACE)
+  size_t req_size = size;
+#endif
+
+  (void)caller;
 
   /* Handle bad sizes */
 
@@ -122,29 +126,11 @@ void *mm_malloc(struct mm_heap_s *heap, size_t size, void *caller)
 
   mm_takesemaphore(heap);
 
-  /* Get the location in the node list to start the search. Special case
-   * really big allocations
+  /* Find the best fitting free chunk, a list walk or a TLSF bitmap lookup
+   * depending on the backend.
    */
 
-  if (size >= MM_MAX_CHUNK)
-    {
-      ndx = MM_NNODES-1;
-    }
-  else
-    {
-      /* Convert the request size into a nodelist index */
-
-      ndx = mm_size2ndx(size);
-    }
-
-  /* Search for a large enough chunk in the list of nodes. This list is
-   * ordered by size, but will have occasional zero sized nodes as we visit
-   * other mm_nodelist[] entries.
-   */
-
-  for (node = heap->mm_nodelist[ndx].flink;
-       node && node->size < size;
-       node = node->flink);
+  node = mm_findfreechunk(heap, size);
 
   /* If we found a node with non-zero size, then this is one to use. Since
    * the list is ordered, we know that is must be best fitting chunk
@@ -157,16 +143,9 @@ void *mm_malloc(struct mm_heap_s *heap, size_t size, void *caller)
       struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node */
 
-      //DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_remfreechunk(heap, node);
 
       /* Check if we have to split the free node into one of the allocated
        * size and another smaller freenode.  In some cases, the remaining
@@ -223,8 +202,9 @@ void *mm_malloc(struct mm_heap_s *heap, size_t size, void *caller)
   }
 #endif
   mm_givesemaphore(heap);
+  mm_trace_alloc(heap, ret, req_size);
   if (!ret) {
-    printf("Allocation failed, size %d\n", size);
+    printf("Allocation failed, size %u\n", (unsigned int)size);
 #if defined(CONFIG_MM_DETECT_ERROR)
     mm_leak_dump();
 #endif
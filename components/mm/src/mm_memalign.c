@@ -0,0 +1,167 @@
+/****************************************************************************
+ * mm/src/mm_memalign.c
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include "mm.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* MM_MEMALIGN_PRE/POST: bytes mm_malloc() puts before/after the user data;
+ * MM_MEMALIGN_NATURAL: alignment every mm_malloc() result already has.
+ * Chunks start wherever memalign puts them, so that is the chunk header
+ * size (the debug header leaves only the 4 byte rounding of the size).
+ */
+
+#if defined(CONFIG_MM_DETECT_ERROR)
+#  define MM_MEMALIGN_PRE      MDBG_SZ_HEAD
+#  define MM_MEMALIGN_POST     MDBG_SZ_TAIL
+#  define MM_MEMALIGN_NATURAL  4
+#  define MM_MEMALIGN_SIZE(s)  (((s) + 3) & ~3)
+#else
+#  define MM_MEMALIGN_PRE      0
+#  define MM_MEMALIGN_POST     0
+#  define MM_MEMALIGN_NATURAL  SIZEOF_MM_ALLOCNODE
+#  define MM_MEMALIGN_SIZE(s)  (s)
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_memalign
+ *
+ * Description:
+ *   Allocate size bytes aligned to alignment (a power of two).  A chunk
+ *   with room for the worst case offset is taken with mm_malloc(), then
+ *   the slack in front of the aligned address is split off and returned to
+ *   the free lists, as is the tail beyond size, so only the chunk header
+ *   and granule rounding stay allocated.
+ *
+ *   The leading slack is kept at least one free node large (moving up by
+ *   alignment if needed), so it can always become a free chunk.  Chunks
+ *   behind an aligned block then start at the chunk header size rather than
+ *   the granule, which the allocator handles as it only adds sizes.
+ *
+ ****************************************************************************/
+
+void *mm_memalign(struct mm_heap_s *heap, size_t alignment, size_t size,
+                  void *caller)
+{
+  struct mm_allocnode_s *node;
+  struct mm_allocnode_s *newnode;
+  struct mm_allocnode_s *next;
+  struct mm_freenode_s *lead;
+  uintptr_t rawmem;
+  uintptr_t alignedmem;
+  size_t allocsize;
+  size_t leadsize;
+  size_t need;
+
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+      return NULL;
+    }
+
+  if (alignment <= MM_MEMALIGN_NATURAL)
+    {
+      return mm_malloc(heap, size, caller);
+    }
+
+  if (size < 1 || size > (SIZE_MAX >> 2) || alignment > (SIZE_MAX >> 2))
+    {
+      return NULL;
+    }
+
+  /* Room for the largest leading slack (below alignment + a free node)
+   * and for the granule rounding of the aligned chunk.
+   */
+
+  allocsize = size + 2 * alignment + SIZEOF_MM_FREENODE + MM_MIN_CHUNK;
+  need      = MM_ALIGN_UP(SIZEOF_MM_ALLOCNODE + MM_MEMALIGN_PRE +
+                          MM_MEMALIGN_SIZE(size) + MM_MEMALIGN_POST);
+
+  rawmem = (uintptr_t)mm_malloc(heap, allocsize, caller);
+  if (rawmem == 0)
+    {
+      return NULL;
+    }
+
+  mm_trace_free(heap, (void *)rawmem);
+
+#if defined(CONFIG_MM_DETECT_ERROR)
+  /* The debug header is rebuilt in front of the aligned address */
+
+  mm_leak_del_chunk((struct m_dbg_hdr *)rawmem - 1);
+  rawmem -= MDBG_SZ_HEAD;
+#endif
+
+  node = (struct mm_allocnode_s *)(rawmem - SIZEOF_MM_ALLOCNODE);
+
+  mm_takesemaphore(heap);
+
+  alignedmem = (rawmem + MM_MEMALIGN_PRE + alignment - 1) & ~(uintptr_t)(alignment - 1);
+  if (alignedmem != rawmem + MM_MEMALIGN_PRE)
+    {
+      while (alignedmem - MM_MEMALIGN_PRE - rawmem < SIZEOF_MM_FREENODE)
+        {
+          alignedmem += alignment;
+        }
+
+      /* Split the leading slack off as a free chunk.  The chunk before it
+       * is allocated (free chunks are always merged and mm_malloc took the
+       * front of a free chunk), so there is nothing to merge with.
+       */
+
+      newnode  = (struct mm_allocnode_s *)
+                 (alignedmem - MM_MEMALIGN_PRE - SIZEOF_MM_ALLOCNODE);
+      leadsize = (uintptr_t)newnode - (uintptr_t)node;
+      next     = (struct mm_allocnode_s *)((uintptr_t)node + node->size);
+
+      newnode->size      = node->size - leadsize;
+      newnode->preceding = leadsize | MM_ALLOC_BIT;
+      next->preceding    = newnode->size | (next->preceding & MM_ALLOC_BIT);
+
+      lead            = (struct mm_freenode_s *)node;
+      lead->size      = leadsize;
+      lead->preceding = node->preceding & ~MM_ALLOC_BIT;
+      mm_addfreechunk(heap, lead);
+
+      node = newnode;
+    }
+
+  /* Give back the tail */
+
+  if (node->size > need)
+    {
+      mm_shrinkchunk(heap, node, need);
+    }
+
+  mm_givesemaphore(heap);
+
+#if defined(CONFIG_MM_DETECT_ERROR)
+  {
+    struct m_dbg_hdr *hdr = (struct m_dbg_hdr *)(alignedmem - MDBG_SZ_HEAD);
+
+    hdr->caller = caller;
+    hdr->size   = MM_MEMALIGN_SIZE(size);
+    hdr->pid    = 0;
+    mdbg_set_magic_hdr(hdr);
+    mdbg_set_magic_end(hdr);
+    mm_leak_add_chunk(hdr);
+  }
+#endif
+
+  mm_trace_alloc(heap, (void *)alignedmem, size);
+  return (void *)alignedmem;
+}
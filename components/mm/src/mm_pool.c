@@ -0,0 +1,277 @@
+/****************************************************************************
+ * mm/src/mm_pool.c
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ * Fixed-size block pools.  Each pool is a static array carved lazily into
+ * blocks: a block comes from the pool's free list or, while the pool has
+ * never been fully used, from the untouched tail, so no initialization call
+ * is needed and the .bss zero state is a valid empty pool.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "mm_pool.h"
+
+#ifdef CONFIG_MM_POOL
+
+#include <csi_core.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CK802 has no exclusive load/store, so the free list head is updated in a
+ * few instructions with interrupts masked instead of a compare-and-swap
+ * loop; this keeps alloc/free O(1) and safe against interrupt handlers.
+ */
+
+#define mm_pool_lock()          csi_irq_save()
+#define mm_pool_unlock(flags)   csi_irq_restore(flags)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mm_freeblk_s
+{
+  struct mm_freeblk_s *next;
+};
+
+struct mm_poolcfg_s
+{
+  uint8_t *start;
+  uint16_t blksize;
+  uint16_t nblks;
+};
+
+struct mm_pool_s
+{
+  struct mm_freeblk_s *freelist;
+  uint16_t carved;    /* Blocks taken from the untouched tail so far */
+  uint16_t used;
+  uint16_t peak;
+  uint32_t fails;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Pool storage, 8-byte aligned; a bad block size fails to compile */
+
+#define MM_POOL(size, count) \
+  typedef char mm_pool_check_##size##_##count[((size) % 8 == 0 && (size) > 0 && (count) > 0) ? 1 : -1]; \
+  static uint64_t g_pool_##size##_##count[(size) * (count) / 8];
+CONFIG_MM_POOL_TABLE
+#undef MM_POOL
+
+#define MM_POOL(size, count) \
+  { (uint8_t *)g_pool_##size##_##count, (size), (count) },
+static const struct mm_poolcfg_s g_poolcfg[] =
+{
+  CONFIG_MM_POOL_TABLE
+};
+#undef MM_POOL
+
+#define MM_POOL_NUM ((int)(sizeof(g_poolcfg) / sizeof(g_poolcfg[0])))
+
+static struct mm_pool_s g_pools[MM_POOL_NUM];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_pool_find
+ *
+ * Description:
+ *   Index of the pool holding mem, -1 if none.
+ *
+ ****************************************************************************/
+
+static int mm_pool_find(void *mem)
+{
+  const struct mm_poolcfg_s *cfg;
+  int ndx;
+
+  for (ndx = 0; ndx < MM_POOL_NUM; ndx++)
+    {
+      cfg = &g_poolcfg[ndx];
+      if ((uint8_t *)mem >= cfg->start &&
+          (uint8_t *)mem < cfg->start + (uint32_t)cfg->blksize * cfg->nblks)
+        {
+          return ndx;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_pool_alloc
+ *
+ * Description:
+ *   Take a block from the smallest pool that fits, or from the next larger
+ *   one when that pool is exhausted.  Constant time for a given table.
+ *
+ ****************************************************************************/
+
+void *mm_pool_alloc(size_t size)
+{
+  const struct mm_poolcfg_s *cfg;
+  struct mm_pool_s *pool;
+  struct mm_freeblk_s *blk;
+  uint32_t flags;
+  int ndx;
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+  for (ndx = 0; ndx < MM_POOL_NUM; ndx++)
+    {
+      cfg = &g_poolcfg[ndx];
+      if (cfg->blksize < size)
+        {
+          continue;
+        }
+
+      pool = &g_pools[ndx];
+      flags = mm_pool_lock();
+
+      blk = pool->freelist;
+      if (blk)
+        {
+          pool->freelist = blk->next;
+        }
+      else if (pool->carved < cfg->nblks)
+        {
+          blk = (struct mm_freeblk_s *)
+                (cfg->start + (uint32_t)pool->carved * cfg->blksize);
+          pool->carved++;
+        }
+
+      if (blk)
+        {
+          if (++pool->used > pool->peak)
+            {
+              pool->peak = pool->used;
+            }
+        }
+      else
+        {
+          pool->fails++;
+        }
+
+      mm_pool_unlock(flags);
+
+      if (blk)
+        {
+          return blk;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mm_pool_free
+ *
+ * Description:
+ *   Push a block back on its pool's free list.  mem must be a pointer
+ *   returned by mm_pool_alloc(); anything outside the pools is left alone
+ *   and reported with false.
+ *
+ ****************************************************************************/
+
+bool mm_pool_free(void *mem)
+{
+  struct mm_freeblk_s *blk = (struct mm_freeblk_s *)mem;
+  struct mm_pool_s *pool;
+  uint32_t flags;
+  int ndx;
+
+  ndx = mm_pool_find(mem);
+  if (ndx < 0)
+    {
+      return false;
+    }
+
+  pool = &g_pools[ndx];
+  flags = mm_pool_lock();
+  blk->next = pool->freelist;
+  pool->freelist = blk;
+  pool->used--;
+  mm_pool_unlock(flags);
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: mm_pool_member
+ ****************************************************************************/
+
+bool mm_pool_member(void *mem)
+{
+  return mm_pool_find(mem) >= 0;
+}
+
+/****************************************************************************
+ * Name: mm_pool_blksize
+ ****************************************************************************/
+
+size_t mm_pool_blksize(void *mem)
+{
+  int ndx = mm_pool_find(mem);
+
+  return (ndx < 0) ? 0 : g_poolcfg[ndx].blksize;
+}
+
+/****************************************************************************
+ * Name: mm_pool_count
+ ****************************************************************************/
+
+int mm_pool_count(void)
+{
+  return MM_POOL_NUM;
+}
+
+/****************************************************************************
+ * Name: mm_pool_info
+ *
+ * Description:
+ *   Snapshot of one pool, the high-water mark tells how many blocks the
+ *   table really needs.
+ *
+ ****************************************************************************/
+
+int mm_pool_info(int ndx, struct mm_poolinfo_s *info)
+{
+  uint32_t flags;
+
+  if (ndx < 0 || ndx >= MM_POOL_NUM || info == NULL)
+    {
+      return -1;
+    }
+
+  flags = mm_pool_lock();
+  info->blksize = g_poolcfg[ndx].blksize;
+  info->nblks   = g_poolcfg[ndx].nblks;
+  info->used    = g_pools[ndx].used;
+  info->peak    = g_pools[ndx].peak;
+  info->fails   = g_pools[ndx].fails;
+  mm_pool_unlock(flags);
+
+  return 0;
+}
+
+#endif /* CONFIG_MM_POOL */
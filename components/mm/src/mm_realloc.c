@@ -0,0 +1,152 @@
+/****************************************************************************
+ * mm/src/mm_realloc.c
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "mm.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_realloc
+ *
+ * Description:
+ *   Resize an allocation, keeping it where it is whenever possible:
+ *
+ *   - Shrinking splits the tail off and frees it.
+ *   - Growing absorbs the physically next chunk when it is free and large
+ *     enough, any excess is split off again.
+ *   - Otherwise a new chunk is allocated, the old contents (old size) are
+ *     copied and the old chunk is freed; oldmem is left untouched if that
+ *     allocation fails.
+ *
+ *   Only the last case needs the old and the new block at the same time.
+ *   oldmem == NULL behaves as mm_malloc(), size == 0 as mm_free().
+ *
+ ****************************************************************************/
+
+void *mm_realloc(struct mm_heap_s *heap, void *oldmem, size_t size,
+                 void *caller)
+{
+  void *newmem;
+#if !defined(CONFIG_MM_DETECT_ERROR)
+  struct mm_allocnode_s *oldnode;
+  struct mm_freenode_s *next;
+  struct mm_allocnode_s *andbeyond;
+  size_t oldsize;
+  size_t newsize;
+#endif
+
+  if (!oldmem)
+    {
+      return mm_malloc(heap, size, caller);
+    }
+
+  if (size < 1)
+    {
+      mm_free(heap, oldmem, caller);
+      return NULL;
+    }
+
+#if defined(CONFIG_MM_DETECT_ERROR)
+  /* The debug header and tail magic are laid around the user size, always
+   * move so they are rebuilt by mm_malloc().
+   */
+
+  {
+    struct m_dbg_hdr *hdr = (struct m_dbg_hdr *)oldmem - 1;
+
+    newmem = mm_malloc(heap, size, caller);
+    if (newmem)
+      {
+        memcpy(newmem, oldmem, hdr->size < size ? hdr->size : size);
+        mm_free(heap, oldmem, caller);
+      }
+
+    return newmem;
+  }
+#else
+
+  /* Chunk size needed, as in mm_malloc() */
+
+  newsize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE);
+  oldnode = (struct mm_allocnode_s *)((uintptr_t)oldmem - SIZEOF_MM_ALLOCNODE);
+
+  mm_takesemaphore(heap);
+
+  oldsize = oldnode->size;
+
+  /* Shrink (or same size) in place */
+
+  if (newsize <= oldsize)
+    {
+      if (newsize < oldsize)
+        {
+          mm_shrinkchunk(heap, oldnode, newsize);
+        }
+
+      mm_givesemaphore(heap);
+
+      /* Traced as free + allocation at the same place */
+
+      mm_trace_free(heap, oldmem);
+      mm_trace_alloc(heap, oldmem, size);
+      return oldmem;
+    }
+
+  /* Grow in place into a free next chunk */
+
+  next = (struct mm_freenode_s *)((uintptr_t)oldnode + oldsize);
+  if ((next->preceding & MM_ALLOC_BIT) == 0 &&
+      oldsize + next->size >= newsize)
+    {
+      andbeyond = (struct mm_allocnode_s *)((uintptr_t)next + next->size);
+
+      mm_remfreechunk(heap, next);
+
+      oldnode->size        = oldsize + next->size;
+      andbeyond->preceding = oldnode->size | (andbeyond->preceding & MM_ALLOC_BIT);
+
+      /* Give back what was taken beyond the request */
+
+      if (oldnode->size > newsize)
+        {
+          mm_shrinkchunk(heap, oldnode, newsize);
+        }
+
+      mm_givesemaphore(heap);
+      mm_trace_free(heap, oldmem);
+      mm_trace_alloc(heap, oldmem, size);
+
+#if (CONFIG_MM_MAX_USED)
+      mm_max_usedsize_update(heap);
+#endif
+      return oldmem;
+    }
+
+  mm_givesemaphore(heap);
+
+  /* Move.  The new chunk is larger than the old one, so copying the old
+   * payload never reads beyond it nor writes beyond the new one.
+   */
+
+  newmem = mm_malloc(heap, size, caller);
+  if (newmem)
+    {
+      memcpy(newmem, oldmem, oldsize - SIZEOF_MM_ALLOCNODE);
+      mm_free(heap, oldmem, caller);
+    }
+
+  return newmem;
+#endif
+}
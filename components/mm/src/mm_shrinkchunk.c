@@ -0,0 +1,74 @@
+/****************************************************************************
+ * mm/src/mm_shrinkchunk.c
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "mm.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_shrinkchunk
+ *
+ * Description:
+ *   Reduce the size of the allocated chunk at node to size (granule aligned,
+ *   header included), returning the tail to the free lists: it is merged
+ *   into the next chunk when that one is free, otherwise it becomes a free
+ *   chunk of its own if it is large enough to hold a free node.  It is
+ *   assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_shrinkchunk(struct mm_heap_s *heap,
+                    struct mm_allocnode_s *node, size_t size)
+{
+  struct mm_freenode_s *next;
+  struct mm_freenode_s *newnode;
+  struct mm_allocnode_s *andbeyond;
+  size_t tail;
+
+  tail = node->size - size;
+  next = (struct mm_freenode_s *)((uintptr_t)node + node->size);
+
+  if ((next->preceding & MM_ALLOC_BIT) == 0)
+    {
+      /* The next chunk is free, move its start down over the tail.  The
+       * chunk after a free chunk is always allocated (frees coalesce), and
+       * the tail chunk ends the region, so andbeyond is valid.
+       */
+
+      andbeyond = (struct mm_allocnode_s *)((uintptr_t)next + next->size);
+
+      mm_remfreechunk(heap, next);
+
+      newnode              = (struct mm_freenode_s *)((uintptr_t)node + size);
+      newnode->size        = next->size + tail;
+      newnode->preceding   = size;
+      node->size           = size;
+      andbeyond->preceding = newnode->size | (andbeyond->preceding & MM_ALLOC_BIT);
+
+      mm_addfreechunk(heap, newnode);
+    }
+  else if (tail >= SIZEOF_MM_FREENODE)
+    {
+      /* The next chunk is allocated, the tail becomes a free chunk */
+
+      newnode            = (struct mm_freenode_s *)((uintptr_t)node + size);
+      newnode->size      = tail;
+      newnode->preceding = size;
+      node->size         = size;
+      next->preceding    = tail | (next->preceding & MM_ALLOC_BIT);
+
+      mm_addfreechunk(heap, newnode);
+    }
+
+  /* Otherwise the few bytes stay at the end of the allocation */
+}
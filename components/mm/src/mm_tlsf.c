@@ -0,0 +1,247 @@
+/****************************************************************************
+ * mm/src/mm_tlsf.c
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ * TLSF (two-level segregated fit) free lists for the mm heap, selected with
+ * CONFIG_MM_TLSF in place of the size-ordered list of mm_addfreechunk.c.
+ * Chunks keep the mm boundary tags (size/preceding, MM_ALLOC_BIT), so
+ * mm_malloc, mm_free, mm_mallinfo and the leak checker are shared; only
+ * finding, adding and removing free chunks changes, in a bounded number
+ * of steps except for the top list of chunks beyond CONFIG_MM_TLSF_MAXSHIFT,
+ * which is walked first-fit.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <string.h>
+#include "mm.h"
+
+#ifdef CONFIG_MM_TLSF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if MM_TLSF_FLI > 32 || CONFIG_MM_TLSF_SLI_LOG2 > 5
+#  error "TLSF bitmaps are 32 bits"
+#endif
+
+#if CONFIG_MM_TLSF_MAXSHIFT <= MM_TLSF_FLSHIFT
+#  error "CONFIG_MM_TLSF_MAXSHIFT too small"
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_tlsf_fls
+ *
+ * Description:
+ *   Index of the highest set bit, val != 0.  No clz instruction on ck802,
+ *   a fixed five step binary search instead.
+ *
+ ****************************************************************************/
+
+static int mm_tlsf_fls(uint32_t val)
+{
+  int bit = 0;
+
+  if (val >> 16) { val >>= 16; bit += 16; }
+  if (val >> 8)  { val >>= 8;  bit += 8; }
+  if (val >> 4)  { val >>= 4;  bit += 4; }
+  if (val >> 2)  { val >>= 2;  bit += 2; }
+  if (val >> 1)  { bit += 1; }
+
+  return bit;
+}
+
+/* Index of the lowest set bit, val != 0 */
+
+static inline int mm_tlsf_ffs(uint32_t val)
+{
+  return mm_tlsf_fls(val & (~val + 1));
+}
+
+/****************************************************************************
+ * Name: mm_tlsf_mapping
+ *
+ * Description:
+ *   Class of a chunk size.  Returns false when the size is above the top
+ *   class; fl and sl are then set to the top class.
+ *
+ ****************************************************************************/
+
+static bool mm_tlsf_mapping(size_t size, int *fl, int *sl)
+{
+  int t;
+
+  if (size < (1 << MM_TLSF_FLSHIFT))
+    {
+      *fl = 0;
+      *sl = (int)(size >> MM_MIN_SHIFT);
+      return true;
+    }
+
+  t = (size >> 31 >> 1) ? 32 : mm_tlsf_fls((uint32_t)size);
+  if (t > CONFIG_MM_TLSF_MAXSHIFT - 1)
+    {
+      *fl = MM_TLSF_FLI - 1;
+      *sl = MM_TLSF_SLI - 1;
+      return false;
+    }
+
+  *fl = t - MM_TLSF_FLSHIFT + 1;
+  *sl = (int)(size >> (t - CONFIG_MM_TLSF_SLI_LOG2)) - MM_TLSF_SLI;
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_initfreelists
+ ****************************************************************************/
+
+void mm_initfreelists(struct mm_heap_s *heap)
+{
+  heap->mm_flbitmap = 0;
+  memset(heap->mm_slbitmap, 0, sizeof(heap->mm_slbitmap));
+  memset(heap->mm_freelist, 0, sizeof(heap->mm_freelist));
+}
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Push a free chunk on the list of its class.  It is assumed that the
+ *   caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(struct mm_heap_s *heap, struct mm_freenode_s *node)
+{
+  struct mm_freenode_s *head;
+  int fl;
+  int sl;
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+
+  head = heap->mm_freelist[fl][sl];
+  node->blink = NULL;
+  node->flink = head;
+  if (head)
+    {
+      head->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_flbitmap        |= 1ul << fl;
+  heap->mm_slbitmap[fl]    |= 1ul << sl;
+}
+
+/****************************************************************************
+ * Name: mm_remfreechunk
+ *
+ * Description:
+ *   Unlink a free chunk, clearing the bitmaps when its list gets empty.
+ *
+ ****************************************************************************/
+
+void mm_remfreechunk(struct mm_heap_s *heap, struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  if (node->blink)
+    {
+      node->blink->flink = node->flink;
+      return;
+    }
+
+  /* The node was the list head */
+
+  mm_tlsf_mapping(node->size, &fl, &sl);
+  heap->mm_freelist[fl][sl] = node->flink;
+  if (node->flink == NULL)
+    {
+      heap->mm_slbitmap[fl] &= ~(1ul << sl);
+      if (heap->mm_slbitmap[fl] == 0)
+        {
+          heap->mm_flbitmap &= ~(1ul << fl);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Good fit: round the size up to the next class boundary, so every chunk
+ *   of the first non-empty class at or above it is large enough, and take
+ *   that list's head.  Only sizes above the top class walk a list, first
+ *   fit against the size asked for, not the rounded one.
+ *
+ ****************************************************************************/
+
+struct mm_freenode_s *mm_findfreechunk(struct mm_heap_s *heap, size_t size)
+{
+  struct mm_freenode_s *node;
+  size_t round = size;
+  uint32_t map;
+  int fl;
+  int sl;
+
+  if (size >= (1 << MM_TLSF_FLSHIFT))
+    {
+      round += ((size_t)1 << (mm_tlsf_fls((uint32_t)size) -
+                              CONFIG_MM_TLSF_SLI_LOG2)) - 1;
+    }
+
+  if (!mm_tlsf_mapping(round, &fl, &sl))
+    {
+      /* Larger than any class, first fit in the shared top list */
+
+      for (node = heap->mm_freelist[fl][sl];
+           node && node->size < size;
+           node = node->flink);
+
+      return node;
+    }
+
+  /* First non-empty class at (fl, sl) or above */
+
+  map = heap->mm_slbitmap[fl] & (~0ul << sl);
+  if (map == 0)
+    {
+      map = heap->mm_flbitmap & (~0ul << 1 << fl);
+      if (map == 0)
+        {
+          return NULL;
+        }
+
+      fl  = mm_tlsf_ffs(map);
+      map = heap->mm_slbitmap[fl];
+    }
+
+  sl = mm_tlsf_ffs(map);
+  node = heap->mm_freelist[fl][sl];
+
+  /* The top class also holds chunks above its range, all of them large
+   * enough; every other class is large enough by construction.
+   */
+
+  return node;
+}
+
+#endif /* CONFIG_MM_TLSF */
@@ -0,0 +1,187 @@
+/****************************************************************************
+ * mm/src/mm_trace.c
+ *
+ *   Copyright (C) 2015-2022 @ APTCHIP
+ *
+ * Allocation trace ring.  Records are written with interrupts masked so
+ * allocations from interrupt handlers interleave correctly; when the ring
+ * is full the oldest record is overwritten and counted as lost.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include "mm.h"
+#include "mm_trace.h"
+
+#ifdef CONFIG_MM_TRACE
+
+#include <csi_core.h>
+#include <drv/tick.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_MM_TRACE_DEPTH & (CONFIG_MM_TRACE_DEPTH - 1)) != 0
+#  error "CONFIG_MM_TRACE_DEPTH must be a power of two"
+#endif
+
+#define MM_TRACE_MASK  (CONFIG_MM_TRACE_DEPTH - 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mm_trace_s g_trace[CONFIG_MM_TRACE_DEPTH];
+static uint32_t g_trace_head;   /* Free running write count */
+static uint32_t g_trace_tail;   /* Free running read count */
+static uint32_t g_trace_lost;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void mm_trace_put(uint16_t id, uint16_t opsize)
+{
+  struct mm_trace_s *rec;
+  uint32_t stamp = mm_trace_stamp();
+  uint32_t flags;
+
+  flags = csi_irq_save();
+
+  if (g_trace_head - g_trace_tail >= CONFIG_MM_TRACE_DEPTH)
+    {
+      g_trace_tail++;
+      g_trace_lost++;
+    }
+
+  rec = &g_trace[g_trace_head & MM_TRACE_MASK];
+  rec->stamp  = stamp;
+  rec->id     = id;
+  rec->opsize = opsize;
+  g_trace_head++;
+
+  csi_irq_restore(flags);
+}
+
+static uint16_t mm_trace_id(struct mm_heap_s *heap, void *mem)
+{
+  return (uint16_t)(((uintptr_t)mem - (uintptr_t)heap->mm_heapstart[0]) >>
+                    MM_MIN_SHIFT);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_trace_stamp
+ ****************************************************************************/
+
+__attribute__((weak)) uint32_t mm_trace_stamp(void)
+{
+  return (uint32_t)csi_tick_get_us();
+}
+
+/****************************************************************************
+ * Name: mm_trace_alloc / mm_trace_free
+ *
+ * Description:
+ *   Hooks of mm_malloc/mm_free/mm_realloc.  mem is the pointer handed to
+ *   the user, NULL for a failed allocation.
+ *
+ ****************************************************************************/
+
+void mm_trace_alloc(struct mm_heap_s *heap, void *mem, size_t size)
+{
+  uint16_t opsize = size > MM_TRACE_SIZE ? MM_TRACE_SIZE : (uint16_t)size;
+
+  mm_trace_put(mem ? mm_trace_id(heap, mem) : MM_TRACE_FAILID, opsize);
+}
+
+void mm_trace_free(struct mm_heap_s *heap, void *mem)
+{
+  mm_trace_put(mm_trace_id(heap, mem), MM_TRACE_FREE);
+}
+
+/****************************************************************************
+ * Name: mm_trace_read
+ ****************************************************************************/
+
+int mm_trace_read(struct mm_trace_s *rec)
+{
+  uint32_t flags;
+  int ret = 0;
+
+  flags = csi_irq_save();
+  if (g_trace_tail != g_trace_head)
+    {
+      *rec = g_trace[g_trace_tail & MM_TRACE_MASK];
+      g_trace_tail++;
+      ret = 1;
+    }
+
+  csi_irq_restore(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mm_trace_lost
+ ****************************************************************************/
+
+uint32_t mm_trace_lost(void)
+{
+  uint32_t flags;
+  uint32_t lost;
+
+  flags = csi_irq_save();
+  lost = g_trace_lost;
+  g_trace_lost = 0;
+  csi_irq_restore(flags);
+
+  return lost;
+}
+
+/****************************************************************************
+ * Name: mm_trace_dump
+ ****************************************************************************/
+
+int mm_trace_dump(void)
+{
+  struct mm_trace_s rec;
+  uint32_t lost;
+  int n = 0;
+
+  lost = mm_trace_lost();
+  if (lost)
+    {
+      printf("@mm lost %u\n", (unsigned int)lost);
+    }
+
+  while (mm_trace_read(&rec))
+    {
+      if (rec.opsize & MM_TRACE_FREE)
+        {
+          printf("@mm f %u %u\n", rec.id, (unsigned int)rec.stamp);
+        }
+      else if (rec.id == MM_TRACE_FAILID)
+        {
+          printf("@mm x %u %u\n", rec.opsize, (unsigned int)rec.stamp);
+        }
+      else
+        {
+          printf("@mm a %u %u %u\n", rec.id, rec.opsize,
+                 (unsigned int)rec.stamp);
+        }
+
+      n++;
+    }
+
+  return n;
+}
+
+#endif /* CONFIG_MM_TRACE */
@@ -0,0 +1,261 @@
+/***********************************************************************//**
+ * \file  adc_ovs_host.c
+ * \brief  host(linux) check of adc oversampling(components/chip/drivers/adc_ovs.c):
+ *         parameter limits, block splitting against a one-pass reference for all
+ *         ratios and channel numbers, full scale and ADC_DR upper bits, and the
+ *         resolution gain on synthetic dithered waveforms(dc with a fraction of a
+ *         lsb, slow sine).
+ *
+ *         build(from the repo root):
+ *         gcc -O2 -Icomponents/csi/include demo/script/adc_ovs_host.c \
+ *             components/chip/drivers/adc_ovs.c -lm -o adc_ovs_host
+ *         usage:
+ *         adc_ovs_host [-r seed]
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+#include <drv/adc_ovs.h>
+
+#define SIM_SEQ_MAX			8192		//sequences of one run, two outputs at ratio 4096
+
+static uint32_t s_wData[SIM_SEQ_MAX * ADC_OVS_CHNL_MAX];
+static csi_adc_ovs_result_t s_tOut[(SIM_SEQ_MAX + 1) * ADC_OVS_CHNL_MAX];
+static uint32_t s_wRng = 1;
+static int s_iFail = 0;
+
+static uint32_t xorshift(void)
+{
+	uint32_t x = s_wRng;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return s_wRng = x;
+}
+
+//uniform in [-1, 1)
+static double dither(void)
+{
+	return (double)xorshift() / 2147483648.0 - 1.0;
+}
+
+//12bit conversion of an analog level in lsb, with junk in the ADC_DR upper bits
+static uint32_t sim_adc(double dLevel)
+{
+	long lCode = lround(dLevel);
+
+	if(lCode < 0)
+		lCode = 0;
+	if(lCode > ADC_OVS_DATA_MSK)
+		lCode = ADC_OVS_DATA_MSK;
+	return (uint32_t)lCode | (xorshift() & 0xf0000ul);
+}
+
+static void fail(const char *pName, double dGot, double dWant)
+{
+	printf("FAIL %s: %g, expected %g\n", pName, dGot, dWant);
+	s_iFail = 1;
+}
+
+static void check_params(void)
+{
+	csi_adc_ovs_t tOvs;
+
+	if(csi_adc_ovs_init(&tOvs, 0, 16) != -1 || csi_adc_ovs_init(&tOvs, ADC_OVS_CHNL_MAX + 1, 16) != -1 ||
+		csi_adc_ovs_init(&tOvs, 1, 0) != -1 || csi_adc_ovs_init(&tOvs, 1, 48) != -1 ||
+		csi_adc_ovs_init(&tOvs, 1, ADC_OVS_RATIO_MAX * 2) != -1 || csi_adc_ovs_init(NULL, 1, 16) != -1)
+		fail("bad parameter accepted", 0, -1);
+	if(csi_adc_ovs_init(&tOvs, ADC_OVS_CHNL_MAX, ADC_OVS_RATIO_MAX) != 0 || tOvs.byExtBits != 6)
+		fail("ratio 4096 ext bits", tOvs.byExtBits, 6);
+	if(csi_adc_ovs_init(&tOvs, 1, 2) != 0 || tOvs.byExtBits != 0)
+		fail("ratio 2 ext bits", tOvs.byExtBits, 0);
+}
+
+/* random block splits give the same outputs as a one-pass reference */
+static void check_split(uint8_t byChnl, uint16_t hwRatio, uint16_t hwSeq)
+{
+	csi_adc_ovs_t tOvs;
+	uint32_t wSum, wPos, wRound, k, wOut = 0;
+	uint16_t hwMin, hwMax, hwVal, hwBlk, hwDone = 0, hwOuts;
+	uint8_t byShift, byExt, i;
+	const csi_adc_ovs_result_t *ptRes;
+	char chName[64];
+
+	for(k = 0; k < (uint32_t)hwSeq * byChnl; k++)
+		s_wData[k] = xorshift() & 0xffff0fff;
+
+	csi_adc_ovs_init(&tOvs, byChnl, hwRatio);
+	byShift = tOvs.byShift;
+	byExt = tOvs.byExtBits;
+	while(hwDone < hwSeq)
+	{
+		hwBlk = (xorshift() & 1) ? (uint16_t)(xorshift() % 7 + 1) : (uint16_t)(xorshift() % (2u * hwRatio) + 1);
+		if(hwBlk > hwSeq - hwDone)
+			hwBlk = hwSeq - hwDone;
+		hwOuts = csi_adc_ovs_accumulate(&tOvs, &s_wData[(uint32_t)hwDone * byChnl], hwBlk, &s_tOut[wOut * byChnl]);
+		wOut += hwOuts;
+		hwDone += hwBlk;
+	}
+
+	snprintf(chName, sizeof(chName), "outputs chnl %u ratio %u", byChnl, hwRatio);
+	if(wOut != hwSeq / hwRatio)
+		fail(chName, wOut, hwSeq / hwRatio);
+	if(tOvs.hwCount != hwSeq % hwRatio)
+		fail("partial count", tOvs.hwCount, hwSeq % hwRatio);
+
+	for(k = 0; k < wOut && !s_iFail; k++)
+	{
+		for(i = 0; i < byChnl; i++)
+		{
+			wSum = 0;
+			hwMin = ADC_OVS_DATA_MSK;
+			hwMax = 0;
+			for(wPos = k * hwRatio; wPos < (k + 1) * hwRatio; wPos++)
+			{
+				hwVal = s_wData[wPos * byChnl + i] & ADC_OVS_DATA_MSK;
+				wSum += hwVal;
+				hwMin = hwVal < hwMin ? hwVal : hwMin;
+				hwMax = hwVal > hwMax ? hwVal : hwMax;
+			}
+			ptRes = &s_tOut[k * byChnl + i];
+			snprintf(chName, sizeof(chName), "chnl %u/%u ratio %u output %u", i, byChnl, hwRatio, (unsigned int)k);
+			if(ptRes->hwMin != hwMin || ptRes->hwMax != hwMax)
+				fail(chName, ptRes->hwMin, hwMin);
+			wRound = 1ul << (byShift - byExt) >> 1;				//half lsb of the output, 0 at ratio 1
+			if(ptRes->hwMean != (wSum + (hwRatio >> 1)) / hwRatio)
+				fail(chName, ptRes->hwMean, (double)wSum / hwRatio);
+			if(ptRes->wValue != (wSum + wRound) / (1ul << (byShift - byExt)))
+				fail(chName, ptRes->wValue, (double)wSum / (1ul << (byShift - byExt)));
+		}
+	}
+}
+
+static void check_full_scale(void)
+{
+	csi_adc_ovs_t tOvs;
+	uint32_t k;
+
+	for(k = 0; k < ADC_OVS_RATIO_MAX; k++)
+		s_wData[k] = 0xfffff000ul | ADC_OVS_DATA_MSK;
+	csi_adc_ovs_init(&tOvs, 1, ADC_OVS_RATIO_MAX);
+	if(csi_adc_ovs_accumulate(&tOvs, s_wData, ADC_OVS_RATIO_MAX, s_tOut) != 1)
+		fail("full scale outputs", 0, 1);
+	if(s_tOut[0].wValue != (uint32_t)ADC_OVS_DATA_MSK << 6 || s_tOut[0].hwMean != ADC_OVS_DATA_MSK ||
+		s_tOut[0].hwMin != ADC_OVS_DATA_MSK || s_tOut[0].hwMax != ADC_OVS_DATA_MSK)
+		fail("full scale value", s_tOut[0].wValue, ADC_OVS_DATA_MSK << 6);
+}
+
+/* dc level with a fraction of a lsb: dithered oversampling resolves it, the raw code can not */
+static void check_dc(uint16_t hwRatio)
+{
+	csi_adc_ovs_t tOvs;
+	double dLevel, dGot, dErr, dBound, dWorst = 0;
+	uint16_t hwOut, k;
+	int iRun;
+	char chName[48];
+
+	csi_adc_ovs_init(&tOvs, 1, hwRatio);
+	//quantisation of the output + 4 sigma of the mean of a uniform [-1, 1) dither
+	dBound = 0.5 / (1u << tOvs.byExtBits) + 4.0 * 0.5774 / sqrt(hwRatio);
+	for(iRun = 0; iRun < 200; iRun++)
+	{
+		dLevel = 8.0 + (double)(xorshift() % 4000000) / 1000.0;
+		for(k = 0; k < hwRatio; k++)
+			s_wData[k] = sim_adc(dLevel + dither());
+		hwOut = csi_adc_ovs_accumulate(&tOvs, s_wData, hwRatio, s_tOut);
+		dGot = (double)s_tOut[0].wValue / (1u << tOvs.byExtBits);
+		dErr = fabs(dGot - dLevel);
+		if(dErr > dWorst)
+			dWorst = dErr;
+		if(hwOut != 1 || dErr > dBound)
+		{
+			snprintf(chName, sizeof(chName), "dc %.3f ratio %u", dLevel, hwRatio);
+			fail(chName, dGot, dLevel);
+			return;
+		}
+	}
+	printf("dc    ratio %4u  +%u bits  worst error %.4f lsb(bound %.4f)\n", hwRatio, tOvs.byExtBits, dWorst, dBound);
+}
+
+/* slow sine: rms error of the outputs against the window average of the analog signal */
+static void check_sine(uint16_t hwRatio)
+{
+	csi_adc_ovs_t tOvs;
+	double dPhase, dStep, dTrue, dErr, dRaw = 0, dOvs = 0;
+	uint32_t k, wSeq = SIM_SEQ_MAX;
+	uint16_t hwOut, n;
+
+	csi_adc_ovs_init(&tOvs, 1, hwRatio);
+	dStep = 2.0 * M_PI / (64.0 * hwRatio);						//64 outputs per period
+	for(n = 0; n < 16; n++)
+	{
+		dPhase = (double)(xorshift() % 1000) / 1000.0;
+		for(k = 0; k < wSeq; k++)
+			s_wData[k] = sim_adc(2048.0 + 1500.0 * sin(dPhase + dStep * k) + dither());
+		hwOut = csi_adc_ovs_accumulate(&tOvs, s_wData, (uint16_t)wSeq, s_tOut);
+		for(k = 0; k < hwOut; k++)
+		{
+			//average of the sine over the window, closed form
+			dTrue = 2048.0 + 1500.0 * (cos(dPhase + dStep * (k * hwRatio - 0.5)) -
+				cos(dPhase + dStep * ((k + 1) * hwRatio - 0.5))) / (dStep * hwRatio);
+			dErr = (double)s_tOut[k].wValue / (1u << tOvs.byExtBits) - dTrue;
+			dOvs += dErr * dErr;
+			dErr = (double)(s_wData[k * hwRatio + hwRatio / 2] & ADC_OVS_DATA_MSK) -
+				(2048.0 + 1500.0 * sin(dPhase + dStep * (k * hwRatio + hwRatio / 2)));
+			dRaw += dErr * dErr;
+		}
+		if(hwOut != wSeq / hwRatio)
+			fail("sine outputs", hwOut, wSeq / hwRatio);
+	}
+	dOvs = sqrt(dOvs / (16.0 * (wSeq / hwRatio)));
+	dRaw = sqrt(dRaw / (16.0 * (wSeq / hwRatio)));
+	printf("sine  ratio %4u  +%u bits  rms error %.4f lsb, raw sample %.4f lsb\n", hwRatio, tOvs.byExtBits, dOvs, dRaw);
+	if(dOvs > 2.0 * (dRaw / sqrt(hwRatio) + 0.5 / (1u << tOvs.byExtBits) / sqrt(3.0)))
+		fail("sine rms error", dOvs, dRaw / sqrt(hwRatio));
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t wSeq;
+	uint16_t hwRatio;
+	uint8_t byChnl;
+	int iOpt;
+
+	while((iOpt = getopt(argc, argv, "r:")) != -1)
+	{
+		if(iOpt == 'r')
+			s_wRng = (uint32_t)strtoul(optarg, NULL, 0) | 1;
+		else
+		{
+			fprintf(stderr, "usage: %s [-r seed]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	check_params();
+	check_full_scale();
+	for(hwRatio = 1; hwRatio <= ADC_OVS_RATIO_MAX && !s_iFail; hwRatio <<= 1)
+	{
+		for(byChnl = 1; byChnl <= ADC_OVS_CHNL_MAX && !s_iFail; byChnl += (byChnl < 4) ? 1 : 5)
+		{
+			wSeq = 2u * hwRatio + xorshift() % hwRatio;			//two outputs and a partial one
+			check_split(byChnl, hwRatio, (uint16_t)(wSeq > SIM_SEQ_MAX ? SIM_SEQ_MAX : wSeq));
+		}
+	}
+	for(hwRatio = 4; hwRatio <= ADC_OVS_RATIO_MAX && !s_iFail; hwRatio <<= 2)
+		check_dc(hwRatio);
+	for(hwRatio = 4; hwRatio <= 256 && !s_iFail; hwRatio <<= 2)
+		check_sine(hwRatio);
+
+	printf("%s\n", s_iFail ? "FAIL" : "PASS");
+	return s_iFail;
+}
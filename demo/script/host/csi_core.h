@@ -0,0 +1,29 @@
+/***********************************************************************//**
+ * \file  csi_core.h
+ * \brief  host(linux) stand-in of csi/include/core/csi_core.h for the driver checks in
+ *         demo/script; csi_irq_save/csi_irq_restore go to the interrupt mask model of
+ *         the harness(lat_host.c), the vic functions used by drv/irq.h do nothing
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#ifndef _CSI_CORE_H_
+#define _CSI_CORE_H_
+
+#include <stdint.h>
+
+uint32_t host_irq_save(void);
+void host_irq_restore(uint32_t wState);
+
+#define csi_irq_save()			host_irq_save()
+#define csi_irq_restore(s)		host_irq_restore(s)
+
+#define __ALWAYS_STATIC_INLINE	static inline
+
+static inline void csi_vic_set_prio(int32_t IRQn, uint32_t priority) { (void)IRQn; (void)priority; }
+static inline void csi_vic_set_wakeup_irq(int32_t IRQn) { (void)IRQn; }
+static inline void csi_vic_clear_wakeup_irq(int32_t IRQn) { (void)IRQn; }
+
+#endif /* _CSI_CORE_H_ */
@@ -0,0 +1,44 @@
+/***********************************************************************//**
+ * \file  csp_hwdiv.h
+ * \brief  host(linux) stand-in of chip/include/csp_hwdiv.h: the register access
+ *         functions go to the divider model of the harness(hwdiv_host.c), which
+ *         may run an "isr" before each access
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <stdint.h>
+
+typedef struct host_hwdiv csp_hwdiv_t;
+
+void host_hwdiv_write(csp_hwdiv_t *ptHwdivBase, uint8_t byReg, uint32_t wVal);
+uint32_t host_hwdiv_read(csp_hwdiv_t *ptHwdivBase, uint8_t byReg);
+
+enum {HOST_HWDIV_DIVIDEND = 0, HOST_HWDIV_DIVISOR, HOST_HWDIV_QUOTIENT, HOST_HWDIV_REMAIN, HOST_HWDIV_CR};
+
+static inline void csp_hwdiv_set_mode(csp_hwdiv_t *ptHwdivBase, uint32_t wCr)
+{
+	host_hwdiv_write(ptHwdivBase, HOST_HWDIV_CR, wCr);
+}
+
+static inline void csp_hwdiv_set_dividend(csp_hwdiv_t *ptHwdivBase, uint32_t wDividend)
+{
+	host_hwdiv_write(ptHwdivBase, HOST_HWDIV_DIVIDEND, wDividend);
+}
+
+static inline void csp_hwdiv_set_divisor(csp_hwdiv_t *ptHwdivBase, uint32_t wDivisor)
+{
+	host_hwdiv_write(ptHwdivBase, HOST_HWDIV_DIVISOR, wDivisor);
+}
+
+static inline uint32_t csp_hwdiv_get_quotient(csp_hwdiv_t *ptHwdivBase)
+{
+	return host_hwdiv_read(ptHwdivBase, HOST_HWDIV_QUOTIENT);
+}
+
+static inline uint32_t csp_hwdiv_get_remain(csp_hwdiv_t *ptHwdivBase)
+{
+	return host_hwdiv_read(ptHwdivBase, HOST_HWDIV_REMAIN);
+}
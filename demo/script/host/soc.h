@@ -0,0 +1,40 @@
+/***********************************************************************//**
+ * \file  soc.h
+ * \brief  host(linux) stand-in of chip/drivers/sys/soc.h for the driver checks in
+ *         demo/script; only what hwdiv.c and stimer.c need, the PSR interrupt enable
+ *         and the divider registers are modelled by the harness(hwdiv_host.c, lat_host.c)
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#ifndef _SOC_H_
+#define _SOC_H_
+
+#include <stdint.h>
+
+//HWDIV, same values as the chip soc.h
+#define HWDIV_MODE_IRQ_LOCK		0
+#define HWDIV_MODE_SEQ_RETRY	1
+#ifndef HWDIV_MODE
+#define HWDIV_MODE			HWDIV_MODE_IRQ_LOCK
+#endif
+
+extern struct host_hwdiv g_tHostHwdiv;
+#define AHB_HWD_BASE		(&g_tHostHwdiv)
+
+//csi_core.h PSR access, interrupts masked by the harness model
+uint32_t host_get_psr(void);
+void host_set_psr(uint32_t wPsr);
+void host_disable_irq(void);
+
+#define __get_PSR()				host_get_psr()
+#define __set_PSR(psr)			host_set_psr(psr)
+#define __disable_excp_irq()	host_disable_irq()
+
+//software timer wheel, same values as the chip soc.h
+#define STIMER_WHEEL_BITS	4
+#define STIMER_WHEEL_LEVELS	5
+
+#endif /* _SOC_H_ */
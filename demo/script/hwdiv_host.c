@@ -0,0 +1,366 @@
+/***********************************************************************//**
+ * \file  hwdiv_host.c
+ * \brief  host(linux) check of the hardware divider runtime(components/chip/drivers/hwdiv.c)
+ *         against native division: hwdiv.c is built on a register model(demo/script/host)
+ *         which runs an "isr" doing its own divisions before any register access while
+ *         interrupts are enabled, nested up to HOST_ISR_NEST_MAX, and holds it pending
+ *         while they are masked; both HWDIV_MODE builds must give only exact results.
+ *         The HWDIV_MODE_IRQ_LOCK build also runs a pass with the masking ignored, which
+ *         must go wrong, so the model is shown to reach the divider sequence. The 64 bit
+ *         helpers(__udivdi3 ...) are checked on edge operands and random bit widths the
+ *         same way, then the reciprocal divider(csi_hwdiv_recip_xxx) is compared with / and %.
+ *
+ *         build(from the repo root), HWDIV_MODE 0: irq lock, 1: sequence retry:
+ *         gcc -O2 -DHWDIV_MODE=1 -Idemo/script/host -Icomponents/csi/include \
+ *             demo/script/hwdiv_host.c components/chip/drivers/hwdiv.c -o hwdiv_host
+ *         usage:
+ *         hwdiv_host [-n divisions] [-r seed]
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <soc.h>
+#include "csp_hwdiv.h"
+#include <drv/hwdiv.h>
+
+#define HOST_PSR_IE			(0x01ul << 6)	//CK802 PSR.IE
+#define HOST_ISR_NEST_MAX	3
+#define HOST_ISR_RATE		4				//an isr before 1 of HOST_ISR_RATE register accesses(thread level)
+
+//runtime functions of hwdiv.c, normally called by the compiler for / and %
+int __divsi3(int wDividend, int wDivisor);
+int __modsi3(int wDividend, int wDivisor);
+unsigned int __udivsi3(unsigned int wDividend, unsigned int wDivisor);
+unsigned int __umodsi3(unsigned int wDividend, unsigned int wDivisor);
+unsigned long long __udivdi3(unsigned long long dwDividend, unsigned long long dwDivisor);
+unsigned long long __umoddi3(unsigned long long dwDividend, unsigned long long dwDivisor);
+long long __divdi3(long long dwDividend, long long dwDivisor);
+long long __moddi3(long long dwDividend, long long dwDivisor);
+
+struct host_hwdiv {
+	uint32_t	wReg[5];				//HOST_HWDIV_xxx
+};
+struct host_hwdiv g_tHostHwdiv;
+
+static uint32_t s_wPsr = HOST_PSR_IE;
+static uint8_t s_byPending = 0;
+static uint8_t s_byNest = 0;
+static uint8_t s_byNoMask = 0;			//1: __disable_excp_irq ignored
+static uint32_t s_wRng = 1;
+
+static uint32_t s_wIsrNum = 0;			//isr taken
+static uint32_t s_wIsrErr = 0;			//wrong results inside the isr
+static uint32_t s_wCrWrite = 0;			//divider sequences started at thread level
+
+static uint32_t xorshift(void)
+{
+	uint32_t x = s_wRng;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return s_wRng = x;
+}
+
+//operand of random bit width, small values and full range equally likely
+static uint32_t rand_operand(void)
+{
+	return xorshift() >> (xorshift() & 31);
+}
+
+static uint64_t rand_operand64(void)
+{
+	uint64_t dwVal = ((uint64_t)xorshift() << 32) | xorshift();
+
+	return dwVal >> (xorshift() & 63);
+}
+
+/* one random division from the isr, checked at once */
+static void host_isr(void)
+{
+	uint32_t wA = rand_operand(), wB = rand_operand() | 1, wPsr = s_wPsr;
+	uint64_t dwA = rand_operand64();
+	hwdiv_urslt_t tU;
+
+	s_wIsrNum++;
+	s_byNest++;
+	s_wPsr &= ~HOST_PSR_IE;							//exception entry masks
+	if(xorshift() & 1)
+		s_wPsr |= HOST_PSR_IE;						//nesting allowed by the isr
+	switch(xorshift() & 3)
+	{
+		case 0:
+			s_wIsrErr += (__udivsi3(wA, wB) != wA / wB);
+			break;
+		case 1:
+			s_wIsrErr += ((uint32_t)__modsi3((int32_t)wA, (int32_t)wB) != (uint32_t)((int32_t)wA % (int32_t)wB));
+			break;
+		case 2:
+			s_wIsrErr += (__udivdi3(dwA, wB) != dwA / wB);
+			break;
+		default:
+			tU = csi_hwdiv_unsigned_calc(wA, wB);
+			s_wIsrErr += (tU.wQuot != wA / wB || tU.wRem != wA % wB);
+			break;
+	}
+	s_byNest--;
+	s_wPsr = wPsr;
+}
+
+/* interrupt point before a register access */
+static void host_irq_point(void)
+{
+	if(xorshift() % (HOST_ISR_RATE << (s_byNest * 2)))		//nested isr less often, retry storms stay short
+		return;
+	if(!(s_wPsr & HOST_PSR_IE))
+		s_byPending = 1;
+	else if(s_byNest < HOST_ISR_NEST_MAX)
+		host_isr();
+}
+
+uint32_t host_get_psr(void)
+{
+	return s_wPsr;
+}
+
+void host_set_psr(uint32_t wPsr)
+{
+	s_wPsr = wPsr;
+	if((s_wPsr & HOST_PSR_IE) && s_byPending)
+	{
+		s_byPending = 0;
+		host_isr();
+	}
+}
+
+void host_disable_irq(void)
+{
+	if(!s_byNoMask)
+		s_wPsr &= ~HOST_PSR_IE;
+}
+
+void host_hwdiv_write(csp_hwdiv_t *ptHwdivBase, uint8_t byReg, uint32_t wVal)
+{
+	uint32_t *pwReg = ptHwdivBase->wReg;
+
+	host_irq_point();
+	pwReg[byReg] = wVal;
+	if(byReg == HOST_HWDIV_CR && s_byNest == 0)
+		s_wCrWrite++;
+	if(byReg != HOST_HWDIV_DIVISOR)
+		return;
+
+	if(wVal == 0)													//result of x/0 is not checked
+	{
+		pwReg[HOST_HWDIV_QUOTIENT] = 0xffffffff;
+		pwReg[HOST_HWDIV_REMAIN] = pwReg[HOST_HWDIV_DIVIDEND];
+	}
+	else if(pwReg[HOST_HWDIV_CR] & 1)								//unsigned
+	{
+		pwReg[HOST_HWDIV_QUOTIENT] = pwReg[HOST_HWDIV_DIVIDEND] / wVal;
+		pwReg[HOST_HWDIV_REMAIN] = pwReg[HOST_HWDIV_DIVIDEND] % wVal;
+	}
+	else if(pwReg[HOST_HWDIV_DIVIDEND] == 0x80000000 && wVal == 0xffffffff)
+	{
+		pwReg[HOST_HWDIV_QUOTIENT] = 0x80000000;
+		pwReg[HOST_HWDIV_REMAIN] = 0;
+	}
+	else
+	{
+		pwReg[HOST_HWDIV_QUOTIENT] = (uint32_t)((int32_t)pwReg[HOST_HWDIV_DIVIDEND] / (int32_t)wVal);
+		pwReg[HOST_HWDIV_REMAIN] = (uint32_t)((int32_t)pwReg[HOST_HWDIV_DIVIDEND] % (int32_t)wVal);
+	}
+}
+
+uint32_t host_hwdiv_read(csp_hwdiv_t *ptHwdivBase, uint8_t byReg)
+{
+	host_irq_point();
+	return ptHwdivBase->wReg[byReg];
+}
+
+/* thread level divisions by every runtime entry, return the wrong ones */
+static uint32_t check_div32(uint32_t wNum)
+{
+	uint32_t i, wA, wB, wErr = 0;
+	int32_t iA, iB;
+	hwdiv_urslt_t tU;
+	hwdiv_rslt_t tS;
+
+	for(i = 0; i < wNum; i++)
+	{
+		wA = rand_operand();
+		wB = rand_operand();
+		if(wB == 0)
+			wB = 1;
+		iA = (int32_t)wA;
+		iB = (int32_t)wB;
+		if(iA == INT32_MIN && iB == -1)
+			iB = 1;
+
+		switch(i % 6)
+		{
+			case 0: wErr += (__udivsi3(wA, wB) != wA / wB); break;
+			case 1: wErr += (__umodsi3(wA, wB) != wA % wB); break;
+			case 2: wErr += (__divsi3(iA, iB) != iA / iB); break;
+			case 3: wErr += (__modsi3(iA, iB) != iA % iB); break;
+			case 4:
+				tU = csi_hwdiv_unsigned_calc(wA, wB);
+				wErr += (tU.wQuot != wA / wB || tU.wRem != wA % wB);
+				break;
+			default:
+				tS = csi_hwdiv_signed_calc(iA, iB);
+				wErr += (tS.wQuot != iA / iB || tS.wRem != iA % iB);
+				break;
+		}
+	}
+	return wErr;
+}
+
+/* one 64 bit pair through the four helpers */
+static uint32_t check_pair64(uint64_t dwA, uint64_t dwB)
+{
+	int64_t lA = (int64_t)dwA, lB = (int64_t)dwB;
+	uint32_t wErr = 0;
+
+	if(dwB == 0)
+		return 0;
+	wErr += (__udivdi3(dwA, dwB) != dwA / dwB);
+	wErr += (__umoddi3(dwA, dwB) != dwA % dwB);
+	if(!(lA == INT64_MIN && lB == -1))
+	{
+		wErr += (__divdi3(lA, lB) != lA / lB);
+		wErr += (__moddi3(lA, lB) != lA % lB);
+	}
+	return wErr;
+}
+
+/* 64 bit helpers: edge operands crossed, then random pairs of random bit widths,
+   a third of them with a 32 bit divisor(the 64/32 divlu path) */
+static uint32_t check_div64(uint32_t wNum)
+{
+	static const uint64_t dwEdge[] = {1, 2, 3, 7, 10, 0xffff, 0x10000, 0x10001, 0x7fffffff, 0x80000000,
+		0x80000001, 0xffffffff, 0x100000000ull, 0x100000001ull, 0x1ffffffffull, 0xffffffff00000000ull,
+		0x7fffffffffffffffull, 0x8000000000000000ull, 0x8000000000000001ull, 0xfffffffffffffffeull,
+		0xffffffffffffffffull};
+	uint32_t i, j, wErr = 0;
+	uint64_t dwA, dwB;
+
+	for(i = 0; i < sizeof(dwEdge) / sizeof(dwEdge[0]); i++)
+	{
+		for(j = 0; j < sizeof(dwEdge) / sizeof(dwEdge[0]); j++)
+		{
+			wErr += check_pair64(dwEdge[i], dwEdge[j]);
+			wErr += check_pair64(dwEdge[i] - 1, dwEdge[j]);
+			wErr += check_pair64(dwEdge[i] * 3, dwEdge[j]);
+		}
+	}
+	for(i = 0; i < wNum; i++)
+	{
+		dwA = rand_operand64();
+		dwB = (i % 3) ? rand_operand64() : rand_operand();
+		wErr += check_pair64(dwA, dwB);
+		if(dwB && (dwA / dwB) < 0x100000000ull)
+			wErr += check_pair64(dwA / dwB * dwB + (dwB - 1), dwB);		//largest remainder
+	}
+	return wErr;
+}
+
+/* reciprocal divider against / and %, edge divisors and random pairs */
+static uint32_t check_recip(uint32_t wNum)
+{
+	static const uint32_t wEdge[] = {1, 2, 3, 5, 7, 10, 641, 1000, 0x10000, 0x10001, 0x7fffffff,
+									 0x80000000, 0x80000001, 0xfffffffe, 0xffffffff};
+	static const uint32_t wNumEdge[] = {0, 1, 9, 10, 11, 0x7fffffff, 0x80000000, 0xfffffffe, 0xffffffff};
+	const hwdiv_recip_t tRecip10 = HWDIV_RECIP_10;
+	hwdiv_recip_t tRecip;
+	uint32_t i, j, wA, wB, wErr = 0;
+
+	for(i = 0; i < sizeof(wEdge) / sizeof(wEdge[0]); i++)
+	{
+		csi_hwdiv_recip_init(&tRecip, wEdge[i]);
+		for(j = 0; j < sizeof(wNumEdge) / sizeof(wNumEdge[0]); j++)
+		{
+			wA = wNumEdge[j];
+			wErr += (csi_hwdiv_recip_div(&tRecip, wA) != wA / wEdge[i]);
+			wErr += (csi_hwdiv_recip_mod(&tRecip, wA) != wA % wEdge[i]);
+			wErr += (csi_hwdiv_recip_div(&tRecip, wEdge[i] * (wA & 0xff)) != ((wEdge[i] * (wA & 0xff)) / wEdge[i]));
+		}
+	}
+	for(i = 0; i < wNum; i++)
+	{
+		wB = rand_operand();
+		if(wB == 0)
+			wB = 3;
+		csi_hwdiv_recip_init(&tRecip, wB);
+		for(j = 0; j < 4; j++)
+		{
+			wA = (j & 1) ? rand_operand() : xorshift();
+			wErr += (csi_hwdiv_recip_div(&tRecip, wA) != wA / wB);
+			wErr += (csi_hwdiv_recip_mod(&tRecip, wA) != wA % wB);
+		}
+		wA = xorshift();
+		wErr += (csi_hwdiv_recip_div(&tRecip10, wA) != wA / 10);
+	}
+	return wErr;
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t wNum = 1000000, wErr, wNoMaskErr = 0;
+	int iFail = 0, iOpt;
+
+	while((iOpt = getopt(argc, argv, "n:r:")) != -1)
+	{
+		switch(iOpt)
+		{
+			case 'n': wNum = strtoul(optarg, NULL, 0); break;
+			case 'r': s_wRng = strtoul(optarg, NULL, 0) | 1; break;
+			default:
+				fprintf(stderr, "usage: %s [-n divisions] [-r seed]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	printf("HWDIV_MODE %s\n", HWDIV_MODE == HWDIV_MODE_SEQ_RETRY ? "SEQ_RETRY" : "IRQ_LOCK");
+	wErr = check_div32(wNum);
+	wErr += s_wIsrErr;
+	printf("div32      %8u divisions, %u isr, %u sequences redone: %u wrong\n", (unsigned int)wNum,
+		(unsigned int)s_wIsrNum, (unsigned int)(s_wCrWrite - wNum), (unsigned int)wErr);
+	if(wErr || s_wIsrNum == 0)
+		iFail = 1;
+
+#if HWDIV_MODE != HWDIV_MODE_SEQ_RETRY
+	s_byNoMask = 1;
+	s_wIsrErr = 0;
+	wNoMaskErr = check_div32(wNum / 10 + 1000) + s_wIsrErr;
+	s_byNoMask = 0;
+	printf("no masking %8u divisions: %u wrong(must not be 0)\n", (unsigned int)(wNum / 10 + 1000), (unsigned int)wNoMaskErr);
+	if(wNoMaskErr == 0)
+		iFail = 1;
+#endif
+	(void)wNoMaskErr;
+
+	s_wIsrErr = 0;
+	s_wIsrNum = 0;
+	wErr = check_div64(wNum / 2 + 1000);
+	wErr += s_wIsrErr;
+	printf("div64      %8u pairs, %u isr: %u wrong\n", (unsigned int)(wNum / 2 + 1000),
+		(unsigned int)s_wIsrNum, (unsigned int)wErr);
+	if(wErr)
+		iFail = 1;
+
+	wErr = check_recip(wNum / 4 + 1000);
+	printf("reciprocal %8u divisors: %u wrong\n", (unsigned int)(wNum / 4 + 1000), (unsigned int)wErr);
+	if(wErr)
+		iFail = 1;
+
+	printf("%s\n", iFail ? "FAIL" : "PASS");
+	return iFail;
+}
@@ -0,0 +1,381 @@
+/***********************************************************************//**
+ * \file  lat_host.c
+ * \brief  host(linux) driver of the latency harness core(components/chip/drivers/lat_bench.c)
+ *         on the masked sections of the drivers: hwdiv.c(HWDIV_MODE_IRQ_LOCK divider access)
+ *         and stimer.c(csi_stimer_idle_ticks wheel scan) are built on the host stubs of
+ *         demo/script/host, their csi_irq_save/__disable_excp_irq take one lock that stands
+ *         for the masked interrupts. A periodic thread stands for the tick interrupt: it
+ *         takes the lock(held off by a masked section), records its wakeup latency against
+ *         the programmed deadline, then runs csi_stimer_tick; one run per background load.
+ *         The path_div/path_recip loads run the driver hot paths with / and % and with the
+ *         reciprocal divider(csi_hwdiv_recip_xxx), to compare the hwdiv masked sections.
+ *         Sections are timed in thread cpu time, so preemption of the host is not counted;
+ *         the wakeup latency is wall clock and includes the host scheduler.
+ *         Same report format as latency_demo.c.
+ *
+ *         build(from the repo root):
+ *         gcc -O2 -DCONFIG_LAT_CRIT_HOOK -DLAT_HIST_BINS=24 -Idemo/script/host -Icomponents/csi/include \
+ *             demo/script/lat_host.c components/chip/drivers/lat_bench.c components/chip/drivers/hwdiv.c \
+ *             components/chip/drivers/stimer.c -lpthread -o lat_host
+ *         usage:
+ *         lat_host [-n samples] [-p period_us] [-t threads] [-l limit_ns] [-c crit_limit_ns]
+ *         limits default to LAT_HOST_LIMIT(LAT_HOST_LIMIT_OTHER without SCHED_FIFO) and
+ *         LAT_HOST_CRIT_LIMIT, a run over them exits with 1
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <soc.h>
+#include "csp_hwdiv.h"
+#include <drv/hwdiv.h>
+#include <drv/stimer.h>
+#include <drv/lat_bench.h>
+
+#define LAT_HOST_LIMIT			5000000			//ns, default wakeup limit, "interrupt" thread in SCHED_FIFO
+#define LAT_HOST_LIMIT_OTHER	50000000		//ns, default wakeup limit when SCHED_FIFO is not allowed
+#define LAT_HOST_CRIT_LIMIT		500000			//ns cpu time, default masked section limit; host interrupts
+												//charged to the thread add up to ~150us
+#define LAT_HOST_TIMERS			64				//stimer load: timers parked in the upper wheel levels
+
+typedef enum {
+	LAT_LOAD_IDLE = 0,
+	LAT_LOAD_PRINTF,
+	LAT_LOAD_CRC,
+	LAT_LOAD_DIV,
+	LAT_LOAD_STIMER,
+	LAT_LOAD_PATH_DIV,
+	LAT_LOAD_PATH_RECIP,
+	LAT_LOAD_NUM
+} lat_load_e;
+
+static const char * const s_pLoadName[LAT_LOAD_NUM] = {
+	"idle", "printf", "crc", "div", "stimer", "path_div", "path_recip"
+};
+
+//runtime functions of hwdiv.c, normally called by the compiler for / and %
+unsigned int __udivsi3(unsigned int wDividend, unsigned int wDivisor);
+unsigned int __umodsi3(unsigned int wDividend, unsigned int wDivisor);
+
+struct host_hwdiv {
+	uint32_t	wReg[5];				//HOST_HWDIV_xxx
+};
+struct host_hwdiv g_tHostHwdiv;
+
+static lat_hist_t s_tHist;
+static pthread_mutex_t s_tIrqLock;					//recursive, stands for the masked interrupts
+static csi_stimer_t s_tTimer[LAT_HOST_TIMERS];
+static hwdiv_recip_t s_tCoretKhz;					//path load: coret clocks per ms, as in tick.c
+static volatile uint32_t s_wTimerFired;
+static volatile int s_iLoadRun;
+static FILE *s_ptNull;
+
+static uint64_t lat_host_ns(clockid_t tClk)
+{
+	struct timespec tNow;
+
+	clock_gettime(tClk, &tNow);
+	return (uint64_t)tNow.tv_sec * 1000000000ull + (uint64_t)tNow.tv_nsec;
+}
+
+//sections are entered and left by the same thread
+uint32_t lat_port_cycles(void)
+{
+	return (uint32_t)lat_host_ns(CLOCK_THREAD_CPUTIME_ID);
+}
+
+uint32_t host_irq_save(void)
+{
+	pthread_mutex_lock(&s_tIrqLock);
+	return 0;
+}
+
+void host_irq_restore(uint32_t wState)
+{
+	(void)wState;
+	pthread_mutex_unlock(&s_tIrqLock);
+}
+
+uint32_t lat_port_irq_save(void)
+{
+	return host_irq_save();
+}
+
+void lat_port_irq_restore(uint32_t wState)
+{
+	host_irq_restore(wState);
+}
+
+//PSR model for apt_hwdiv_calc: __disable_excp_irq takes the lock, __set_PSR of the saved PSR gives it back
+uint32_t host_get_psr(void)
+{
+	return 0;
+}
+
+void host_disable_irq(void)
+{
+	pthread_mutex_lock(&s_tIrqLock);
+}
+
+void host_set_psr(uint32_t wPsr)
+{
+	(void)wPsr;
+	pthread_mutex_unlock(&s_tIrqLock);
+}
+
+//divider registers, result on the divisor write
+void host_hwdiv_write(csp_hwdiv_t *ptHwdivBase, uint8_t byReg, uint32_t wVal)
+{
+	uint32_t *pwReg = ptHwdivBase->wReg;
+
+	pwReg[byReg] = wVal;
+	if(byReg != HOST_HWDIV_DIVISOR)
+		return;
+	if(wVal == 0)
+	{
+		pwReg[HOST_HWDIV_QUOTIENT] = 0xffffffff;
+		pwReg[HOST_HWDIV_REMAIN] = pwReg[HOST_HWDIV_DIVIDEND];
+	}
+	else if(pwReg[HOST_HWDIV_CR] & 1)
+	{
+		pwReg[HOST_HWDIV_QUOTIENT] = pwReg[HOST_HWDIV_DIVIDEND] / wVal;
+		pwReg[HOST_HWDIV_REMAIN] = pwReg[HOST_HWDIV_DIVIDEND] % wVal;
+	}
+	else
+	{
+		pwReg[HOST_HWDIV_QUOTIENT] = (uint32_t)((int64_t)(int32_t)pwReg[HOST_HWDIV_DIVIDEND] / (int32_t)wVal);
+		pwReg[HOST_HWDIV_REMAIN] = (uint32_t)((int64_t)(int32_t)pwReg[HOST_HWDIV_DIVIDEND] % (int32_t)wVal);
+	}
+}
+
+uint32_t host_hwdiv_read(csp_hwdiv_t *ptHwdivBase, uint8_t byReg)
+{
+	return ptHwdivBase->wReg[byReg];
+}
+
+static void lat_host_putc(char c)
+{
+	putchar(c);
+}
+
+static uint16_t lat_host_crc16(const uint8_t *pbyData, uint32_t wSize)
+{
+	uint16_t hwCrc = 0;
+	uint8_t i;
+
+	while(wSize--)
+	{
+		hwCrc ^= (uint16_t)(*pbyData++) << 8;
+		for(i = 0; i < 8; i++)
+			hwCrc = (hwCrc & 0x8000) ? (uint16_t)((hwCrc << 1) ^ 0x1021) : (uint16_t)(hwCrc << 1);
+	}
+	return hwCrc;
+}
+
+static void lat_host_timer_cb(csi_stimer_t *ptTimer, void *pArg)
+{
+	(void)ptTimer;
+	(void)pArg;
+	s_wTimerFired++;
+}
+
+/** \brief timers due 16 ~ 2^18 ticks ahead, several per upper level slot, so
+ *         csi_stimer_idle_ticks finds level 0 empty and walks the slot lists
+ */
+static void lat_host_timer_start(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < LAT_HOST_TIMERS; i++)
+	{
+		csi_stimer_init(&s_tTimer[i], lat_host_timer_cb, NULL, STIMER_CTX_TICK);
+		csi_stimer_start(&s_tTimer[i], 16u << (i % 15), 16u << (i % 15));
+	}
+}
+
+/** \brief the per-byte/per-tick paths taken off the divider: decimal conversion(_ntoa_long,
+ *         myitoa), ring index wrap(ringbuf.c) and coret clocks to ms(csi_tick_get_ms);
+ *         iRecip 0: / and % through the hwdiv.c runtime as the CK802 compiler emits them,
+ *         22 masked divider accesses for a 10 digit value; 1: reciprocal and compare, none
+ */
+static uint32_t lat_host_paths(uint32_t wVal, int iRecip)
+{
+	static const hwdiv_recip_t s_tRecip10 = HWDIV_RECIP_10;
+	uint32_t wQ, wSum = 0, wIdx = (wVal & 0x3f) + 40;
+
+	do {
+		if(iRecip)
+		{
+			wQ = csi_hwdiv_recip_div(&s_tRecip10, wVal);
+			wSum += wVal - wQ * 10;
+		}
+		else
+		{
+			wSum += __umodsi3(wVal, 10);
+			wQ = __udivsi3(wVal, 10);
+		}
+		wVal = wQ;
+	} while(wVal);
+
+	if(iRecip)
+		wSum += ((wIdx >= 100) ? (wIdx - 100) : wIdx) + csi_hwdiv_recip_div(&s_tCoretKhz, wSum << 10);
+	else
+		wSum += __umodsi3(wIdx, 100) + __udivsi3(wSum << 10, s_tCoretKhz.wDivisor);
+	return wSum;
+}
+
+/** \brief background load thread, one load step per loop
+ */
+static void *lat_host_load(void *pArg)
+{
+	lat_load_e eLoad = (lat_load_e)(intptr_t)pArg;
+	volatile uint32_t wDiv;
+	uint8_t byBuf[256];
+	uint32_t i, wLoop = 0;
+
+	for(i = 0; i < sizeof(byBuf); i++)
+		byBuf[i] = (uint8_t)i;
+
+	while(s_iLoadRun)
+	{
+		switch(eLoad)
+		{
+			case LAT_LOAD_PRINTF:
+				fprintf(s_ptNull, "latency load %u\n", wLoop);
+				break;
+			case LAT_LOAD_CRC:
+				byBuf[0] = (uint8_t)lat_host_crc16(byBuf, sizeof(byBuf));
+				break;
+			case LAT_LOAD_DIV:						//one masked divider access each
+				wDiv = 0x7fffffff;
+				for(i = 1; i < 32; i++)
+					wDiv = __udivsi3(wDiv, i) + __umodsi3(wDiv, i);
+				break;
+			case LAT_LOAD_STIMER:
+				csi_stimer_idle_ticks();
+				break;
+			case LAT_LOAD_PATH_DIV:
+			case LAT_LOAD_PATH_RECIP:
+				wDiv = lat_host_paths(0xf0000000u | wLoop, eLoad == LAT_LOAD_PATH_RECIP);
+				break;
+			case LAT_LOAD_IDLE:
+			default:
+				usleep(1000);
+				break;
+		}
+		wLoop++;
+	}
+	return NULL;
+}
+
+/** \brief the tick "interrupt": sleep to absolute deadlines, wait for the masked sections,
+ *         record how late each entry is, then advance the timer wheel
+ */
+static void lat_host_sample(uint32_t wSamples, uint32_t wPeriodUs)
+{
+	struct timespec tDue;
+	uint64_t dwDue, dwNow;
+
+	dwDue = lat_host_ns(CLOCK_MONOTONIC);
+	while(s_tHist.wCount < wSamples)
+	{
+		dwDue += (uint64_t)wPeriodUs * 1000u;
+		tDue.tv_sec = (time_t)(dwDue / 1000000000ull);
+		tDue.tv_nsec = (long)(dwDue % 1000000000ull);
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &tDue, NULL);
+
+		host_irq_save();
+		dwNow = lat_host_ns(CLOCK_MONOTONIC);
+		host_irq_restore(0);
+		lat_hist_add(&s_tHist, (dwNow > dwDue) ? (uint32_t)(dwNow - dwDue) : 0);
+		csi_stimer_tick();
+		if(dwNow > dwDue + (uint64_t)wPeriodUs * 1000u)	//overrun, skip missed periods
+			dwDue = dwNow;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t wSamples = 2000, wPeriodUs = 100, wThreads = 4, wLimit = LAT_HOST_LIMIT, wCritLimit = LAT_HOST_CRIT_LIMIT;
+	pthread_mutexattr_t tAttr;
+	pthread_attr_t tLoadAttr;
+	struct sched_param tParam;
+	pthread_t tThread[64];
+	uint32_t i, j;
+	int iOpt, iRet = 0, iLimitSet = 0;
+
+	while((iOpt = getopt(argc, argv, "n:p:t:l:c:")) != -1)
+	{
+		switch(iOpt)
+		{
+			case 'n': wSamples = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'p': wPeriodUs = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 't': wThreads = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'l': wLimit = (uint32_t)strtoul(optarg, NULL, 0); iLimitSet = 1; break;
+			case 'c': wCritLimit = (uint32_t)strtoul(optarg, NULL, 0); break;
+			default:
+				fprintf(stderr, "usage: %s [-n samples] [-p period_us] [-t threads] [-l limit_ns] [-c crit_limit_ns]\n", argv[0]);
+				return 2;
+		}
+	}
+	if(wThreads == 0 || wThreads > sizeof(tThread) / sizeof(tThread[0]) || wPeriodUs == 0)
+	{
+		fprintf(stderr, "bad threads/period\n");
+		return 2;
+	}
+
+	s_ptNull = fopen("/dev/null", "w");
+	if(s_ptNull == NULL)
+		return 2;
+
+	//the "interrupt" preempts the loads if the host allows SCHED_FIFO, loads stay SCHED_OTHER
+	pthread_attr_init(&tLoadAttr);
+	pthread_attr_setinheritsched(&tLoadAttr, PTHREAD_EXPLICIT_SCHED);
+	pthread_attr_setschedpolicy(&tLoadAttr, SCHED_OTHER);
+	tParam.sched_priority = 0;
+	pthread_attr_setschedparam(&tLoadAttr, &tParam);
+	tParam.sched_priority = sched_get_priority_max(SCHED_FIFO);
+	if(pthread_setschedparam(pthread_self(), SCHED_FIFO, &tParam) != 0 && !iLimitSet)
+		wLimit = LAT_HOST_LIMIT_OTHER;
+	pthread_mutexattr_init(&tAttr);
+	pthread_mutexattr_settype(&tAttr, PTHREAD_MUTEX_RECURSIVE);		//lat_crit_enter masks inside a masked section
+	pthread_mutexattr_setprotocol(&tAttr, PTHREAD_PRIO_INHERIT);	//a masked section runs to its end before the "interrupt"
+	pthread_mutex_init(&s_tIrqLock, &tAttr);
+	lat_host_timer_start();
+	csi_hwdiv_recip_init(&s_tCoretKhz, 48000);
+
+	lat_report_init(lat_host_putc, "ns");
+	for(i = 0; i < LAT_LOAD_NUM; i++)
+	{
+		lat_hist_reset(&s_tHist);
+		lat_crit_reset();
+
+		s_iLoadRun = 1;
+		for(j = 0; j < wThreads; j++)
+			pthread_create(&tThread[j], &tLoadAttr, lat_host_load, (void *)(intptr_t)i);
+
+		lat_host_sample(wSamples, wPeriodUs);
+
+		s_iLoadRun = 0;
+		for(j = 0; j < wThreads; j++)
+			pthread_join(tThread[j], NULL);
+
+		if(lat_report(s_pLoadName[i], &s_tHist, wLimit) < 0)
+			iRet = 1;
+		if(lat_crit_report(wCritLimit) < 0)
+			iRet = 1;
+	}
+
+	fclose(s_ptNull);
+	return iRet;
+}
@@ -0,0 +1,232 @@
+/***********************************************************************//**
+ * \file  mem_host.c
+ * \brief  host(linux) check of the headroom telemetry core(components/chip/drivers/mem_report.c)
+ *         against a simulated memory map: a RAM array laid out as heap + painted stack,
+ *         stack use written from the top, heap low-water mark from a stub; then a real
+ *         recursion on a painted ucontext stack, then prints the reports.
+ *
+ *         build(from the repo root):
+ *         gcc -O2 -Icomponents/csi/include demo/script/mem_host.c \
+ *             components/chip/drivers/mem_report.c -o mem_host
+ *         usage:
+ *         mem_host [-d recursion_depth]
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <ucontext.h>
+#include <drv/mem_report.h>
+
+#define SIM_RAM_WORDS		2048		//8KB, as APT32F110x
+#define SIM_HEAP_WORDS		512
+#define SIM_STACK_WORDS		(SIM_RAM_WORDS - SIM_HEAP_WORDS - 2)	//8 bytes above __kernel_stack
+
+#define CTX_STACK_BYTES		(64 * 1024)
+
+static uint32_t s_wRam[SIM_RAM_WORDS];
+static int s_iHeapMinFree = -1;
+static int s_iFail = 0;
+
+static uint8_t s_byAlarmWhat = 0;
+static uint32_t s_wAlarmLeft = 0;
+static uint32_t s_wAlarmCalls = 0;
+
+static int sim_heap_minfree(void)
+{
+	return s_iHeapMinFree;
+}
+
+static void sim_alarm(uint8_t byWhat, uint32_t wLeft)
+{
+	s_byAlarmWhat |= byWhat;
+	s_wAlarmLeft = wLeft;
+	s_wAlarmCalls++;
+}
+
+static void expect(const char *pName, uint32_t wGot, uint32_t wWant)
+{
+	if(wGot != wWant)
+	{
+		printf("FAIL %s: %u, expected %u\n", pName, (unsigned int)wGot, (unsigned int)wWant);
+		s_iFail = 1;
+	}
+}
+
+static void print_report(const char *pName, const csi_mem_report_t *ptRep)
+{
+	printf("%-10s stack %5u peak %5u gap %5u  heap %5u min free ", pName,
+		(unsigned int)ptRep->wStackSize, (unsigned int)ptRep->wStackPeak,
+		(unsigned int)ptRep->wGap, (unsigned int)ptRep->wHeapSize);
+	if(ptRep->wHeapMinFree == MEM_UNKNOWN)
+		printf("-\n");
+	else
+		printf("%u\n", (unsigned int)ptRep->wHeapMinFree);
+}
+
+//stack use of wBytes below the top, as pushes and locals would leave it
+static void sim_stack_use(uint32_t *pwTop, uint32_t wBytes)
+{
+	uint32_t *pwWord = pwTop - wBytes / 4;
+
+	for(; pwWord < pwTop; pwWord++)
+		*pwWord = (uint32_t)(uintptr_t)pwWord;
+}
+
+static void sim_map(void)
+{
+	csi_mem_map_t tMap = {
+		.pwHeapStart	= &s_wRam[0],
+		.pwHeapEnd		= &s_wRam[SIM_HEAP_WORDS],
+		.pwStackLimit	= &s_wRam[SIM_HEAP_WORDS],
+		.pwStackTop		= &s_wRam[SIM_HEAP_WORDS + SIM_STACK_WORDS],
+		.pfnHeapMinFree	= sim_heap_minfree,
+	};
+	static csi_mem_map_t s_tMap;
+	csi_mem_report_t tRep;
+	uint32_t wStack = SIM_STACK_WORDS * 4;
+	uint8_t byRet;
+
+	s_tMap = tMap;
+	memset(s_wRam, 0, sizeof(s_wRam));
+	csi_mem_paint(s_tMap.pwStackLimit, s_tMap.pwStackTop);			//startup.S
+	csi_mem_map_init(&s_tMap);										//__main
+	csi_mem_watch_init(512, 256, sim_alarm);
+
+	//fresh: nothing used, heap not tracked yet
+	csi_mem_report(&tRep);
+	print_report("fresh", &tRep);
+	expect("fresh peak", tRep.wStackPeak, 0);
+	expect("fresh gap", tRep.wGap, wStack);
+	expect("heap size", tRep.wHeapSize, SIM_HEAP_WORDS * 4);
+	expect("fresh min free", tRep.wHeapMinFree, MEM_UNKNOWN);
+	expect("fresh alarm", csi_mem_watch_tick(), 0);
+
+	//main + some isr nesting, a word equal to the pattern inside the used part
+	s_iHeapMinFree = 1200;
+	sim_stack_use(s_tMap.pwStackTop, 1000);
+	s_tMap.pwStackTop[-100] = MEM_PAINT_WORD;
+	csi_mem_report(&tRep);
+	print_report("run", &tRep);
+	expect("run peak", tRep.wStackPeak, 1000);
+	expect("run gap", tRep.wGap, wStack - 1000);
+	expect("run min free", tRep.wHeapMinFree, 1200);
+	expect("run alarm", csi_mem_watch_tick(), 0);
+
+	//heap below its margin
+	s_iHeapMinFree = 200;
+	byRet = csi_mem_watch_tick();
+	expect("heap alarm", byRet, MEM_ALARM_HEAP);
+	expect("heap alarm left", s_wAlarmLeft, 200);
+
+	//stack down to the alarm line(limit + 512), crossing it with one word skipped
+	sim_stack_use(s_tMap.pwStackTop, wStack - 512 - 4 * MEM_WATCH_PROBE);
+	expect("above line", csi_mem_watch_tick(), MEM_ALARM_HEAP);
+	sim_stack_use(s_tMap.pwStackTop, wStack - 512 + 16);
+	s_tMap.pwStackLimit[512 / 4] = MEM_PAINT_WORD;
+	byRet = csi_mem_watch_tick();
+	csi_mem_report(&tRep);
+	print_report("near", &tRep);
+	expect("stack alarm", byRet, MEM_ALARM_HEAP | MEM_ALARM_STACK);
+	expect("stack alarm left", s_wAlarmLeft, 512);
+	expect("near gap", tRep.wGap, 512 - 16);
+
+	//into the heap region: lowest word gone
+	s_tMap.pwStackLimit[0] = 0;
+	byRet = csi_mem_watch_tick();
+	csi_mem_report(&tRep);
+	print_report("collided", &tRep);
+	expect("crash alarm", byRet, MEM_ALARM_HEAP | MEM_ALARM_STACK | MEM_ALARM_CRASH);
+	expect("collided gap", tRep.wGap, 0);
+	expect("alarm calls", s_wAlarmCalls, 3);						//each source once
+	expect("alarm sources", s_byAlarmWhat, MEM_ALARM_HEAP | MEM_ALARM_STACK | MEM_ALARM_CRASH);
+	csi_mem_watch_tick();
+	expect("alarm latched", s_wAlarmCalls, 3);
+}
+
+/* real stack use: recursion on a painted ucontext stack */
+static ucontext_t s_tMainCtx, s_tRunCtx;
+static uint32_t *s_pwCtxStack;
+static int s_iDepth = 64;
+
+static uint32_t recurse(int iDepth, volatile uint8_t *pbyPrev)
+{
+	volatile uint8_t byLocal[64];
+
+	byLocal[0] = (uint8_t)iDepth;
+	byLocal[63] = pbyPrev ? pbyPrev[0] : 0;
+	if(iDepth == 0)
+		return byLocal[0] + byLocal[63];
+	return recurse(iDepth - 1, byLocal) + byLocal[63];
+}
+
+static void ctx_run(void)
+{
+	recurse(s_iDepth, NULL);
+}
+
+static void ctx_map(void)
+{
+	static csi_mem_map_t s_tMap;
+	csi_mem_report_t tRep[2];
+	uint32_t wMin = 64 * (uint32_t)s_iDepth;			//each level holds at least its 64 byte array
+	int i;
+
+	s_pwCtxStack = malloc(CTX_STACK_BYTES);
+	s_tMap.pwStackLimit = s_pwCtxStack;
+	s_tMap.pwStackTop = s_pwCtxStack + CTX_STACK_BYTES / 4;
+	s_tMap.pwHeapStart = s_tMap.pwHeapEnd = s_pwCtxStack;
+	csi_mem_map_init(&s_tMap);
+
+	for(i = 0; i < 2; i++)
+	{
+		csi_mem_paint(s_tMap.pwStackLimit, s_tMap.pwStackTop);
+		getcontext(&s_tRunCtx);
+		s_tRunCtx.uc_stack.ss_sp = s_pwCtxStack;
+		s_tRunCtx.uc_stack.ss_size = CTX_STACK_BYTES;
+		s_tRunCtx.uc_link = &s_tMainCtx;
+		makecontext(&s_tRunCtx, ctx_run, 0);
+		swapcontext(&s_tMainCtx, &s_tRunCtx);
+		csi_mem_report(&tRep[i]);
+		print_report(i ? "recurse x2" : "recurse", &tRep[i]);
+		s_iDepth *= 2;
+	}
+
+	if(tRep[0].wStackPeak < wMin || tRep[1].wStackPeak < tRep[0].wStackPeak + wMin)
+	{
+		printf("FAIL recursion peak %u / %u\n", (unsigned int)tRep[0].wStackPeak,
+			(unsigned int)tRep[1].wStackPeak);
+		s_iFail = 1;
+	}
+	free(s_pwCtxStack);
+}
+
+int main(int argc, char **argv)
+{
+	int iOpt;
+
+	while((iOpt = getopt(argc, argv, "d:")) != -1)
+	{
+		if(iOpt == 'd')
+			s_iDepth = atoi(optarg);
+		else
+		{
+			fprintf(stderr, "usage: %s [-d recursion_depth]\n", argv[0]);
+			return 2;
+		}
+	}
+	if(s_iDepth < 1 || s_iDepth > 100)
+		s_iDepth = 64;
+
+	sim_map();
+	ctx_map();
+
+	printf("%s\n", s_iFail ? "FAIL" : "PASS");
+	return s_iFail;
+}
@@ -0,0 +1,303 @@
+/***********************************************************************//**
+ * \file  mm_arena_host.c
+ * \brief  host(linux) check of the scoped arena allocator(components/mm/src/mm_arena.c):
+ *         argument errors, bump placement and alignment, exact fill, nested mark/rewind
+ *         and reset, peak, overflow into the heap and its release by rewind/reset/release,
+ *         overflow disabled and heap exhausted; then a random alloc/mark/rewind/reset replay
+ *         against a model of the bump pointer, the mark stack and every block's content.
+ *         Overflow blocks are checked through mallinfo: each rewind must bring the heap
+ *         back to its use at the mark, and the heap is walked(mm_host_common.h) after each op.
+ *
+ *         build(from the repo root), add -DCONFIG_MM_TLSF for the TLSF backend:
+ *         gcc -O2 -DCONFIG_MM_MAX_USED=0 -Icomponents/mm/include demo/script/mm_arena_host.c \
+ *             components/mm/src/mm_arena.c components/mm/src/mm_initialize.c \
+ *             components/mm/src/mm_malloc.c components/mm/src/mm_free.c \
+ *             components/mm/src/mm_addfreechunk.c components/mm/src/mm_size2ndx.c \
+ *             components/mm/src/mm_mallinfo.c components/mm/src/mm_tlsf.c -o mm_arena_host
+ *         usage:
+ *         mm_arena_host [-n ops] [-r seed]
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <errno.h>
+#include "mm_host_common.h"
+#include "mm_arena.h"
+
+#define AR_HEAP_BYTES		6144
+#define AR_REGION_BYTES		512
+#define AR_BLKS				256					//live blocks of the random replay
+#define AR_MARKS			8					//mark nesting of the random replay
+#define AR_SIZE_MAX			96
+
+typedef struct {
+	struct mm_arena_mark_s	tMark;
+	uint32_t				wCur;				//model bump offset at the mark
+	uint32_t				wBlks;				//live blocks at the mark
+	int						iHeapUsed;			//heap use at the mark, ar_heap_used
+} ar_mark_t;
+
+static struct mm_heap_s s_tHeap;
+static uint64_t s_dwHeapMem[AR_HEAP_BYTES / 8];
+static uint64_t s_dwRegion[AR_REGION_BYTES / 8];
+static mm_host_block_t s_tBlk[AR_BLKS];
+static int s_iHeapEmpty;						//mallinfo uordblks of a fresh heap(guard chunks)
+
+static int ar_heap_used(void)
+{
+	struct mallinfo tInfo;
+
+	mm_mallinfo(&s_tHeap, &tInfo);
+	return tInfo.uordblks - s_iHeapEmpty;
+}
+
+static void ar_heap_init(void)
+{
+	s_iHeapEmpty = 0;
+	mm_initialize(&s_tHeap, s_dwHeapMem, sizeof(s_dwHeapMem));
+	s_iHeapEmpty = ar_heap_used();
+}
+
+static int ar_in_region(const struct mm_arena_s *ptArena, const void *pMem, uint32_t wSize)
+{
+	return (const uint8_t *)pMem >= ptArena->base && (const uint8_t *)pMem + wSize <= ptArena->end;
+}
+
+/** \brief argument errors
+ */
+static void ar_args(void)
+{
+	struct mm_arena_s tArena;
+
+	ar_heap_init();
+	MM_HOST_CHECK(mm_arena_init(NULL, s_dwRegion, sizeof(s_dwRegion), NULL) == -EINVAL, "init NULL arena");
+	MM_HOST_CHECK(mm_arena_init(&tArena, NULL, 16, NULL) == -EINVAL, "init NULL buffer");
+	MM_HOST_CHECK(mm_arena_create(&tArena, NULL, 64, false) == -EINVAL, "create NULL heap");
+	MM_HOST_CHECK(mm_arena_create(&tArena, &s_tHeap, 0, false) == -EINVAL, "create size 0");
+	MM_HOST_CHECK(mm_arena_create(&tArena, &s_tHeap, AR_HEAP_BYTES, false) == -ENOMEM, "create beyond the heap");
+	MM_HOST_CHECK(ar_heap_used() == 0, "failed create left heap use");
+}
+
+/** \brief static region, no overflow: placement, alignment, exact fill, nested marks, peak
+ */
+static void ar_region(void)
+{
+	static const size_t s_wAlign[] = {0, 1, 2, 4, 8, 16, 64};
+	struct mm_arena_s tArena;
+	struct mm_arena_mark_s tMark0, tMark1;
+	uint8_t *pbyA, *pbyB, *pbyC;
+	size_t i, wAlign;
+	uintptr_t wExp;
+
+	MM_HOST_CHECK(mm_arena_init(&tArena, s_dwRegion, sizeof(s_dwRegion), NULL) == OK, "init");
+	MM_HOST_CHECK(tArena.flags == 0, "overflow set without a heap");
+
+	//each request at cur rounded up to its alignment(0: CONFIG_MM_ARENA_ALIGN)
+	for(i = 0; i < sizeof(s_wAlign) / sizeof(s_wAlign[0]); i++)
+	{
+		wAlign = s_wAlign[i] ? s_wAlign[i] : CONFIG_MM_ARENA_ALIGN;
+		wExp = ((uintptr_t)tArena.cur + wAlign - 1) & ~(uintptr_t)(wAlign - 1);
+		pbyA = mm_arena_alloc(&tArena, 3, s_wAlign[i]);
+		MM_HOST_CHECK((uintptr_t)pbyA == wExp, "placement, align %u", (unsigned int)wAlign);
+		MM_HOST_CHECK(tArena.cur == pbyA + 3, "bump, align %u", (unsigned int)wAlign);
+	}
+
+	//fill to the last byte, then nothing fits and nothing overflows
+	mm_arena_reset(&tArena);
+	MM_HOST_CHECK(mm_arena_used(&tArena) == 0 && tArena.cur == tArena.base, "reset");
+	pbyA = mm_arena_alloc(&tArena, sizeof(s_dwRegion) - 8, 1);
+	pbyB = mm_arena_alloc(&tArena, 8, 1);
+	MM_HOST_CHECK(pbyA == tArena.base && pbyB == tArena.base + sizeof(s_dwRegion) - 8, "exact fill");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 1, 1) == NULL, "alloc past the end");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 0, 1) == tArena.end, "size 0 at the end");
+	MM_HOST_CHECK(mm_arena_peak(&tArena) == sizeof(s_dwRegion), "peak at full");
+
+	//nested marks rewind like a stack, space is reused from the mark
+	mm_arena_reset(&tArena);
+	pbyA = mm_arena_alloc(&tArena, 40, 0);
+	tMark0 = mm_arena_mark(&tArena);
+	pbyB = mm_arena_alloc(&tArena, 100, 0);
+	tMark1 = mm_arena_mark(&tArena);
+	pbyC = mm_arena_alloc(&tArena, 60, 0);
+	MM_HOST_CHECK(pbyA && pbyB && pbyC, "allocs after reset");
+	mm_arena_rewind(&tArena, tMark1);
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 60, 0) == pbyC, "space after mark1 not reused");
+	mm_arena_rewind(&tArena, tMark0);
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 100, 0) == pbyB, "space after mark0 not reused");
+	MM_HOST_CHECK(mm_arena_used(&tArena) == (size_t)(pbyB + 100 - tArena.base), "used after rewind");
+	MM_HOST_CHECK(mm_arena_peak(&tArena) == sizeof(s_dwRegion), "peak kept across reset");
+	mm_arena_release(&tArena);
+	MM_HOST_CHECK(tArena.base == NULL && tArena.cur == NULL, "release");
+}
+
+/** \brief region carved from the heap: overflow blocks, rewind/reset free them,
+ *         release gives everything back; overflow disabled and heap exhausted
+ */
+static void ar_overflow(void)
+{
+	struct mm_arena_s tArena;
+	struct mm_arena_mark_s tMark;
+	uint8_t *pbyA, *pbyB, *pbyC;
+	int iUsed0, iUsed1;
+
+	ar_heap_init();
+	MM_HOST_CHECK(mm_arena_create(&tArena, &s_tHeap, 128, true) == OK, "create");
+	MM_HOST_CHECK(tArena.flags == (MM_ARENA_OWNED | MM_ARENA_OVERFLOW), "create flags");
+	iUsed0 = ar_heap_used();
+
+	pbyA = mm_arena_alloc(&tArena, 100, 0);
+	MM_HOST_CHECK(ar_in_region(&tArena, pbyA, 100), "first alloc not in the region");
+	tMark = mm_arena_mark(&tArena);
+	pbyB = mm_arena_alloc(&tArena, 100, 64);					//does not fit: overflow
+	MM_HOST_CHECK(pbyB && !ar_in_region(&tArena, pbyB, 1) && ((uintptr_t)pbyB & 63) == 0, "overflow block");
+	memset(pbyB, 0xa5, 100);
+	iUsed1 = ar_heap_used();
+	MM_HOST_CHECK(iUsed1 > iUsed0, "overflow not on the heap");
+	pbyC = mm_arena_alloc(&tArena, 20, 0);						//still fits the region
+	MM_HOST_CHECK(ar_in_region(&tArena, pbyC, 20), "small alloc after overflow");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 200, 0) != NULL, "second overflow");
+	MM_HOST_CHECK(ar_heap_used() > iUsed1, "second overflow not on the heap");
+
+	mm_arena_rewind(&tArena, tMark);
+	MM_HOST_CHECK(ar_heap_used() == iUsed0, "rewind left overflow blocks");
+	MM_HOST_CHECK(tArena.cur == pbyA + 100, "rewind position");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 200, 0) != NULL, "overflow after rewind");
+	mm_arena_reset(&tArena);
+	MM_HOST_CHECK(ar_heap_used() == iUsed0 && mm_arena_used(&tArena) == 0, "reset left overflow blocks");
+
+	//heap exhausted: NULL, arena still usable
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, AR_HEAP_BYTES, 0) == NULL, "overflow beyond the heap");
+	MM_HOST_CHECK(ar_heap_used() == iUsed0, "failed overflow changed the heap");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, SIZE_MAX - 8, 64) == NULL, "overflow size wraps");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 16, (SIZE_MAX >> 1) + 1) == NULL, "overflow alignment wraps");
+	MM_HOST_CHECK(ar_heap_used() == iUsed0, "wrapped overflow changed the heap");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 16, 0) == tArena.base, "region after failed overflow");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 0, 0) != NULL, "size 0 in the region");
+
+	mm_arena_alloc(&tArena, 300, 0);
+	mm_arena_release(&tArena);
+	MM_HOST_CHECK(ar_heap_used() == 0, "release left heap use %d", ar_heap_used());
+
+	//overflow disabled
+	MM_HOST_CHECK(mm_arena_create(&tArena, &s_tHeap, 64, false) == OK, "create, no overflow");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 64, 1) != NULL, "fill, no overflow");
+	MM_HOST_CHECK(mm_arena_alloc(&tArena, 1, 1) == NULL, "overflow while disabled");
+	mm_arena_release(&tArena);
+	MM_HOST_CHECK(ar_heap_used() == 0, "release, no overflow");
+}
+
+/** \brief random alloc/mark/rewind/reset: placement against the model bump offset, content
+ *         of all live blocks, heap use back to its value at each rewound mark
+ */
+static void ar_random(uint32_t wOps, uint32_t wRng)
+{
+	struct mm_arena_s tArena;
+	ar_mark_t tMark[AR_MARKS];
+	uint32_t wCur = 0, wPeak = 0, wBlks = 0, i, j, wSize, wAlign;
+	uint32_t wOvf = 0, wRewind = 0;
+	uint8_t byMarks = 0, *pbyMem;
+	uintptr_t wExp;
+
+	ar_heap_init();
+	MM_HOST_CHECK(mm_arena_create(&tArena, &s_tHeap, AR_REGION_BYTES, true) == OK, "create");
+
+	for(i = 0; i < wOps && !s_iFail; i++)
+	{
+		switch(mm_host_rand(&wRng) % 8)
+		{
+			case 0:													//mark
+				if(byMarks == AR_MARKS)
+					break;
+				tMark[byMarks].tMark = mm_arena_mark(&tArena);
+				tMark[byMarks].wCur = wCur;
+				tMark[byMarks].wBlks = wBlks;
+				tMark[byMarks].iHeapUsed = ar_heap_used();
+				byMarks++;
+				break;
+			case 1:													//rewind the newest mark
+				if(byMarks == 0)
+					break;
+				byMarks--;
+				mm_arena_rewind(&tArena, tMark[byMarks].tMark);
+				wCur = tMark[byMarks].wCur;
+				wBlks = tMark[byMarks].wBlks;
+				MM_HOST_CHECK(ar_heap_used() == tMark[byMarks].iHeapUsed, "heap use after rewind");
+				wRewind++;
+				break;
+			case 2:
+				if(mm_host_rand(&wRng) % 16)
+					break;
+				mm_arena_reset(&tArena);							//now and then drop everything
+				wCur = wBlks = byMarks = 0;
+				break;
+			default:												//alloc
+				if(wBlks == AR_BLKS)
+					break;
+				wSize = mm_host_rand(&wRng) % AR_SIZE_MAX;
+				wAlign = (mm_host_rand(&wRng) & 1) ? 0 : 1u << (mm_host_rand(&wRng) % 7);
+				wExp = ((uintptr_t)tArena.base + wCur + (wAlign ? wAlign : CONFIG_MM_ARENA_ALIGN) - 1) &
+					~(uintptr_t)((wAlign ? wAlign : CONFIG_MM_ARENA_ALIGN) - 1);
+				pbyMem = mm_arena_alloc(&tArena, wSize, wAlign);
+				if(wExp + wSize <= (uintptr_t)tArena.end)
+				{
+					MM_HOST_CHECK((uintptr_t)pbyMem == wExp, "region placement");
+					wCur = (uint32_t)(wExp + wSize - (uintptr_t)tArena.base);
+					if(wCur > wPeak)
+						wPeak = wCur;
+				}
+				else if(pbyMem)
+				{
+					MM_HOST_CHECK(!ar_in_region(&tArena, pbyMem, 1), "overflow block in the region");
+					MM_HOST_CHECK(((uintptr_t)pbyMem & ((wAlign ? wAlign : CONFIG_MM_ARENA_ALIGN) - 1)) == 0,
+						"overflow alignment");
+					wOvf++;
+				}
+				else
+				{
+					MM_HOST_CHECK(wSize == 0 || ar_heap_used() > AR_HEAP_BYTES / 2, "overflow failed, heap not full");
+					break;
+				}
+				s_tBlk[wBlks].pbyMem = pbyMem;
+				s_tBlk[wBlks].wSize = wSize;
+				s_tBlk[wBlks].bySeed = (uint8_t)i;
+				mm_host_fill(&s_tBlk[wBlks], 0);
+				wBlks++;
+				break;
+		}
+
+		MM_HOST_CHECK(tArena.cur == tArena.base + wCur, "bump offset %u, model %u",
+			(unsigned int)(tArena.cur - tArena.base), wCur);
+		for(j = 0; j < wBlks; j++)
+			MM_HOST_CHECK(mm_host_content_ok(&s_tBlk[j]), "content of block %u", j);
+		mm_host_heap_check(&s_tHeap, NULL, 0);				//region and overflow chunks
+	}
+
+	MM_HOST_CHECK(mm_arena_peak(&tArena) == wPeak, "peak %u, model %u", (unsigned int)mm_arena_peak(&tArena), wPeak);
+	MM_HOST_CHECK(wOvf && wRewind, "overflow or rewind never taken");
+	mm_arena_release(&tArena);
+	MM_HOST_CHECK(ar_heap_used() == 0, "release left heap use");
+}
+
+static void ar_run(uint32_t wOps, uint32_t wRng)
+{
+	ar_args();
+	if(!s_iFail)
+		ar_region();
+	if(!s_iFail)
+		ar_overflow();
+	if(!s_iFail)
+		ar_random(wOps, wRng);
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t wOps = 200000;
+
+	if(mm_host_run(argc, argv, &wOps, ar_run) < 0)
+		return 2;
+
+	printf("mm_arena %s: %u ops %s\n", MM_HOST_BACKEND, wOps, s_iFail ? "FAIL" : "PASS");
+	return s_iFail ? 1 : 0;
+}
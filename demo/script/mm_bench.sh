@@ -0,0 +1,35 @@
+#!/bin/sh
+# build demo/script/mm_bench.c once per mm configuration and replay the same
+# workload (synthetic, or a trace file / console log of CONFIG_MM_TRACE) on
+# each; extra arguments go to mm_bench
+#   demo/script/mm_bench.sh [-h heap_bytes] [-n ops] [-s seed] [-r runs] [trace.txt]
+#
+# configurations: BENCH_CONFIGS="name:flag,flag name:..." e.g.
+#   BENCH_CONFIGS="list: tlsf:-DCONFIG_MM_TLSF tlsf4k:-DCONFIG_MM_TLSF,-DCONFIG_MM_TLSF_MAXSHIFT=12"
+# CONFIG_MM_MIN_SHIFT must leave room for a free node: >= 5 on a 64-bit
+# host, >= 4 with BENCH_CFLAGS=-m32 (needs a multilib toolchain)
+# -r counts the timed runs, an untimed warm-up run comes first; compare the
+# backends on p999, max is a single op and dominated by host noise
+
+set -e
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+OUT=${TMPDIR:-/tmp}/mm_bench
+MM=$ROOT/components/mm
+SRC="$ROOT/demo/script/mm_bench.c $MM/src/mm_initialize.c $MM/src/mm_malloc.c \
+ $MM/src/mm_free.c $MM/src/mm_addfreechunk.c $MM/src/mm_size2ndx.c \
+ $MM/src/mm_mallinfo.c $MM/src/mm_tlsf.c"
+CFLAGS="-O2 -Wall -Wextra -DCONFIG_MM_MAX_USED=0 -I$MM/include ${BENCH_CFLAGS:-}"
+CONFIGS=${BENCH_CONFIGS:-"list: tlsf:-DCONFIG_MM_TLSF list_g64:-DCONFIG_MM_MIN_SHIFT=6 tlsf_g64:-DCONFIG_MM_TLSF,-DCONFIG_MM_MIN_SHIFT=6"}
+
+mkdir -p "$OUT"
+for CFG in $CONFIGS; do
+	NAME=${CFG%%:*}
+	FLAGS=$(echo "${CFG#*:}" | tr ',' ' ')
+	${CC:-gcc} $CFLAGS $FLAGS $SRC -o "$OUT/mm_bench_$NAME"
+done
+
+for CFG in $CONFIGS; do
+	NAME=${CFG%%:*}
+	printf "%-10s " "$NAME"
+	"$OUT/mm_bench_$NAME" "$@"
+done
@@ -0,0 +1,203 @@
+/***********************************************************************//**
+ * \file  mm_host_common.h
+ * \brief  fixture shared by the host(linux) checks of components/mm(mm_realloc_host.c,
+ *         mm_arena_host.c, mm_memalign_host.c): xorshift rng, check macro, block model with
+ *         its content pattern, heap walk and the -n/-r main. Included by one translation unit
+ *         per check; the check prints PASS/FAIL on stdout and returns 1 on FAIL.
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#ifndef _MM_HOST_COMMON_H
+#define _MM_HOST_COMMON_H
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "mm.h"
+
+#ifdef CONFIG_MM_TLSF
+#define MM_HOST_BACKEND		"tlsf"
+#else
+#define MM_HOST_BACKEND		"list"
+#endif
+
+#define MM_HOST_CHECK(cond, ...)	do { if(!(cond)) { mm_host_fail(__LINE__, __VA_ARGS__); return; } } while(0)
+
+//linker symbols of the target, referenced by mm_heap_initialize only
+size_t __heap_start, __heap_end;
+
+typedef struct {
+	uint8_t		*pbyMem;
+	uint32_t	wSize;
+	uint32_t	wAlign;				//0: no alignment checked
+	uint8_t		bySeed;				//content byte n is bySeed + n
+} mm_host_block_t;
+
+typedef void (*mm_host_run_t)(uint32_t wOps, uint32_t wRng);
+
+static int s_iFail = 0;
+
+static inline uint32_t mm_host_rand(uint32_t *pwState)
+{
+	uint32_t x = *pwState;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *pwState = x;
+}
+
+//first failure only, on stderr: stdout is sent to /dev/null while mm runs
+static inline void mm_host_fail(int iLine, const char *pFmt, ...)
+{
+	va_list tArgs;
+
+	if(s_iFail++)
+		return;
+	fprintf(stderr, "FAIL line %d: ", iLine);
+	va_start(tArgs, pFmt);
+	vfprintf(stderr, pFmt, tArgs);
+	va_end(tArgs);
+	fputc('\n', stderr);
+}
+
+static inline struct mm_allocnode_s *mm_host_node(void *pMem)
+{
+	return (struct mm_allocnode_s *)((uintptr_t)pMem - SIZEOF_MM_ALLOCNODE);
+}
+
+//chunk size mm_malloc takes for wSize bytes
+static inline uint32_t mm_host_chunk(uint32_t wSize)
+{
+	return MM_ALIGN_UP(wSize + SIZEOF_MM_ALLOCNODE);
+}
+
+static inline void mm_host_fill(mm_host_block_t *ptBlk, uint32_t wFrom)
+{
+	uint32_t i;
+
+	for(i = wFrom; i < ptBlk->wSize; i++)
+		ptBlk->pbyMem[i] = (uint8_t)(ptBlk->bySeed + i);
+}
+
+static inline int mm_host_content_ok(const mm_host_block_t *ptBlk)
+{
+	uint32_t i;
+
+	for(i = 0; i < ptBlk->wSize; i++)
+	{
+		if(ptBlk->pbyMem[i] != (uint8_t)(ptBlk->bySeed + i))
+			return 0;
+	}
+	return 1;
+}
+
+/** \brief walk the region: every chunk holds a free node and is in header units(the first
+ *         chunk is the region less the guards, not a granule multiple when MM_MIN_CHUNK is
+ *         more than twice the header, nor is the leading slack memalign splits off), the
+ *         preceding size of each chunk equals the size of the one before, frees coalesce,
+ *         the walk lands on the end guard, free bytes match mallinfo; live blocks of ptBlk
+ *         lie in allocated chunks, are aligned and hold their content
+ *  \param[in] ptHeap: heap to walk
+ *  \param[in] ptBlk: model of the blocks allocated from ptHeap, NULL when none
+ *  \param[in] wNum: entries of ptBlk, unused ones have pbyMem NULL
+ */
+static inline void mm_host_heap_check(struct mm_heap_s *ptHeap, const mm_host_block_t *ptBlk, uint32_t wNum)
+{
+	struct mm_allocnode_s *ptNode, *ptEnd = ptHeap->mm_heapend[0];
+	struct mallinfo tInfo;
+	uint32_t wPrev = SIZEOF_MM_ALLOCNODE, wFree = 0, wPrevFree = 0, i;
+
+	//start and end guards are allocated header-only chunks
+	ptNode = ptHeap->mm_heapstart[0];
+	MM_HOST_CHECK(ptNode->size == SIZEOF_MM_ALLOCNODE && ptEnd->size == SIZEOF_MM_ALLOCNODE, "guard chunks");
+	for(ptNode = (struct mm_allocnode_s *)((uintptr_t)ptNode + SIZEOF_MM_ALLOCNODE); ptNode < ptEnd;
+		ptNode = (struct mm_allocnode_s *)((uintptr_t)ptNode + ptNode->size))
+	{
+		MM_HOST_CHECK(ptNode->size >= SIZEOF_MM_FREENODE && ptNode->size % SIZEOF_MM_ALLOCNODE == 0, "chunk size");
+		MM_HOST_CHECK((ptNode->preceding & ~MM_ALLOC_BIT) == wPrev, "preceding size");
+		if(ptNode->preceding & MM_ALLOC_BIT)
+			wPrevFree = 0;
+		else
+		{
+			MM_HOST_CHECK(!wPrevFree, "two free chunks in a row");
+			wFree += ptNode->size;
+			wPrevFree = 1;
+		}
+		wPrev = ptNode->size;
+	}
+	MM_HOST_CHECK(ptNode == ptEnd, "walk overran the end chunk");
+	MM_HOST_CHECK((ptEnd->preceding & ~MM_ALLOC_BIT) == wPrev, "end chunk preceding size");
+
+	mm_mallinfo(ptHeap, &tInfo);
+	MM_HOST_CHECK((uint32_t)tInfo.fordblks == wFree, "mallinfo free %d, walked %u", tInfo.fordblks, wFree);
+
+	for(i = 0; i < wNum; i++)
+	{
+		if(ptBlk[i].pbyMem == NULL)
+			continue;
+		ptNode = mm_host_node(ptBlk[i].pbyMem);
+		MM_HOST_CHECK(ptNode->preceding & MM_ALLOC_BIT, "live block in a free chunk");
+		MM_HOST_CHECK(ptNode->size >= mm_host_chunk(ptBlk[i].wSize), "chunk smaller than block");
+		MM_HOST_CHECK(((uintptr_t)ptBlk[i].pbyMem & (ptBlk[i].wAlign ? ptBlk[i].wAlign - 1 : 0)) == 0,
+			"block %u not aligned to %u", i, ptBlk[i].wAlign);
+		MM_HOST_CHECK(mm_host_content_ok(&ptBlk[i]), "content of block %u", i);
+	}
+}
+
+/** \brief all blocks freed: one free chunk between the guards
+ */
+static inline void mm_host_heap_empty(struct mm_heap_s *ptHeap)
+{
+	struct mallinfo tInfo;
+
+	mm_mallinfo(ptHeap, &tInfo);
+	MM_HOST_CHECK(tInfo.ordblks == 1 && tInfo.mxordblk == tInfo.fordblks, "heap not merged back, %d free chunks",
+		tInfo.ordblks);
+}
+
+/** \brief parse [-n ops] [-r seed] and call pfnRun with stdout on /dev/null(mm_malloc prints
+ *         on failure)
+ *  \param[in/out] pwOps: default op count in, the one used out
+ *  \param[in] pfnRun: the check, gets the op count and an xorshift state made from the seed
+ *  \return 0, or -1 on a bad option
+ */
+static inline int mm_host_run(int argc, char **argv, uint32_t *pwOps, mm_host_run_t pfnRun)
+{
+	uint32_t wSeed = 1;
+	int iOpt, iOut, iNull;
+
+	while((iOpt = getopt(argc, argv, "n:r:")) != -1)
+	{
+		switch(iOpt)
+		{
+			case 'n': *pwOps = (uint32_t)strtoul(optarg, NULL, 0); break;
+			case 'r': wSeed = (uint32_t)strtoul(optarg, NULL, 0); break;
+			default:
+				fprintf(stderr, "usage: %s [-n ops] [-r seed]\n", argv[0]);
+				return -1;
+		}
+	}
+
+	fflush(stdout);
+	iOut = dup(1);
+	iNull = open("/dev/null", O_WRONLY);
+	dup2(iNull, 1);
+
+	pfnRun(*pwOps, wSeed * 2654435761u + 1);
+
+	fflush(stdout);
+	dup2(iOut, 1);
+	close(iNull);
+	close(iOut);
+	return 0;
+}
+
+#endif
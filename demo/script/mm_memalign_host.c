@@ -0,0 +1,212 @@
+/***********************************************************************//**
+ * \file  mm_memalign_host.c
+ * \brief  host(linux) check of mm_memalign(components/mm/src/mm_memalign.c): bad alignments
+ *         and sizes, every power of two alignment up to 4 KB with the aligned block
+ *         holding only the header and granule rounding, free of an aligned block(leading
+ *         slack and tail merged back), realloc of an aligned block; then a random
+ *         memalign/malloc/realloc/free replay. After each step the heap is walked and
+ *         every block checked for alignment and content(mm_host_common.h); at the end the
+ *         heap must be one free chunk.
+ *
+ *         build(from the repo root), add -DCONFIG_MM_TLSF for the TLSF backend:
+ *         gcc -O2 -DCONFIG_MM_MAX_USED=0 -Icomponents/mm/include demo/script/mm_memalign_host.c \
+ *             components/mm/src/mm_memalign.c components/mm/src/mm_initialize.c \
+ *             components/mm/src/mm_malloc.c components/mm/src/mm_free.c \
+ *             components/mm/src/mm_realloc.c components/mm/src/mm_shrinkchunk.c \
+ *             components/mm/src/mm_addfreechunk.c components/mm/src/mm_size2ndx.c \
+ *             components/mm/src/mm_mallinfo.c components/mm/src/mm_tlsf.c -o mm_memalign_host
+ *         usage:
+ *         mm_memalign_host [-n ops] [-r seed]
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include "mm_host_common.h"
+
+#define MA_HEAP_BYTES		16384				//room for 4 KB alignment
+#define MA_IDS				24
+#define MA_SIZE_MAX			300
+#define MA_ALIGN_SHIFT_MAX	12
+
+static struct mm_heap_s s_tHeap;
+static uint64_t s_dwHeapMem[MA_HEAP_BYTES / 8];
+static mm_host_block_t s_tBlk[MA_IDS];				//wAlign 0: malloc, or moved by realloc
+
+static void ma_heap_check(void)
+{
+	mm_host_heap_check(&s_tHeap, s_tBlk, MA_IDS);
+}
+
+static void ma_reset(void)
+{
+	memset(s_tBlk, 0, sizeof(s_tBlk));
+	mm_initialize(&s_tHeap, s_dwHeapMem, sizeof(s_dwHeapMem));
+}
+
+static void *ma_memalign(uint8_t byId, uint32_t wAlign, uint32_t wSize)
+{
+	mm_host_block_t *ptBlk = &s_tBlk[byId];
+
+	ptBlk->pbyMem = mm_memalign(&s_tHeap, wAlign, wSize, NULL);
+	ptBlk->wSize = ptBlk->pbyMem ? wSize : 0;
+	ptBlk->wAlign = wAlign;
+	ptBlk->bySeed = (uint8_t)(byId * 29 + wSize);
+	if(ptBlk->pbyMem)
+		mm_host_fill(ptBlk, 0);
+	return ptBlk->pbyMem;
+}
+
+static void ma_free(uint8_t byId)
+{
+	mm_free(&s_tHeap, s_tBlk[byId].pbyMem, NULL);
+	memset(&s_tBlk[byId], 0, sizeof(s_tBlk[byId]));
+}
+
+/** \brief realloc keeps the content, the alignment only while the block stays in place
+ */
+static void ma_realloc(uint8_t byId, uint32_t wSize)
+{
+	mm_host_block_t *ptBlk = &s_tBlk[byId];
+	uint32_t wOldSize = ptBlk->wSize;
+	uint8_t *pbyNew;
+
+	pbyNew = mm_realloc(&s_tHeap, ptBlk->pbyMem, wSize, NULL);
+	if(pbyNew == NULL)
+		return;
+	if(pbyNew != ptBlk->pbyMem)
+		ptBlk->wAlign = 0;
+	ptBlk->pbyMem = pbyNew;
+	ptBlk->wSize = wSize;
+	if(wSize > wOldSize)
+		mm_host_fill(ptBlk, wOldSize);
+}
+
+static void ma_cases(void)
+{
+	struct mallinfo tInfo0, tInfo1;
+	struct mm_allocnode_s *ptNode;
+	uint32_t wAlign, wSize;
+	uint8_t *pbyMem;
+
+	//bad alignment or size: NULL, heap untouched; natural alignment: plain malloc
+	ma_reset();
+	mm_mallinfo(&s_tHeap, &tInfo0);
+	MM_HOST_CHECK(mm_memalign(&s_tHeap, 0, 16, NULL) == NULL, "alignment 0");
+	MM_HOST_CHECK(mm_memalign(&s_tHeap, 24, 16, NULL) == NULL, "alignment 24");
+	MM_HOST_CHECK(mm_memalign(&s_tHeap, 64, 0, NULL) == NULL, "size 0");
+	MM_HOST_CHECK(mm_memalign(&s_tHeap, 64, SIZE_MAX / 2, NULL) == NULL, "size too large");
+	MM_HOST_CHECK(mm_memalign(&s_tHeap, 64, MA_HEAP_BYTES, NULL) == NULL, "size beyond the heap");
+	mm_mallinfo(&s_tHeap, &tInfo1);
+	MM_HOST_CHECK(tInfo1.uordblks == tInfo0.uordblks, "failed memalign left heap use");
+	pbyMem = mm_memalign(&s_tHeap, SIZEOF_MM_ALLOCNODE, 40, NULL);
+	MM_HOST_CHECK(pbyMem == (uint8_t *)s_tHeap.mm_heapstart[0] + 2 * SIZEOF_MM_ALLOCNODE, "natural alignment");
+	mm_free(&s_tHeap, pbyMem, NULL);
+	mm_host_heap_empty(&s_tHeap);
+
+	//every alignment, behind a small block so the raw chunk is rarely aligned already;
+	//the aligned chunk keeps the header and rounding only, less than a free node more
+	for(wAlign = 1; wAlign <= (1u << MA_ALIGN_SHIFT_MAX) && !s_iFail; wAlign <<= 1)
+	{
+		for(wSize = 1; wSize <= 200 && !s_iFail; wSize += 37)
+		{
+			ma_reset();
+			ma_memalign(0, 8, 24);
+			mm_mallinfo(&s_tHeap, &tInfo0);
+			MM_HOST_CHECK(ma_memalign(1, wAlign, wSize) != NULL, "memalign(%u, %u)", wAlign, wSize);
+			ptNode = mm_host_node(s_tBlk[1].pbyMem);
+			MM_HOST_CHECK(ptNode->size < mm_host_chunk(wSize) + SIZEOF_MM_FREENODE, "align %u size %u: chunk %u",
+				wAlign, wSize, (unsigned int)ptNode->size);
+			mm_mallinfo(&s_tHeap, &tInfo1);
+			MM_HOST_CHECK((uint32_t)(tInfo1.uordblks - tInfo0.uordblks) == ptNode->size, "slack not given back");
+			ma_heap_check();
+
+			//free: leading slack, block and tail merge back
+			ma_free(1);
+			ma_free(0);
+			ma_heap_check();
+			mm_host_heap_empty(&s_tHeap);
+		}
+	}
+
+	//realloc of an aligned block: shrink in place keeps it aligned, grow may move it
+	ma_reset();
+	ma_memalign(0, 8, 24);
+	ma_memalign(1, 256, 100);
+	ma_memalign(2, 8, 24);
+	pbyMem = s_tBlk[1].pbyMem;
+	ma_realloc(1, 20);
+	MM_HOST_CHECK(s_tBlk[1].pbyMem == pbyMem && mm_host_node(pbyMem)->size == mm_host_chunk(20), "shrink aligned block");
+	ma_heap_check();
+	ma_realloc(1, 600);
+	ma_heap_check();
+	ma_free(1);
+	ma_free(2);
+	ma_free(0);
+	mm_host_heap_empty(&s_tHeap);
+}
+
+/** \brief random memalign/malloc/realloc/free, the heap walked after each op
+ */
+static void ma_random(uint32_t wOps, uint32_t wRng)
+{
+	uint32_t i, wSize, wAligned = 0;
+	uint8_t byId;
+
+	ma_reset();
+	for(i = 0; i < wOps && !s_iFail; i++)
+	{
+		byId = (uint8_t)(mm_host_rand(&wRng) % MA_IDS);
+		wSize = mm_host_rand(&wRng) % MA_SIZE_MAX + 1;
+		if(s_tBlk[byId].pbyMem == NULL)
+		{
+			if(mm_host_rand(&wRng) % 4)
+			{
+				if(ma_memalign(byId, 1u << (mm_host_rand(&wRng) % (MA_ALIGN_SHIFT_MAX - 3)), wSize))
+					wAligned++;
+			}
+			else
+			{
+				s_tBlk[byId].pbyMem = mm_malloc(&s_tHeap, wSize, NULL);
+				s_tBlk[byId].wSize = s_tBlk[byId].pbyMem ? wSize : 0;
+				s_tBlk[byId].wAlign = 0;
+				s_tBlk[byId].bySeed = (uint8_t)i;
+				if(s_tBlk[byId].pbyMem)
+					mm_host_fill(&s_tBlk[byId], 0);
+			}
+		}
+		else if(mm_host_rand(&wRng) % 4 == 0)
+			ma_realloc(byId, wSize);
+		else
+			ma_free(byId);
+		ma_heap_check();
+	}
+
+	for(byId = 0; byId < MA_IDS; byId++)
+	{
+		if(s_tBlk[byId].pbyMem)
+			ma_free(byId);
+	}
+	ma_heap_check();
+	mm_host_heap_empty(&s_tHeap);
+	MM_HOST_CHECK(wAligned >= wOps / 4, "few aligned blocks: %u", wAligned);
+}
+
+static void ma_run(uint32_t wOps, uint32_t wRng)
+{
+	ma_cases();
+	if(!s_iFail)
+		ma_random(wOps, wRng);
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t wOps = 100000;
+
+	if(mm_host_run(argc, argv, &wOps, ma_run) < 0)
+		return 2;
+
+	printf("mm_memalign %s gran=%d: %u ops %s\n", MM_HOST_BACKEND, MM_MIN_CHUNK, wOps, s_iFail ? "FAIL" : "PASS");
+	return s_iFail ? 1 : 0;
+}
@@ -0,0 +1,248 @@
+/***********************************************************************//**
+ * \file  mm_realloc_host.c
+ * \brief  host(linux) check of mm_realloc/mm_shrinkchunk(components/mm): fixed cases for
+ *         in-place shrink(next chunk allocated or free), shrink to less than one granule
+ *         and below the minimum chunk, in-place grow into a free next chunk(partly and
+ *         fully taken), the move fallback and its failure; then a random malloc/free/realloc
+ *         replay against a model of every block's content. After each step the heap is
+ *         walked(mm_host_common.h) and every path must have been taken.
+ *
+ *         build(from the repo root), add -DCONFIG_MM_TLSF for the TLSF backend:
+ *         gcc -O2 -DCONFIG_MM_MAX_USED=0 -Icomponents/mm/include demo/script/mm_realloc_host.c \
+ *             components/mm/src/mm_initialize.c components/mm/src/mm_malloc.c \
+ *             components/mm/src/mm_free.c components/mm/src/mm_realloc.c \
+ *             components/mm/src/mm_shrinkchunk.c components/mm/src/mm_addfreechunk.c \
+ *             components/mm/src/mm_size2ndx.c components/mm/src/mm_mallinfo.c \
+ *             components/mm/src/mm_tlsf.c -o mm_realloc_host
+ *         usage:
+ *         mm_realloc_host [-n ops] [-r seed]
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include "mm_host_common.h"
+
+#define RA_HEAP_BYTES		6144
+#define RA_IDS				32
+#define RA_SIZE_MAX			600
+
+typedef struct {
+	uint32_t	wGrow;				//in place, into the next chunk
+	uint32_t	wShrink;			//in place, chunk made smaller
+	uint32_t	wKeep;				//in place, chunk size unchanged
+	uint32_t	wMove;
+	uint32_t	wNoMem;				//move failed, old block kept
+} ra_paths_t;
+
+static struct mm_heap_s s_tHeap;
+static uint64_t s_dwHeapMem[RA_HEAP_BYTES / 8];
+static mm_host_block_t s_tBlk[RA_IDS];
+static ra_paths_t s_tPaths;
+
+static void ra_heap_check(void)
+{
+	mm_host_heap_check(&s_tHeap, s_tBlk, RA_IDS);
+}
+
+static void ra_alloc(uint8_t byId, uint32_t wSize)
+{
+	mm_host_block_t *ptBlk = &s_tBlk[byId];
+
+	ptBlk->pbyMem = mm_malloc(&s_tHeap, wSize, NULL);
+	ptBlk->wSize = ptBlk->pbyMem ? wSize : 0;
+	ptBlk->bySeed = (uint8_t)(byId * 37 + wSize);
+	if(ptBlk->pbyMem)
+		mm_host_fill(ptBlk, 0);
+}
+
+static void ra_free(uint8_t byId)
+{
+	mm_free(&s_tHeap, s_tBlk[byId].pbyMem, NULL);
+	s_tBlk[byId].pbyMem = NULL;
+	s_tBlk[byId].wSize = 0;
+}
+
+/** \brief realloc a live block, keep the model and count the path taken;
+ *         returns the path(&s_tPaths member) for the fixed cases
+ */
+static uint32_t *ra_realloc(uint8_t byId, uint32_t wSize)
+{
+	mm_host_block_t *ptBlk = &s_tBlk[byId];
+	uint32_t wOldChunk = mm_host_node(ptBlk->pbyMem)->size, wOldSize = ptBlk->wSize;
+	uint8_t *pbyNew;
+
+	pbyNew = mm_realloc(&s_tHeap, ptBlk->pbyMem, wSize, NULL);
+	if(pbyNew == NULL)
+	{
+		s_tPaths.wNoMem++;
+		return &s_tPaths.wNoMem;
+	}
+
+	ptBlk->wSize = wSize;
+	if(pbyNew != ptBlk->pbyMem)
+	{
+		ptBlk->pbyMem = pbyNew;
+		if(wSize > wOldSize)
+			mm_host_fill(ptBlk, wOldSize);
+		s_tPaths.wMove++;
+		return &s_tPaths.wMove;
+	}
+
+	if(wSize > wOldSize)
+		mm_host_fill(ptBlk, wOldSize);
+	if(mm_host_node(pbyNew)->size > wOldChunk)
+	{
+		s_tPaths.wGrow++;
+		return &s_tPaths.wGrow;
+	}
+	if(mm_host_node(pbyNew)->size < wOldChunk)
+	{
+		s_tPaths.wShrink++;
+		return &s_tPaths.wShrink;
+	}
+	s_tPaths.wKeep++;
+	return &s_tPaths.wKeep;
+}
+
+static void ra_reset(void)
+{
+	memset(s_tBlk, 0, sizeof(s_tBlk));
+	mm_initialize(&s_tHeap, s_dwHeapMem, sizeof(s_dwHeapMem));
+}
+
+/** \brief fixed cases, blocks 0/1/2 placed next to each other in a fresh heap
+ */
+static void ra_cases(void)
+{
+	struct mallinfo tInfo0, tInfo1;
+	uint8_t *pbyOld;
+
+	//shrink in place, next chunk allocated: the tail becomes a free chunk of its own
+	ra_reset();
+	ra_alloc(0, 400); ra_alloc(1, 64); ra_alloc(2, 64);
+	MM_HOST_CHECK(s_tBlk[1].pbyMem == s_tBlk[0].pbyMem + mm_host_chunk(400), "blocks not adjacent");
+	mm_mallinfo(&s_tHeap, &tInfo0);
+	MM_HOST_CHECK(ra_realloc(0, 100) == &s_tPaths.wShrink, "shrink, next allocated");
+	mm_mallinfo(&s_tHeap, &tInfo1);
+	MM_HOST_CHECK(mm_host_node(s_tBlk[0].pbyMem)->size == mm_host_chunk(100), "shrunk chunk size");
+	MM_HOST_CHECK(tInfo1.ordblks == tInfo0.ordblks + 1, "tail not a free chunk");
+	MM_HOST_CHECK((uint32_t)(tInfo1.fordblks - tInfo0.fordblks) == mm_host_chunk(400) - mm_host_chunk(100), "tail size");
+	ra_heap_check();
+
+	//shrink in place, next chunk free: the tail is merged into it, no new chunk
+	ra_free(1);
+	mm_mallinfo(&s_tHeap, &tInfo0);
+	MM_HOST_CHECK(ra_realloc(0, 20) == &s_tPaths.wShrink, "shrink, next free");
+	mm_mallinfo(&s_tHeap, &tInfo1);
+	MM_HOST_CHECK(tInfo1.ordblks == tInfo0.ordblks, "tail not merged");
+	MM_HOST_CHECK((uint32_t)(tInfo1.fordblks - tInfo0.fordblks) == mm_host_chunk(100) - mm_host_chunk(20), "merged size");
+	ra_heap_check();
+
+	//less than one granule smaller: same chunk; below the minimum chunk: MM_MIN_CHUNK kept.
+	//Chunk sizes stay multiples of SIZEOF_MM_FREENODE(32 on a 64-bit host, 16 on ck802), so a
+	//shrink tail always holds a free node and the "few bytes stay" branch is not reachable
+	ra_reset();
+	ra_alloc(0, 200); ra_alloc(1, 64);
+	MM_HOST_CHECK(ra_realloc(0, 200 - 1) == &s_tPaths.wKeep, "shrink within a granule");
+	MM_HOST_CHECK(ra_realloc(0, 1) == &s_tPaths.wShrink, "shrink to 1 byte");
+	MM_HOST_CHECK(mm_host_node(s_tBlk[0].pbyMem)->size == MM_MIN_CHUNK, "chunk below MM_MIN_CHUNK");
+	MM_HOST_CHECK(ra_realloc(0, 1) == &s_tPaths.wKeep, "second shrink to 1 byte");
+	ra_heap_check();
+
+	//grow in place into a free next chunk, the rest of it given back
+	ra_reset();
+	ra_alloc(0, 64); ra_alloc(1, 300); ra_alloc(2, 64);
+	ra_free(1);
+	pbyOld = s_tBlk[0].pbyMem;
+	MM_HOST_CHECK(ra_realloc(0, 150) == &s_tPaths.wGrow, "grow into free next");
+	MM_HOST_CHECK(s_tBlk[0].pbyMem == pbyOld && mm_host_node(pbyOld)->size == mm_host_chunk(150), "grown chunk size");
+	ra_heap_check();
+
+	//grow taking the whole free next chunk
+	MM_HOST_CHECK(ra_realloc(0, mm_host_chunk(64) + mm_host_chunk(300) - SIZEOF_MM_ALLOCNODE) == &s_tPaths.wGrow,
+		"grow into all of next");
+	MM_HOST_CHECK(s_tBlk[0].pbyMem == pbyOld &&
+		(uint8_t *)mm_host_node(pbyOld) + mm_host_node(pbyOld)->size == (uint8_t *)mm_host_node(s_tBlk[2].pbyMem),
+		"next chunk not fully taken");
+	ra_heap_check();
+
+	//move: next chunk allocated, content copied, old chunk freed
+	ra_reset();
+	ra_alloc(0, 64); ra_alloc(1, 64);
+	pbyOld = s_tBlk[0].pbyMem;
+	mm_mallinfo(&s_tHeap, &tInfo0);
+	MM_HOST_CHECK(ra_realloc(0, 500) == &s_tPaths.wMove, "move");
+	mm_mallinfo(&s_tHeap, &tInfo1);
+	MM_HOST_CHECK(tInfo1.uordblks - tInfo0.uordblks == (int)(mm_host_chunk(500) - mm_host_chunk(64)), "old chunk not freed");
+	ra_heap_check();
+
+	//move fails: NULL, the old block and its content stay
+	pbyOld = s_tBlk[0].pbyMem;
+	MM_HOST_CHECK(ra_realloc(0, RA_HEAP_BYTES) == &s_tPaths.wNoMem, "move beyond the heap");
+	MM_HOST_CHECK(s_tBlk[0].pbyMem == pbyOld, "block lost on failure");
+	ra_heap_check();
+
+	//NULL behaves as malloc, size 0 as free
+	s_tBlk[3].pbyMem = mm_realloc(&s_tHeap, NULL, 32, NULL);
+	s_tBlk[3].wSize = 32;
+	s_tBlk[3].bySeed = 3;
+	MM_HOST_CHECK(s_tBlk[3].pbyMem != NULL, "realloc(NULL)");
+	mm_host_fill(&s_tBlk[3], 0);
+	MM_HOST_CHECK(mm_realloc(&s_tHeap, s_tBlk[3].pbyMem, 0, NULL) == NULL, "realloc(0)");
+	s_tBlk[3].pbyMem = NULL;
+	s_tBlk[3].wSize = 0;
+	ra_heap_check();
+}
+
+/** \brief random malloc/free/realloc, the heap and every block checked after each op
+ */
+static void ra_random(uint32_t wOps, uint32_t wRng)
+{
+	uint32_t i, wSize;
+	uint8_t byId;
+
+	ra_reset();
+	for(i = 0; i < wOps && !s_iFail; i++)
+	{
+		byId = (uint8_t)(mm_host_rand(&wRng) % RA_IDS);
+		wSize = mm_host_rand(&wRng) % RA_SIZE_MAX + 1;
+		if(s_tBlk[byId].pbyMem == NULL)
+			ra_alloc(byId, wSize);
+		else if(mm_host_rand(&wRng) % 4 == 0)
+			ra_free(byId);
+		else
+		{
+			if(mm_host_rand(&wRng) & 1)						//small steps hit the in-place paths
+				wSize = s_tBlk[byId].wSize + wSize / 8 - RA_SIZE_MAX / 16;
+			if((int32_t)wSize < 1)
+				wSize = 1;
+			ra_realloc(byId, wSize);
+		}
+		ra_heap_check();
+	}
+}
+
+static void ra_run(uint32_t wOps, uint32_t wRng)
+{
+	ra_cases();
+	if(!s_iFail)
+		ra_random(wOps, wRng);
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t wOps = 200000;
+
+	if(mm_host_run(argc, argv, &wOps, ra_run) < 0)
+		return 2;
+
+	if(!s_iFail && (!s_tPaths.wGrow || !s_tPaths.wShrink || !s_tPaths.wKeep || !s_tPaths.wMove || !s_tPaths.wNoMem))
+		mm_host_fail(__LINE__, "a path was never taken");
+
+	printf("mm_realloc %s gran=%d: grow=%u shrink=%u keep=%u move=%u nomem=%u %s\n", MM_HOST_BACKEND,
+		MM_MIN_CHUNK, s_tPaths.wGrow, s_tPaths.wShrink, s_tPaths.wKeep, s_tPaths.wMove,
+		s_tPaths.wNoMem, s_iFail ? "FAIL" : "PASS");
+	return s_iFail ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+"""Decode csi_prof_dump() binary output (components/chip/drivers/prof.c).
+
+usage:
+    prof_decode.py capture.bin              # raw uart capture, text around the dump is skipped
+    prof_decode.py /dev/ttyUSB0 -b 115200   # read from serial port(needs pyserial) until one dump is decoded
+"""
+
+import argparse
+import struct
+import sys
+
+# order of csi_prof_id_e in csi/include/drv/prof.h when PROF_ISR_EN = 1
+ISR_NAMES = [
+    "CORET", "SYSCON", "IFC", "ADC", "EPT0", "DMA", "WWDT", "GPTA0", "GPTA1",
+    "GPTB0", "GPTB1", "RTC", "UART0", "UART1", "UART2", "USART0", "SIO", "I2C",
+    "SPI0", "EXI0", "EXI1", "EXI2_3", "EXI4_9", "EXI10_15", "CNTA", "TKEY",
+    "LPT", "LED", "CMP", "BT0", "BT1", "LCD",
+]
+
+MAGIC = b"PF"
+HEAD = struct.Struct("<2sBBBBBBII")
+
+
+def fletcher16(data):
+    s1 = s2 = 0
+    for b in data:
+        s1 = (s1 + b) % 255
+        s2 = (s2 + s1) % 255
+    return s1, s2
+
+
+def probe_name(pid, first_user):
+    if pid >= first_user:
+        return "USER%d" % (pid - first_user)
+    if first_user == len(ISR_NAMES) and pid < len(ISR_NAMES):
+        return "ISR_" + ISR_NAMES[pid]
+    return "ID%d" % pid
+
+
+def parse(buf):
+    """return (header dict, records, bytes used) of the first valid dump in buf, or None"""
+    pos = buf.find(MAGIC)
+    while pos >= 0:
+        if len(buf) - pos < HEAD.size:
+            return None
+        _, ver, bins, shift, first_user, num, _, hz, overhead = HEAD.unpack_from(buf, pos)
+        rec = struct.Struct("<BIII%dH" % bins)
+        end = pos + HEAD.size + num * rec.size
+        if ver == 1 and bins > 0:
+            if len(buf) < end + 2:
+                return None
+            if tuple(buf[end:end + 2]) == fletcher16(buf[pos:end]):
+                recs = []
+                for i in range(num):
+                    v = rec.unpack_from(buf, pos + HEAD.size + i * rec.size)
+                    recs.append({"id": v[0], "count": v[1], "min": v[2], "max": v[3], "hist": v[4:]})
+                head = {"bins": bins, "shift": shift, "first_user": first_user, "hz": hz, "overhead": overhead}
+                return head, recs, end + 2
+        pos = buf.find(MAGIC, pos + 1)
+    return None
+
+
+def show(head, recs, out=sys.stdout):
+    hz = head["hz"] or 1
+    us = lambda c: c * 1e6 / hz
+    out.write("coret %d Hz, overhead %d cycles subtracted, %d probes\n" % (hz, head["overhead"], len(recs)))
+    out.write("%-14s %10s %10s %10s %10s %10s\n" % ("probe", "count", "min(cyc)", "max(cyc)", "min(us)", "max(us)"))
+    for r in recs:
+        out.write("%-14s %10d %10d %10d %10.2f %10.2f\n" % (
+            probe_name(r["id"], head["first_user"]), r["count"], r["min"], r["max"], us(r["min"]), us(r["max"])))
+        peak = max(r["hist"]) or 1
+        for b, n in enumerate(r["hist"]):
+            if n == 0:
+                continue
+            lo = 0 if b == 0 else 1 << (b + head["shift"])
+            hi = "inf" if b == head["bins"] - 1 else str((1 << (b + head["shift"] + 1)) - 1)
+            sat = "+" if n == 0xffff else " "
+            out.write("    [%8d, %8s] %6d%s %s\n" % (lo, hi, n, sat, "#" * max(1, n * 40 // peak)))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("src", help="capture file, or serial port")
+    ap.add_argument("-b", "--baud", type=int, default=115200)
+    args = ap.parse_args()
+
+    if args.src.startswith("/dev/") or args.src.upper().startswith("COM"):
+        import serial
+        port = serial.Serial(args.src, args.baud, timeout=1)
+        buf = b""
+        while True:
+            buf += port.read(256)
+            res = parse(buf)
+            if res:
+                break
+    else:
+        with open(args.src, "rb") as f:
+            res = parse(f.read())
+        if res is None:
+            sys.exit("no valid dump found")
+
+    show(res[0], res[1])
+
+
+if __name__ == "__main__":
+    main()
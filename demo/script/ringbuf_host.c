@@ -0,0 +1,207 @@
+/***********************************************************************//**
+ * \file  ringbuf_host.c
+ * \brief  host(linux) stress test of the spsc ring buffer(components/chip/drivers/ringbuf.c):
+ *         a producer thread and a consumer thread move a byte sequence through one FIFO,
+ *         each side rotating over the copy, byte and zero-copy(acquire/commit, peek/release)
+ *         paths with random lengths; the consumer checks every byte and the FIFO bounds.
+ *
+ *         build(from the repo root):
+ *         gcc -O2 -Icomponents/csi/include demo/script/ringbuf_host.c \
+ *             components/chip/drivers/ringbuf.c -lpthread -o ringbuf_host
+ *         usage:
+ *         ringbuf_host [-n bytes] [-s fifo_size] [-r seed]
+ * \copyright Copyright (C) 2015-2022 @ APTCHIP
+ * <table>
+ * <tr><th> Date  <th>Version  <th>Author	<th>Description
+ * </table>
+ * *********************************************************************
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <drv/ringbuf.h>
+
+#define RB_CHUNK_MAX		300			//longer than small FIFOs, exercises the clamp
+
+static ringbuffer_spsc_t s_tFifo;
+static uint32_t s_wTotal = 50000000;
+static uint32_t s_wSize = 256;
+static uint32_t s_wSeed = 1;
+static volatile int s_iFail = 0;
+
+//sequence byte n, not a multiple of the FIFO size so wraps are checked too
+static inline uint8_t seq_byte(uint32_t n)
+{
+	return (uint8_t)(n ^ (n >> 8) ^ (n >> 17));
+}
+
+static uint32_t xorshift(uint32_t *pwState)
+{
+	uint32_t x = *pwState;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *pwState = x;
+}
+
+static void *producer(void *pArg)
+{
+	uint8_t byChunk[RB_CHUNK_MAX];
+	uint32_t wRng = s_wSeed * 2654435761u + 1;
+	uint32_t wSent = 0, wLen, wDone, i;
+	uint8_t *pbyDst;
+
+	(void)pArg;
+	while(wSent < s_wTotal && !s_iFail)
+	{
+		wLen = xorshift(&wRng) % RB_CHUNK_MAX + 1;
+		if(wLen > s_wTotal - wSent)
+			wLen = s_wTotal - wSent;
+
+		switch(xorshift(&wRng) & 3)
+		{
+			case 0:											//copy in
+				for(i = 0; i < wLen; i++)
+					byChunk[i] = seq_byte(wSent + i);
+				wDone = ringbuffer_spsc_in(&s_tFifo, byChunk, wLen);
+				break;
+			case 1:											//byte in
+				for(wDone = 0; wDone < wLen; wDone++)
+					if(!ringbuffer_spsc_byte_in(&s_tFifo, seq_byte(wSent + wDone)))
+						break;
+				break;
+			default:										//zero copy
+				pbyDst = ringbuffer_spsc_write_acquire(&s_tFifo, &wDone);
+				if(pbyDst == NULL)
+					wDone = 0;
+				if(wDone > wLen)
+					wDone = wLen;
+				for(i = 0; i < wDone; i++)
+					pbyDst[i] = seq_byte(wSent + i);
+				if(wDone)
+					ringbuffer_spsc_write_commit(&s_tFifo, wDone);
+				break;
+		}
+
+		wSent += wDone;
+		if(wDone == 0)
+			sched_yield();
+	}
+	return NULL;
+}
+
+static void consume_check(uint32_t wGot, const uint8_t *pbyData, uint32_t wLen)
+{
+	uint32_t i;
+
+	for(i = 0; i < wLen; i++)
+	{
+		if(pbyData[i] != seq_byte(wGot + i))
+		{
+			printf("FAIL byte %u: 0x%02x, expected 0x%02x\n", (unsigned int)(wGot + i),
+				pbyData[i], seq_byte(wGot + i));
+			s_iFail = 1;
+			return;
+		}
+	}
+}
+
+static void *consumer(void *pArg)
+{
+	uint8_t byChunk[RB_CHUNK_MAX];
+	uint32_t wRng = s_wSeed * 40503u + 7;
+	uint32_t wGot = 0, wLen, wDone, wUsed;
+	uint8_t *pbySrc;
+
+	(void)pArg;
+	while(wGot < s_wTotal && !s_iFail)
+	{
+		wUsed = s_tFifo.wWrite - s_tFifo.wRead;
+		if(wUsed > s_wSize)
+		{
+			printf("FAIL used %u > size %u\n", (unsigned int)wUsed, (unsigned int)s_wSize);
+			s_iFail = 1;
+			break;
+		}
+
+		wLen = xorshift(&wRng) % RB_CHUNK_MAX + 1;
+		switch(xorshift(&wRng) & 3)
+		{
+			case 0:											//copy out
+				wDone = ringbuffer_spsc_out(&s_tFifo, byChunk, wLen);
+				consume_check(wGot, byChunk, wDone);
+				break;
+			case 1:											//byte out
+				for(wDone = 0; wDone < wLen; wDone++)
+				{
+					if(!ringbuffer_spsc_byte_out(&s_tFifo, &byChunk[wDone]))
+						break;
+				}
+				consume_check(wGot, byChunk, wDone);
+				break;
+			default:										//zero copy
+				pbySrc = ringbuffer_spsc_read_peek(&s_tFifo, &wDone);
+				if(pbySrc == NULL)
+					wDone = 0;
+				if(wDone > wLen)
+					wDone = wLen;
+				consume_check(wGot, pbySrc, wDone);
+				if(wDone)
+					ringbuffer_spsc_read_release(&s_tFifo, wDone);
+				break;
+		}
+
+		wGot += wDone;
+		if(wDone == 0)
+			sched_yield();
+	}
+
+	if(!s_iFail && ringbuffer_spsc_out(&s_tFifo, byChunk, 1))
+	{
+		printf("FAIL data beyond the sequence\n");
+		s_iFail = 1;
+	}
+	return NULL;
+}
+
+int main(int argc, char **argv)
+{
+	pthread_t tProd, tCons;
+	uint8_t *pbyBuf;
+	int iOpt;
+
+	while((iOpt = getopt(argc, argv, "n:s:r:")) != -1)
+	{
+		switch(iOpt)
+		{
+			case 'n': s_wTotal = strtoul(optarg, NULL, 0); break;
+			case 's': s_wSize = strtoul(optarg, NULL, 0); break;
+			case 'r': s_wSeed = strtoul(optarg, NULL, 0); break;
+			default:
+				fprintf(stderr, "usage: %s [-n bytes] [-s fifo_size] [-r seed]\n", argv[0]);
+				return 2;
+		}
+	}
+
+	pbyBuf = malloc(s_wSize);
+	if(!ringbuffer_spsc_init(&s_tFifo, pbyBuf, s_wSize))
+	{
+		fprintf(stderr, "fifo size %u is not a power of two\n", (unsigned int)s_wSize);
+		return 2;
+	}
+
+	pthread_create(&tProd, NULL, producer, NULL);
+	pthread_create(&tCons, NULL, consumer, NULL);
+	pthread_join(tProd, NULL);
+	pthread_join(tCons, NULL);
+
+	printf("spsc fifo %u bytes, %u bytes moved: %s\n", (unsigned int)s_wSize,
+		(unsigned int)s_wTotal, s_iFail ? "FAIL" : "PASS");
+	free(pbyBuf);
+	return s_iFail;
+}